@@ -0,0 +1,33 @@
+#!/bin/bash
+# Shared harness for the benchmark_*.sh scripts, sourced by each of them:
+#   source benchmark_common.sh
+# The sourcing script sets np and maxTime before calling runCase.
+
+exe=../source/main
+outDir=../data
+mkdir -p $outDir
+
+# run one case: output prefix, input file, case name, then extra input file lines
+# sets caseLog (the screen output), caseOut (the outputDir of the run), and
+# wallTime (s)
+runCase () {
+  prefix=$1; caseIn=$2; name=$3; shift 3
+  caseFile=$outDir/${prefix}_${name}.in
+  caseLog=$outDir/${prefix}_${name}.log
+  caseOut=$outDir/${prefix}_${name}_
+  cp $caseIn $caseFile
+  # later settings override earlier ones
+  echo "maxTime = $maxTime" >> $caseFile
+  echo "outputDir = $caseOut" >> $caseFile
+  for line in "$@"; do echo "$line" >> $caseFile; done
+
+  start=$(date +%s.%N)
+  mpirun -n $np $exe $caseFile > $caseLog 2>&1
+  end=$(date +%s.%N)
+  wallTime=$(echo "$end - $start" | bc)
+}
+
+# last field of the last line of the log of the previous case matching a pattern
+logValue () {
+  grep "$1" $caseLog | tail -1 | awk '{print $NF}'
+}
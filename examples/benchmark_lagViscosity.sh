@@ -0,0 +1,42 @@
+#!/bin/bash
+# Benchmark of lagging the effective viscosity across Runge-Kutta stages
+# (lagViscosity, lagViscosityTol) for a power-law simulation.
+#
+# Runs the given input file once with the viscosity computed at every stage
+# (the reference), then with lagViscosity = yes for each tolerance below,
+# and reports the wall time and number of time steps of each run.
+# Use compare_lagViscosity.m to compare the accuracy of each run against the
+# reference.
+#
+# lagViscosity = yes requires an explicit Runge-Kutta integrator, whose d_dt
+# does not integrate the heat equation, so every case (the reference included)
+# is run with timeIntegrator = RK43 and thermalCoupling = no. ex4.in is the
+# power-law example; its IMEX settings are overridden by these lines.
+#
+# usage (from the examples directory):
+#   ./benchmark_lagViscosity.sh [input file] [number of processors] [max time (s)]
+# e.g.
+#   ./benchmark_lagViscosity.sh ex4.in 4 1e10
+
+inFile=${1:-ex4.in}
+np=${2:-1}
+maxTime=${3:-1e10}
+tols="1e-3 1e-2 1e-1"
+common=("timeIntegrator = RK43" "thermalCoupling = no")
+
+source benchmark_common.sh
+
+# run one case: name, then extra input file lines
+runLag () {
+  name=$1; shift
+  runCase lagVisc $inFile $name "${common[@]}" "$@"
+  numSteps=$(wc -l < ${caseOut}med_time1D.txt)
+  numVisc=$(logValue "effective viscosity was computed")
+  printf "%-12s %12.2f %12s %12s\n" $name $wallTime $numSteps ${numVisc:--}
+}
+
+printf "%-12s %12s %12s %12s\n" "case" "wall time (s)" "steps output" "visc evals"
+runLag ref "lagViscosity = no"
+for tol in $tols; do
+  runLag tol$tol "lagViscosity = yes" "lagViscosityTol = $tol"
+done
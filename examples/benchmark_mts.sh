@@ -0,0 +1,43 @@
+#!/bin/bash
+# Benchmark of multiple time stepping of the wave equation (mtsLevels) in the
+# fully dynamic periods of a quasidynamic/fully dynamic simulation.
+#
+# Runs the given input file once with a single rate (the reference), then
+# with mtsLevels = 2 and 3, and reports the wall time and the time spent
+# propagating the wave of each run. Use compare_mts.m to compare the accuracy
+# of each run against the reference. A run that goes unstable shows up there
+# as a large difference, or as a run that stops early.
+#
+# mtsLevels > 1 only splits the work of the spatial operator between nodes of
+# different wave travel times, so it needs a grid that is stretched away from
+# the fault. ex3.in is the quasidynamic/fully dynamic example, with
+# bCoordTrans = 7; its inputDir is relative to the repository, so it is
+# overridden here.
+#
+# usage (from the examples directory):
+#   ./benchmark_mts.sh [input file] [number of processors] [max time (s)]
+# e.g.
+#   ./benchmark_mts.sh ex3.in 4 1e12
+
+inFile=${1:-ex3.in}
+np=${2:-1}
+maxTime=${3:-1e12}
+levels="2 3"
+common=("inputDir = ex3_")
+
+source benchmark_common.sh
+
+# run one case: name, then extra input file lines
+runMts () {
+  name=$1; shift
+  runCase mts $inFile $name "${common[@]}" "$@"
+  numSteps=$(wc -l < ${caseOut}med_time1D.txt)
+  propTime=$(logValue "time spent propagating the wave")
+  printf "%-12s %12.2f %12s %16s\n" $name $wallTime $numSteps ${propTime:--}
+}
+
+printf "%-12s %12s %12s %16s\n" "case" "wall time (s)" "steps output" "propagate (s)"
+runMts ref "mtsLevels = 1"
+for k in $levels; do
+  runMts levels$k "mtsLevels = $k"
+done
@@ -0,0 +1,39 @@
+#!/bin/bash
+# Benchmark of the PETSc TS integrators (timeIntegrator = TSARKIMEX, TSROSW,
+# TSBDF) against RK43 for a quasi-dynamic simulation.
+#
+# Runs the given input file once with RK43, then with each TS integrator and
+# each Jacobian preconditioner (tsJacobian) below, and reports the wall time,
+# number of accepted and rejected time steps, and the number of d_dt
+# evaluations of each run side by side.
+#
+# usage (from the examples directory):
+#   ./benchmark_tsIntegrators.sh [input file] [number of processors] [max time (s)]
+# e.g.
+#   ./benchmark_tsIntegrators.sh ex2.in 4 1e10
+
+inFile=${1:-ex2.in}
+np=${2:-1}
+maxTime=${3:-1e10}
+tsTypes="TSARKIMEX TSROSW TSBDF"
+jacTypes="mf diagonal"
+
+source benchmark_common.sh
+
+# run one case: name, then extra input file lines
+runTS () {
+  name=$1; shift
+  runCase tsInt $inFile $name "$@"
+  numSteps=$(logValue "total number of steps taken" | cut -d/ -f1)
+  numRejected=$(logValue "number of rejected steps")
+  numRhs=$(logValue "number of d_dt evaluations")
+  printf "%-20s %12.2f %12s %12s %12s\n" $name $wallTime ${numSteps:--} ${numRejected:--} ${numRhs:--}
+}
+
+printf "%-20s %12s %12s %12s %12s\n" "case" "wall time (s)" "steps" "rejected" "d_dt evals"
+runTS RK43 "timeIntegrator = RK43"
+for ts in $tsTypes; do
+  for jac in $jacTypes; do
+    runTS ${ts}_${jac} "timeIntegrator = $ts" "tsJacobian = $jac"
+  done
+done
@@ -0,0 +1,44 @@
+#!/bin/bash
+# Work-precision benchmark of the explicit embedded Runge-Kutta pairs
+# (timeIntegrator = RK43, RK54, RK65) on ex1 and ex2.
+#
+# Runs each input file with each integrator and each timeStepTol below, plus a
+# reference run with RK65 at a tighter tolerance, and reports the wall time,
+# number of time steps, and number of rejected steps of each run.
+# Use compare_workPrecision.m to compute the error of each run against the
+# reference and plot error against wall time.
+#
+# usage (from the examples directory):
+#   ./benchmark_workPrecision.sh [number of processors] [max time (s)]
+# e.g.
+#   ./benchmark_workPrecision.sh 4 1e10
+
+np=${1:-1}
+maxTime=${2:-1e10}
+inFiles="ex1 ex2"
+integrators="RK43 RK54 RK65"
+tols="1e-5 1e-6 1e-7 1e-8 1e-9"
+refTol=1e-11
+
+source benchmark_common.sh
+
+# run one case: input file, name, then extra input file lines
+runWP () {
+  inFile=$1; name=$2; shift 2
+  runCase wp_${inFile} ${inFile}.in $name "$@"
+  numSteps=$(logValue "total number of steps taken" | cut -d/ -f1)
+  numRejected=$(logValue "number of rejected steps")
+  printf "%-6s %-14s %12.2f %12s %12s\n" $inFile $name $wallTime ${numSteps:--} ${numRejected:--}
+  echo "$name $wallTime ${numSteps:-0}" >> $outDir/wp_${inFile}_summary.txt
+}
+
+printf "%-6s %-14s %12s %12s %12s\n" "input" "case" "wall time (s)" "steps" "rejected"
+for inFile in $inFiles; do
+  rm -f $outDir/wp_${inFile}_summary.txt
+  runWP $inFile ref "timeIntegrator = RK65" "timeStepTol = $refTol"
+  for integ in $integrators; do
+    for tol in $tols; do
+      runWP $inFile ${integ}_tol$tol "timeIntegrator = $integ" "timeStepTol = $tol"
+    done
+  done
+done
@@ -0,0 +1,33 @@
+% Script comparing the accuracy of runs from benchmark_lagViscosity.sh,
+% which lag the effective viscosity across Runge-Kutta stages, against the
+% reference run in which the viscosity is computed at every stage.
+%
+% Reports the max relative difference in shear stress and slip velocity on the
+% fault, after interpolating each run onto the output times of the reference.
+%
+% Required matlab functions are located in matlab/visualizePetsc.
+
+sourceDir = '../data/lagVisc_';
+cases = {'tol1e-3','tol1e-2','tol1e-1'};
+
+ref.time = load(strcat(sourceDir,'ref_med_time1D.txt'));
+ref.tau = loadVec(strcat(sourceDir,'ref_'),'tauP');
+ref.slipVel = loadVec(strcat(sourceDir,'ref_'),'slipVel');
+
+fprintf('%-12s %20s %20s\n','case','max rel err tau','max rel err log10(V)');
+for ii = 1:length(cases)
+  dir = strcat(sourceDir,cases{ii},'_');
+  d.time = load(strcat(dir,'med_time1D.txt'));
+  d.tau = loadVec(dir,'tauP');
+  d.slipVel = loadVec(dir,'slipVel');
+
+  % restrict to times covered by both runs
+  tEnd = min(ref.time(end),d.time(end));
+  I = ref.time <= tEnd;
+  tau = interp1(d.time,d.tau',ref.time(I))';
+  logV = interp1(d.time,log10(d.slipVel)',ref.time(I))';
+
+  errTau = max(max(abs(tau - ref.tau(:,I)))) / max(max(abs(ref.tau(:,I))));
+  errV = max(max(abs(logV - log10(ref.slipVel(:,I))))) / max(max(abs(log10(ref.slipVel(:,I)))));
+  fprintf('%-12s %20.5e %20.5e\n',cases{ii},errTau,errV);
+end
@@ -0,0 +1,35 @@
+% Script comparing the accuracy of runs from benchmark_mts.sh, which use
+% multiple time stepping for the wave equation, against the reference run
+% with a single rate.
+%
+% Reports the max relative difference in shear stress and slip velocity on the
+% fault, after interpolating each run onto the output times of the reference.
+% Small differences in the timing of an event grow over later cycles, so the
+% comparison is most telling for a max time just past the first event.
+%
+% Required matlab functions are located in matlab/visualizePetsc.
+
+sourceDir = '../data/mts_';
+cases = {'levels2','levels3'};
+
+ref.time = load(strcat(sourceDir,'ref_med_time1D.txt'));
+ref.tau = loadVec(strcat(sourceDir,'ref_'),'tauP');
+ref.slipVel = loadVec(strcat(sourceDir,'ref_'),'slipVel');
+
+fprintf('%-12s %12s %20s %20s\n','case','end time','max rel err tau','max rel err log10(V)');
+for ii = 1:length(cases)
+  dir = strcat(sourceDir,cases{ii},'_');
+  d.time = load(strcat(dir,'med_time1D.txt'));
+  d.tau = loadVec(dir,'tauP');
+  d.slipVel = loadVec(dir,'slipVel');
+
+  % restrict to times covered by both runs
+  tEnd = min(ref.time(end),d.time(end));
+  I = ref.time <= tEnd;
+  tau = interp1(d.time,d.tau',ref.time(I))';
+  logV = interp1(d.time,log10(d.slipVel)',ref.time(I))';
+
+  errTau = max(max(abs(tau - ref.tau(:,I)))) / max(max(abs(ref.tau(:,I))));
+  errV = max(max(abs(logV - log10(ref.slipVel(:,I))))) / max(max(abs(log10(ref.slipVel(:,I)))));
+  fprintf('%-12s %12.5e %20.5e %20.5e\n',cases{ii},d.time(end),errTau,errV);
+end
@@ -0,0 +1,49 @@
+% Script computing the work-precision diagram of the runs from
+% benchmark_workPrecision.sh, which integrate ex1 and ex2 with RK43, RK54 and
+% RK65 at a range of tolerances.
+%
+% Reports the max relative difference in log10(slip velocity) on the fault
+% against the reference run, after interpolating each run onto the output
+% times of the reference, and plots it against the wall time of each run.
+%
+% Required matlab functions are located in matlab/visualizePetsc.
+
+sourceDir = '../data/wp_';
+inFiles = {'ex1','ex2'};
+integrators = {'RK43','RK54','RK65'};
+tols = {'1e-5','1e-6','1e-7','1e-8','1e-9'};
+
+for kk = 1:length(inFiles)
+  ref.time = load(strcat(sourceDir,inFiles{kk},'_ref_med_time1D.txt'));
+  ref.slipVel = loadVec(strcat(sourceDir,inFiles{kk},'_ref_'),'slipVel');
+
+  % wall times from benchmark_workPrecision.sh
+  fid = fopen(strcat(sourceDir,inFiles{kk},'_summary.txt'));
+  summary = textscan(fid,'%s %f %f');
+  fclose(fid);
+
+  figure(kk), clf
+  fprintf('\n%s\n%-16s %14s %10s %20s\n',inFiles{kk},'case','wall time (s)','steps','max rel err log10(V)');
+  for ii = 1:length(integrators)
+    err = zeros(size(tols)); wallTime = zeros(size(tols));
+    for jj = 1:length(tols)
+      name = strcat(integrators{ii},'_tol',tols{jj});
+      dir = strcat(sourceDir,inFiles{kk},'_',name,'_');
+      d.time = load(strcat(dir,'med_time1D.txt'));
+      d.slipVel = loadVec(dir,'slipVel');
+
+      % restrict to times covered by both runs
+      tEnd = min(ref.time(end),d.time(end));
+      I = ref.time <= tEnd;
+      logV = interp1(d.time,log10(d.slipVel)',ref.time(I))';
+      err(jj) = max(max(abs(logV - log10(ref.slipVel(:,I))))) / max(max(abs(log10(ref.slipVel(:,I)))));
+
+      ind = find(strcmp(summary{1},name));
+      wallTime(jj) = summary{2}(ind);
+      fprintf('%-16s %14.2f %10i %20.5e\n',name,wallTime(jj),summary{3}(ind),err(jj));
+    end
+    loglog(wallTime,err,'.-','MarkerSize',15), hold on
+  end
+  xlabel('wall time (s)'), ylabel('max relative error in log_{10}(V)')
+  title(inFiles{kk}), legend(integrators)
+end
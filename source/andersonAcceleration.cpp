@@ -0,0 +1,160 @@
+#include "andersonAcceleration.hpp"
+
+#define FILENAME "andersonAcceleration.cpp"
+
+using namespace std;
+
+
+AndersonAcceleration::AndersonAcceleration(const PetscInt depth,const PetscScalar beta)
+: _depth(depth),_beta(beta),_numUpdates(0),_numRestarts(0)
+{
+  assert(_depth >= 0);
+  assert(_beta > 0 && _beta <= 1);
+}
+
+AndersonAcceleration::~AndersonAcceleration()
+{
+  reset();
+  destroy(_fPrev);
+  destroy(_gPrev);
+}
+
+
+PetscErrorCode AndersonAcceleration::reset()
+{
+  for (size_t i = 0; i < _dF.size(); i++) {
+    destroy(_dF[i]);
+    destroy(_dG[i]);
+  }
+  _dF.clear();
+  _dG.clear();
+  return 0;
+}
+
+
+// sum of dot products of the components of a and b
+PetscErrorCode AndersonAcceleration::dot(const vector<Vec>& a,const vector<Vec>& b,PetscScalar& val)
+{
+  PetscErrorCode ierr = 0;
+  val = 0;
+  for (size_t c = 0; c < a.size(); c++) {
+    PetscScalar v = 0;
+    ierr = VecDot(a[c],b[c],&v);CHKERRQ(ierr);
+    val += v;
+  }
+  return ierr;
+}
+
+PetscErrorCode AndersonAcceleration::duplicate(const vector<Vec>& in,vector<Vec>& out)
+{
+  PetscErrorCode ierr = 0;
+  out.resize(in.size());
+  for (size_t c = 0; c < in.size(); c++) {
+    ierr = VecDuplicate(in[c],&out[c]);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+PetscErrorCode AndersonAcceleration::destroy(vector<Vec>& v)
+{
+  for (size_t c = 0; c < v.size(); c++) { VecDestroy(&v[c]); }
+  v.clear();
+  return 0;
+}
+
+
+PetscErrorCode AndersonAcceleration::update(const vector<Vec>& x,vector<Vec>& gx)
+{
+  PetscErrorCode ierr = 0;
+  assert(x.size() == gx.size());
+  const size_t nc = x.size();
+
+  // residual f = g(x) - x
+  vector<Vec> f;
+  ierr = duplicate(x,f);CHKERRQ(ierr);
+  for (size_t c = 0; c < nc; c++) { ierr = VecWAXPY(f[c],-1.0,x[c],gx[c]);CHKERRQ(ierr); }
+
+  // update history of differences
+  if (_fPrev.size() == nc && _depth > 0) {
+    vector<Vec> dF,dG;
+    ierr = duplicate(x,dF);CHKERRQ(ierr);
+    ierr = duplicate(x,dG);CHKERRQ(ierr);
+    for (size_t c = 0; c < nc; c++) {
+      ierr = VecWAXPY(dF[c],-1.0,_fPrev[c],f[c]);CHKERRQ(ierr);
+      ierr = VecWAXPY(dG[c],-1.0,_gPrev[c],gx[c]);CHKERRQ(ierr);
+    }
+    _dF.push_back(dF);
+    _dG.push_back(dG);
+    if ((PetscInt) _dF.size() > _depth) {
+      destroy(_dF.front()); _dF.erase(_dF.begin());
+      destroy(_dG.front()); _dG.erase(_dG.begin());
+    }
+  }
+  if (_fPrev.size() != nc) {
+    ierr = duplicate(x,_fPrev);CHKERRQ(ierr);
+    ierr = duplicate(x,_gPrev);CHKERRQ(ierr);
+  }
+  for (size_t c = 0; c < nc; c++) {
+    ierr = VecCopy(f[c],_fPrev[c]);CHKERRQ(ierr);
+    ierr = VecCopy(gx[c],_gPrev[c]);CHKERRQ(ierr);
+  }
+
+  // least squares problem for gamma, using the normal equations (dF^T dF) gamma = dF^T f
+  const PetscInt m = _dF.size();
+  vector<PetscScalar> M(m*m,0.0), gamma(m,0.0);
+  for (PetscInt i = 0; i < m; i++) {
+    ierr = dot(_dF[i],f,gamma[i]);CHKERRQ(ierr);
+    for (PetscInt j = 0; j <= i; j++) {
+      ierr = dot(_dF[i],_dF[j],M[i*m+j]);CHKERRQ(ierr);
+      M[j*m+i] = M[i*m+j];
+    }
+  }
+
+  // Gaussian elimination with partial pivoting, with a small diagonal shift
+  // if the history is (nearly) linearly dependent, discard it
+  bool isSingular = 0;
+  PetscScalar maxDiag = 0;
+  for (PetscInt i = 0; i < m; i++) { maxDiag = max(maxDiag,M[i*m+i]); }
+  for (PetscInt i = 0; i < m; i++) { M[i*m+i] += 1e-12 * maxDiag; }
+  for (PetscInt k = 0; k < m && !isSingular; k++) {
+    PetscInt p = k;
+    for (PetscInt i = k+1; i < m; i++) { if (abs(M[i*m+k]) > abs(M[p*m+k])) { p = i; } }
+    if (!(abs(M[p*m+k]) > 1e-14 * maxDiag)) { isSingular = 1; break; }
+    if (p != k) {
+      for (PetscInt j = 0; j < m; j++) { std::swap(M[k*m+j],M[p*m+j]); }
+      std::swap(gamma[k],gamma[p]);
+    }
+    for (PetscInt i = k+1; i < m; i++) {
+      PetscScalar l = M[i*m+k] / M[k*m+k];
+      for (PetscInt j = k; j < m; j++) { M[i*m+j] -= l * M[k*m+j]; }
+      gamma[i] -= l * gamma[k];
+    }
+  }
+  if (!isSingular) {
+    for (PetscInt k = m-1; k >= 0; k--) {
+      for (PetscInt j = k+1; j < m; j++) { gamma[k] -= M[k*m+j] * gamma[j]; }
+      gamma[k] /= M[k*m+k];
+    }
+  }
+  if (isSingular && m > 0) {
+    reset();
+    _numRestarts++;
+  }
+
+  // next iterate: x + beta*f - sum_i gamma_i * (dG_i - (1-beta)*dF_i)
+  for (size_t c = 0; c < nc; c++) {
+    ierr = VecAXPBY(gx[c],1.0-_beta,_beta,x[c]);CHKERRQ(ierr);
+  }
+  if (!isSingular) {
+    for (PetscInt i = 0; i < m; i++) {
+      for (size_t c = 0; c < nc; c++) {
+        ierr = VecAXPY(gx[c],-gamma[i],_dG[i][c]);CHKERRQ(ierr);
+        ierr = VecAXPY(gx[c],(1.0-_beta)*gamma[i],_dF[i][c]);CHKERRQ(ierr);
+      }
+    }
+  }
+
+  destroy(f);
+  _numUpdates++;
+  return ierr;
+}
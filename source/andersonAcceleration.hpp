@@ -0,0 +1,57 @@
+#ifndef ANDERSONACCELERATION_H_INCLUDED
+#define ANDERSONACCELERATION_H_INCLUDED
+
+#include <petscksp.h>
+#include <vector>
+#include <cmath>
+#include <assert.h>
+
+using namespace std;
+
+/*
+ * Anderson acceleration for fixed-point iterations x = g(x), where the
+ * unknown may be made up of several Vecs (e.g. fault shear stress and
+ * temperature), which are treated as one concatenated vector.
+ *
+ * With f_k = g(x_k) - x_k and the differences dF, dG of the last m residuals
+ * and map evaluations, the next iterate is
+ *    x_{k+1} = x_k + beta*f_k - (dG - (1-beta)*dF) * gamma,
+ * where gamma minimizes |f_k - dF*gamma|. With depth m = 0 this is the
+ * damped fixed-point iteration x_{k+1} = (1-beta)*x_k + beta*g(x_k).
+ *
+ * Example usage:
+ *    AndersonAcceleration aa(depth,beta);
+ *    while (not converged) {
+ *      // evaluate g(x) into gx, then
+ *      aa.update(x,gx); // gx now holds the next iterate
+ *    }
+ */
+
+class AndersonAcceleration
+{
+private:
+  // disable default copy constructor and assignment operator
+  AndersonAcceleration(const AndersonAcceleration &that);
+  AndersonAcceleration& operator=(const AndersonAcceleration &rhs);
+
+  static PetscErrorCode dot(const vector<Vec>& a,const vector<Vec>& b,PetscScalar& val);
+  static PetscErrorCode duplicate(const vector<Vec>& in,vector<Vec>& out);
+  static PetscErrorCode destroy(vector<Vec>& v);
+
+public:
+  const PetscInt        _depth; // max number of previous iterates used
+  const PetscScalar     _beta; // damping, 0 < beta <= 1
+  vector< vector<Vec> > _dF,_dG; // differences of residuals and map evaluations, oldest first
+  vector<Vec>           _fPrev,_gPrev; // residual and map evaluation from previous update
+  PetscInt              _numUpdates,_numRestarts;
+
+  AndersonAcceleration(const PetscInt depth,const PetscScalar beta);
+  ~AndersonAcceleration();
+
+  PetscErrorCode reset(); // discard history
+
+  // given iterate x and gx = g(x), overwrite gx with the next iterate
+  PetscErrorCode update(const vector<Vec>& x,vector<Vec>& gx);
+};
+
+#endif
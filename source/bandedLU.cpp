@@ -0,0 +1,489 @@
+#include "bandedLU.hpp"
+
+#define FILENAME "bandedLU.cpp"
+
+using namespace std;
+
+
+BandedLU::BandedLU()
+: _N(0),_bw(0),_isFactored(0)
+{ }
+
+BandedLU::BandedLU(const PetscInt N,const PetscInt bw)
+: _N(0),_bw(0),_isFactored(0)
+{
+  setSize(N,bw);
+}
+
+
+PetscErrorCode BandedLU::setSize(const PetscInt N,const PetscInt bw)
+{
+  assert(N > 0 && bw >= 0);
+  _N = N;
+  _bw = min(bw,N-1);
+  _a.assign(_N*(2*_bw+1),0.0);
+  _isFactored = 0;
+  return 0;
+}
+
+
+PetscErrorCode BandedLU::zeroEntries()
+{
+  std::fill(_a.begin(),_a.end(),0.0);
+  _isFactored = 0;
+  return 0;
+}
+
+
+// compute max |i-j| over nonzero entries of A
+// A may be distributed, in which case the result is reduced over its communicator
+PetscErrorCode BandedLU::computeBandwidth(const Mat& A,PetscInt& bw)
+{
+  PetscErrorCode ierr = 0;
+  PetscInt Istart,Iend,ncols;
+  const PetscInt *cols;
+  const PetscScalar *vals;
+  MPI_Comm comm;
+
+  PetscInt bwLocal = 0;
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend); CHKERRQ(ierr);
+  for (PetscInt Ii = Istart; Ii < Iend; Ii++) {
+    ierr = MatGetRow(A,Ii,&ncols,&cols,&vals); CHKERRQ(ierr);
+    for (PetscInt jj = 0; jj < ncols; jj++) {
+      if (vals[jj] != 0.0) { bwLocal = max(bwLocal,(PetscInt) abs(cols[jj]-Ii)); }
+    }
+    ierr = MatRestoreRow(A,Ii,&ncols,&cols,&vals); CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectGetComm((PetscObject) A,&comm); CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&bwLocal,&bw,1,MPIU_INT,MPI_MAX,comm); CHKERRQ(ierr);
+
+  return ierr;
+}
+
+
+// copy entries of A into band storage on rank 0 of A's communicator
+// if A is distributed, each rank's rows (contiguous in band storage) are gathered
+// to rank 0, and the storage on the other ranks is released
+PetscErrorCode BandedLU::setFromMat(const Mat& A)
+{
+  PetscErrorCode ierr = 0;
+  PetscInt Istart,Iend,ncols;
+  const PetscInt *cols;
+  const PetscScalar *vals;
+  const PetscInt w = 2*_bw+1;
+  MPI_Comm comm;
+
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend); CHKERRQ(ierr);
+  vector<PetscScalar> rows((Iend-Istart)*w,0.0);
+  for (PetscInt Ii = Istart; Ii < Iend; Ii++) {
+    ierr = MatGetRow(A,Ii,&ncols,&cols,&vals); CHKERRQ(ierr);
+    for (PetscInt jj = 0; jj < ncols; jj++) {
+      if (vals[jj] == 0.0) { continue; }
+      assert(cols[jj] >= 0 && cols[jj] < _N && abs(cols[jj]-Ii) <= _bw);
+      rows[(Ii-Istart)*w + _bw + cols[jj]-Ii] = vals[jj];
+    }
+    ierr = MatRestoreRow(A,Ii,&ncols,&cols,&vals); CHKERRQ(ierr);
+  }
+  _isFactored = 0;
+
+  PetscMPIInt rank,size;
+  ierr = PetscObjectGetComm((PetscObject) A,&comm); CHKERRQ(ierr);
+  MPI_Comm_rank(comm,&rank);
+  MPI_Comm_size(comm,&size);
+  if (size == 1) {
+    _a.swap(rows);
+    return ierr;
+  }
+
+  PetscMPIInt count = (PetscMPIInt) rows.size();
+  vector<PetscMPIInt> counts, displs;
+  if (rank == 0) {
+    counts.resize(size);
+    displs.assign(size,0);
+  }
+  ierr = MPI_Gather(&count,1,MPI_INT,counts.data(),1,MPI_INT,0,comm); CHKERRQ(ierr);
+  if (rank == 0) {
+    for (PetscMPIInt r = 1; r < size; r++) { displs[r] = displs[r-1] + counts[r-1]; }
+    _a.assign(_N*w,0.0);
+  }
+  ierr = MPI_Gatherv(rows.data(),count,MPIU_SCALAR,_a.data(),counts.data(),displs.data(),MPIU_SCALAR,0,comm); CHKERRQ(ierr);
+  if (rank != 0) { vector<PetscScalar>().swap(_a); }
+
+  return ierr;
+}
+
+
+// copy the band storage from rank 0 to every rank of comm
+PetscErrorCode BandedLU::bcast(MPI_Comm comm)
+{
+  PetscErrorCode ierr = 0;
+
+  _a.resize(_N*(2*_bw+1));
+  ierr = MPI_Bcast(_a.data(),(PetscMPIInt) _a.size(),MPIU_SCALAR,0,comm); CHKERRQ(ierr);
+  ierr = MPI_Bcast(&_isFactored,1,MPI_INT,0,comm); CHKERRQ(ierr);
+
+  return ierr;
+}
+
+
+// LU factorization without pivoting, in place
+// L (unit diagonal) is stored below the diagonal, U on and above it
+PetscErrorCode BandedLU::factor()
+{
+  PetscErrorCode ierr = 0;
+  const PetscInt w = 2*_bw+1;
+
+  for (PetscInt i = 0; i < _N; i++) {
+    const PetscScalar piv = _a[i*w + _bw];
+    if (piv == 0.0) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"ERROR: zero pivot in BandedLU::factor at row %i\n",i);
+      assert(0);
+    }
+    const PetscInt rEnd = min(_N-1,i+_bw);
+    for (PetscInt r = i+1; r <= rEnd; r++) {
+      PetscScalar& l = _a[r*w + _bw + i-r];
+      if (l == 0.0) { continue; }
+      l /= piv;
+      for (PetscInt c = i+1; c <= rEnd; c++) {
+        _a[r*w + _bw + c-r] -= l * _a[i*w + _bw + c-i];
+      }
+    }
+  }
+  _isFactored = 1;
+
+  return ierr;
+}
+
+
+// solve A x = rhs using the LU factors; rhs and x may point to the same array
+PetscErrorCode BandedLU::solve(const PetscScalar *rhs, PetscScalar *x) const
+{
+  assert(_isFactored);
+  const PetscInt w = 2*_bw+1;
+
+  if (x != rhs) { for (PetscInt i = 0; i < _N; i++) { x[i] = rhs[i]; } }
+
+  // forward substitution with unit lower triangle
+  for (PetscInt i = 1; i < _N; i++) {
+    const PetscInt cStart = max((PetscInt) 0,i-_bw);
+    PetscScalar sum = x[i];
+    for (PetscInt c = cStart; c < i; c++) { sum -= _a[i*w + _bw + c-i] * x[c]; }
+    x[i] = sum;
+  }
+
+  // backward substitution with upper triangle
+  for (PetscInt i = _N-1; i >= 0; i--) {
+    const PetscInt cEnd = min(_N-1,i+_bw);
+    PetscScalar sum = x[i];
+    for (PetscInt c = i+1; c <= cEnd; c++) { sum -= _a[i*w + _bw + c-i] * x[c]; }
+    x[i] = sum / _a[i*w + _bw];
+  }
+
+  return 0;
+}
+
+
+// solve A x = rhs for sequential Vecs
+PetscErrorCode BandedLU::solve(const Vec& rhs, Vec& x) const
+{
+  PetscErrorCode ierr = 0;
+  const PetscScalar *b;
+  PetscScalar *xA;
+
+  ierr = VecGetArrayRead(rhs,&b); CHKERRQ(ierr);
+  ierr = VecGetArray(x,&xA); CHKERRQ(ierr);
+  ierr = solve(b,xA); CHKERRQ(ierr);
+  ierr = VecRestoreArray(x,&xA); CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(rhs,&b); CHKERRQ(ierr);
+
+  return ierr;
+}
+
+
+// out = A * in
+PetscErrorCode BandedLU::mult(const PetscScalar *in, PetscScalar *out) const
+{
+  assert(!_isFactored);
+  const PetscInt w = 2*_bw+1;
+
+  for (PetscInt i = 0; i < _N; i++) {
+    const PetscInt cStart = max((PetscInt) 0,i-_bw);
+    const PetscInt cEnd = min(_N-1,i+_bw);
+    PetscScalar sum = 0.0;
+    for (PetscInt c = cStart; c <= cEnd; c++) { sum += _a[i*w + _bw + c-i] * in[c]; }
+    out[i] = sum;
+  }
+
+  return 0;
+}
+
+
+//======================================================================
+// BandedLUShell
+
+BandedLUShell::BandedLUShell()
+: _scatter(NULL),_seq(NULL),_rank(0)
+{
+  MPI_Comm_rank(PETSC_COMM_WORLD,&_rank);
+}
+
+BandedLUShell::~BandedLUShell()
+{
+  VecScatterDestroy(&_scatter);
+  VecDestroy(&_seq);
+}
+
+
+// turn pc into a banded LU shell preconditioner
+PetscErrorCode BandedLUShell::setPCType(PC& pc)
+{
+  PetscErrorCode ierr = 0;
+
+  BandedLUShell *ctx = new BandedLUShell();
+  ierr = PCSetType(pc,PCSHELL);                                         CHKERRQ(ierr);
+  ierr = PCShellSetContext(pc,ctx);                                     CHKERRQ(ierr);
+  ierr = PCShellSetSetUp(pc,BandedLUShell::setUp);                      CHKERRQ(ierr);
+  ierr = PCShellSetApply(pc,BandedLUShell::apply);                      CHKERRQ(ierr);
+  ierr = PCShellSetDestroy(pc,BandedLUShell::destroy);                  CHKERRQ(ierr);
+  ierr = PCShellSetName(pc,"bandedLU");                                 CHKERRQ(ierr);
+
+  return ierr;
+}
+
+
+// gather preconditioning matrix into band storage and factor it on rank 0
+PetscErrorCode BandedLUShell::setUp(PC pc)
+{
+  PetscErrorCode ierr = 0;
+  void *vctx;
+  Mat A,P;
+  PetscInt N,bw;
+
+  ierr = PCShellGetContext(pc,&vctx); CHKERRQ(ierr);
+  BandedLUShell *ctx = (BandedLUShell*) vctx;
+  ierr = PCGetOperators(pc,&A,&P); CHKERRQ(ierr);
+
+  ierr = MatGetSize(P,&N,NULL); CHKERRQ(ierr);
+  ierr = BandedLU::computeBandwidth(P,bw); CHKERRQ(ierr);
+  ierr = ctx->_lu.setSize(N,bw); CHKERRQ(ierr);
+  ierr = ctx->_lu.setFromMat(P); CHKERRQ(ierr);
+  if (ctx->_rank == 0) { ierr = ctx->_lu.factor(); CHKERRQ(ierr); }
+
+  return ierr;
+}
+
+
+// y = P^-1 x
+PetscErrorCode BandedLUShell::apply(PC pc,Vec x,Vec y)
+{
+  PetscErrorCode ierr = 0;
+  void *vctx;
+
+  ierr = PCShellGetContext(pc,&vctx); CHKERRQ(ierr);
+  BandedLUShell *ctx = (BandedLUShell*) vctx;
+
+  if (ctx->_scatter == NULL) {
+    ierr = VecScatterCreateToZero(x,&ctx->_scatter,&ctx->_seq); CHKERRQ(ierr);
+  }
+
+  ierr = VecScatterBegin(ctx->_scatter,x,ctx->_seq,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(ctx->_scatter,x,ctx->_seq,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  if (ctx->_rank == 0) {
+    PetscScalar *s;
+    ierr = VecGetArray(ctx->_seq,&s); CHKERRQ(ierr);
+    ierr = ctx->_lu.solve(s,s); CHKERRQ(ierr);
+    ierr = VecRestoreArray(ctx->_seq,&s); CHKERRQ(ierr);
+  }
+  ierr = VecScatterBegin(ctx->_scatter,ctx->_seq,y,INSERT_VALUES,SCATTER_REVERSE); CHKERRQ(ierr);
+  ierr = VecScatterEnd(ctx->_scatter,ctx->_seq,y,INSERT_VALUES,SCATTER_REVERSE); CHKERRQ(ierr);
+
+  return ierr;
+}
+
+
+PetscErrorCode BandedLUShell::destroy(PC pc)
+{
+  PetscErrorCode ierr = 0;
+  void *vctx;
+  ierr = PCShellGetContext(pc,&vctx); CHKERRQ(ierr);
+  delete (BandedLUShell*) vctx;
+  return ierr;
+}
+
+
+//======================================================================
+// BandedCoeffOp
+
+BandedCoeffOp::BandedCoeffOp()
+: _N(0),_bw(0),_rc(0)
+{ }
+
+
+// find W by probing sbp with coefficients that are 1 on every s-th node and 0 elsewhere
+// for s = 2*rc+1, each row of A sees at most one of these nodes within radius rc
+PetscErrorCode BandedCoeffOp::setFromSbp(SbpOps *sbp,const Vec& coeff,PetscBool& isAffine)
+{
+  PetscErrorCode ierr = 0;
+  Mat A;
+  Vec v,r,rSeq;
+  VecScatter toZero;
+  PetscInt Istart,Iend;
+  PetscMPIInt rank;
+
+  MPI_Comm_rank(PETSC_COMM_WORLD,&rank);
+  isAffine = PETSC_FALSE;
+  ierr = VecGetSize(coeff,&_N); CHKERRQ(ierr);
+  ierr = VecDuplicate(coeff,&v); CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(v,&Istart,&Iend); CHKERRQ(ierr);
+
+  // bandwidth, and constant part
+  ierr = VecSet(v,1.0); CHKERRQ(ierr);
+  ierr = sbp->updateVarCoeff(v); CHKERRQ(ierr);
+  ierr = sbp->getA(A); CHKERRQ(ierr);
+  ierr = BandedLU::computeBandwidth(A,_bw); CHKERRQ(ierr);
+  _bw = min(_bw,_N-1);
+  ierr = VecSet(v,0.0); CHKERRQ(ierr);
+  ierr = sbp->updateVarCoeff(v); CHKERRQ(ierr);
+  ierr = sbp->getA(A); CHKERRQ(ierr);
+  ierr = _A0.setSize(_N,_bw); CHKERRQ(ierr);
+  ierr = _A0.setFromMat(A); CHKERRQ(ierr);
+
+  // operator for a random positive coefficient, to check the representation against
+  ierr = VecDuplicate(coeff,&r); CHKERRQ(ierr);
+  ierr = VecSetRandom(r,NULL); CHKERRQ(ierr);
+  ierr = VecShift(r,0.5); CHKERRQ(ierr);
+  ierr = sbp->updateVarCoeff(r); CHKERRQ(ierr);
+  ierr = sbp->getA(A); CHKERRQ(ierr);
+  BandedLU Ar(_N,_bw), Am(_N,_bw), Atest;
+  if (rank == 0) { ierr = Atest.setSize(_N,_bw); CHKERRQ(ierr); }
+  ierr = Ar.setFromMat(A); CHKERRQ(ierr);
+  ierr = VecScatterCreateToZero(r,&toZero,&rSeq); CHKERRQ(ierr);
+  ierr = VecScatterBegin(toZero,r,rSeq,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(toZero,r,rSeq,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+
+  PetscScalar maxA = 0.0;
+  for (size_t Ii = 0; Ii < Ar._a.size(); Ii++) { maxA = max(maxA,(PetscScalar) fabs(Ar._a[Ii])); }
+
+  // the operator is probed on every rank, W is formed and checked on rank 0
+  _rc = _bw + 1;
+  while (1) {
+    PetscInt s = 2*_rc+1;
+    if (s >= _N) { s = _N; _rc = _N-1; }
+    if (rank == 0) { _W.assign(_N*(2*_bw+1)*(2*_rc+1),0.0); }
+
+    for (PetscInt m = 0; m < s; m++) {
+      PetscScalar *vA;
+      ierr = VecGetArray(v,&vA); CHKERRQ(ierr);
+      for (PetscInt Ii = Istart; Ii < Iend; Ii++) { vA[Ii-Istart] = (Ii % s == m) ? 1.0 : 0.0; }
+      ierr = VecRestoreArray(v,&vA); CHKERRQ(ierr);
+      ierr = sbp->updateVarCoeff(v); CHKERRQ(ierr);
+      ierr = sbp->getA(A); CHKERRQ(ierr);
+      ierr = Am.setFromMat(A); CHKERRQ(ierr);
+      if (rank != 0) { continue; }
+
+      for (PetscInt i = 0; i < _N; i++) {
+        // the only node of color m within radius rc of i
+        const PetscInt k0 = max((PetscInt) 0,i-_rc);
+        const PetscInt k = k0 + ((m - k0) % s + s) % s;
+        if (k >= _N || k > i+_rc) { continue; }
+        const PetscInt jStart = max((PetscInt) 0,i-_bw), jEnd = min(_N-1,i+_bw);
+        for (PetscInt j = jStart; j <= jEnd; j++) {
+          _W[(i*(2*_bw+1) + _bw + j-i)*(2*_rc+1) + _rc + k-i] = Am.getValue(i,j) - _A0.getValue(i,j);
+        }
+      }
+    }
+
+    // check against the random coefficient
+    int passed = 0;
+    if (rank == 0) {
+      const PetscScalar *rA;
+      ierr = VecGetArrayRead(rSeq,&rA); CHKERRQ(ierr);
+      ierr = assemble(rA,Atest); CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(rSeq,&rA); CHKERRQ(ierr);
+      PetscScalar maxDiff = 0.0;
+      for (size_t Ii = 0; Ii < Ar._a.size(); Ii++) { maxDiff = max(maxDiff,(PetscScalar) fabs(Ar._a[Ii] - Atest._a[Ii])); }
+      passed = maxDiff <= 1e-10 * maxA;
+    }
+    ierr = MPI_Bcast(&passed,1,MPI_INT,0,PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+    if (passed) { isAffine = PETSC_TRUE; break; }
+    if (s == _N) { break; } // every node probed separately, so A is not affine in c
+    _rc *= 2;
+  }
+
+  // shrink the radius to the actual coefficient dependence
+  if (isAffine && rank == 0) {
+    PetscInt rc = 0;
+    for (PetscInt i = 0; i < _N; i++) {
+      const PetscInt jStart = max((PetscInt) 0,i-_bw), jEnd = min(_N-1,i+_bw);
+      const PetscInt kStart = max((PetscInt) 0,i-_rc), kEnd = min(_N-1,i+_rc);
+      for (PetscInt j = jStart; j <= jEnd; j++) {
+        for (PetscInt k = kStart; k <= kEnd; k++) {
+          if (getW(i,j,k) != 0.0) { rc = max(rc,(PetscInt) abs(k-i)); }
+        }
+      }
+    }
+    vector<PetscScalar> W(_N*(2*_bw+1)*(2*rc+1),0.0);
+    for (PetscInt i = 0; i < _N; i++) {
+      const PetscInt jStart = max((PetscInt) 0,i-_bw), jEnd = min(_N-1,i+_bw);
+      const PetscInt kStart = max((PetscInt) 0,i-rc), kEnd = min(_N-1,i+rc);
+      for (PetscInt j = jStart; j <= jEnd; j++) {
+        for (PetscInt k = kStart; k <= kEnd; k++) {
+          W[(i*(2*_bw+1) + _bw + j-i)*(2*rc+1) + rc + k-i] = getW(i,j,k);
+        }
+      }
+    }
+    _W.swap(W);
+    _rc = rc;
+  }
+
+  ierr = MPI_Bcast(&_rc,1,MPIU_INT,0,PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+  VecDestroy(&v);
+  VecDestroy(&r);
+  VecDestroy(&rSeq);
+  VecScatterDestroy(&toZero);
+
+  return ierr;
+}
+
+
+// A = A(c)
+PetscErrorCode BandedCoeffOp::assemble(const PetscScalar *c,BandedLU& A) const
+{
+  assert(A._N == _N && A._bw >= _bw);
+  A.zeroEntries();
+
+  for (PetscInt i = 0; i < _N; i++) {
+    const PetscInt jStart = max((PetscInt) 0,i-_bw), jEnd = min(_N-1,i+_bw);
+    const PetscInt kStart = max((PetscInt) 0,i-_rc), kEnd = min(_N-1,i+_rc);
+    for (PetscInt j = jStart; j <= jEnd; j++) {
+      const PetscScalar *w = &_W[(i*(2*_bw+1) + _bw + j-i)*(2*_rc+1) + _rc];
+      PetscScalar sum = _A0.getValue(i,j);
+      for (PetscInt k = kStart; k <= kEnd; k++) { sum += w[k-i] * c[k]; }
+      A.setValue(i,j,sum);
+    }
+  }
+
+  return 0;
+}
+
+
+// J += diag(rowScale) * G(p) * diag(dc), where G(p)_ik = sum_j W_ijk p_j = d(A(c)*p)_i/dc_k
+PetscErrorCode BandedCoeffOp::addCoeffDerivative(const PetscScalar *p,const PetscScalar *rowScale,const PetscScalar *dc,BandedLU& J) const
+{
+  assert(J._N == _N && J._bw >= _rc);
+
+  for (PetscInt i = 0; i < _N; i++) {
+    const PetscInt jStart = max((PetscInt) 0,i-_bw), jEnd = min(_N-1,i+_bw);
+    const PetscInt kStart = max((PetscInt) 0,i-_rc), kEnd = min(_N-1,i+_rc);
+    for (PetscInt j = jStart; j <= jEnd; j++) {
+      const PetscScalar *w = &_W[(i*(2*_bw+1) + _bw + j-i)*(2*_rc+1) + _rc];
+      const PetscScalar f = rowScale[i] * p[j];
+      for (PetscInt k = kStart; k <= kEnd; k++) { J.addValue(i,k,f * w[k-i] * dc[k]); }
+    }
+  }
+
+  return 0;
+}
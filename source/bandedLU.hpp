@@ -0,0 +1,158 @@
+#ifndef BANDEDLU_H_INCLUDED
+#define BANDEDLU_H_INCLUDED
+
+#include <petscksp.h>
+#include <vector>
+#include <assert.h>
+#include "sbpOps.hpp"
+
+using namespace std;
+
+/*
+ * Small sequential class for banded matrices and their LU factorization,
+ * for the narrow-banded systems that arise from 1D SBP operators.
+ *
+ * No pivoting is performed, so this is only appropriate for matrices
+ * that are (positive or negative) definite, such as the SBP-SAT operators
+ * with multiplyByH = 1, or diagonally dominant matrices such as I - dt*D2.
+ *
+ * Example usage:
+ *    BandedLU lu(N,bw); // N x N matrix with bw super- and sub-diagonals
+ *    lu.setValue(i,j,v); // or addValue
+ *    lu.factor();
+ *    lu.solve(rhs,x); // rhs and x may be the same array
+ */
+
+class BandedLU
+{
+public:
+  PetscInt            _N; // number of rows
+  PetscInt            _bw; // half bandwidth (number of super- or sub-diagonals)
+  vector<PetscScalar> _a; // row-major band storage: entry (i,j) stored at i*(2*bw+1) + bw + j-i
+  int                 _isFactored; // 0 = no, 1 = yes
+
+  BandedLU();
+  BandedLU(const PetscInt N,const PetscInt bw);
+
+  PetscErrorCode setSize(const PetscInt N,const PetscInt bw);
+  PetscErrorCode zeroEntries();
+
+  // compute the half bandwidth of a PETSc Mat (may be distributed)
+  static PetscErrorCode computeBandwidth(const Mat& A,PetscInt& bw);
+
+  // set from PETSc Mat (entries outside band are an error)
+  // the matrix is held on rank 0 only; storage on the other ranks is released
+  PetscErrorCode setFromMat(const Mat& A);
+
+  // copy the matrix from rank 0 to every rank, for callers that need it everywhere
+  PetscErrorCode bcast(MPI_Comm comm);
+
+  // in-place LU factorization, and solve using the factors
+  PetscErrorCode factor();
+  PetscErrorCode solve(const PetscScalar *rhs, PetscScalar *x) const;
+  PetscErrorCode solve(const Vec& rhs, Vec& x) const; // sequential Vecs
+
+  // out = A * in, only valid before factor() is called
+  PetscErrorCode mult(const PetscScalar *in, PetscScalar *out) const;
+
+  inline void setValue(const PetscInt i,const PetscInt j,const PetscScalar v)
+  {
+    assert(i >= 0 && i < _N && j >= 0 && j < _N && abs(j-i) <= _bw);
+    _a[i*(2*_bw+1) + _bw + j-i] = v;
+  };
+
+  inline void addValue(const PetscInt i,const PetscInt j,const PetscScalar v)
+  {
+    assert(i >= 0 && i < _N && j >= 0 && j < _N && abs(j-i) <= _bw);
+    _a[i*(2*_bw+1) + _bw + j-i] += v;
+  };
+
+  inline PetscScalar getValue(const PetscInt i,const PetscInt j) const
+  {
+    if (abs(j-i) > _bw) { return 0.0; }
+    return _a[i*(2*_bw+1) + _bw + j-i];
+  };
+};
+
+
+/*
+ * Shell preconditioner that applies the exact banded LU factorization of the
+ * preconditioning matrix, for 1D problems (Ny = 1 or Nz = 1). The matrix is
+ * gathered and factored on rank 0, so the solve carries no MUMPS overhead.
+ * The factorization is recomputed whenever the KSP sets up its preconditioner,
+ * and the context is freed when the PC is destroyed.
+ *
+ * Example usage, in place of a MUMPS LU or Cholesky PC:
+ *    KSPSetType(ksp,KSPPREONLY);
+ *    KSPGetPC(ksp,&pc);
+ *    BandedLUShell::setPCType(pc);
+ */
+
+class BandedLUShell
+{
+public:
+  BandedLU     _lu;
+  VecScatter   _scatter; // scatter from global Vec to rank 0
+  Vec          _seq; // full Vec on rank 0, empty elsewhere
+  PetscMPIInt  _rank;
+
+  BandedLUShell();
+  ~BandedLUShell();
+
+  static PetscErrorCode setPCType(PC& pc);
+
+  // PCSHELL callbacks
+  static PetscErrorCode setUp(PC pc);
+  static PetscErrorCode apply(PC pc,Vec x,Vec y);
+  static PetscErrorCode destroy(PC pc);
+};
+
+
+/*
+ * Banded representation of a 1D SBP operator as a function of its variable
+ * coefficient c. For the operators in this code A(c) is affine in c, so
+ *    A(c)_ij = A0_ij + sum_k W_ijk c_k,
+ * where for each row i only coefficient nodes k within a fixed radius of i
+ * contribute. W is found by probing the operator with indicator vectors of
+ * coefficient nodes that are far enough apart not to interact, and is checked
+ * against the operator for a random coefficient; the radius is doubled until
+ * the check passes.
+ *
+ * This allows A(c), and the derivative of A(c)*p with respect to c, to be formed
+ * in O(N) without rebuilding the SBP operators, e.g. for a Newton Jacobian.
+ * The operator is probed on all ranks, and the representation is held on rank 0.
+ *
+ * Example usage:
+ *    BandedCoeffOp op;
+ *    op.setFromSbp(sbp,coeff,isAffine); // changes sbp's coefficient, caller must restore it
+ *    op.assemble(c,A); // A(c) into band storage
+ *    op.addCoeffDerivative(p,rowScale,dc,J); // J += diag(rowScale) * d(A(c)*p)/dc * diag(dc)
+ */
+
+class BandedCoeffOp
+{
+public:
+  PetscInt            _N; // number of rows
+  PetscInt            _bw; // half bandwidth of A
+  PetscInt            _rc; // radius of coefficient dependence: W_ijk = 0 for |k-i| > rc
+  BandedLU            _A0; // A(0)
+  vector<PetscScalar> _W; // entry (i,j,k) stored at (i*(2*bw+1) + bw+j-i)*(2*rc+1) + rc+k-i
+
+  BandedCoeffOp();
+
+  // probe sbp, which must be a 1D operator; coeff is only used for its layout
+  PetscErrorCode setFromSbp(SbpOps *sbp,const Vec& coeff,PetscBool& isAffine);
+
+  // A(c) into A, which must have half bandwidth >= _bw
+  PetscErrorCode assemble(const PetscScalar *c,BandedLU& A) const;
+
+  // J_ik += rowScale_i * sum_j W_ijk p_j * dc_k, J must have half bandwidth >= _rc
+  PetscErrorCode addCoeffDerivative(const PetscScalar *p,const PetscScalar *rowScale,const PetscScalar *dc,BandedLU& J) const;
+
+  inline PetscScalar getW(const PetscInt i,const PetscInt j,const PetscInt k) const
+  {
+    return _W[(i*(2*_bw+1) + _bw + j-i)*(2*_rc+1) + _rc + k-i];
+  };
+};
+
+#endif
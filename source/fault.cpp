@@ -1065,7 +1065,7 @@ PetscErrorCode ComputeVel_qd::getResid(const PetscInt Jj,const PetscScalar vel,P
 Fault_fd::Fault_fd(Domain &D, VecScatter& scatter2fault, const int& faultTypeScale)
 : Fault(D, scatter2fault,faultTypeScale),
   _Phi(NULL), _an(NULL), _fricPen(NULL),
-  _u(NULL), _uPrev(NULL), _d2u(NULL),_alphay(NULL),
+  _u(NULL), _uPrev(NULL), _d2u(NULL),_alphay(NULL),_pmlDamping(NULL),
   _timeMode("None")
 {
   #if VERBOSE > 1
@@ -1101,6 +1101,7 @@ Fault_fd::~Fault_fd()
   VecDestroy(&_uPrev);
   VecDestroy(&_d2u);
   VecDestroy(&_alphay);
+  VecDestroy(&_pmlDamping);
 
   #if VERBOSE > 1
     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
@@ -1200,6 +1201,10 @@ PetscErrorCode Fault_fd::setFields() {
   PetscObjectSetName((PetscObject) _alphay, "alphay");
   VecSet(_alphay, 17.0/48.0 / (_N-1));
 
+  VecDuplicate(_tauP,&_pmlDamping);
+  PetscObjectSetName((PetscObject) _pmlDamping, "pmlDamping");
+  VecSet(_pmlDamping, 0.0);
+
   #if VERBOSE > 1
     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
   #endif
@@ -1463,7 +1468,7 @@ PetscErrorCode Fault_fd::d_dt(const PetscScalar time,const PetscScalar deltaT, m
 
   PetscInt       Ii,Istart,Iend;
   PetscScalar   *u, *uPrev, *slip, *slipVel; // changed in this loop
-  const PetscScalar  *rho, *sNEff, *a, *an, *Phi, *psi, *alphay; // constant in this loop
+  const PetscScalar  *rho, *sNEff, *a, *an, *Phi, *psi, *alphay, *pmlDamping; // constant in this loop
   ierr = VecGetOwnershipRange(_u,&Istart,&Iend); CHKERRQ(ierr);
   ierr = VecGetArray(_u, &u);
   ierr = VecGetArray(_uPrev, &uPrev);
@@ -1476,7 +1481,9 @@ PetscErrorCode Fault_fd::d_dt(const PetscScalar time,const PetscScalar deltaT, m
   ierr = VecGetArrayRead(_a, &a);
   ierr = VecGetArrayRead(_Phi, &Phi);
   ierr = VecGetArrayRead(_alphay, &alphay);
+  ierr = VecGetArrayRead(_pmlDamping, &pmlDamping);
 
+  // Phi and fricPen were divided by (1 + deltaT*pmlDamping) in setPhi
   PetscInt Jj = 0;
   for (Ii = Istart; Ii < Iend; Ii++) {
     if (slipVel[Jj] < 1e-14){
@@ -1485,9 +1492,10 @@ PetscErrorCode Fault_fd::d_dt(const PetscScalar time,const PetscScalar deltaT, m
     else {
       PetscScalar fric = strength_psi(sNEff[Jj], psi[Jj], slipVel[Jj], a[Jj], _v0);
       PetscScalar alpha = 1.0 / (rho[Jj] * alphay[Jj]) * fric / slipVel[Jj];
-      PetscScalar A = 1.0 + alpha * deltaT;
-      slipVel[Jj] = Phi[Jj] / (1. + _deltaT * alpha);
-      u[Jj] = (2.*u[Jj]  +  (an[Jj] * deltaT*deltaT / rho[Jj])  +  (_deltaT*alpha-1.)*uPrev[Jj]) / A;
+      PetscScalar B = 1.0 + pmlDamping[Jj] * deltaT;
+      PetscScalar A = B + alpha * deltaT;
+      slipVel[Jj] = Phi[Jj] * B / A;
+      u[Jj] = (2.*u[Jj]  +  (an[Jj] * deltaT*deltaT / rho[Jj])  +  (A - 2.)*uPrev[Jj]) / A;
     }
     Jj++;
   }
@@ -1503,6 +1511,7 @@ PetscErrorCode Fault_fd::d_dt(const PetscScalar time,const PetscScalar deltaT, m
   ierr = VecRestoreArrayRead(_a, &a);
   ierr = VecRestoreArrayRead(_Phi, &Phi);
   ierr = VecRestoreArrayRead(_alphay, &alphay);
+  ierr = VecRestoreArrayRead(_pmlDamping, &pmlDamping);
 
   // update state variable
   computeStateEvolution(varNext["psi"], var.find("psi")->second, varPrev.find("psi")->second);
@@ -1537,7 +1546,7 @@ PetscErrorCode Fault_fd::setPhi(const PetscScalar deltaT)
   ierr = VecGetOwnershipRange(_d2u,&Istart,&Iend);CHKERRQ(ierr);
 
   PetscScalar  *an, *Phi, *fricPen;
-  const PetscScalar *u, *uPrev, *d2u, *rho, *tau0, *alphay;
+  const PetscScalar *u, *uPrev, *d2u, *rho, *tau0, *alphay, *pmlDamping;
 
   ierr = VecGetArray(_an, &an);
   ierr = VecGetArray(_Phi, &Phi);
@@ -1548,12 +1557,18 @@ PetscErrorCode Fault_fd::setPhi(const PetscScalar deltaT)
   ierr = VecGetArrayRead(_rho, &rho);
   ierr = VecGetArrayRead(_tau0, &tau0);
   ierr = VecGetArrayRead(_alphay, &alphay);
+  ierr = VecGetArrayRead(_pmlDamping, &pmlDamping);
 
+  // inside a perfectly matched layer the damping term rho*2*pmlDamping*u_t
+  // turns slipVel + fricPen*strength = Phi into
+  // (1 + deltaT*pmlDamping)*slipVel + fricPen*strength = Phi, so Phi and
+  // fricPen are divided by (1 + deltaT*pmlDamping)
   PetscInt Jj = 0;
   for (Ii = Istart; Ii < Iend; Ii++){
+    PetscScalar B = 1.0 + deltaT * pmlDamping[Jj];
     an[Jj] = d2u[Jj] + tau0[Jj] / alphay[Jj];
-    Phi[Jj] = 2.0 / deltaT * (u[Jj] - uPrev[Jj]) + deltaT * an[Jj] / rho[Jj];
-    fricPen[Jj] = deltaT / alphay[Jj] / rho[Jj];
+    Phi[Jj] = (2.0 / deltaT * (u[Jj] - uPrev[Jj]) + deltaT * an[Jj] / rho[Jj]) / B;
+    fricPen[Jj] = deltaT / alphay[Jj] / rho[Jj] / B;
     Jj++;
   }
 
@@ -1566,6 +1581,7 @@ PetscErrorCode Fault_fd::setPhi(const PetscScalar deltaT)
   ierr = VecGetArrayRead(_rho, &rho);
   ierr = VecGetArrayRead(_tau0, &tau0);
   ierr = VecGetArrayRead(_alphay, &alphay);
+  ierr = VecRestoreArrayRead(_pmlDamping, &pmlDamping);
 
   #if VERBOSE > 1
     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
@@ -173,6 +173,7 @@ public:
   Vec            _u,_uPrev,_d2u; // d2u = (Dyy+Dzz)*u evaluated on the fault
   PetscScalar    _deltaT;
   Vec            _alphay;
+  Vec            _pmlDamping; // damping of a perfectly matched layer reaching the fault (0 outside it)
   Vec            _tau0; // dU0/dy (stress at end of qd period)
 
   PetscScalar    _tCenterTau, _tStdTau, _zCenterTau, _zStdTau, _ampTau;
@@ -26,6 +26,319 @@ void destroyVector(map<string,Vec>& vec)
 }
 
 
+// Each Vec in a packed map holds a reference to the contiguous Vec, composed
+// under this name, so the contiguous storage lives as long as any of its views.
+static const char* packedVecName = "packedVec";
+
+// after writing to the contiguous Vec, mark the views as changed so that
+// PETSc does not reuse norms cached on them
+static PetscErrorCode increaseViewStates(const map<string,Vec>& var)
+{
+  PetscErrorCode ierr = 0;
+  for (map<string,Vec>::const_iterator it = var.begin(); it!=var.end(); it++ ) {
+    ierr = PetscObjectStateIncrease((PetscObject) it->second);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+// contiguous Vec with local size equal to the sum of the local sizes in var
+static PetscErrorCode createContiguousVec(const map<string,Vec>& var, Vec& packed)
+{
+  PetscErrorCode ierr = 0;
+  MPI_Comm comm;
+  PetscInt n = 0, nTot = 0;
+  ierr = PetscObjectGetComm((PetscObject) var.begin()->second,&comm);CHKERRQ(ierr);
+  for (map<string,Vec>::const_iterator it = var.begin(); it!=var.end(); it++ ) {
+    ierr = VecGetLocalSize(it->second,&n);CHKERRQ(ierr);
+    nTot += n;
+  }
+  ierr = VecCreateMPI(comm,nTot,PETSC_DETERMINE,&packed);CHKERRQ(ierr);
+  return ierr;
+}
+
+PetscErrorCode createPackedMap(map<string,Vec>& out, const map<string,Vec>& layout)
+{
+  PetscErrorCode ierr = 0;
+  if (layout.size() == 0) { return ierr; }
+
+  Vec packed;
+  ierr = createContiguousVec(layout,packed);CHKERRQ(ierr);
+  ierr = VecSet(packed,0.0);CHKERRQ(ierr);
+
+  MPI_Comm comm;
+  ierr = PetscObjectGetComm((PetscObject) packed,&comm);CHKERRQ(ierr);
+  PetscScalar *arr;
+  ierr = VecGetArray(packed,&arr);CHKERRQ(ierr);
+  PetscInt offset = 0;
+  for (map<string,Vec>::const_iterator it = layout.begin(); it!=layout.end(); it++ ) {
+    PetscInt n = 0, N = 0, bs = 1;
+    ierr = VecGetLocalSize(it->second,&n);CHKERRQ(ierr);
+    ierr = VecGetSize(it->second,&N);CHKERRQ(ierr);
+    ierr = VecGetBlockSize(it->second,&bs);CHKERRQ(ierr);
+
+    Vec view;
+    ierr = VecCreateMPIWithArray(comm,bs,n,N,arr+offset,&view);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject) view,packedVecName,(PetscObject) packed);CHKERRQ(ierr);
+    out[it->first] = view;
+    offset += n;
+  }
+  ierr = VecRestoreArray(packed,&arr);CHKERRQ(ierr);
+
+  // the views now hold the only references to packed
+  ierr = VecDestroy(&packed);CHKERRQ(ierr);
+  return ierr;
+}
+
+PetscErrorCode placePackedMap(map<string,Vec>& var)
+{
+  PetscErrorCode ierr = 0;
+  if (var.size() == 0) { return ierr; }
+
+  Vec packed;
+  ierr = createContiguousVec(var,packed);CHKERRQ(ierr);
+
+  PetscScalar *arr;
+  ierr = VecGetArray(packed,&arr);CHKERRQ(ierr);
+  PetscInt offset = 0;
+  for (map<string,Vec>::iterator it = var.begin(); it!=var.end(); it++ ) {
+    PetscInt n = 0;
+    const PetscScalar *varArr;
+    ierr = VecGetLocalSize(it->second,&n);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(it->second,&varArr);CHKERRQ(ierr);
+    ierr = PetscMemcpy(arr+offset,varArr,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(it->second,&varArr);CHKERRQ(ierr);
+
+    ierr = VecPlaceArray(it->second,arr+offset);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject) it->second,packedVecName,(PetscObject) packed);CHKERRQ(ierr);
+    offset += n;
+  }
+  ierr = VecRestoreArray(packed,&arr);CHKERRQ(ierr);
+  ierr = VecDestroy(&packed);CHKERRQ(ierr);
+  return ierr;
+}
+
+PetscErrorCode resetPackedMap(map<string,Vec>& var)
+{
+  PetscErrorCode ierr = 0;
+  Vec packed = NULL;
+  ierr = getPackedVec(var,packed);CHKERRQ(ierr);
+  if (packed == NULL) { return ierr; }
+
+  const PetscScalar *arr;
+  ierr = VecGetArrayRead(packed,&arr);CHKERRQ(ierr);
+  PetscInt offset = 0;
+  for (map<string,Vec>::iterator it = var.begin(); it!=var.end(); it++ ) {
+    PetscInt n = 0;
+    PetscScalar *varArr;
+    ierr = VecGetLocalSize(it->second,&n);CHKERRQ(ierr);
+    ierr = VecResetArray(it->second);CHKERRQ(ierr);
+    ierr = VecGetArray(it->second,&varArr);CHKERRQ(ierr);
+    ierr = PetscMemcpy(varArr,arr+offset,n*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = VecRestoreArray(it->second,&varArr);CHKERRQ(ierr);
+    offset += n;
+  }
+  ierr = VecRestoreArrayRead(packed,&arr);CHKERRQ(ierr);
+
+  // drop the references to packed last, since this frees it
+  for (map<string,Vec>::iterator it = var.begin(); it!=var.end(); it++ ) {
+    ierr = PetscObjectCompose((PetscObject) it->second,packedVecName,NULL);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+PetscErrorCode getPackedVec(const map<string,Vec>& var, Vec& packed)
+{
+  PetscErrorCode ierr = 0;
+  packed = NULL;
+  for (map<string,Vec>::const_iterator it = var.begin(); it!=var.end(); it++ ) {
+    PetscObject obj = NULL;
+    ierr = PetscObjectQuery((PetscObject) it->second,packedVecName,&obj);CHKERRQ(ierr);
+    if (obj == NULL || (it != var.begin() && (Vec) obj != packed)) { packed = NULL; return ierr; }
+    packed = (Vec) obj;
+  }
+  return ierr;
+}
+
+PetscErrorCode mapSet(map<string,Vec>& x, const PetscScalar alpha)
+{
+  PetscErrorCode ierr = 0;
+  Vec xP;
+  ierr = getPackedVec(x,xP);CHKERRQ(ierr);
+  if (xP != NULL) {
+    ierr = VecSet(xP,alpha);CHKERRQ(ierr);
+    ierr = increaseViewStates(x);CHKERRQ(ierr);
+    return ierr;
+  }
+  for (map<string,Vec>::iterator it = x.begin(); it!=x.end(); it++ ) {
+    ierr = VecSet(it->second,alpha);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+PetscErrorCode mapCopy(const map<string,Vec>& x, map<string,Vec>& y)
+{
+  PetscErrorCode ierr = 0;
+  Vec xP,yP;
+  ierr = getPackedVec(x,xP);CHKERRQ(ierr);
+  ierr = getPackedVec(y,yP);CHKERRQ(ierr);
+  if (xP != NULL && yP != NULL) {
+    ierr = VecCopy(xP,yP);CHKERRQ(ierr);
+    ierr = increaseViewStates(y);CHKERRQ(ierr);
+    return ierr;
+  }
+  for (map<string,Vec>::iterator it = y.begin(); it!=y.end(); it++ ) {
+    ierr = VecCopy(x.find(it->first)->second,it->second);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+PetscErrorCode mapAXPY(map<string,Vec>& y, const PetscScalar alpha, const map<string,Vec>& x)
+{
+  PetscErrorCode ierr = 0;
+  Vec xP,yP;
+  ierr = getPackedVec(x,xP);CHKERRQ(ierr);
+  ierr = getPackedVec(y,yP);CHKERRQ(ierr);
+  if (xP != NULL && yP != NULL) {
+    ierr = VecAXPY(yP,alpha,xP);CHKERRQ(ierr);
+    ierr = increaseViewStates(y);CHKERRQ(ierr);
+    return ierr;
+  }
+  for (map<string,Vec>::iterator it = y.begin(); it!=y.end(); it++ ) {
+    ierr = VecAXPY(it->second,alpha,x.find(it->first)->second);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+PetscErrorCode mapAXPBY(map<string,Vec>& y, const PetscScalar alpha, const PetscScalar beta, const map<string,Vec>& x)
+{
+  PetscErrorCode ierr = 0;
+  Vec xP,yP;
+  ierr = getPackedVec(x,xP);CHKERRQ(ierr);
+  ierr = getPackedVec(y,yP);CHKERRQ(ierr);
+  if (xP != NULL && yP != NULL) {
+    ierr = VecAXPBY(yP,alpha,beta,xP);CHKERRQ(ierr);
+    ierr = increaseViewStates(y);CHKERRQ(ierr);
+    return ierr;
+  }
+  for (map<string,Vec>::iterator it = y.begin(); it!=y.end(); it++ ) {
+    ierr = VecAXPBY(it->second,alpha,beta,x.find(it->first)->second);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+PetscErrorCode mapWAXPY(map<string,Vec>& w, const PetscScalar alpha, const map<string,Vec>& x, const map<string,Vec>& y)
+{
+  PetscErrorCode ierr = 0;
+  Vec wP,xP,yP;
+  ierr = getPackedVec(w,wP);CHKERRQ(ierr);
+  ierr = getPackedVec(x,xP);CHKERRQ(ierr);
+  ierr = getPackedVec(y,yP);CHKERRQ(ierr);
+  if (wP != NULL && xP != NULL && yP != NULL) {
+    ierr = VecWAXPY(wP,alpha,xP,yP);CHKERRQ(ierr);
+    ierr = increaseViewStates(w);CHKERRQ(ierr);
+    return ierr;
+  }
+  for (map<string,Vec>::iterator it = w.begin(); it!=w.end(); it++ ) {
+    ierr = VecWAXPY(it->second,alpha,x.find(it->first)->second,y.find(it->first)->second);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+PetscErrorCode mapWMAXPY(map<string,Vec>& y, const map<string,Vec>& x, const vector<PetscScalar>& alpha, const vector< map<string,Vec>* >& f)
+{
+  PetscErrorCode ierr = 0;
+  assert(alpha.size() == f.size());
+  const PetscInt nv = f.size();
+  vector<Vec> fVecs(nv);
+
+  Vec xP,yP;
+  bool isPacked = 1;
+  ierr = getPackedVec(x,xP);CHKERRQ(ierr);
+  ierr = getPackedVec(y,yP);CHKERRQ(ierr);
+  isPacked = (xP != NULL && yP != NULL);
+  for (PetscInt i = 0; i < nv && isPacked; i++) {
+    ierr = getPackedVec(*f[i],fVecs[i]);CHKERRQ(ierr);
+    isPacked = (fVecs[i] != NULL);
+  }
+  if (isPacked) {
+    ierr = VecCopy(xP,yP);CHKERRQ(ierr);
+    if (nv > 0) { ierr = VecMAXPY(yP,nv,&alpha[0],&fVecs[0]);CHKERRQ(ierr); }
+    ierr = increaseViewStates(y);CHKERRQ(ierr);
+    return ierr;
+  }
+
+  for (map<string,Vec>::iterator it = y.begin(); it!=y.end(); it++ ) {
+    ierr = VecCopy(x.find(it->first)->second,it->second);CHKERRQ(ierr);
+    for (PetscInt i = 0; i < nv; i++) { fVecs[i] = f[i]->find(it->first)->second; }
+    if (nv > 0) { ierr = VecMAXPY(it->second,nv,&alpha[0],&fVecs[0]);CHKERRQ(ierr); }
+  }
+  return ierr;
+}
+
+
+// Error norms for adaptive time stepping. The contribution of every variable
+// is accumulated in one pass over the local arrays, and the per-variable sums
+// (or maxima) are combined with one MPI_Allreduce, rather than a VecNorm
+// (and a temporary Vec) per variable.
+PetscErrorCode mapErrorNorm(PetscScalar& totErr, const map<string,Vec>& x, const map<string,Vec>* y, const map<string,Vec>& ref, const vector<string>& errInds, const vector<double>& scale, const string normType)
+{
+  PetscErrorCode ierr = 0;
+  totErr = 0;
+  const size_t nv = errInds.size();
+  assert(scale.size() == nv);
+  if (nv == 0) { return ierr; }
+
+  const bool isAbs = normType.compare("L2_absolute")==0;
+  const bool isRel = normType.compare("L2_relative")==0;
+  const bool isMax = normType.compare("max_relative")==0;
+  if (!isAbs && !isRel && !isMax) { return ierr; }
+
+  // L2 norms need sum(e^2) (and sum(ref^2)), max_relative needs max(|e|/ref)
+  vector<PetscScalar> loc(2*nv,0.0), glob(2*nv,0.0);
+  if (isMax) { for (size_t i = 0; i < nv; i++) { loc[i] = -PETSC_MAX_REAL; } }
+  vector<PetscInt> N(nv,0);
+
+  MPI_Comm comm;
+  ierr = PetscObjectGetComm((PetscObject) x.find(errInds[0])->second,&comm);CHKERRQ(ierr);
+
+  for (size_t i = 0; i < nv; i++) {
+    const Vec xV = x.find(errInds[i])->second;
+    const Vec rV = ref.find(errInds[i])->second;
+    PetscInt n = 0;
+    ierr = VecGetSize(xV,&N[i]);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(xV,&n);CHKERRQ(ierr);
+
+    const PetscScalar *xA,*yA = NULL,*rA;
+    ierr = VecGetArrayRead(xV,&xA);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(rV,&rA);CHKERRQ(ierr);
+    if (y != NULL) { ierr = VecGetArrayRead(y->find(errInds[i])->second,&yA);CHKERRQ(ierr); }
+
+    for (PetscInt j = 0; j < n; j++) {
+      const PetscScalar e = (yA == NULL) ? xA[j] : xA[j] - yA[j];
+      if (isMax) { loc[i] = max(loc[i],abs(e) / rA[j]); }
+      else {
+        loc[i] += e * e;
+        if (isRel) { loc[nv+i] += rA[j] * rA[j]; }
+      }
+    }
+
+    ierr = VecRestoreArrayRead(xV,&xA);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(rV,&rA);CHKERRQ(ierr);
+    if (y != NULL) { ierr = VecRestoreArrayRead(y->find(errInds[i])->second,&yA);CHKERRQ(ierr); }
+  }
+
+  if (isMax) { ierr = MPI_Allreduce(&loc[0],&glob[0],nv,MPIU_SCALAR,MPI_MAX,comm);CHKERRQ(ierr); }
+  else { ierr = MPI_Allreduce(&loc[0],&glob[0],(isRel ? 2 : 1)*nv,MPIU_SCALAR,MPI_SUM,comm);CHKERRQ(ierr); }
+
+  for (size_t i = 0; i < nv; i++) {
+    if (isAbs) { totErr += sqrt(glob[i]) / (sqrt(N[i]) * scale[i]); }
+    if (isRel) { totErr += sqrt(glob[i]) / (sqrt(glob[nv+i]) * scale[i]); }
+    if (isMax) { assert(!isinf(glob[i])); totErr += glob[i] / scale[i]; }
+  }
+  return ierr;
+}
+
+
 // Print out a vector with 15 significant figures.
 void printVec(Vec vec)
 {
@@ -9,6 +9,8 @@
 #include <assert.h>
 #include <vector>
 #include <map>
+#include <cmath>
+#include <algorithm>
 #include <iostream>
 
 /*
@@ -33,6 +35,35 @@ void destroyVector(vector<Vec>& vec);
 // clean up a C++ std library map of PETSc Vecs
 void destroyVector(map<string,Vec>& vec);
 
+// Packed maps of PETSc Vecs: every Vec in the map is a view into one
+// contiguous Vec (ordered as the map is), so operations on the whole map
+// can be done with a single call on the contiguous Vec.
+// create a packed map with the same keys and layout as the map layout
+PetscErrorCode createPackedMap(map<string,Vec>& out, const map<string,Vec>& layout);
+// temporarily place contiguous storage under the existing Vecs in var,
+// copying their values in, and return it to them with resetPackedMap
+PetscErrorCode placePackedMap(map<string,Vec>& var);
+PetscErrorCode resetPackedMap(map<string,Vec>& var);
+// get the contiguous Vec underlying a packed map, or NULL if var is not packed
+PetscErrorCode getPackedVec(const map<string,Vec>& var, Vec& packed);
+
+// vector operations over all Vecs in maps with the same keys, using a
+// single operation on the contiguous Vecs if all maps are packed
+PetscErrorCode mapSet(map<string,Vec>& x, const PetscScalar alpha);
+PetscErrorCode mapCopy(const map<string,Vec>& x, map<string,Vec>& y); // y = x
+PetscErrorCode mapAXPY(map<string,Vec>& y, const PetscScalar alpha, const map<string,Vec>& x); // y = alpha*x + y
+PetscErrorCode mapAXPBY(map<string,Vec>& y, const PetscScalar alpha, const PetscScalar beta, const map<string,Vec>& x); // y = alpha*x + beta*y
+PetscErrorCode mapWAXPY(map<string,Vec>& w, const PetscScalar alpha, const map<string,Vec>& x, const map<string,Vec>& y); // w = alpha*x + y
+// y = x + sum_i alpha[i]*f[i]
+PetscErrorCode mapWMAXPY(map<string,Vec>& y, const map<string,Vec>& x, const vector<PetscScalar>& alpha, const vector< map<string,Vec>* >& f);
+
+// scaled error norm of e = x - y (or e = x if y is NULL) over the keys in
+// errInds, for adaptive time step control, using a single global reduction:
+//   L2_absolute:  sum_i ||e_i||_2 / (sqrt(N_i) * scale_i)
+//   L2_relative:  sum_i ||e_i||_2 / (||ref_i||_2 * scale_i)
+//   max_relative: sum_i max(|e_i| / ref_i) / scale_i
+PetscErrorCode mapErrorNorm(PetscScalar& totErr, const map<string,Vec>& x, const map<string,Vec>* y, const map<string,Vec>& ref, const vector<string>& errInds, const vector<double>& scale, const string normType);
+
 // Print out a vector with 15 significant figures.
 void printVec(Vec vec);
 
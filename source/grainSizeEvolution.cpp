@@ -8,9 +8,12 @@
 
 GrainSizeEvolution::GrainSizeEvolution(Domain& D)
 : _D(&D),_file(D._file),_delim(D._delim),_inputDir(D._inputDir),_outputDir(D._outputDir),_timeIntegrationType("explicit"),
+  _beSolver("logNewton"),_beRootTol(1e-13),_beMaxNumIts(1e4),
+  _beSolves(0),_beIts(0),_beBisections(0),_beFailures(0),_beMaxIts(0),
   _order(D._order),_Ny(D._Ny),_Nz(D._Nz),
   _Ly(D._Ly),_Lz(D._Lz),_dy(D._dq),_dz(D._dr),_y(&D._y),_z(&D._z),
-  _A(NULL),_QR(NULL),_p(NULL),_f(NULL),_gamma(NULL),_d(NULL),_d_t(NULL)
+  _A(NULL),_QR(NULL),_p(NULL),_f(NULL),_gamma(NULL),_d(NULL),_d_t(NULL),
+  _nonlinearSolveTime(0)
 {
   #if VERBOSE > 1
     std::string funcName = "GrainSizeEvolution::GrainSizeEvolution";
@@ -104,6 +107,9 @@ PetscErrorCode GrainSizeEvolution::loadSettings(const char *file)
     else if (var.compare("grainSizeEv_grainSizeDepths")==0) { loadVectorFromInputFile(rhsFull,_dDepths); }
 
     if (var.compare("grainSizeEv_timeIntegrationType")==0) { _timeIntegrationType = rhs.c_str(); }
+    else if (var.compare("grainSizeEv_beSolver")==0) { _beSolver = rhs.c_str(); }
+    else if (var.compare("grainSizeEv_beRootTol")==0) { _beRootTol = atof( rhs.c_str() ); }
+    else if (var.compare("grainSizeEv_beMaxNumIts")==0) { _beMaxNumIts = (int) atof( rhs.c_str() ); }
 
   }
 
@@ -147,6 +153,10 @@ PetscErrorCode GrainSizeEvolution::checkInput()
     assert(_timeIntegrationType.compare("explicit")==0 ||
       _timeIntegrationType.compare("implicit")==0 );
 
+    assert(_beSolver.compare("logNewton")==0 || _beSolver.compare("bracketedNewton")==0);
+    assert(_beRootTol > 0);
+    assert(_beMaxNumIts > 0);
+
 
   #if VERBOSE > 1
     ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
@@ -368,11 +378,20 @@ PetscErrorCode GrainSizeEvolution::be(Vec& grainSizeNew,const Vec& grainSizePrev
   ierr = VecGetOwnershipRange(_d,&Istart,&Iend);CHKERRQ(ierr);
   PetscInt N = Iend - Istart;
 
-  PetscScalar rootTol = 1e-13;
-  PetscInt maxNumIts = 1e4;
   PetscInt rootIts = 0;
   AustinEvans2007 temp(N, dt, dprev, A,QR,p,T, f,s,dgdev,gamma,_c);
-  ierr = temp.computeGrainSize(dNew, rootTol, rootIts, maxNumIts); CHKERRQ(ierr);
+  if (_beSolver.compare("logNewton")==0) {
+    PetscInt maxIts = 0, bisections = 0, failures = 0;
+    ierr = temp.computeGrainSize_logNewton(dNew, _beRootTol, _beMaxNumIts, rootIts, maxIts, bisections, failures); CHKERRQ(ierr);
+    _beMaxIts = max(_beMaxIts,maxIts);
+    _beBisections += bisections;
+    _beFailures += failures;
+  }
+  else {
+    ierr = temp.computeGrainSize(dNew, _beRootTol, rootIts, _beMaxNumIts); CHKERRQ(ierr);
+  }
+  _beIts += rootIts;
+  _beSolves += N;
 
   VecRestoreArrayRead(_A,&A);
   VecRestoreArrayRead(_QR,&QR);
@@ -485,6 +504,20 @@ PetscErrorCode GrainSizeEvolution::view(const double totRunTime)
   ierr = PetscPrintf(PETSC_COMM_WORLD,"Grain Size Evolution Runtime Summary:\n");CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent solving nonlinear system: (s): %g\n",_nonlinearSolveTime);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   %% time spent solving linear system: %g\n",_nonlinearSolveTime/totRunTime*100.);CHKERRQ(ierr);
+  if (_timeIntegrationType.compare("implicit")==0 && _beSolver.compare("logNewton")==0) {
+    PetscInt64 solves = 0, its = 0, bisections = 0, failures = 0;
+    PetscInt maxIts = 0;
+    MPI_Allreduce(&_beSolves,&solves,1,MPIU_INT64,MPI_SUM,PETSC_COMM_WORLD);
+    MPI_Allreduce(&_beIts,&its,1,MPIU_INT64,MPI_SUM,PETSC_COMM_WORLD);
+    MPI_Allreduce(&_beMaxIts,&maxIts,1,MPIU_INT,MPI_MAX,PETSC_COMM_WORLD);
+    MPI_Allreduce(&_beBisections,&bisections,1,MPIU_INT64,MPI_SUM,PETSC_COMM_WORLD);
+    MPI_Allreduce(&_beFailures,&failures,1,MPIU_INT64,MPI_SUM,PETSC_COMM_WORLD);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of pointwise grain size solves: %lld\n",(long long) solves);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   mean Newton iterations per solve: %g\n",solves > 0 ? (double) its / solves : 0.);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   max Newton iterations in one solve: %i\n",maxIts);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of bisection steps: %lld\n",(long long) bisections);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of solves that did not converge: %lld\n",(long long) failures);CHKERRQ(ierr);
+  }
 
   ierr = PetscPrintf(PETSC_COMM_WORLD,"\n");CHKERRQ(ierr);
   return ierr;
@@ -591,6 +624,90 @@ PetscErrorCode AustinEvans2007::computeGrainSize(PetscScalar* grainSize, const P
   return ierr;
 }
 
+// Backward Euler for dd/dt = Ag*d^(1-p) - Ar*d^2, solved in y = log(d/dprev), in which
+// the residual divided by d,
+//    G(y) = 1 - exp(-y) - alpha*exp(-p*y) + beta*exp(y),
+//    alpha = dt*Ag/dprev^p, beta = dt*Ar*dprev,
+// is monotonically increasing. The root lies between 0 (d = dprev) and the steady-state
+// (piezometric) grain size y_ss = log(alpha/beta)/(1+p), which bracket it. The initial
+// guess is the secant between them, and Newton steps leaving the bracket are replaced
+// by bisection.
+PetscErrorCode AustinEvans2007::computeGrainSize_logNewton(PetscScalar* grainSize, const PetscScalar rootTol, const PetscInt maxNumIts,
+  PetscInt& totIts, PetscInt& maxIts, PetscInt& numBisections, PetscInt& numFailures)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    std::string funcName = "AustinEvans2007::computeGrainSize_logNewton";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  // coefficients for all points
+  std::vector<PetscScalar> alpha(_N), beta(_N);
+  for (PetscInt Jj = 0; Jj < _N; Jj++) {
+    const PetscScalar Ag = _A[Jj]*exp(-_QR[Jj]/_T[Jj]) / _p[Jj];
+    const PetscScalar Ar = _f[Jj] / (_gamma[Jj] * _c) * (_sdev[Jj]*_dgdev[Jj]);
+    alpha[Jj] = _deltaT * Ag * exp(-_p[Jj]*log(_dprev[Jj]));
+    beta[Jj] = _deltaT * Ar * _dprev[Jj];
+  }
+
+  for (PetscInt Jj = 0; Jj < _N; Jj++) {
+    const PetscScalar a = alpha[Jj], b = beta[Jj], p = _p[Jj];
+
+    // bracket [lo,hi] with G(lo) <= 0 <= G(hi)
+    PetscScalar lo = 0, hi = 0, Glo = b - a, Ghi = b - a;
+    if (Glo == 0) { grainSize[Jj] = _dprev[Jj]; continue; }
+    PetscScalar yss = 0;
+    if (b > 0 && a > 0) { yss = log(a/b) / (1.0 + p); }
+    if (Glo < 0) { // grain growth
+      hi = (b > 0) ? yss : 1.0;
+      Ghi = 1.0 - exp(-hi) - a*exp(-p*hi) + b*exp(hi);
+      while (Ghi < 0) { // only without grain size reduction
+        lo = hi; Glo = Ghi;
+        hi *= 2.0;
+        Ghi = 1.0 - exp(-hi) - a*exp(-p*hi) + b*exp(hi);
+      }
+    }
+    else { // grain size reduction
+      lo = (a > 0) ? yss : -1.0;
+      Glo = 1.0 - exp(-lo) - a*exp(-p*lo) + b*exp(lo);
+      while (Glo > 0) { // only without grain growth
+        hi = lo; Ghi = Glo;
+        lo *= 2.0;
+        Glo = 1.0 - exp(-lo) - a*exp(-p*lo) + b*exp(lo);
+      }
+    }
+
+    // initial guess: secant between ends of bracket
+    PetscScalar y = (Ghi > Glo) ? lo - Glo * (hi - lo) / (Ghi - Glo) : 0.5*(lo + hi);
+    PetscInt its = 0;
+    bool converged = 0;
+    while (its < maxNumIts && !converged) {
+      const PetscScalar em = exp(-y), ep = exp(y), eg = a*exp(-p*y);
+      const PetscScalar G = 1.0 - em - eg + b*ep;
+      const PetscScalar dG = em + p*eg + b*ep;
+      if (G < 0) { lo = y; } else { hi = y; }
+
+      PetscScalar yNew = y - G / dG;
+      if (!(yNew > lo && yNew < hi)) { yNew = 0.5*(lo + hi); numBisections++; }
+      converged = (abs(yNew - y) <= rootTol * max(1.0,abs(y))) || G == 0;
+      y = yNew;
+      its++;
+    }
+    if (!converged) { numFailures++; }
+
+    totIts += its;
+    maxIts = max(maxIts,its);
+    grainSize[Jj] = _dprev[Jj] * exp(y);
+    assert(!isnan(grainSize[Jj]));
+    assert(!isinf(grainSize[Jj]));
+  }
+
+  #if VERBOSE > 1
+     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
 // function that matches root finder template
 PetscErrorCode AustinEvans2007::getResid(const PetscInt Jj,const PetscScalar dnew,PetscScalar* out)
 {
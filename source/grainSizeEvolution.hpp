@@ -34,6 +34,13 @@ class GrainSizeEvolution
     std::string          _outputDir;  // output data
     std::string          _timeIntegrationType;  // explicit or implicit time stepping
 
+    // nonlinear solve for implicit time stepping
+    std::string          _beSolver; // "logNewton" (default) or "bracketedNewton"
+    PetscScalar          _beRootTol;
+    PetscInt             _beMaxNumIts;
+    PetscInt64           _beSolves,_beIts,_beBisections,_beFailures; // per processor, totals over the run
+    PetscInt             _beMaxIts;
+
     const PetscInt       _order,_Ny,_Nz;
     PetscScalar          _Ly,_Lz,_dy,_dz;
     Vec                 *_y,*_z;
@@ -115,6 +122,10 @@ struct AustinEvans2007 : public RootFinderContext
   // command to perform root-finding process, once contextual variables have been set
   PetscErrorCode computeGrainSize(PetscScalar* grainSize, const PetscScalar rootTol, PetscInt& rootIts, const PetscInt maxNumIts);
 
+  // Newton's method in log(grain size), for all points at once, without the RootFinder
+  PetscErrorCode computeGrainSize_logNewton(PetscScalar* grainSize, const PetscScalar rootTol, const PetscInt maxNumIts,
+    PetscInt& totIts, PetscInt& maxIts, PetscInt& numBisections, PetscInt& numFailures);
+
   // function that matches root finder template
   PetscErrorCode getResid(const PetscInt Jj,const PetscScalar dnew,PetscScalar* out);
   PetscErrorCode getResid(const PetscInt Jj,const PetscScalar dnew,PetscScalar *out,PetscScalar *J);
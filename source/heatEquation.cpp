@@ -16,6 +16,13 @@ HeatEquation::HeatEquation(Domain& D)
   _linSolver("CG"),_kspTol(1e-11),
   _kspSS(NULL),_kspTrans(NULL),_pc(NULL),
   _I(NULL),_rcInv(NULL),_B(NULL),_pcMat(NULL),_D2ath(NULL),
+  _dtBuckets("no"),_dtBucketMin(1e-3),_dtBucketRatio(2.0),_dtBucketCacheSize(4),
+  _dtDeficit(0),_dtBucketUseCount(0),_dtBucketSetupCount(0),
+  _activeRegion("no"),_activeRegionTol(1e-3),_activeRegionBuffer(10),_NyActive(0),
+  _sbpActive(NULL),_scatterActive(NULL),_scatterActiveEdge(NULL),_kspActive(NULL),_pcActive(NULL),
+  _IActive(NULL),_rcInvActive(NULL),_D2athActive(NULL),_BActive(NULL),
+  _kActive(NULL),_rhoActive(NULL),_cActive(NULL),_yActive(NULL),_zActive(NULL),_dTActive(NULL),_QActive(NULL),
+  _bcRActive(NULL),_bcTActive(NULL),_bcBActive(NULL),_activeRegionSetupCount(0),
   _MapV(NULL),_Gw(NULL),_w(NULL),
   _linSolveTime(0),_factorTime(0),_beTime(0),_writeTime(0),_miscTime(0),
   _linSolveCount(0),_ckpt(D._ckpt),_ckptNumber(D._ckptNumber),
@@ -35,6 +42,7 @@ HeatEquation::HeatEquation(Domain& D)
   setFields(); // sets material parameters
 
   loadFieldsFromFiles();
+  if (_ckpt > 0 && _ckptNumber > 0) { loadCheckpoint(); }
   if (_loadICs == 0 && _isMMS == 0 && _ckptNumber == 0) { computeInitialSteadyStateTemp(); }
   if (_heatEquationType.compare("transient")==0 ) { setUpTransientProblem(); }
   else if (_heatEquationType.compare("steadyState")==0 ) { setUpSteadyStateProblem(); }
@@ -48,6 +56,8 @@ HeatEquation::~HeatEquation()
 {
   KSPDestroy(&_kspSS);
   KSPDestroy(&_kspTrans);
+  destroyDtBuckets();
+  destroyActiveRegion();
   MatDestroy(&_B);
   MatDestroy(&_rcInv);
   MatDestroy(&_I);
@@ -173,6 +183,13 @@ PetscErrorCode HeatEquation::loadSettings(const char *file)
     // linear solver settings
     else if (var.compare("linSolver_heateq")==0) { _linSolver = rhs.c_str(); }
     else if (var.compare("kspTol_heateq")==0) { _kspTol = atof( rhs.c_str() ); }
+    else if (var.compare("dtBuckets_heateq")==0) { _dtBuckets = rhs.c_str(); }
+    else if (var.compare("dtBucketMin_heateq")==0) { _dtBucketMin = atof( rhs.c_str() ); }
+    else if (var.compare("dtBucketRatio_heateq")==0) { _dtBucketRatio = atof( rhs.c_str() ); }
+    else if (var.compare("dtBucketCacheSize_heateq")==0) { _dtBucketCacheSize = atoi( rhs.c_str() ); }
+    else if (var.compare("activeRegion_heateq")==0) { _activeRegion = rhs.c_str(); }
+    else if (var.compare("activeRegionTol_heateq")==0) { _activeRegionTol = atof( rhs.c_str() ); }
+    else if (var.compare("activeRegionBuffer_heateq")==0) { _activeRegionBuffer = atoi( rhs.c_str() ); }
 
     // if values are set by vector
     else if (var.compare("rhoVals")==0) { loadVectorFromInputFile(rhsFull,_rhoVals); }
@@ -378,6 +395,22 @@ PetscErrorCode HeatEquation::checkInput()
   assert(_heatEquationType.compare("transient")==0 ||
       _heatEquationType.compare("steadyState")==0 );
 
+  assert(_dtBuckets.compare("yes")==0 || _dtBuckets.compare("no")==0);
+  assert(_dtBucketMin > 0);
+  assert(_dtBucketRatio > 1);
+  assert(_dtBucketCacheSize >= 1);
+
+  assert(_activeRegion.compare("yes")==0 || _activeRegion.compare("no")==0);
+  assert(_activeRegionTol > 0);
+  assert(_activeRegionBuffer >= 1);
+  if (_activeRegion.compare("yes")==0) {
+    if (_heatEquationType.compare("transient")!=0 || _wFrictionalHeating.compare("yes")!=0
+      || _wViscShearHeating.compare("yes")==0 || _dtBuckets.compare("yes")==0 || _Ny == 1) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"ERROR: activeRegion_heateq = yes requires a 2D or 1D-in-y transient problem with only frictional heating, and dtBuckets_heateq = no.\n");
+      assert(0);
+    }
+  }
+
   assert(_kVals.size() == _kDepths.size() );
   assert(_rhoVals.size() == _rhoDepths.size() );
   assert(_cVals.size() == _cDepths.size() );
@@ -695,7 +728,15 @@ PetscErrorCode HeatEquation::setupKSP_SS(Mat& A)
 
   ierr = KSPCreate(PETSC_COMM_WORLD,&_kspSS); CHKERRQ(ierr);
   PC pc;
-  if (_linSolver.compare("AMG")==0) { // algebraic multigrid from HYPRE
+  // 1D problems: banded LU on rank 0 in place of MUMPS
+  if ((_Ny == 1 || _Nz == 1) && (_linSolver.compare("MUMPSCHOLESKY")==0 || _linSolver.compare("MUMPSLU")==0)) {
+    ierr = KSPSetType(_kspSS,KSPPREONLY); CHKERRQ(ierr);
+    ierr = KSPSetOperators(_kspSS,A,A); CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(_kspSS,PETSC_TRUE); CHKERRQ(ierr);
+    ierr = KSPGetPC(_kspSS,&pc); CHKERRQ(ierr);
+    ierr = BandedLUShell::setPCType(pc); CHKERRQ(ierr);
+  }
+  else if (_linSolver.compare("AMG")==0) { // algebraic multigrid from HYPRE
     // uses HYPRE's solver AMG (not HYPRE's preconditioners)
     ierr = KSPSetType(_kspSS,KSPRICHARDSON); CHKERRQ(ierr);
     ierr = KSPSetOperators(_kspSS,A,A); CHKERRQ(ierr);
@@ -763,7 +804,7 @@ PetscErrorCode HeatEquation::setupKSP_SS(Mat& A)
 
 
 // set up KSP for transient problem
-PetscErrorCode HeatEquation::setupKSP(Mat& A)
+PetscErrorCode HeatEquation::setupKSP(KSP& ksp,PC& pc,Mat& A)
 {
   PetscErrorCode ierr = 0;
   #if VERBOSE > 1
@@ -771,54 +812,62 @@ PetscErrorCode HeatEquation::setupKSP(Mat& A)
     PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
   #endif
 
-  ierr = KSPCreate(PETSC_COMM_WORLD,&_kspTrans); CHKERRQ(ierr);
-  if (_linSolver.compare("AMG")==0) { // algebraic multigrid from HYPRE
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp); CHKERRQ(ierr);
+  // 1D problems: banded LU on rank 0 in place of MUMPS
+  if ((_Ny == 1 || _Nz == 1) && (_linSolver.compare("MUMPSCHOLESKY")==0 || _linSolver.compare("MUMPSLU")==0)) {
+    ierr = KSPSetType(ksp,KSPPREONLY); CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,A,A); CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE); CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc); CHKERRQ(ierr);
+    ierr = BandedLUShell::setPCType(pc); CHKERRQ(ierr);
+  }
+  else if (_linSolver.compare("AMG")==0) { // algebraic multigrid from HYPRE
     // uses HYPRE's solver AMG (not HYPRE's preconditioners)
-    ierr = KSPSetType(_kspTrans,KSPRICHARDSON); CHKERRQ(ierr);
-    ierr = KSPSetOperators(_kspTrans,A,A); CHKERRQ(ierr);
-    ierr = KSPSetReusePreconditioner(_kspTrans,PETSC_FALSE); CHKERRQ(ierr);
-    ierr = KSPGetPC(_kspTrans,&_pc); CHKERRQ(ierr);
-    ierr = PCSetType(_pc,PCHYPRE); CHKERRQ(ierr);
-    ierr = PCHYPRESetType(_pc,"boomeramg"); CHKERRQ(ierr);
-    ierr = KSPSetTolerances(_kspTrans,_kspTol,_kspTol,PETSC_DEFAULT,PETSC_DEFAULT); CHKERRQ(ierr);
-    ierr = PCFactorSetLevels(_pc,4); CHKERRQ(ierr);
-    ierr = KSPSetInitialGuessNonzero(_kspTrans,PETSC_TRUE); CHKERRQ(ierr);
+    ierr = KSPSetType(ksp,KSPRICHARDSON); CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,A,A); CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp,PETSC_FALSE); CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc); CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCHYPRE); CHKERRQ(ierr);
+    ierr = PCHYPRESetType(pc,"boomeramg"); CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp,_kspTol,_kspTol,PETSC_DEFAULT,PETSC_DEFAULT); CHKERRQ(ierr);
+    ierr = PCFactorSetLevels(pc,4); CHKERRQ(ierr);
+    ierr = KSPSetInitialGuessNonzero(ksp,PETSC_TRUE); CHKERRQ(ierr);
   }
   else if (_linSolver.compare("MUMPSLU")==0) { // direct LU from MUMPS
     // use direct LU from MUMPS
-    ierr = KSPSetType(_kspTrans,KSPPREONLY); CHKERRQ(ierr);
-    ierr = KSPSetOperators(_kspTrans,A,A); CHKERRQ(ierr);
-    ierr = KSPSetReusePreconditioner(_kspTrans,PETSC_TRUE); CHKERRQ(ierr);
-    ierr = KSPGetPC(_kspTrans,&_pc); CHKERRQ(ierr);
-    ierr = PCSetType(_pc,PCLU); CHKERRQ(ierr);
+    ierr = KSPSetType(ksp,KSPPREONLY); CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,A,A); CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE); CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc); CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCLU); CHKERRQ(ierr);
     //~ ierr = PCFactorSetMatSolverType(pc,MATSOLVERMUMPS);                 CHKERRQ(ierr); // new PETSc
     //~ ierr = PCFactorSetUpMatSolverType(pc);                              CHKERRQ(ierr); // new PETSc
-    ierr = PCFactorSetMatSolverPackage(_pc,MATSOLVERMUMPS);              CHKERRQ(ierr); // old PETSc
-    ierr = PCFactorSetUpMatSolverPackage(_pc);                           CHKERRQ(ierr); // old PETSc
-    ierr = KSPSetInitialGuessNonzero(_kspTrans,PETSC_TRUE); CHKERRQ(ierr);
+    ierr = PCFactorSetMatSolverPackage(pc,MATSOLVERMUMPS);              CHKERRQ(ierr); // old PETSc
+    ierr = PCFactorSetUpMatSolverPackage(pc);                           CHKERRQ(ierr); // old PETSc
+    ierr = KSPSetInitialGuessNonzero(ksp,PETSC_TRUE); CHKERRQ(ierr);
   }
   else if (_linSolver.compare("MUMPSCHOLESKY")==0) { // direct Cholesky (RR^T) from MUMPS
     // use direct LL^T (Cholesky factorization) from MUMPS
-    ierr = KSPSetType(_kspTrans,KSPPREONLY); CHKERRQ(ierr);
-    ierr = KSPSetOperators(_kspTrans,A,A); CHKERRQ(ierr);
-    ierr = KSPSetReusePreconditioner(_kspTrans,PETSC_TRUE); CHKERRQ(ierr);
-    ierr = KSPGetPC(_kspTrans,&_pc); CHKERRQ(ierr);
-    ierr = PCSetType(_pc,PCCHOLESKY); CHKERRQ(ierr);
+    ierr = KSPSetType(ksp,KSPPREONLY); CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,A,A); CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE); CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc); CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCCHOLESKY); CHKERRQ(ierr);
     //~ ierr = PCFactorSetMatSolverType(pc,MATSOLVERMUMPS);                 CHKERRQ(ierr); // new PETSc
     //~ ierr = PCFactorSetUpMatSolverType(pc);                              CHKERRQ(ierr); // new PETSc
-    ierr = PCFactorSetMatSolverPackage(_pc,MATSOLVERMUMPS);              CHKERRQ(ierr); // old PETSc
-    ierr = PCFactorSetUpMatSolverPackage(_pc);                           CHKERRQ(ierr); // old PETSc
-    ierr = KSPSetInitialGuessNonzero(_kspTrans,PETSC_TRUE); CHKERRQ(ierr);
+    ierr = PCFactorSetMatSolverPackage(pc,MATSOLVERMUMPS);              CHKERRQ(ierr); // old PETSc
+    ierr = PCFactorSetUpMatSolverPackage(pc);                           CHKERRQ(ierr); // old PETSc
+    ierr = KSPSetInitialGuessNonzero(ksp,PETSC_TRUE); CHKERRQ(ierr);
   }
   else if (_linSolver.compare("CG")==0) { // conjugate gradient
-    ierr = KSPSetType(_kspTrans,KSPCG); CHKERRQ(ierr);
-    ierr = KSPSetOperators(_kspTrans,A,A); CHKERRQ(ierr);
-    ierr = KSPSetReusePreconditioner(_kspTrans,PETSC_FALSE); CHKERRQ(ierr);
-    ierr = KSPGetPC(_kspTrans,&_pc); CHKERRQ(ierr);
-    ierr = KSPSetTolerances(_kspTrans,_kspTol,_kspTol,PETSC_DEFAULT,PETSC_DEFAULT); CHKERRQ(ierr);
-    ierr = PCSetType(_pc,PCHYPRE); CHKERRQ(ierr);
-    ierr = PCFactorSetShiftType(_pc,MAT_SHIFT_POSITIVE_DEFINITE); CHKERRQ(ierr);
-    ierr = KSPSetInitialGuessNonzero(_kspTrans,PETSC_TRUE); CHKERRQ(ierr);
+    ierr = KSPSetType(ksp,KSPCG); CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,A,A); CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp,PETSC_FALSE); CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc); CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp,_kspTol,_kspTol,PETSC_DEFAULT,PETSC_DEFAULT); CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCHYPRE); CHKERRQ(ierr);
+    ierr = PCFactorSetShiftType(pc,MAT_SHIFT_POSITIVE_DEFINITE); CHKERRQ(ierr);
+    ierr = KSPSetInitialGuessNonzero(ksp,PETSC_TRUE); CHKERRQ(ierr);
   }
   else {
     ierr = PetscPrintf(PETSC_COMM_WORLD,"ERROR: linSolver type not understood\n");
@@ -826,11 +875,11 @@ PetscErrorCode HeatEquation::setupKSP(Mat& A)
   }
 
   // accept command line options
-  ierr = KSPSetFromOptions(_kspTrans);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
 
   // perform computation of preconditioners now, rather than on first use
   double startTime = MPI_Wtime();
-  ierr = KSPSetUp(_kspTrans);CHKERRQ(ierr);
+  ierr = KSPSetUp(ksp);CHKERRQ(ierr);
   _factorTime += MPI_Wtime() - startTime;
 
   #if VERBOSE > 1
@@ -1122,6 +1171,12 @@ PetscErrorCode HeatEquation::be(const PetscScalar time,const Vec slipVel,const V
   else if (_isMMS && _heatEquationType.compare("steadyState")==0) {
     be_steadyStateMMS(time,slipVel,tau,sdev,dgxy,dgxz,T,To,dt);
   }
+  else if (!_isMMS && _heatEquationType.compare("transient")==0 && _activeRegion.compare("yes")==0) {
+    be_transient_activeRegion(time,slipVel,tau,sdev,dgxy,dgxz,T,To,dt);
+  }
+  else if (!_isMMS && _heatEquationType.compare("transient")==0 && _dtBuckets.compare("yes")==0) {
+    be_transient_dtBuckets(time,slipVel,tau,sdev,dgxy,dgxz,T,To,dt);
+  }
   else if (!_isMMS && _heatEquationType.compare("transient")==0) {
     be_transient(time,slipVel,tau,sdev,dgxy,dgxz,T,To,dt);
   }
@@ -1161,7 +1216,7 @@ PetscErrorCode HeatEquation::be_transient(const PetscScalar time,const Vec slipV
   MatAXPY(_B,1.0,_I,SUBSET_NONZERO_PATTERN);
   if (_kspTrans == NULL) {
     KSPDestroy(&_kspSS);
-    setupKSP(_B);
+    setupKSP(_kspTrans,_pc,_B);
   }
   ierr = KSPSetOperators(_kspTrans,_B,_B);CHKERRQ(ierr);
 
@@ -1187,17 +1242,10 @@ PetscErrorCode HeatEquation::be_transient(const PetscScalar time,const Vec slipV
     VecAXPY(_Q,1.0,_Qvisc);
   }
 
+  // rhs = dt * rcInv * (SAT + H*J*Q), as in d_dt
   ierr = _sbp->setRhs(temp,_bcL,_bcR,_bcT,_bcB);CHKERRQ(ierr);
-  Vec temp1; VecDuplicate(_Q,&temp1);
-  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
-    Mat J,Jinv,qy,rz,yq,zr;
-    ierr = _sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
-    ierr = MatMult(J,_Q,temp1);
-  }
-
-  Mat H; _sbp->getH(H);
-  ierr = MatMultAdd(H,temp1,temp,temp); CHKERRQ(ierr);
-  VecDestroy(&temp1);
+  ierr = multHJ(_sbp,_Q,rhs); CHKERRQ(ierr);
+  VecAXPY(temp,1.0,rhs);
   MatMult(_rcInv,temp,rhs);
   VecScale(rhs,dt);
 
@@ -1237,6 +1285,428 @@ PetscErrorCode HeatEquation::be_transient(const PetscScalar time,const Vec slipV
 }
 
 
+// return the cached linear system for backward Euler with step size dt, creating it
+// (and replacing the least recently used entry if the cache is full) if necessary
+PetscErrorCode HeatEquation::getDtBucket(const PetscScalar dt,HeatEqDtBucket*& bucket)
+{
+  PetscErrorCode ierr = 0;
+
+  // index k such that dt = dtBucketMin * dtBucketRatio^k
+  const PetscInt k = (PetscInt) round(log(dt/_dtBucketMin) / log(_dtBucketRatio));
+  _dtBucketUseCount++;
+
+  // search cache
+  PetscInt lru = -1;
+  for (size_t i = 0; i < _dtBucketCache.size(); i++) {
+    if (_dtBucketCache[i]._index == k) {
+      _dtBucketCache[i]._lastUse = _dtBucketUseCount;
+      bucket = &_dtBucketCache[i];
+      return ierr;
+    }
+    if (lru < 0 || _dtBucketCache[i]._lastUse < _dtBucketCache[lru]._lastUse) { lru = i; }
+  }
+
+  // not in cache: reuse least recently used entry, or add a new one
+  if ((PetscInt) _dtBucketCache.size() >= _dtBucketCacheSize) {
+    bucket = &_dtBucketCache[lru];
+    KSPDestroy(&bucket->_ksp);
+    MatDestroy(&bucket->_B);
+  }
+  else {
+    _dtBucketCache.push_back(HeatEqDtBucket());
+    bucket = &_dtBucketCache.back();
+  }
+  bucket->_index = k;
+  bucket->_dt = dt;
+  bucket->_lastUse = _dtBucketUseCount;
+  bucket->_ksp = NULL;
+  bucket->_pc = NULL;
+
+  // B = I - dt * D2ath
+  ierr = MatDuplicate(_D2ath,MAT_COPY_VALUES,&bucket->_B); CHKERRQ(ierr);
+  ierr = MatScale(bucket->_B,-dt); CHKERRQ(ierr);
+  ierr = MatAXPY(bucket->_B,1.0,_I,SUBSET_NONZERO_PATTERN); CHKERRQ(ierr);
+  ierr = setupKSP(bucket->_ksp,bucket->_pc,bucket->_B); CHKERRQ(ierr);
+  _dtBucketSetupCount++;
+
+  return ierr;
+}
+
+PetscErrorCode HeatEquation::destroyDtBuckets()
+{
+  for (size_t i = 0; i < _dtBucketCache.size(); i++) {
+    KSPDestroy(&_dtBucketCache[i]._ksp);
+    MatDestroy(&_dtBucketCache[i]._B);
+  }
+  _dtBucketCache.clear();
+  return 0;
+}
+
+// out = H * J * in, where J is only included for variable grid spacing
+PetscErrorCode HeatEquation::multHJ(SbpOps* sbp,const Vec& in,Vec& out)
+{
+  PetscErrorCode ierr = 0;
+  ierr = sbp->H(in,out); CHKERRQ(ierr);
+  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
+    Mat J,Jinv,qy,rz,yq,zr;
+    ierr = sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
+    Vec temp; VecDuplicate(out,&temp);
+    ierr = MatMult(J,out,temp); CHKERRQ(ierr);
+    ierr = VecCopy(temp,out); CHKERRQ(ierr);
+    VecDestroy(&temp);
+  }
+  return ierr;
+}
+
+
+// for thermomechanical problem using implicit time stepping (backward Euler),
+// with step sizes restricted to dt buckets so that the linear solvers can be reused.
+// The heat equation is advanced by as many steps of the largest bucket
+// h <= dt + _dtDeficit as fit, and the remainder is carried over to the next call,
+// so the heat equation's time never lags the mechanical time by more than h.
+// Boundary conditions and source terms are held fixed over the sub-steps.
+PetscErrorCode HeatEquation::be_transient_dtBuckets(const PetscScalar time,const Vec slipVel,const Vec& tau, const Vec& sdev, const Vec& dgxy,const Vec& dgxz,Vec& T,const Vec& Tn,const PetscScalar dt)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "HeatEquation::be_transient_dtBuckets";
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s: time=%.15e\n",funcName.c_str(),FILENAME,time);
+    CHKERRQ(ierr);
+  #endif
+
+  if (_kspSS != NULL) { KSPDestroy(&_kspSS); }
+
+  // update fields
+  VecCopy(Tn,_T);
+  VecWAXPY(_dT,-1.0,_Tamb,Tn); // dTn = Tn - Tamb
+
+  // choose bucket and number of steps
+  const PetscScalar totalDt = dt + _dtDeficit;
+  if (totalDt < _dtBucketMin) { // too short to take a step
+    _dtDeficit = totalDt;
+    VecCopy(_T,T);
+    #if VERBOSE > 1
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s: time=%.15e\n",funcName.c_str(),FILENAME,time);
+      CHKERRQ(ierr);
+    #endif
+    return ierr;
+  }
+  PetscInt k = (PetscInt) floor(log(totalDt/_dtBucketMin) / log(_dtBucketRatio));
+  PetscScalar h = _dtBucketMin * pow(_dtBucketRatio,k);
+  while (h > totalDt && k > 0) { k--; h = _dtBucketMin * pow(_dtBucketRatio,k); }
+  const PetscInt numSteps = (PetscInt) floor(totalDt / h);
+  _dtDeficit = totalDt - numSteps * h;
+
+  HeatEqDtBucket *bucket = NULL;
+  ierr = getDtBucket(h,bucket); CHKERRQ(ierr);
+
+  // set up boundary conditions and source terms: Q = Qfric + Qvisc
+  // Note: there is no Qrad because radioactive heat generation is already included in Tamb
+  Vec src,rhs,temp;
+  VecDuplicate(_k,&src);
+  VecDuplicate(_k,&rhs);
+  VecDuplicate(_k,&temp);
+  VecSet(_Q,0.);
+
+  // frictional heat generation: Qfric or bcL depending on shear zone width
+  if (_wFrictionalHeating.compare("yes")==0) {
+    computeFrictionalShearHeating(tau,slipVel);
+    VecAXPY(_Q,1.0,_Qfric);
+  }
+
+  // viscous shear heating: Qvisc
+  if (_wViscShearHeating.compare("yes")==0
+      && dgxy!=NULL && dgxz!=NULL && sdev!=NULL) {
+    computeViscousShearHeating(sdev, dgxy, dgxz);
+    VecAXPY(_Q,1.0,_Qvisc);
+  }
+
+  // src = rcInv * (SAT + H * J * Q)
+  ierr = _sbp->setRhs(rhs,_bcL,_bcR,_bcT,_bcB);CHKERRQ(ierr);
+  ierr = multHJ(_sbp,_Q,temp); CHKERRQ(ierr);
+  VecAXPY(rhs,1.0,temp);
+  MatMult(_rcInv,rhs,src);
+
+  // sub-steps: (I - h*D2ath) dT^{m+1} = h * src + H * J * dT^m
+  double startTime = MPI_Wtime();
+  for (PetscInt m = 0; m < numSteps; m++) {
+    ierr = multHJ(_sbp,_dT,rhs); CHKERRQ(ierr);
+    VecAXPY(rhs,h,src);
+    KSPSolve(bucket->_ksp,rhs,_dT);
+    _linSolveCount++;
+  }
+  _linSolveTime += MPI_Wtime() - startTime;
+
+  VecDestroy(&src);
+  VecDestroy(&rhs);
+  VecDestroy(&temp);
+
+  // update total temperature: _T (internal variable) and T (output)
+  VecWAXPY(_T,1.0,_Tamb,_dT); // T = dT + Tamb
+  VecCopy(_T,T);
+  computeHeatFlux();
+
+  #if VERBOSE > 1
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s: time=%.15e\n",funcName.c_str(),FILENAME,time);
+    CHKERRQ(ierr);
+  #endif
+  return ierr;
+}
+
+
+// last row of the grid (i in index i*Nz+j, increasing away from the fault) that is
+// heated: |dT| > activeRegionTol_heateq, or within 3 widths of the shear zone
+PetscErrorCode HeatEquation::computeHeatedExtent(PetscInt& iEdge)
+{
+  PetscErrorCode ierr = 0;
+
+  PetscInt iEdgeLocal = 0, Ii,Istart,Iend;
+  PetscScalar const *dT, *y, *w = NULL;
+  ierr = VecGetOwnershipRange(_dT,&Istart,&Iend);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(_dT,&dT);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(*_y,&y);CHKERRQ(ierr);
+  if (_wMax > 0) { ierr = VecGetArrayRead(_w,&w);CHKERRQ(ierr); }
+  PetscInt Jj = 0;
+  for (Ii = Istart; Ii < Iend; Ii++) {
+    if (abs(dT[Jj]) > _activeRegionTol || (w != NULL && y[Jj] <= 3.0*w[Jj])) {
+      iEdgeLocal = max(iEdgeLocal, Ii / _Nz);
+    }
+    Jj++;
+  }
+  ierr = VecRestoreArrayRead(_dT,&dT);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(*_y,&y);CHKERRQ(ierr);
+  if (_wMax > 0) { ierr = VecRestoreArrayRead(_w,&w);CHKERRQ(ierr); }
+
+  MPI_Allreduce(&iEdgeLocal,&iEdge,1,MPIU_INT,MPI_MAX,PETSC_COMM_WORLD);
+  return ierr;
+}
+
+
+// set up the transient problem on the first NyActive rows of the grid
+PetscErrorCode HeatEquation::setUpActiveRegion(const PetscInt NyActive)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "HeatEquation::setUpActiveRegion";
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+    CHKERRQ(ierr);
+  #endif
+
+  destroyActiveRegion();
+  _NyActive = NyActive;
+  _activeRegionSetupCount++;
+  if (_NyActive == _Ny) { return ierr; } // full domain: use be_transient
+
+  // Vecs on active region
+  const PetscInt N = _NyActive * _Nz;
+  ierr = VecCreate(PETSC_COMM_WORLD,&_kActive); CHKERRQ(ierr);
+  ierr = VecSetSizes(_kActive,PETSC_DECIDE,N); CHKERRQ(ierr);
+  ierr = VecSetFromOptions(_kActive); CHKERRQ(ierr);
+  VecDuplicate(_kActive,&_rhoActive);
+  VecDuplicate(_kActive,&_cActive);
+  VecDuplicate(_kActive,&_yActive);
+  VecDuplicate(_kActive,&_zActive);
+  VecDuplicate(_kActive,&_dTActive);
+  VecDuplicate(_kActive,&_QActive);
+
+  // scatter from full domain to active region
+  IS is;
+  ierr = ISCreateStride(PETSC_COMM_WORLD,N,0,1,&is); CHKERRQ(ierr);
+  ierr = VecScatterCreate(_k,is,_kActive,is,&_scatterActive); CHKERRQ(ierr);
+  ISDestroy(&is);
+
+  // scatter from full domain to last row of active region, for its boundary condition
+  VecDuplicate(_bcL,&_bcRActive);
+  IS isf,ist;
+  ierr = ISCreateStride(PETSC_COMM_WORLD,_Nz,(_NyActive-1)*_Nz,1,&isf); CHKERRQ(ierr);
+  ierr = ISCreateStride(PETSC_COMM_WORLD,_Nz,0,1,&ist); CHKERRQ(ierr);
+  ierr = VecScatterCreate(_dT,isf,_bcRActive,ist,&_scatterActiveEdge); CHKERRQ(ierr);
+  ISDestroy(&isf);
+  ISDestroy(&ist);
+
+  ierr = VecCreate(PETSC_COMM_WORLD,&_bcTActive); CHKERRQ(ierr);
+  ierr = VecSetSizes(_bcTActive,PETSC_DECIDE,_NyActive); CHKERRQ(ierr);
+  ierr = VecSetFromOptions(_bcTActive); CHKERRQ(ierr);
+  VecSet(_bcTActive,0.);
+  VecDuplicate(_bcTActive,&_bcBActive);
+  VecSet(_bcBActive,0.);
+
+  Vec full[4] = {_k,_rho,_c,*_y};
+  Vec active[4] = {_kActive,_rhoActive,_cActive,_yActive};
+  for (int c = 0; c < 4; c++) {
+    ierr = VecScatterBegin(_scatterActive,full[c],active[c],INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+    ierr = VecScatterEnd(_scatterActive,full[c],active[c],INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  }
+  ierr = VecScatterBegin(_scatterActive,*_z,_zActive,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_scatterActive,*_z,_zActive,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+
+  // SBP operators, with Dirichlet condition on the edge of the active region
+  PetscScalar LyActive = 0;
+  VecMax(_yActive,NULL,&LyActive);
+  if (_D->_gridSpacingType.compare("constantGridSpacing")==0) {
+    _sbpActive = new SbpOps_m_constGrid(_order,_NyActive,_Nz,LyActive,_Lz,_kActive);
+  }
+  else if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
+    _sbpActive = new SbpOps_m_varGrid(_order,_NyActive,_Nz,LyActive,_Lz,_kActive);
+    if (_Nz > 1) { _sbpActive->setGrid(&_yActive,&_zActive); }
+    else { _sbpActive->setGrid(&_yActive,NULL); }
+  }
+  _sbpActive->setCompatibilityType(_D->_sbpCompatibilityType);
+  _sbpActive->setBCTypes("Dirichlet","Dirichlet","Neumann","Dirichlet");
+  _sbpActive->setMultiplyByH(1);
+  _sbpActive->setLaplaceType("yz");
+  _sbpActive->computeMatrices();
+
+  // I (multiplied by H), (rho*c)^-1, and D2ath = (rho*c)^-1 H D2, as in setUpTransientProblem
+  Mat H;
+  _sbpActive->getH(H);
+  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
+    Mat J,Jinv,qy,rz,yq,zr;
+    ierr = _sbpActive->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
+    MatMatMult(J,H,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&_IActive);
+  }
+  else {
+    MatDuplicate(H,MAT_COPY_VALUES,&_IActive);
+  }
+
+  Vec rhocV;
+  VecDuplicate(_rhoActive,&rhocV);
+  VecSet(rhocV,1.);
+  VecPointwiseDivide(rhocV,rhocV,_rhoActive);
+  VecPointwiseDivide(rhocV,rhocV,_cActive);
+  MatDuplicate(_IActive,MAT_DO_NOT_COPY_VALUES,&_rcInvActive);
+  MatDiagonalSet(_rcInvActive,rhocV,INSERT_VALUES);
+  VecDestroy(&rhocV);
+
+  Mat D2;
+  _sbpActive->getA(D2);
+  MatMatMult(_rcInvActive,D2,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&_D2athActive);
+  PetscScalar v=0.0;
+  PetscInt Ii,Istart,Iend=0;
+  MatGetOwnershipRange(_D2athActive,&Istart,&Iend);
+  for (Ii = Istart; Ii < Iend; Ii++) {
+    MatSetValues(_D2athActive,1,&Ii,1,&Ii,&v,ADD_VALUES);
+  }
+  MatAssemblyBegin(_D2athActive,MAT_FINAL_ASSEMBLY);
+  MatAssemblyEnd(_D2athActive,MAT_FINAL_ASSEMBLY);
+  MatDuplicate(_D2athActive,MAT_COPY_VALUES,&_BActive);
+
+  #if VERBOSE > 1
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+    CHKERRQ(ierr);
+  #endif
+  return ierr;
+}
+
+PetscErrorCode HeatEquation::destroyActiveRegion()
+{
+  delete _sbpActive; _sbpActive = NULL;
+  VecScatterDestroy(&_scatterActive);
+  VecScatterDestroy(&_scatterActiveEdge);
+  KSPDestroy(&_kspActive);
+  MatDestroy(&_IActive);
+  MatDestroy(&_rcInvActive);
+  MatDestroy(&_D2athActive);
+  MatDestroy(&_BActive);
+  VecDestroy(&_kActive);
+  VecDestroy(&_rhoActive);
+  VecDestroy(&_cActive);
+  VecDestroy(&_yActive);
+  VecDestroy(&_zActive);
+  VecDestroy(&_dTActive);
+  VecDestroy(&_QActive);
+  VecDestroy(&_bcRActive);
+  VecDestroy(&_bcTActive);
+  VecDestroy(&_bcBActive);
+  return 0;
+}
+
+
+// for thermomechanical problem with only frictional heating, using implicit time
+// stepping (backward Euler) on the active region only. dT outside the active
+// region is held fixed, and provides the Dirichlet condition at its edge.
+PetscErrorCode HeatEquation::be_transient_activeRegion(const PetscScalar time,const Vec slipVel,const Vec& tau, const Vec& sdev, const Vec& dgxy,const Vec& dgxz,Vec& T,const Vec& Tn,const PetscScalar dt)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "HeatEquation::be_transient_activeRegion";
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s: time=%.15e\n",funcName.c_str(),FILENAME,time);
+    CHKERRQ(ierr);
+  #endif
+
+  VecCopy(Tn,_T);
+  VecWAXPY(_dT,-1.0,_Tamb,Tn); // dTn = Tn - Tamb
+
+  // choose active region from heated zone
+  PetscInt iEdge = 0;
+  ierr = computeHeatedExtent(iEdge); CHKERRQ(ierr);
+  if (_NyActive == 0) {
+    ierr = setUpActiveRegion(min(_Ny,iEdge + _activeRegionBuffer + 1)); CHKERRQ(ierr);
+  }
+  else if (_NyActive < _Ny && iEdge + _activeRegionBuffer >= _NyActive) {
+    ierr = setUpActiveRegion(min(_Ny,max(2*_NyActive,iEdge + _activeRegionBuffer + 1))); CHKERRQ(ierr);
+  }
+  if (_NyActive == _Ny) {
+    ierr = be_transient(time,slipVel,tau,sdev,dgxy,dgxz,T,Tn,dt); CHKERRQ(ierr);
+    return ierr;
+  }
+
+  // source term and boundary conditions
+  VecSet(_Q,0.);
+  computeFrictionalShearHeating(tau,slipVel);
+  VecAXPY(_Q,1.0,_Qfric);
+  ierr = VecScatterBegin(_scatterActive,_Q,_QActive,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_scatterActive,_Q,_QActive,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterBegin(_scatterActive,_dT,_dTActive,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_scatterActive,_dT,_dTActive,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterBegin(_scatterActiveEdge,_dT,_bcRActive,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_scatterActiveEdge,_dT,_bcRActive,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+
+  // set up matrix
+  MatCopy(_D2athActive,_BActive,SAME_NONZERO_PATTERN);
+  MatScale(_BActive,-dt);
+  MatAXPY(_BActive,1.0,_IActive,SUBSET_NONZERO_PATTERN);
+  if (_kspActive == NULL) {
+    KSPDestroy(&_kspSS);
+    setupKSP(_kspActive,_pcActive,_BActive);
+  }
+  ierr = KSPSetOperators(_kspActive,_BActive,_BActive);CHKERRQ(ierr);
+
+  // rhs = dt * rcInv * (SAT + H*J*Q) + H*J*dTn
+  Vec rhs,temp;
+  VecDuplicate(_kActive,&rhs);
+  VecDuplicate(_kActive,&temp);
+  ierr = _sbpActive->setRhs(temp,_bcL,_bcRActive,_bcTActive,_bcBActive);CHKERRQ(ierr);
+  ierr = multHJ(_sbpActive,_QActive,rhs); CHKERRQ(ierr);
+  VecAXPY(temp,1.0,rhs);
+  MatMult(_rcInvActive,temp,rhs);
+  VecScale(rhs,dt);
+  ierr = multHJ(_sbpActive,_dTActive,temp); CHKERRQ(ierr);
+  VecAXPY(rhs,1.0,temp);
+  VecDestroy(&temp);
+
+  double startTime = MPI_Wtime();
+  KSPSolve(_kspActive,rhs,_dTActive);
+  _linSolveTime += MPI_Wtime() - startTime;
+  _linSolveCount++;
+  VecDestroy(&rhs);
+
+  ierr = VecScatterBegin(_scatterActive,_dTActive,_dT,INSERT_VALUES,SCATTER_REVERSE); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_scatterActive,_dTActive,_dT,INSERT_VALUES,SCATTER_REVERSE); CHKERRQ(ierr);
+
+  // update total temperature: _T (internal variable) and T (output)
+  VecWAXPY(_T,1.0,_Tamb,_dT); // T = dT + Tamb
+  VecCopy(_T,T);
+  computeHeatFlux();
+
+  #if VERBOSE > 1
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s: time=%.15e\n",funcName.c_str(),FILENAME,time);
+    CHKERRQ(ierr);
+  #endif
+  return ierr;
+}
+
+
 // for thermomechanical problem when solving only the steady-state heat equation
 // Note: This function uses the KSP algorithm to solve for dT, where T = Tamb + dT
 PetscErrorCode HeatEquation::be_steadyState(const PetscScalar time,const Vec slipVel,const Vec& tau,
@@ -1709,6 +2179,40 @@ PetscErrorCode HeatEquation::setUpTransientProblem()
 }
 
 
+// time step limit for accuracy of backward Euler: the time for heat to diffuse
+// across one grid cell, based on the average grid spacing
+PetscErrorCode HeatEquation::computeMaxTimeStep(PetscScalar& maxTimeStep)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "HeatEquation::computeMaxTimeStep";
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+    CHKERRQ(ierr);
+  #endif
+
+  // thermal diffusivity: k / (rho * c)
+  Vec alpha;
+  VecDuplicate(_k,&alpha);
+  VecPointwiseDivide(alpha,_k,_rho);
+  VecPointwiseDivide(alpha,alpha,_c);
+  PetscScalar maxAlpha;
+  VecMax(alpha,NULL,&maxAlpha);
+  VecDestroy(&alpha);
+
+  PetscScalar h = PETSC_MAX_REAL;
+  if (_Ny > 1) { h = min(h,_Ly/(_Ny-1.0)); }
+  if (_Nz > 1) { h = min(h,_Lz/(_Nz-1.0)); }
+
+  maxTimeStep = h * h / maxAlpha;
+
+  #if VERBOSE > 1
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+    CHKERRQ(ierr);
+  #endif
+  return ierr;
+}
+
+
 // compute heat flux (full body field and surface heat flux) for output
 PetscErrorCode HeatEquation::computeHeatFlux()
 {
@@ -1823,6 +2327,16 @@ PetscErrorCode HeatEquation::view()
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times linear system was solved: %i\n",_linSolveCount);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent solving linear system (s): %g\n",_linSolveTime);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   %% be time spent solving linear system: %g\n",_linSolveTime/_beTime*100.);CHKERRQ(ierr);
+  if (_dtBuckets.compare("yes")==0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of dt bucket lookups: %i\n",_dtBucketUseCount);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of dt bucket linear solver setups: %i\n",_dtBucketSetupCount);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent setting up linear solvers (s): %g\n",_factorTime);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   time not yet advanced by heat equation (s): %g\n",_dtDeficit);CHKERRQ(ierr);
+  }
+  if (_activeRegion.compare("yes")==0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of rows in active region: %i of %i\n",_NyActive,_Ny);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of active region set ups: %i\n",_activeRegionSetupCount);CHKERRQ(ierr);
+  }
   ierr = PetscPrintf(PETSC_COMM_WORLD,"\n");CHKERRQ(ierr);
 
   return ierr;
@@ -1855,6 +2369,13 @@ PetscErrorCode HeatEquation::writeDomain(const string outputDir)
   ierr = PetscViewerASCIIPrintf(viewer,"withRadioHeatGeneration = %s\n",_wRadioHeatGen.c_str());CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"linSolver_heateq = %s\n",_linSolver.c_str());CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"kspTol_heateq = %.15e\n",_kspTol);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"dtBuckets_heateq = %s\n",_dtBuckets.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"dtBucketMin_heateq = %.15e\n",_dtBucketMin);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"dtBucketRatio_heateq = %.15e\n",_dtBucketRatio);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"dtBucketCacheSize_heateq = %i\n",_dtBucketCacheSize);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"activeRegion_heateq = %s\n",_activeRegion.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"activeRegionTol_heateq = %.15e\n",_activeRegionTol);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"activeRegionBuffer_heateq = %i\n",_activeRegionBuffer);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
 
   ierr = PetscViewerASCIIPrintf(viewer,"Nz_lab = %i\n",_Nz_lab);CHKERRQ(ierr);
@@ -1877,6 +2398,42 @@ PetscErrorCode HeatEquation::writeDomain(const string outputDir)
 }
 
 
+// load data from a checkpoint
+PetscErrorCode HeatEquation::loadCheckpoint()
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "HeatEquation::loadCheckpoint";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  // time not yet advanced when using dt buckets
+  ierr = loadValueFromCheckpoint(_outputDir, "chkpt_he_dtDeficit", _dtDeficit); CHKERRQ(ierr);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+// write data needed to restart from a checkpoint
+PetscErrorCode HeatEquation::writeCheckpoint()
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "HeatEquation::writeCheckpoint";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  ierr = writeASCII(_outputDir, "chkpt_he_dtDeficit", _dtDeficit,"%.15e\n"); CHKERRQ(ierr);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
 // write out material properties
 PetscErrorCode HeatEquation::writeContext(const string outputDir)
 {
@@ -11,6 +11,7 @@
 #include "sbpOps.hpp"
 #include "sbpOps_m_constGrid.hpp"
 #include "sbpOps_m_varGrid.hpp"
+#include "bandedLU.hpp"
 #include "integratorContextEx.hpp"
 #include "integratorContextImex.hpp"
 #include "odeSolver.hpp"
@@ -18,6 +19,17 @@
 
 using namespace std;
 
+// linear system for one backward Euler time step size, I - dt * D2ath, with its KSP
+struct HeatEqDtBucket
+{
+  PetscInt    _index; // dt = dtBucketMin * dtBucketRatio^index
+  PetscScalar _dt;
+  Mat         _B;
+  KSP         _ksp;
+  PC          _pc;
+  PetscInt    _lastUse; // for least-recently-used replacement
+};
+
 /*
  * Class implementing the heat equation.
  *
@@ -94,6 +106,37 @@ public:
   Mat             _I,_rcInv,_B,_pcMat; // intermediates for Backward Euler
   Mat             _D2ath;
 
+  // dt buckets for transient backward Euler: if dtBuckets_heateq = yes, the heat
+  // equation takes steps whose size is the largest h in {dtBucketMin * dtBucketRatio^k}
+  // with h <= dt + _dtDeficit, and the time not covered is carried over to the next
+  // call. The linear systems for recently used h are kept, with their
+  // factorizations, in an LRU cache of size dtBucketCacheSize_heateq.
+  string                  _dtBuckets;
+  PetscScalar             _dtBucketMin,_dtBucketRatio;
+  PetscInt                _dtBucketCacheSize;
+  PetscScalar             _dtDeficit; // time not yet advanced by heat equation
+  vector<HeatEqDtBucket>  _dtBucketCache;
+  PetscInt                _dtBucketUseCount,_dtBucketSetupCount;
+
+  // active region for frictional heating: if activeRegion_heateq = yes, the transient
+  // problem is solved only on the first _NyActive rows of the grid (those nearest the
+  // fault), with dT held fixed beyond them. _NyActive covers the rows where
+  // |dT| > activeRegionTol_heateq plus activeRegionBuffer_heateq rows, and is
+  // doubled whenever the heated zone reaches the buffer.
+  string          _activeRegion;
+  PetscScalar     _activeRegionTol;
+  PetscInt        _activeRegionBuffer;
+  PetscInt        _NyActive; // 0 until set up
+  SbpOps*         _sbpActive;
+  VecScatter      _scatterActive; // full domain -> active region
+  VecScatter      _scatterActiveEdge; // full domain -> last row of active region
+  KSP             _kspActive;
+  PC              _pcActive;
+  Mat             _IActive,_rcInvActive,_D2athActive,_BActive;
+  Vec             _kActive,_rhoActive,_cActive,_yActive,_zActive,_dTActive,_QActive;
+  Vec             _bcRActive,_bcTActive,_bcBActive;
+  PetscInt        _activeRegionSetupCount;
+
   // scatters to take values from body field(s) to 1D fields
   // naming convention for key (string): body2<boundary>, example: "body2L>"
   map <string, VecScatter>  _scatters;
@@ -131,9 +174,16 @@ public:
   PetscErrorCode setUpTransientProblem();
   PetscErrorCode computeViscousShearHeating(const Vec& sdev, const Vec& dgxy, const Vec& dgxz);
   PetscErrorCode computeFrictionalShearHeating(const Vec& tau, const Vec& slipVel);
-  PetscErrorCode setupKSP(Mat& A);
+  PetscErrorCode setupKSP(KSP& ksp,PC& pc,Mat& A);
+  PetscErrorCode getDtBucket(const PetscScalar dt,HeatEqDtBucket*& bucket);
+  PetscErrorCode destroyDtBuckets();
+  PetscErrorCode multHJ(SbpOps* sbp,const Vec& in,Vec& out);
+  PetscErrorCode computeHeatedExtent(PetscInt& iEdge);
+  PetscErrorCode setUpActiveRegion(const PetscInt NyActive);
+  PetscErrorCode destroyActiveRegion();
   PetscErrorCode setupKSP_SS(Mat& A);
   PetscErrorCode computeHeatFlux();
+  PetscErrorCode computeMaxTimeStep(PetscScalar& maxTimeStep); // diffusion time across one grid cell
 
   Vec _Tamb,_dT,_T; // full domain: ambient temperature, change in temperature from ambiant, and total temperature
   Vec _k,_rho,_c; // thermal conductivity, density, heat capacity,
@@ -159,6 +209,8 @@ public:
   // implicitly solve for temperature using backward Euler
   PetscErrorCode be(const PetscScalar time,const Vec slipVel,const Vec& tau, const Vec& sdev, const Vec& dgxy, const Vec& dgxz,Vec& T,const Vec& To,const PetscScalar dt);
   PetscErrorCode be_transient(const PetscScalar time,const Vec slipVel,const Vec& tau, const Vec& sdev, const Vec& dgxy, const Vec& dgxz,Vec& T,const Vec& To,const PetscScalar dt);
+  PetscErrorCode be_transient_dtBuckets(const PetscScalar time,const Vec slipVel,const Vec& tau, const Vec& sdev, const Vec& dgxy, const Vec& dgxz,Vec& T,const Vec& To,const PetscScalar dt);
+  PetscErrorCode be_transient_activeRegion(const PetscScalar time,const Vec slipVel,const Vec& tau, const Vec& sdev, const Vec& dgxy, const Vec& dgxz,Vec& T,const Vec& To,const PetscScalar dt);
   PetscErrorCode be_steadyState(const PetscScalar time,const Vec slipVel,const Vec& tau, const Vec& sdev, const Vec& dgxy, const Vec& dgxz,Vec& T,const Vec& To,const PetscScalar dt);
   PetscErrorCode be_steadyStateMMS(const PetscScalar time,const Vec slipVel,const Vec& tau, const Vec& sigmadev, const Vec& dgxy, const Vec& dgxz,Vec& T,const Vec& To,const PetscScalar dt);
 
@@ -173,6 +225,10 @@ public:
   PetscErrorCode writeStep1D(const PetscInt stepCount, const PetscScalar time,const string outputDir);
   PetscErrorCode writeStep2D(const PetscInt stepCount, const PetscScalar time,const string outputDir);
 
+  // checkpointing functions
+  PetscErrorCode loadCheckpoint();
+  PetscErrorCode writeCheckpoint();
+
 
   // MMS functions
   PetscErrorCode measureMMSError(const PetscScalar time);
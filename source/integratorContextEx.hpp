@@ -24,6 +24,26 @@ class IntegratorContextEx
   // for output and monitoring as time integration progresses
   // this function is not required
   virtual PetscErrorCode timeMonitor(const PetscReal time,const PetscScalar deltaT, const PetscInt stepCount,int& stopIntegration){return 1;};
+
+  // event function g(t,y,y'), for OdeSolver event detection: a step over
+  // which g changes from g <= 0 to g > 0 is ended at the crossing
+  // this function is only required if event detection is used
+  virtual PetscErrorCode eventFunction(const PetscReal time,const map<string,Vec>& var,const map<string,Vec>& dvar,PetscScalar& g){return 1;};
+
+  // for contexts that keep state between calls to d_dt, such as a lagged
+  // coefficient, the adaptive explicit Runge-Kutta methods call
+  //   beginLastStage: before d_dt for the last stage of each attempted step
+  //   stepError: error of that state in the attempted step, relative to the
+  //     time step tolerance, which is added to the integrator's error estimate
+  //   stepRejected: after a step is rejected, before it is retried
+  //   stepAccepted: after a step is accepted, before d_dt at the accepted
+  //     solution; lastStageIsSolution is true if the last stage was evaluated
+  //     at the accepted solution, which is then not evaluated again (FSAL)
+  // these functions are not required
+  virtual PetscErrorCode beginLastStage(){return 0;};
+  virtual PetscErrorCode stepError(PetscScalar& err){err = 0; return 0;};
+  virtual PetscErrorCode stepRejected(){return 0;};
+  virtual PetscErrorCode stepAccepted(const bool lastStageIsSolution){return 0;};
 };
 
 #include "odeSolver.hpp"
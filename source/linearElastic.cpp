@@ -12,10 +12,11 @@ LinearElastic::LinearElastic(Domain&D,string bcRTtype,string bcTTtype,string bcL
     _isMMS(D._isMMS),
     _mu(NULL),_rho(NULL),_cs(NULL),_bcRShift(NULL),_surfDisp(NULL),
     _rhs(NULL),_u(NULL),_sxy(NULL),_sxz(NULL),_computeSxz(0),_computeSdev(0),
-    _linSolver("MUMPSCHOLESKY"),_ksp(NULL),_pc(NULL),_kspTol(1e-10),
-    _sbp(NULL),
+    _faultStressOnly(0),_stressesUpToDate(0),
+    _linSolver("MUMPSCHOLESKY"),_activeLinSolver("MUMPSCHOLESKY"),_ksp(NULL),_pc(NULL),_kspTol(1e-10),_factorTol(1e-7),
+    _sbp(NULL),_sep(NULL),
     _writeTime(0),_linSolveTime(0),_factorTime(0),_startTime(MPI_Wtime()),
-    _miscTime(0), _matrixTime(0), _linSolveCount(0),
+    _miscTime(0), _matrixTime(0), _linSolveCount(0), _linSolveIts(0),
     _bcRType(bcRTtype),_bcTType(bcTTtype),_bcLType(bcLTtype),_bcBType(bcBTtype),
     _bcR(NULL),_bcT(NULL),_bcL(NULL),_bcB(NULL)
 {
@@ -78,6 +79,8 @@ LinearElastic::~LinearElastic()
   VecDestroy(&_surfDisp);
 
   KSPDestroy(&_ksp);
+  delete _sep;
+  _sep = NULL;
 
   delete _sbp;
   _sbp = NULL;
@@ -128,6 +131,7 @@ PetscErrorCode LinearElastic::loadSettings(const char *file)
 
     if (var.compare("linSolver")==0) { _linSolver = rhs; }
     else if (var.compare("kspTol")==0) { _kspTol = atof( (rhs).c_str() ); }
+    else if (var.compare("factorTol")==0) { _factorTol = atof( (rhs).c_str() ); }
 
     else if (var.compare("muVals")==0) { loadVectorFromInputFile(rhsFull,_muVals); }
     else if (var.compare("muDepths")==0) { loadVectorFromInputFile(rhsFull,_muDepths); }
@@ -137,6 +141,7 @@ PetscErrorCode LinearElastic::loadSettings(const char *file)
     // switches for computing extra stresses
     else if (var.compare("momBal_computeSxz")==0) { _computeSxz = atof( rhs.c_str() ); }
     else if (var.compare("momBal_computeSdev")==0) { _computeSdev = atof( rhs.c_str() ); }
+    else if (var.compare("momBal_faultStressOnly")==0) { _faultStressOnly = atoi( rhs.c_str() ); }
   }
 
   #if VERBOSE > 1
@@ -159,13 +164,18 @@ PetscErrorCode LinearElastic::checkInput()
 
   assert(_linSolver.compare("MUMPSCHOLESKY") == 0 ||
          _linSolver.compare("MUMPSLU") == 0 ||
+         _linSolver.compare("MUMPSCHOLESKY_IR") == 0 ||
+         _linSolver.compare("MUMPSLU_IR") == 0 ||
+         _linSolver.compare("SEPARABLE") == 0 ||
          _linSolver.compare("PCG") == 0 ||
          _linSolver.compare("AMG") == 0 ||
          _linSolver.compare("CG") == 0 );
 
-  if (_linSolver.compare("CG")==0 || _linSolver.compare("AMG")==0) {
+  if (_linSolver.compare("CG")==0 || _linSolver.compare("AMG")==0 ||
+      _linSolver.compare("MUMPSCHOLESKY_IR")==0 || _linSolver.compare("MUMPSLU_IR")==0) {
     assert(_kspTol >= 1e-14);
   }
+  assert(_factorTol >= 0 && _factorTol < 1);
 
   assert(_muVals.size() == _muDepths.size());
   assert(_muVals.size() != 0);
@@ -174,6 +184,10 @@ PetscErrorCode LinearElastic::checkInput()
 
   if (_computeSdev == 1) { _computeSxz = 1; }
 
+  // MMS tests measure the error in the body stress
+  assert(_faultStressOnly == 0 || _faultStressOnly == 1);
+  if (_isMMS) { _faultStressOnly = 0; }
+
   #if VERBOSE > 1
     ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
     CHKERRQ(ierr);
@@ -194,6 +208,29 @@ PetscErrorCode LinearElastic::checkInput()
  * algebraic multigrid       HYPRE                AMG
  * direct LU                 MUMPS                MUMPSLU
  * direct Cholesky           MUMPS                MUMPSCHOLESKY
+ * low-precision LU + IR     MUMPS                MUMPSLU_IR
+ * low-precision Cholesky+CG MUMPS                MUMPSCHOLESKY_IR
+ * separable direct solve    LAPACK               SEPARABLE
+ *
+ * The *_IR methods compute an approximate factorization using MUMPS'
+ * block low-rank (BLR) compression, with entries dropped below factorTol
+ * (default 1e-7, roughly single precision). This substantially reduces
+ * factor memory and the cost of the triangular solves. The factor is then
+ * used as a preconditioner for iterative refinement (LU) or conjugate
+ * gradient (Cholesky), which recover the solution to kspTol in a few
+ * iterations. The previous displacement is used as the initial guess.
+ *
+ * For 1D problems (Ny = 1 or Nz = 1), MUMPSLU and MUMPSCHOLESKY are
+ * replaced by a banded LU factorization on rank 0 (see bandedLU.hpp).
+ *
+ * SEPARABLE applies to depth-layered media (mu = mu(z)) on a constant
+ * grid, for which the operator separates into 1D operators in y and z (see
+ * separableSolver.hpp). It is applied through a shell preconditioner, and
+ * is checked against A during setup. If mu varies in y, the grid is
+ * variable, or the check fails, MUMPSCHOLESKY is used instead. Each solve
+ * is distributed over the ranks by grid lines, but its dense transforms
+ * cost O(N^1.5) for N = Ny*Nz, so it pays off only for moderate
+ * min(Ny,Nz).
  *
  * A list of options for each algorithm that can be set can be obtained
  * by running the code with the argument main <input file> -help and
@@ -222,8 +259,22 @@ PetscErrorCode LinearElastic::setupKSP(KSP& ksp,PC& pc,Mat& A)
   // set operators, here the matrix that defines the linear system also serves as the preconditioning matrix
   ierr = KSPSetOperators(ksp,A,A); CHKERRQ(ierr);
 
+  // separable direct solve, if applicable (otherwise falls back to MUMPSCHOLESKY)
+  _activeLinSolver = _linSolver;
+  if (_activeLinSolver == "SEPARABLE") {
+    ierr = setupSeparableSolver(A); CHKERRQ(ierr);
+  }
+
+  // 1D problems: banded LU on rank 0 in place of MUMPS
+  if ((_Ny == 1 || _Nz == 1) && (_activeLinSolver == "MUMPSCHOLESKY" || _activeLinSolver == "MUMPSLU")) {
+    ierr = KSPSetType(ksp,KSPPREONLY);                                  CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE);                   CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc);                                           CHKERRQ(ierr);
+    ierr = BandedLUShell::setPCType(pc);                                CHKERRQ(ierr);
+  }
+
   // algebraic multigrid from HYPRE
-  if (_linSolver == "AMG") {
+  else if (_activeLinSolver == "AMG") {
     ierr = KSPSetType(ksp,KSPRICHARDSON);                               CHKERRQ(ierr);
     ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE);                   CHKERRQ(ierr);
     ierr = KSPGetPC(ksp,&pc);                                           CHKERRQ(ierr);
@@ -235,7 +286,7 @@ PetscErrorCode LinearElastic::setupKSP(KSP& ksp,PC& pc,Mat& A)
   }
 
   // direct LU from MUMPS
-  else if (_linSolver == "MUMPSLU") {
+  else if (_activeLinSolver == "MUMPSLU") {
     ierr = KSPSetType(ksp,KSPPREONLY);                                  CHKERRQ(ierr);
     ierr = KSPSetOperators(ksp,A,A);                                    CHKERRQ(ierr);
     ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE);                   CHKERRQ(ierr);
@@ -248,7 +299,7 @@ PetscErrorCode LinearElastic::setupKSP(KSP& ksp,PC& pc,Mat& A)
   }
 
   // direct Cholesky (RR^T) from MUMPS
-  else if (_linSolver == "MUMPSCHOLESKY") {
+  else if (_activeLinSolver == "MUMPSCHOLESKY") {
     ierr = KSPSetType(ksp,KSPPREONLY);                                  CHKERRQ(ierr);
     ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE);                   CHKERRQ(ierr);
     ierr = KSPGetPC(ksp,&pc);                                           CHKERRQ(ierr);
@@ -259,8 +310,54 @@ PetscErrorCode LinearElastic::setupKSP(KSP& ksp,PC& pc,Mat& A)
     ierr = PCFactorSetUpMatSolverPackage(pc);                           CHKERRQ(ierr); // old PETSc
   }
 
+  // low-precision LU from MUMPS, with iterative refinement to recover kspTol
+  else if (_activeLinSolver == "MUMPSLU_IR") {
+    Mat F;
+    ierr = KSPSetType(ksp,KSPRICHARDSON);                               CHKERRQ(ierr);
+    ierr = KSPSetInitialGuessNonzero(ksp,PETSC_TRUE);                   CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE);                   CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp,_kspTol,_kspTol,PETSC_DEFAULT,PETSC_DEFAULT); CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc);                                           CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCLU);                                          CHKERRQ(ierr);
+    //~ ierr = PCFactorSetMatSolverType(pc,MATSOLVERMUMPS);                 CHKERRQ(ierr); // new PETSc
+    //~ ierr = PCFactorSetUpMatSolverType(pc);                              CHKERRQ(ierr); // new PETSc
+    ierr = PCFactorSetMatSolverPackage(pc,MATSOLVERMUMPS);              CHKERRQ(ierr); // old PETSc
+    ierr = PCFactorSetUpMatSolverPackage(pc);                           CHKERRQ(ierr); // old PETSc
+    ierr = PCFactorGetMatrix(pc,&F);                                    CHKERRQ(ierr);
+    ierr = MatMumpsSetIcntl(F,35,1);                                    CHKERRQ(ierr); // enable BLR factorization
+    ierr = MatMumpsSetCntl(F,7,_factorTol);                             CHKERRQ(ierr); // BLR dropping tolerance
+  }
+
+  // low-precision Cholesky from MUMPS, used as preconditioner for conjugate gradient
+  else if (_activeLinSolver == "MUMPSCHOLESKY_IR") {
+    Mat F;
+    ierr = KSPSetType(ksp,KSPCG);                                       CHKERRQ(ierr);
+    ierr = KSPSetInitialGuessNonzero(ksp,PETSC_TRUE);                   CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE);                   CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp,_kspTol,_kspTol,PETSC_DEFAULT,PETSC_DEFAULT); CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc);                                           CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCCHOLESKY);                                    CHKERRQ(ierr);
+    //~ ierr = PCFactorSetMatSolverType(pc,MATSOLVERMUMPS);                 CHKERRQ(ierr); // new PETSc
+    //~ ierr = PCFactorSetUpMatSolverType(pc);                              CHKERRQ(ierr); // new PETSc
+    ierr = PCFactorSetMatSolverPackage(pc,MATSOLVERMUMPS);              CHKERRQ(ierr); // old PETSc
+    ierr = PCFactorSetUpMatSolverPackage(pc);                           CHKERRQ(ierr); // old PETSc
+    ierr = PCFactorGetMatrix(pc,&F);                                    CHKERRQ(ierr);
+    ierr = MatMumpsSetIcntl(F,35,1);                                    CHKERRQ(ierr); // enable BLR factorization
+    ierr = MatMumpsSetCntl(F,7,_factorTol);                             CHKERRQ(ierr); // BLR dropping tolerance
+  }
+
+  // separable direct solve, applied as a shell preconditioner
+  else if (_activeLinSolver == "SEPARABLE") {
+    ierr = KSPSetType(ksp,KSPPREONLY);                                  CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc);                                           CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCSHELL);                                       CHKERRQ(ierr);
+    ierr = PCShellSetContext(pc,_sep);                                  CHKERRQ(ierr);
+    ierr = PCShellSetApply(pc,SeparableSolver::applyPC);                CHKERRQ(ierr);
+    ierr = PCShellSetName(pc,"separable");                              CHKERRQ(ierr);
+  }
+
   // preconditioned conjugate gradient
-  else if (_linSolver == "CG") {
+  else if (_activeLinSolver == "CG") {
     ierr = KSPSetType(ksp,KSPCG);                                       CHKERRQ(ierr);
     ierr = KSPSetInitialGuessNonzero(ksp, PETSC_TRUE);                  CHKERRQ(ierr);
     ierr = KSPSetReusePreconditioner(ksp,PETSC_TRUE);                   CHKERRQ(ierr);
@@ -292,6 +389,57 @@ PetscErrorCode LinearElastic::setupKSP(KSP& ksp,PC& pc,Mat& A)
 }
 
 
+// set up the separable solver for depth-layered media
+// if the material or grid does not allow it, use MUMPSCHOLESKY for this operator
+PetscErrorCode LinearElastic::setupSeparableSolver(Mat& A)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "LinearElastic::setupSeparableSolver";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  double startTime = MPI_Wtime();
+  delete _sep;
+  _sep = NULL;
+
+  PetscBool isLayered = PETSC_FALSE;
+  if (_D->_gridSpacingType.compare("constantGridSpacing")==0 && _Ny > 1 && _Nz > 1) {
+    Vec muL;
+    ierr = VecDuplicate(_bcL,&muL); CHKERRQ(ierr);
+    ierr = SeparableSolver::isDepthLayered(_mu,_D->_scatters["body2L"],_Ny,muL,isLayered); CHKERRQ(ierr);
+    if (isLayered) {
+      _sep = new SeparableSolver(_order,_Ny,_Nz,_Ly,_Lz,muL,_D->_sbpCompatibilityType,
+        _bcRType,_bcTType,_bcLType,_bcBType);
+      ierr = _sep->setUp(); CHKERRQ(ierr);
+    }
+    VecDestroy(&muL);
+  }
+
+  // check against the assembled operator
+  if (_sep != NULL) {
+    PetscScalar relErr = 0;
+    ierr = _sep->verify(A,relErr); CHKERRQ(ierr);
+    if (relErr > 1e-8) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"WARNING: separable solver relative error %g exceeds 1e-8\n",relErr); CHKERRQ(ierr);
+      delete _sep;
+      _sep = NULL;
+    }
+  }
+
+  if (_sep == NULL) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"NOTE: linSolver SEPARABLE is not applicable, using MUMPSCHOLESKY instead\n"); CHKERRQ(ierr);
+    _activeLinSolver = "MUMPSCHOLESKY";
+  }
+  _factorTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
 // allocate space for member fields
 PetscErrorCode LinearElastic::allocateFields()
 {
@@ -475,6 +623,11 @@ PetscErrorCode LinearElastic::computeU()
   ierr = KSPSolve(_ksp,_rhs,_u); CHKERRQ(ierr);
   _linSolveTime += MPI_Wtime() - startTime;
   _linSolveCount++;
+  _stressesUpToDate = 0;
+
+  PetscInt its;
+  ierr = KSPGetIterationNumber(_ksp,&its); CHKERRQ(ierr);
+  _linSolveIts += its;
 
   ierr = setSurfDisp();
 
@@ -520,6 +673,10 @@ PetscErrorCode LinearElastic::changeBCTypes(string bcRTtype,string bcTTtype,stri
 
   // destroy current KSP context to reset
   KSPDestroy(&_ksp);
+  _bcRType = bcRTtype;
+  _bcTType = bcTTtype;
+  _bcLType = bcLTtype;
+  _bcBType = bcBTtype;
   _sbp->changeBCTypes(bcRTtype,bcTTtype,bcLTtype,bcBTtype);
 
   Mat A;
@@ -562,8 +719,12 @@ PetscErrorCode LinearElastic::view(const double totRunTime)
   ierr = PetscPrintf(PETSC_COMM_WORLD,"\n-------------------------------\n\n");CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"Linear Elastic Runtime Summary:\n"); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent creating matrices (s): %g\n",_matrixTime); CHKERRQ(ierr);
+  if (_activeLinSolver.compare("SEPARABLE")==0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent setting up separable solver (s): %g\n",_factorTime); CHKERRQ(ierr);
+  }
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent writing output (s): %g\n",_writeTime); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times linear system was solved: %i\n",_linSolveCount); CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   total number of linear solver iterations: %i\n",_linSolveIts); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent solving linear system (s): %g\n",_linSolveTime); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   %% time spent solving linear system: %g\n",_linSolveTime/totRunTime*100.); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   %% integration time spent solving linear system: %g\n",_linSolveTime/totRunTime*100.); CHKERRQ(ierr);
@@ -596,6 +757,11 @@ PetscErrorCode LinearElastic::writeContext(const string outputDir)
   // linear solve settings
   ierr = PetscViewerASCIIPrintf(viewer,"linSolver = %s\n",_linSolver.c_str());CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"kspTol = %.15e\n",_kspTol);CHKERRQ(ierr);
+  if (_linSolver.compare("MUMPSCHOLESKY_IR")==0 || _linSolver.compare("MUMPSLU_IR")==0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"factorTol = %.15e\n",_factorTol);CHKERRQ(ierr);
+  }
+
+  ierr = PetscViewerASCIIPrintf(viewer,"momBal_faultStressOnly = %i\n",_faultStressOnly);CHKERRQ(ierr);
 
   // boundary conditions
   ierr = PetscViewerASCIIPrintf(viewer,"bcR_type = %s\n",_bcRType.c_str());CHKERRQ(ierr);
@@ -666,6 +832,8 @@ PetscErrorCode LinearElastic::writeStep2D(PetscInt stepCount, const string outpu
   #endif
   double startTime = MPI_Wtime();
 
+  ierr = updateStresses(); CHKERRQ(ierr);
+
   if (_viewers2D.empty()) {
     initiate_appendVecToOutput(_viewers2D, "u", _u, outputDir + "momBal_u", _D->_outFileMode);
     initiate_appendVecToOutput(_viewers2D, "sxy", _sxy, outputDir + "momBal_sxy", _D->_outFileMode);
@@ -730,6 +898,8 @@ PetscErrorCode LinearElastic::computeStresses()
     ierr = computeSDev(); CHKERRQ(ierr);
   }
 
+  _stressesUpToDate = 1;
+
   #if VERBOSE > 1
     ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %\n",funcName.c_str(),FILENAME); CHKERRQ(ierr);
   #endif
@@ -738,6 +908,44 @@ PetscErrorCode LinearElastic::computeStresses()
 }
 
 
+// compute body stresses if they are out of date with respect to _u
+// (in fault-only mode they are skipped during time stepping)
+PetscErrorCode LinearElastic::updateStresses()
+{
+  PetscErrorCode ierr = 0;
+  if (!_stressesUpToDate) {
+    ierr = computeStresses(); CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+
+// shear stress on the fault (y=0)
+// if the body stresses are up to date this is a scatter, otherwise only
+// the y=0 rows of mu*Dy are applied to u
+PetscErrorCode LinearElastic::getFaultStress(Vec& sxyL)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "LinearElastic::getFaultStress()";
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME); CHKERRQ(ierr);
+  #endif
+
+  if (_stressesUpToDate) {
+    ierr = VecScatterBegin(_D->_scatters["body2L"], _sxy, sxyL, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+    ierr = VecScatterEnd(_D->_scatters["body2L"], _sxy, sxyL, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  }
+  else {
+    ierr = _sbp->muxDy_y0(_u,sxyL); CHKERRQ(ierr);
+  }
+
+  #if VERBOSE > 1
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME); CHKERRQ(ierr);
+  #endif
+  return ierr;
+}
+
+
 // computes sigmadev = sqrt(sigmaxy^2 + sigmaxz^2)
 PetscErrorCode LinearElastic::computeSDev()
 {
@@ -773,10 +981,12 @@ PetscErrorCode LinearElastic::computeSDev()
 // set stress pointers to calculated values
 PetscErrorCode LinearElastic::getStresses(Vec& sxy, Vec& sxz, Vec& sdev)
 {
+  PetscErrorCode ierr = 0;
+  ierr = updateStresses(); CHKERRQ(ierr);
   sxy = _sxy;
   sxz = _sxz;
   sdev = _sdev;
-  return 0;
+  return ierr;
 }
 
 
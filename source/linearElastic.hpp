@@ -13,6 +13,7 @@
 #include "sbpOps.hpp"
 #include "sbpOps_m_constGrid.hpp"
 #include "sbpOps_m_varGrid.hpp"
+#include "separableSolver.hpp"
 
 using namespace std;
 
@@ -41,14 +42,19 @@ public:
   Vec             _bcRShift,_surfDisp;
   Vec             _rhs,_u,_sxy,_sxz,_sdev;
   int             _computeSxz,_computeSdev; // 0 = no, 1 = yes
+  int             _faultStressOnly; // 1 = during time stepping only compute sxy on the fault, body stresses on demand
+  int             _stressesUpToDate; // 1 if _sxy, _sxz, _sdev correspond to the current _u
 
   // linear system data
   string          _linSolver;
+  string          _activeLinSolver; // solver in use: _linSolver, or MUMPSCHOLESKY if SEPARABLE is not applicable
   KSP             _ksp;
   PC              _pc;
   PetscScalar     _kspTol;
+  PetscScalar     _factorTol; // dropping tolerance for low-precision MUMPS factors (*_IR solvers)
   SbpOps         *_sbp;
   string          _sbpType;
+  SeparableSolver *_sep; // only used if linSolver = SEPARABLE
 
   // viewers for 1D and 2D fields
   // 1st string = key naming relevant field, e.g. "slip"
@@ -59,7 +65,7 @@ public:
 
   // runtime data
   double   _writeTime,_linSolveTime,_factorTime,_startTime,_miscTime, _matrixTime;
-  PetscInt _linSolveCount;
+  PetscInt _linSolveCount,_linSolveIts;
 
   // boundary conditions
   string _bcRType,_bcTType,_bcLType,_bcBType; // options: Dirichlet, Neumann
@@ -77,10 +83,13 @@ public:
   PetscErrorCode loadICsFromFiles();
   PetscErrorCode setUpSBPContext();
   PetscErrorCode setupKSP(KSP& ksp,PC& pc,Mat& A);
+  PetscErrorCode setupSeparableSolver(Mat& A); // falls back to MUMPSCHOLESKY if not applicable
 
   // time stepping function
   PetscErrorCode getStresses(Vec& sxy, Vec& sxz, Vec& sdev);
   PetscErrorCode computeStresses();
+  PetscErrorCode updateStresses(); // compute body stresses only if _u has changed since last computed
+  PetscErrorCode getFaultStress(Vec& sxyL); // sxy at y=0
   PetscErrorCode computeSDev();
   PetscErrorCode setSurfDisp();
   PetscErrorCode setRHS();
@@ -0,0 +1,118 @@
+#include "multirateScheduler.hpp"
+
+#define FILENAME "multirateScheduler.cpp"
+
+using namespace std;
+
+
+MultirateScheduler::MultirateScheduler(const string name,const PetscScalar tol)
+: _name(name),_tol(tol),_maxDeltaT(PETSC_MAX_REAL),_elapsed(0),
+  _haveRef(0),_numSteps(0),_numUpdates(0)
+{
+  assert(_tol >= 0);
+}
+
+MultirateScheduler::~MultirateScheduler()
+{
+  for (size_t c = 0; c < _integral.size(); c++) {
+    VecDestroy(&_integral[c]);
+    VecDestroy(&_avg[c]);
+    VecDestroy(&_ref[c]);
+  }
+}
+
+
+PetscErrorCode MultirateScheduler::allocate(const vector<Vec>& fields)
+{
+  PetscErrorCode ierr = 0;
+  _integral.resize(fields.size());
+  _avg.resize(fields.size());
+  _ref.resize(fields.size());
+  for (size_t c = 0; c < fields.size(); c++) {
+    ierr = VecDuplicate(fields[c],&_integral[c]); CHKERRQ(ierr);
+    ierr = VecDuplicate(fields[c],&_avg[c]); CHKERRQ(ierr);
+    ierr = VecDuplicate(fields[c],&_ref[c]); CHKERRQ(ierr);
+    ierr = VecSet(_integral[c],0.0); CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+
+PetscErrorCode MultirateScheduler::setMaxTimeStep(const PetscScalar maxDeltaT)
+{
+  assert(maxDeltaT > 0);
+  _maxDeltaT = maxDeltaT;
+  return 0;
+}
+
+
+// add contribution of a mechanical time step of size dt
+PetscErrorCode MultirateScheduler::accumulate(const PetscScalar dt,const vector<Vec>& fields)
+{
+  PetscErrorCode ierr = 0;
+  if (_integral.size() != fields.size()) { ierr = allocate(fields); CHKERRQ(ierr); }
+  for (size_t c = 0; c < fields.size(); c++) {
+    ierr = VecAXPY(_integral[c],dt,fields[c]); CHKERRQ(ierr);
+  }
+  _elapsed += dt;
+  _numSteps++;
+  return ierr;
+}
+
+
+// whether the slow field should be updated now
+PetscErrorCode MultirateScheduler::isDue(bool& isDue)
+{
+  PetscErrorCode ierr = 0;
+  isDue = 0;
+
+  if (!_haveRef || _elapsed >= _maxDeltaT) { isDue = 1; return ierr; }
+
+  // relative change in time-averaged coupling fields
+  for (size_t c = 0; c < _integral.size() && !isDue; c++) {
+    PetscScalar refNorm = 0, diffNorm = 0;
+    ierr = VecWAXPY(_avg[c],-_elapsed,_ref[c],_integral[c]); CHKERRQ(ierr);
+    ierr = VecNorm(_avg[c],NORM_INFINITY,&diffNorm); CHKERRQ(ierr);
+    ierr = VecNorm(_ref[c],NORM_INFINITY,&refNorm); CHKERRQ(ierr);
+    if (diffNorm > _tol * refNorm * _elapsed) { isDue = 1; }
+  }
+
+  return ierr;
+}
+
+
+// time average of coupling fields since last update
+PetscErrorCode MultirateScheduler::getAverage(vector<Vec>& avg)
+{
+  PetscErrorCode ierr = 0;
+  assert(_elapsed > 0);
+  for (size_t c = 0; c < _integral.size(); c++) {
+    ierr = VecCopy(_integral[c],_avg[c]); CHKERRQ(ierr);
+    ierr = VecScale(_avg[c],1.0/_elapsed); CHKERRQ(ierr);
+  }
+  avg = _avg;
+  return ierr;
+}
+
+
+// record that the slow field has been advanced to the current time
+PetscErrorCode MultirateScheduler::completeUpdate(const vector<Vec>& fields)
+{
+  PetscErrorCode ierr = 0;
+  for (size_t c = 0; c < fields.size(); c++) {
+    ierr = VecCopy(fields[c],_ref[c]); CHKERRQ(ierr);
+    ierr = VecSet(_integral[c],0.0); CHKERRQ(ierr);
+  }
+  _haveRef = 1;
+  _elapsed = 0;
+  _numUpdates++;
+  return ierr;
+}
+
+
+PetscErrorCode MultirateScheduler::view()
+{
+  PetscErrorCode ierr = 0;
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   %s: updated on %i of %i mechanical steps\n",_name.c_str(),_numUpdates,_numSteps);CHKERRQ(ierr);
+  return ierr;
+}
@@ -0,0 +1,67 @@
+#ifndef MULTIRATESCHEDULER_H_INCLUDED
+#define MULTIRATESCHEDULER_H_INCLUDED
+
+#include <petscksp.h>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <assert.h>
+
+using namespace std;
+
+/*
+ * Schedules the updates of a slowly evolving field (e.g. temperature or pore
+ * pressure) that is integrated implicitly alongside the mechanical problem.
+ * Rather than being advanced at every mechanical time step, the slow field is
+ * advanced by one backward Euler step covering all the mechanical steps since
+ * its last update, once either:
+ *    - the elapsed time reaches the field's own max time step, or
+ *    - the time average of the coupling fields (e.g. slip velocity, shear
+ *      stress) since the last update differs from their values at the last
+ *      update by more than tol, relative to the inf-norm of those values.
+ * The time-averaged coupling fields are then used as the source terms for the
+ * update.
+ *
+ * Example usage, at the end of each accepted mechanical step:
+ *    sched.accumulate(dt,couplingFields);
+ *    sched.isDue(isDue);
+ *    if (isDue) {
+ *      sched.getAverage(avgFields);
+ *      // advance slow field by sched._elapsed using avgFields
+ *      sched.completeUpdate(couplingFields);
+ *    }
+ *    else { // slow field is unchanged }
+ */
+
+class MultirateScheduler
+{
+private:
+  // disable default copy constructor and assignment operator
+  MultirateScheduler(const MultirateScheduler &that);
+  MultirateScheduler& operator=(const MultirateScheduler &rhs);
+
+  PetscErrorCode allocate(const vector<Vec>& fields);
+
+public:
+  const string      _name;
+  const PetscScalar _tol; // relative change in coupling fields that forces an update
+  PetscScalar       _maxDeltaT; // max time step for slow field
+  PetscScalar       _elapsed; // time since last update
+  vector<Vec>       _integral; // time integral of coupling fields since last update
+  vector<Vec>       _avg; // time average of coupling fields since last update
+  vector<Vec>       _ref; // coupling fields at last update
+  bool              _haveRef;
+  PetscInt          _numSteps,_numUpdates;
+
+  MultirateScheduler(const string name,const PetscScalar tol);
+  ~MultirateScheduler();
+
+  PetscErrorCode setMaxTimeStep(const PetscScalar maxDeltaT);
+  PetscErrorCode accumulate(const PetscScalar dt,const vector<Vec>& fields);
+  PetscErrorCode isDue(bool& isDue);
+  PetscErrorCode getAverage(vector<Vec>& avg);
+  PetscErrorCode completeUpdate(const vector<Vec>& fields);
+  PetscErrorCode view();
+};
+
+#endif
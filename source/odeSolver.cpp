@@ -6,7 +6,9 @@ using namespace std;
 OdeSolver::OdeSolver(PetscInt maxNumSteps, PetscReal finalT,PetscReal deltaT,string controlType)
 : _initT(0),_finalT(finalT),_currT(0),_deltaT(deltaT),_newDeltaT(deltaT),
   _maxNumSteps(maxNumSteps),_stepCount(0),_runTime(0),
-  _controlType(controlType),_normType("L2_absolute")
+  _controlType(controlType),_normType("L2_absolute"),_packedState(0),
+  _denseOutput(0),_prevT(0),
+  _eventDetection(0),_eventTol(1e-6),_eventVal(0),_numEvents(0)
 {
   #if VERBOSE > 1
     PetscPrintf(PETSC_COMM_WORLD,"Starting OdeSolver constructor in odeSolver.cpp.\n");
@@ -21,6 +23,16 @@ OdeSolver::OdeSolver(PetscInt maxNumSteps, PetscReal finalT,PetscReal deltaT,str
 }
 
 
+// destructor, frees storage for dense output
+OdeSolver::~OdeSolver()
+{
+  destroyVector(_varPrev);
+  destroyVector(_dvarPrev);
+  destroyVector(_varEv);
+  destroyVector(_dvarEv);
+}
+
+
 // if starting with a nonzero initial step count
 PetscErrorCode OdeSolver::setInitialStepCount(const PetscReal stepCount) {
   _stepCount = stepCount;
@@ -93,6 +105,201 @@ PetscErrorCode OdeSolver::setToleranceType(const string normType)
 
 
 
+// store integration variables and intermediate stages in contiguous Vecs
+PetscErrorCode OdeSolver::setPackedState(const bool packedState)
+{
+  _packedState = packedState;
+  return 0;
+}
+
+
+// keep the start of each accepted step so that y can be interpolated within it
+PetscErrorCode OdeSolver::setDenseOutput(const bool denseOutput)
+{
+  _denseOutput = denseOutput;
+  return 0;
+}
+
+
+// allocate storage for y and y' at the start of the step, same layout as _var
+PetscErrorCode OdeSolver::initDenseOutput()
+{
+  PetscErrorCode ierr = 0;
+  if (!_denseOutput) { return ierr; }
+
+  if (_packedState) {
+    ierr = createPackedMap(_varPrev,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_dvarPrev,_var);CHKERRQ(ierr);
+  }
+  else {
+    for (map<string,Vec>::iterator it=_var.begin(); it!=_var.end(); it++ ) {
+      Vec varPrev;
+      ierr = VecDuplicate(_var[it->first],&varPrev); CHKERRQ(ierr);
+      ierr = VecSet(varPrev,0.0); CHKERRQ(ierr);
+      _varPrev[it->first] = varPrev;
+
+      Vec dvarPrev;
+      ierr = VecDuplicate(_var[it->first],&dvarPrev); CHKERRQ(ierr);
+      ierr = VecSet(dvarPrev,0.0); CHKERRQ(ierr);
+      _dvarPrev[it->first] = dvarPrev;
+    }
+  }
+
+  // the event function is evaluated on unpacked copies
+  if (_eventDetection) {
+    for (map<string,Vec>::iterator it=_var.begin(); it!=_var.end(); it++ ) {
+      Vec varEv;
+      ierr = VecDuplicate(_var[it->first],&varEv); CHKERRQ(ierr);
+      ierr = VecSet(varEv,0.0); CHKERRQ(ierr);
+      _varEv[it->first] = varEv;
+
+      Vec dvarEv;
+      ierr = VecDuplicate(_var[it->first],&dvarEv); CHKERRQ(ierr);
+      ierr = VecSet(dvarEv,0.0); CHKERRQ(ierr);
+      _dvarEv[it->first] = dvarEv;
+    }
+  }
+  return ierr;
+}
+
+
+// store y and y' at _currT, called before the accepted step overwrites _var and _dvar
+PetscErrorCode OdeSolver::saveStepStart()
+{
+  PetscErrorCode ierr = 0;
+  _prevT = _currT;
+  ierr = mapCopy(_var,_varPrev);CHKERRQ(ierr);
+  ierr = mapCopy(_dvar,_dvarPrev);CHKERRQ(ierr);
+  return ierr;
+}
+
+
+// cubic Hermite interpolant through y and y' at both ends of the last accepted
+// step, with theta = (time - _prevT)/h:
+//   y(time) = y1 + h00*(y0 - y1) + h*h10*y0' + h*h11*y1'
+//   h00 = 2 theta^3 - 3 theta^2 + 1, h10 = theta^3 - 2 theta^2 + theta, h11 = theta^3 - theta^2
+// Must be called after the step has been accepted and _dvar updated to y1',
+// i.e. from timeMonitor. out must have the same keys as _var.
+PetscErrorCode OdeSolver::interpolate(const PetscReal time, map<string,Vec>& out)
+{
+  PetscErrorCode ierr = 0;
+  if (!_denseOutput || _varPrev.size() == 0) {
+    PetscPrintf(PETSC_COMM_WORLD,"ERROR: interpolate requires setDenseOutput(true) and RK32, RK43, RK54, or RK65.\n");
+    assert(0);
+  }
+
+  const PetscReal h = _currT - _prevT;
+  if (h <= 0) {
+    ierr = mapCopy(_var,out);CHKERRQ(ierr);
+    return ierr;
+  }
+
+  const PetscReal th = (time - _prevT)/h;
+  const PetscReal h00 = (2.0*th - 3.0)*th*th + 1.0;
+  const PetscReal h10 = ((th - 2.0)*th + 1.0)*th;
+  const PetscReal h11 = (th - 1.0)*th*th;
+  ierr = mapWMAXPY(out,_var,{h00,-h00,h*h10,h*h11},{&_varPrev,&_var,&_dvarPrev,&_dvar});CHKERRQ(ierr);
+
+  return ierr;
+}
+
+
+// derivative of the cubic Hermite interpolant
+//   y'(time) = (dh00/h)*(y0 - y1) + dh10*y0' + dh11*y1'
+PetscErrorCode OdeSolver::interpolateRate(const PetscReal time, map<string,Vec>& out)
+{
+  PetscErrorCode ierr = 0;
+  if (!_denseOutput || _varPrev.size() == 0) {
+    PetscPrintf(PETSC_COMM_WORLD,"ERROR: interpolateRate requires setDenseOutput(true) and RK32, RK43, RK54, or RK65.\n");
+    assert(0);
+  }
+
+  const PetscReal h = _currT - _prevT;
+  if (h <= 0) {
+    ierr = mapCopy(_dvar,out);CHKERRQ(ierr);
+    return ierr;
+  }
+
+  const PetscReal th = (time - _prevT)/h;
+  const PetscReal dh00 = 6.0*(th - 1.0)*th;
+  const PetscReal dh10 = (3.0*th - 4.0)*th + 1.0;
+  const PetscReal dh11 = (3.0*th - 2.0)*th;
+  ierr = mapSet(out,0.0);CHKERRQ(ierr);
+  ierr = mapWMAXPY(out,out,{dh00/h,-dh00/h,dh10,dh11},{&_varPrev,&_var,&_dvarPrev,&_dvar});CHKERRQ(ierr);
+
+  return ierr;
+}
+
+
+// event detection uses the dense output interpolant
+PetscErrorCode OdeSolver::setEventDetection(const bool eventDetection,const PetscReal eventTol)
+{
+  _eventDetection = eventDetection;
+  _eventTol = eventTol;
+  if (_eventDetection) { _denseOutput = 1; }
+  return 0;
+}
+
+
+// If the event function went from g <= 0 to g > 0 over the last accepted
+// step, locate the crossing with the Illinois variant of regula falsi on the
+// interpolant, and end the step at the upper end of the final bracket, so
+// that g > 0 at the new _currT.
+PetscErrorCode OdeSolver::locateEvent(IntegratorContextEx *obj)
+{
+  PetscErrorCode ierr = 0;
+
+  PetscScalar gb = 0;
+  ierr = obj->eventFunction(_currT,_var,_dvar,gb);CHKERRQ(ierr);
+  if (_eventVal > 0 || gb <= 0) {
+    _eventVal = gb;
+    return ierr;
+  }
+
+  PetscReal a = _prevT, b = _currT;
+  PetscScalar ga = _eventVal;
+  const PetscReal tol = _eventTol*(_currT - _prevT);
+  int side = 0;
+  for (PetscInt it = 0; it < 100 && b - a > tol; it++) {
+    PetscReal t = b - gb*(b - a)/(gb - ga);
+    if (!(t > a && t < b)) { t = 0.5*(a + b); }
+
+    PetscScalar g = 0;
+    ierr = interpolate(t,_varEv);CHKERRQ(ierr);
+    ierr = interpolateRate(t,_dvarEv);CHKERRQ(ierr);
+    ierr = obj->eventFunction(t,_varEv,_dvarEv,g);CHKERRQ(ierr);
+
+    // halve the value at an end point kept twice in a row
+    if (g > 0) {
+      b = t; gb = g;
+      if (side == 1) { ga *= 0.5; }
+      side = 1;
+    }
+    else {
+      a = t; ga = g;
+      if (side == -1) { gb *= 0.5; }
+      side = -1;
+    }
+  }
+
+  // land the step on the event
+  if (b < _currT) {
+    ierr = interpolate(b,_varEv);CHKERRQ(ierr);
+    ierr = mapCopy(_varEv,_var);CHKERRQ(ierr);
+    _deltaT = b - _prevT;
+    _currT = b;
+    ierr = mapSet(_dvar,0.0);CHKERRQ(ierr);
+    ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr);
+    ierr = obj->eventFunction(_currT,_var,_dvar,gb);CHKERRQ(ierr);
+  }
+  _eventVal = gb;
+  _numEvents++;
+
+  return ierr;
+}
+
+
+
 //================= FEuler child class functions =======================
 
 // constructor, initializes same object as OdeSolver
@@ -282,6 +489,9 @@ PetscErrorCode RK32::view()
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of rejected steps: %i\n",_numRejectedSteps);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times min step size enforced: %i\n",_numMinSteps);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times max step size enforced: %i\n",_numMaxSteps);CHKERRQ(ierr);
+  if (_eventDetection) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of located events: %i\n",_numEvents);CHKERRQ(ierr);
+  }
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   total run time: %g\n",_runTime);CHKERRQ(ierr);
 
   return 0;
@@ -308,42 +518,54 @@ PetscErrorCode RK32::setInitialConds(map<string,Vec>& var)
   _var = var; // shallow copy
 
   // initialize RK vectors to zero
-  for (map<string,Vec>::iterator it=var.begin(); it!=var.end(); it++ ) {
-    Vec dvar;
-    ierr = VecDuplicate(_var[it->first],&dvar); CHKERRQ(ierr);
-    ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
-    _dvar[it->first] = dvar;
-
-    Vec varHalfdT;
-    ierr = VecDuplicate(_var[it->first],&varHalfdT); CHKERRQ(ierr);
-    ierr = VecSet(varHalfdT,0.0); CHKERRQ(ierr);
-    _k1[it->first] = varHalfdT;
-
-    Vec dvarHalfdT;
-    ierr = VecDuplicate(_var[it->first],&dvarHalfdT); CHKERRQ(ierr);
-    ierr = VecSet(dvarHalfdT,0.0); CHKERRQ(ierr);
-    _f1[it->first] = dvarHalfdT;
-
-    Vec vardT;
-    ierr = VecDuplicate(_var[it->first],&vardT); CHKERRQ(ierr);
-    ierr = VecSet(vardT,0.0); CHKERRQ(ierr);
-    _k2[it->first] = vardT;
-
-    Vec dvardT;
-    ierr = VecDuplicate(_var[it->first],&dvardT); CHKERRQ(ierr);
-    ierr = VecSet(dvardT,0.0); CHKERRQ(ierr);
-    _f2[it->first] = dvardT;
-
-    Vec y2;
-    ierr = VecDuplicate(_var[it->first],&y2); CHKERRQ(ierr);
-    ierr = VecSet(y2,0.0); CHKERRQ(ierr);
-    _y2[it->first] = y2;
-
-    Vec y3;
-    ierr = VecDuplicate(_var[it->first],&y3); CHKERRQ(ierr);
-    ierr = VecSet(y3,0.0); CHKERRQ(ierr);
-    _y3[it->first] = y3;
+  if (_packedState) {
+    ierr = createPackedMap(_dvar,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_k1,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_f1,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_k2,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_f2,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_y2,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_y3,_var);CHKERRQ(ierr);
+  }
+  else {
+    for (map<string,Vec>::iterator it=var.begin(); it!=var.end(); it++ ) {
+      Vec dvar;
+      ierr = VecDuplicate(_var[it->first],&dvar); CHKERRQ(ierr);
+      ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
+      _dvar[it->first] = dvar;
+
+      Vec varHalfdT;
+      ierr = VecDuplicate(_var[it->first],&varHalfdT); CHKERRQ(ierr);
+      ierr = VecSet(varHalfdT,0.0); CHKERRQ(ierr);
+      _k1[it->first] = varHalfdT;
+
+      Vec dvarHalfdT;
+      ierr = VecDuplicate(_var[it->first],&dvarHalfdT); CHKERRQ(ierr);
+      ierr = VecSet(dvarHalfdT,0.0); CHKERRQ(ierr);
+      _f1[it->first] = dvarHalfdT;
+
+      Vec vardT;
+      ierr = VecDuplicate(_var[it->first],&vardT); CHKERRQ(ierr);
+      ierr = VecSet(vardT,0.0); CHKERRQ(ierr);
+      _k2[it->first] = vardT;
+
+      Vec dvardT;
+      ierr = VecDuplicate(_var[it->first],&dvardT); CHKERRQ(ierr);
+      ierr = VecSet(dvardT,0.0); CHKERRQ(ierr);
+      _f2[it->first] = dvardT;
+
+      Vec y2;
+      ierr = VecDuplicate(_var[it->first],&y2); CHKERRQ(ierr);
+      ierr = VecSet(y2,0.0); CHKERRQ(ierr);
+      _y2[it->first] = y2;
+
+      Vec y3;
+      ierr = VecDuplicate(_var[it->first],&y3); CHKERRQ(ierr);
+      ierr = VecSet(y3,0.0); CHKERRQ(ierr);
+      _y3[it->first] = y3;
+    }
   }
+  ierr = initDenseOutput();CHKERRQ(ierr);
 
   _runTime += MPI_Wtime() - startTime;
 
@@ -452,52 +674,16 @@ PetscReal RK32::computeError()
     PetscPrintf(PETSC_COMM_WORLD,"Starting RK32::computeError in odeSolver.cpp.\n");
   #endif
 
-  PetscErrorCode ierr = 0;
-  PetscScalar err = 0, _totErr = 0;
-
-  // if using absolute error for control
-  // error: the absolute L2 error, weighted by N and a user-inputted scale factor
-  // tolerance: the absolute tolerance
-  if (_normType.compare("L2_absolute")==0) {
-    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
-      string key = _errInds[i];
-      Vec errVec;
-      VecDuplicate(_y3[key],&errVec);
-      VecSet(errVec,0.0);
-      ierr = VecWAXPY(errVec,-1.0,_y3[key],_y2[key]); CHKERRQ(ierr);
-      VecNorm(errVec,NORM_2,&err);
-      VecDestroy(&errVec);
-
-      PetscInt N = 0;
-      VecGetSize(_y3[key],&N);
-      _totErr += err / (sqrt(N) * _scale[i]);
-    }
-  }
-
-  // if using relative error for control
-  // error: the absolute L2 error, scaled by the L2 norm of the solution and a user-inputted scale factor
-  // tolerance: the relative tolerance
-  if (_normType.compare("L2_relative")==0) {
-    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
-      string key = _errInds[i];
-      Vec errVec;
-      VecDuplicate(_y3[key],&errVec);
-      VecSet(errVec,0.0);
-      ierr = VecWAXPY(errVec,-1.0,_y3[key],_y2[key]); CHKERRQ(ierr);
-      VecNorm(errVec,NORM_2,&err);
-      VecDestroy(&errVec);
-
-      PetscReal s = 0;
-      VecNorm(_y3[key],NORM_2,&s);
-      _totErr += err / (s * _scale[i]);
-    }
-  }
+  // error: the L2 norm of y2 - y3, weighted by N (L2_absolute) or by the L2 norm
+  // of the solution (L2_relative), and a user-inputted scale factor
+  PetscScalar totErr = 0;
+  PetscErrorCode ierr = mapErrorNorm(totErr,_y2,&_y3,_y3,_errInds,_scale,_normType);CHKERRQ(ierr);
 
   #if VERBOSE > 1
     PetscPrintf(PETSC_COMM_WORLD,"Ending RK32::computeError in odeSolver.cpp.\n");
   #endif
 
-  return _totErr;
+  return totErr;
 }
 
 
@@ -512,6 +698,7 @@ PetscErrorCode RK32::integrate(IntegratorContextEx *obj)
   PetscErrorCode ierr = 0;
   PetscScalar    _totErr = 0;
   PetscInt       attemptCount = 0;
+  PetscScalar    ctxErr = 0; // error reported by the context for the attempted step
   int            stopIntegration = 0;
 
   // build default errInds if it hasn't been defined already
@@ -542,8 +729,12 @@ PetscErrorCode RK32::integrate(IntegratorContextEx *obj)
   else if (_deltaT==0) { _deltaT = (_finalT-_initT)/_maxNumSteps; }
   if (_maxNumSteps == 0) { return ierr; }
 
+  // share storage of the integration variables with the packed stages
+  if (_packedState) { ierr = placePackedMap(_var);CHKERRQ(ierr); }
+
   // set initial condition
   ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr);
+  if (_eventDetection) { ierr = obj->eventFunction(_currT,_var,_dvar,_eventVal);CHKERRQ(ierr); }
   //~ ierr = obj->timeMonitor(_currT,_deltaT,_stepCount,stopIntegration); CHKERRQ(ierr);
 
   // perform time stepping routine and calling d_dt
@@ -557,53 +748,44 @@ PetscErrorCode RK32::integrate(IntegratorContextEx *obj)
       //~ierr = PetscPrintf(PETSC_COMM_WORLD,"   attemptCount=%i\n",attemptCount);CHKERRQ(ierr);
       if (_currT+_deltaT>_finalT) { _deltaT=_finalT-_currT; }
 
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        VecSet(_k1[it->first],0.0); VecSet(_f1[it->first],0.0);
-        VecSet(_k2[it->first],0.0);     VecSet(_f2[it->first],0.0);
-        VecSet(_y2[it->first],0.0);
-        VecSet(_y3[it->first],0.0);
-      }
+      ierr = mapSet(_f1,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f2,0.0);CHKERRQ(ierr);
 
       // stage 1: integrate fields to _currT + 0.5*deltaT
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        ierr = VecWAXPY(_k1[it->first],0.5*_deltaT,_dvar[it->first],_var[it->first]);CHKERRQ(ierr);
-      }
+      ierr = mapWAXPY(_k1,0.5*_deltaT,_dvar,_var);CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+0.5*_deltaT,_k1,_f1);CHKERRQ(ierr);
 
       // stage 2: integrate fields to _currT + _deltaT
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        ierr = VecWAXPY(_k2[it->first],-_deltaT,_dvar[it->first],_var[it->first]);CHKERRQ(ierr);
-        ierr = VecAXPY(_k2[it->first],2*_deltaT,_f1[it->first]);CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k2,_var,{-_deltaT,2*_deltaT},{&_dvar,&_f1});CHKERRQ(ierr);
+      ierr = obj->beginLastStage();CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+_deltaT,_k2,_f2);CHKERRQ(ierr);
 
       // 2nd and 3rd order update
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        ierr = VecWAXPY(_y2[it->first],0.5*_deltaT,_dvar[it->first],_var[it->first]);CHKERRQ(ierr);
-        ierr = VecAXPY(_y2[it->first],0.5*_deltaT,_f2[it->first]);CHKERRQ(ierr);
-
-        ierr = VecWAXPY(_y3[it->first],_deltaT/6.0,_dvar[it->first],_var[it->first]);CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],2*_deltaT/3.0,_f1[it->first]);CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],_deltaT/6.0,_f2[it->first]);CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_y2,_var,{0.5*_deltaT,0.5*_deltaT},{&_dvar,&_f2});CHKERRQ(ierr);
+      ierr = mapWMAXPY(_y3,_var,{_deltaT/6.0,2*_deltaT/3.0,_deltaT/6.0},{&_dvar,&_f1,&_f2});CHKERRQ(ierr);
 
-      // calculate error
-      _totErr = computeError();
+      // calculate error, including any error the context reports for the step
+      ierr = obj->stepError(ctxErr);CHKERRQ(ierr);
+      _totErr = computeError() + ctxErr*_totTol;
       if (_totErr <= _totTol) { break; }
       _deltaT = computeStepSize(_totErr);
       if (_minDeltaT == _deltaT) { break; }
 
+      ierr = obj->stepRejected();CHKERRQ(ierr);
       _numRejectedSteps++;
     }
 
     // accept 3rd order solution as update
+    if (_denseOutput) { ierr = saveStepStart();CHKERRQ(ierr); }
     _currT = _currT+_deltaT;
-    for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-      ierr = VecCopy(_y3[it->first],_var[it->first]);CHKERRQ(ierr);
-      VecSet(_dvar[it->first],0.0);
-    }
+    ierr = mapCopy(_y3,_var);CHKERRQ(ierr);
+    ierr = obj->stepAccepted(false);CHKERRQ(ierr);
+    ierr = mapSet(_dvar,0.0);CHKERRQ(ierr);
     ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr);
 
+    // end the step early if an event occurred during it
+    if (_eventDetection) { ierr = locateEvent(obj);CHKERRQ(ierr); }
+
     // compute new deltaT for next time step
     // but timeMonitor before updating to newDeltaT, to keep output consistent while allowing for checkpointing
     if (_totErr!=0.0) { _newDeltaT = computeStepSize(_totErr); }
@@ -617,6 +799,8 @@ PetscErrorCode RK32::integrate(IntegratorContextEx *obj)
     _deltaT = _newDeltaT;
   }
 
+  if (_packedState) { ierr = resetPackedMap(_var);CHKERRQ(ierr); }
+
   _runTime += MPI_Wtime() - startTime;
 
   #if VERBOSE > 1
@@ -703,6 +887,9 @@ PetscErrorCode RK43::view()
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of rejected steps: %i\n",_numRejectedSteps);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times min step size enforced: %i\n",_numMinSteps);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times max step size enforced: %i\n",_numMaxSteps);CHKERRQ(ierr);
+  if (_eventDetection) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of located events: %i\n",_numEvents);CHKERRQ(ierr);
+  }
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   total run time: %g\n",_runTime);CHKERRQ(ierr);
   return 0;
 }
@@ -729,72 +916,90 @@ PetscErrorCode RK43::setInitialConds(map<string,Vec>& var)
 
   // initialize _dvar and various RK43 intermediate vectors to zero
   // only doing shallow copies
-  for (map<string,Vec>::iterator it=var.begin(); it!=var.end(); it++ ) {
-    Vec dvar;
-    ierr = VecDuplicate(_var[it->first],&dvar); CHKERRQ(ierr);
-    ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
-    _dvar[it->first] = dvar;
-
-    Vec f2;
-    ierr = VecDuplicate(_var[it->first],&f2); CHKERRQ(ierr);
-    ierr = VecSet(f2,0.0); CHKERRQ(ierr);
-    _f2[it->first] = f2;
-
-    Vec f3;
-    ierr = VecDuplicate(_var[it->first],&f3); CHKERRQ(ierr);
-    ierr = VecSet(f3,0.0); CHKERRQ(ierr);
-    _f3[it->first] = f3;
-
-    Vec f4;
-    ierr = VecDuplicate(_var[it->first],&f4); CHKERRQ(ierr);
-    ierr = VecSet(f4,0.0); CHKERRQ(ierr);
-    _f4[it->first] = f4;
-
-    Vec f5;
-    ierr = VecDuplicate(_var[it->first],&f5); CHKERRQ(ierr);
-    ierr = VecSet(f5,0.0); CHKERRQ(ierr);
-    _f5[it->first] = f5;
-
-    Vec f6;
-    ierr = VecDuplicate(_var[it->first],&f6); CHKERRQ(ierr);
-    ierr = VecSet(f6,0.0); CHKERRQ(ierr);
-    _f6[it->first] = f6;
-
-    Vec k2;
-    ierr = VecDuplicate(_var[it->first],&k2); CHKERRQ(ierr);
-    ierr = VecSet(k2,0.0); CHKERRQ(ierr);
-    _k2[it->first] = k2;
-
-    Vec k3;
-    ierr = VecDuplicate(_var[it->first],&k3); CHKERRQ(ierr);
-    ierr = VecSet(k3,0.0); CHKERRQ(ierr);
-    _k3[it->first] = k3;
-
-    Vec k4;
-    ierr = VecDuplicate(_var[it->first],&k4); CHKERRQ(ierr);
-    ierr = VecSet(k4,0.0); CHKERRQ(ierr);
-    _k4[it->first] = k4;
-
-    Vec k5;
-    ierr = VecDuplicate(_var[it->first],&k5); CHKERRQ(ierr);
-    ierr = VecSet(k5,0.0); CHKERRQ(ierr);
-    _k5[it->first] = k5;
-
-    Vec k6;
-    ierr = VecDuplicate(_var[it->first],&k6); CHKERRQ(ierr);
-    ierr = VecSet(k6,0.0); CHKERRQ(ierr);
-    _k6[it->first] = k6;
-
-    Vec y3;
-    ierr = VecDuplicate(_var[it->first],&y3); CHKERRQ(ierr);
-    ierr = VecSet(y3,0.0); CHKERRQ(ierr);
-    _y3[it->first] = y3;
-
-    Vec y4;
-    ierr = VecDuplicate(_var[it->first],&y4); CHKERRQ(ierr);
-    ierr = VecSet(y4,0.0); CHKERRQ(ierr);
-    _y4[it->first] = y4;
+  if (_packedState) {
+    ierr = createPackedMap(_dvar,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_f2,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_f3,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_f4,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_f5,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_f6,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_k2,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_k3,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_k4,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_k5,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_k6,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_y3,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_y4,_var);CHKERRQ(ierr);
+  }
+  else {
+    for (map<string,Vec>::iterator it=var.begin(); it!=var.end(); it++ ) {
+      Vec dvar;
+      ierr = VecDuplicate(_var[it->first],&dvar); CHKERRQ(ierr);
+      ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
+      _dvar[it->first] = dvar;
+
+      Vec f2;
+      ierr = VecDuplicate(_var[it->first],&f2); CHKERRQ(ierr);
+      ierr = VecSet(f2,0.0); CHKERRQ(ierr);
+      _f2[it->first] = f2;
+
+      Vec f3;
+      ierr = VecDuplicate(_var[it->first],&f3); CHKERRQ(ierr);
+      ierr = VecSet(f3,0.0); CHKERRQ(ierr);
+      _f3[it->first] = f3;
+
+      Vec f4;
+      ierr = VecDuplicate(_var[it->first],&f4); CHKERRQ(ierr);
+      ierr = VecSet(f4,0.0); CHKERRQ(ierr);
+      _f4[it->first] = f4;
+
+      Vec f5;
+      ierr = VecDuplicate(_var[it->first],&f5); CHKERRQ(ierr);
+      ierr = VecSet(f5,0.0); CHKERRQ(ierr);
+      _f5[it->first] = f5;
+
+      Vec f6;
+      ierr = VecDuplicate(_var[it->first],&f6); CHKERRQ(ierr);
+      ierr = VecSet(f6,0.0); CHKERRQ(ierr);
+      _f6[it->first] = f6;
+
+      Vec k2;
+      ierr = VecDuplicate(_var[it->first],&k2); CHKERRQ(ierr);
+      ierr = VecSet(k2,0.0); CHKERRQ(ierr);
+      _k2[it->first] = k2;
+
+      Vec k3;
+      ierr = VecDuplicate(_var[it->first],&k3); CHKERRQ(ierr);
+      ierr = VecSet(k3,0.0); CHKERRQ(ierr);
+      _k3[it->first] = k3;
+
+      Vec k4;
+      ierr = VecDuplicate(_var[it->first],&k4); CHKERRQ(ierr);
+      ierr = VecSet(k4,0.0); CHKERRQ(ierr);
+      _k4[it->first] = k4;
+
+      Vec k5;
+      ierr = VecDuplicate(_var[it->first],&k5); CHKERRQ(ierr);
+      ierr = VecSet(k5,0.0); CHKERRQ(ierr);
+      _k5[it->first] = k5;
+
+      Vec k6;
+      ierr = VecDuplicate(_var[it->first],&k6); CHKERRQ(ierr);
+      ierr = VecSet(k6,0.0); CHKERRQ(ierr);
+      _k6[it->first] = k6;
+
+      Vec y3;
+      ierr = VecDuplicate(_var[it->first],&y3); CHKERRQ(ierr);
+      ierr = VecSet(y3,0.0); CHKERRQ(ierr);
+      _y3[it->first] = y3;
+
+      Vec y4;
+      ierr = VecDuplicate(_var[it->first],&y4); CHKERRQ(ierr);
+      ierr = VecSet(y4,0.0); CHKERRQ(ierr);
+      _y4[it->first] = y4;
+    }
   }
+  ierr = initDenseOutput();CHKERRQ(ierr);
 
   _runTime += MPI_Wtime() - startTime;
 
@@ -905,67 +1110,17 @@ PetscReal RK43::computeError()
     PetscPrintf(PETSC_COMM_WORLD,"Starting RK43::computeError in odeSolver.cpp.\n");
   #endif
 
-  PetscErrorCode ierr = 0;
-  PetscScalar err = 0, _totErr = 0;
-
-  // if using absolute error for control
-  // error: the absolute L2 error, weighted by N and a user-inputted scale factor
-  // tolerance: the absolute tolerance
-  if (_normType.compare("L2_absolute")==0) {
-    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
-      string key = _errInds[i];
-      Vec errVec;
-      VecDuplicate(_y3[key],&errVec);
-      VecSet(errVec,0.0);
-      ierr = VecWAXPY(errVec,-1.0,_y4[key],_y3[key]); CHKERRQ(ierr);
-      VecNorm(errVec,NORM_2,&err);
-      VecDestroy(&errVec);
-
-      PetscInt N = 0;
-      VecGetSize(_y4[key],&N);
-      _totErr += err / (sqrt(N) * _scale[i]);
-    }
-  }
-
-  // if using relative error for control
-  // error: the absolute L2 error, scaled by the L2 norm of the solution and a user-inputted scale factor
-  // tolerance: the relative tolerance
-  //~ if (_normType.compare("L2_relative")==0) {
-    //~ for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
-      //~ string key = _errInds[i];
-      //~ Vec errVec;
-      //~ VecDuplicate(_y3[key],&errVec);
-      //~ VecSet(errVec,0.0);
-      //~ ierr = VecWAXPY(errVec,-1.0,_y4[key],_y3[key]); CHKERRQ(ierr);
-      //~ VecNorm(errVec,NORM_2,&err);
-      //~ VecDestroy(&errVec);
-      //~ PetscReal s = 0;
-      //~ VecNorm(_y4[key],NORM_2,&s);
-      //~ _totErr += err / (s * _scale[i]);
-    //~ }
-  //~ }
-
-  if (_normType.compare("L2_relative")==0) {
-    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
-      string key = _errInds[i];
-      Vec errVec;
-      VecDuplicate(_y3[key],&errVec);
-      VecSet(errVec,0.0);
-      ierr = VecWAXPY(errVec,-1.0,_y4[key],_y3[key]); CHKERRQ(ierr);
-      VecAbs(errVec);
-      VecPointwiseDivide(errVec,errVec,_y4[key]);
-      PetscReal maxV = 0;
-      VecMax(errVec,NULL,&err);
-      assert(!isinf(err));
-      _totErr += err / (_scale[i]);
-    }
-  }
+  // error: the L2 norm of y3 - y4 weighted by N (L2_absolute), or the max
+  // pointwise error relative to the solution (L2_relative), and a user-inputted scale factor
+  PetscScalar totErr = 0;
+  string normType = _normType.compare("L2_relative")==0 ? "max_relative" : _normType;
+  PetscErrorCode ierr = mapErrorNorm(totErr,_y3,&_y4,_y4,_errInds,_scale,normType);CHKERRQ(ierr);
 
   #if VERBOSE > 1
     PetscPrintf(PETSC_COMM_WORLD,"Ending RK43::computeError in odeSolver.cpp.\n");
   #endif
 
-  return _totErr;
+  return totErr;
 }
 
 
@@ -980,6 +1135,7 @@ PetscErrorCode RK43::integrate(IntegratorContextEx *obj)
   PetscErrorCode  ierr = 0;
   PetscScalar    _totErr = 0;
   PetscInt       attemptCount = 0;
+  PetscScalar    ctxErr = 0; // error reported by the context for the attempted step
   int            stopIntegration = 0;
 
   // coefficients
@@ -1050,8 +1206,12 @@ PetscErrorCode RK43::integrate(IntegratorContextEx *obj)
   if (_deltaT == 0) { _deltaT = (_finalT - _initT) / _maxNumSteps; }
   if (_maxNumSteps == 0) { return ierr; }
 
+  // share storage of the integration variables with the packed stages
+  if (_packedState) { ierr = placePackedMap(_var);CHKERRQ(ierr); }
+
   // set initial condition
   ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr);
+  if (_eventDetection) { ierr = obj->eventFunction(_currT,_var,_dvar,_eventVal);CHKERRQ(ierr); }
   //~ ierr = obj->timeMonitor(_currT,_deltaT,_stepCount,stopIntegration); CHKERRQ(ierr);
 
   // perform time stepping
@@ -1064,93 +1224,62 @@ PetscErrorCode RK43::integrate(IntegratorContextEx *obj)
 
       if (_currT + _deltaT > _finalT) { _deltaT = _finalT - _currT; }
 
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        VecSet(_k2[it->first],0.0);
-        VecSet(_k3[it->first],0.0); VecSet(_k4[it->first],0.0);
-        VecSet(_k5[it->first],0.0); VecSet(_k6[it->first],0.0);
-        VecSet(_f2[it->first],0.0);
-        VecSet(_f3[it->first],0.0); VecSet(_f4[it->first],0.0);
-        VecSet(_f5[it->first],0.0); VecSet(_f6[it->first],0.0);
-      }
+      ierr = mapSet(_f2,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f3,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f4,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f5,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f6,0.0);CHKERRQ(ierr);
 
       // stage 1: k1 = var, compute f1 = f(k1) = dvar
       _f1 = _dvar;
 
       // stage 2: compute k2
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        ierr = VecWAXPY(_k2[it->first],a21*_deltaT,_f1[it->first],_var[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWAXPY(_k2,a21*_deltaT,_f1,_var);CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c2*_deltaT,_k2,_f2);CHKERRQ(ierr);
 
       // stage 3: compute k3
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        ierr = VecWAXPY(_k3[it->first],a31*_deltaT,_f1[it->first],_var[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_k3[it->first],a32*_deltaT,_f2[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k3,_var,{a31*_deltaT,a32*_deltaT},{&_f1,&_f2});CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c3*_deltaT,_k3,_f3);CHKERRQ(ierr);
 
       // stage 4
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        ierr = VecWAXPY(_k4[it->first],a41*_deltaT,_f1[it->first],_var[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k4[it->first],a42*_deltaT,_f2[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k4[it->first],a43*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k4,_var,{a41*_deltaT,a42*_deltaT,a43*_deltaT},{&_f1,&_f2,&_f3});CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c4*_deltaT,_k4,_f4);CHKERRQ(ierr);
 
       // stage 5
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        ierr = VecWAXPY(_k5[it->first],a51*_deltaT,_f1[it->first],_var[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k5[it->first],a52*_deltaT,_f2[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k5[it->first],a53*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k5[it->first],a54*_deltaT,_f4[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k5,_var,{a51*_deltaT,a52*_deltaT,a53*_deltaT,a54*_deltaT},{&_f1,&_f2,&_f3,&_f4});CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c5*_deltaT,_k5,_f5);CHKERRQ(ierr);
 
       // stage 6
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        ierr = VecWAXPY(_k6[it->first],a61*_deltaT,_f1[it->first],_var[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k6[it->first],a62*_deltaT,_f2[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k6[it->first],a63*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k6[it->first],a64*_deltaT,_f4[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k6[it->first],a65*_deltaT,_f5[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k6,_var,{a61*_deltaT,a62*_deltaT,a63*_deltaT,a64*_deltaT,a65*_deltaT},{&_f1,&_f2,&_f3,&_f4,&_f5});CHKERRQ(ierr);
+      ierr = obj->beginLastStage();CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c6*_deltaT,_k6,_f6);CHKERRQ(ierr);
 
-      // 3rd and 4th order updates
-      for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-        ierr = VecWAXPY(_y3[it->first],hb1*_deltaT,_f1[it->first],_var[it->first]); CHKERRQ(ierr);
-        //~ ierr = VecAXPY(_y3[it->first],hb2*_deltaT,_f2[it->first]); CHKERRQ(ierr); // hb2 = 0
-        ierr = VecAXPY(_y3[it->first],hb3*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],hb4*_deltaT,_f4[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],hb5*_deltaT,_f5[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],hb6*_deltaT,_f6[it->first]); CHKERRQ(ierr);
-
-
-        ierr = VecWAXPY(_y4[it->first],b1*_deltaT,_f1[it->first],_var[it->first]); CHKERRQ(ierr);
-        //~ ierr = VecAXPY(_y4[it->first],b2*_deltaT,_f2[it->first]); CHKERRQ(ierr); // b2 = 0
-        ierr = VecAXPY(_y4[it->first],b3*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y4[it->first],b4*_deltaT,_f4[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y4[it->first],b5*_deltaT,_f5[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y4[it->first],b6*_deltaT,_f6[it->first]); CHKERRQ(ierr);
-      }
+      // 3rd and 4th order updates (hb2 = b2 = 0)
+      ierr = mapWMAXPY(_y3,_var,{hb1*_deltaT,hb3*_deltaT,hb4*_deltaT,hb5*_deltaT,hb6*_deltaT},{&_f1,&_f3,&_f4,&_f5,&_f6});CHKERRQ(ierr);
+      ierr = mapWMAXPY(_y4,_var,{b1*_deltaT,b3*_deltaT,b4*_deltaT,b5*_deltaT,b6*_deltaT},{&_f1,&_f3,&_f4,&_f5,&_f6});CHKERRQ(ierr);
 
-      // calculate error
-      _totErr = computeError();
+      // calculate error, including any error the context reports for the step
+      ierr = obj->stepError(ctxErr);CHKERRQ(ierr);
+      _totErr = computeError() + ctxErr*_totTol;
       if (_totErr<_totTol) { break; } // accept step
       _deltaT = computeStepSize(_totErr);
       if (_minDeltaT == _deltaT) { break; }
 
+      ierr = obj->stepRejected();CHKERRQ(ierr);
       _numRejectedSteps++;
     }
 
     // accept 4th order solution as update
+    if (_denseOutput) { ierr = saveStepStart();CHKERRQ(ierr); }
     _currT = _currT+_deltaT;
-    for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
-      ierr = VecCopy(_y4[it->first],_var[it->first]);CHKERRQ(ierr);
-      VecSet(_dvar[it->first],0.0);
-    }
+    ierr = mapCopy(_y4,_var);CHKERRQ(ierr);
+    ierr = obj->stepAccepted(false);CHKERRQ(ierr);
+    ierr = mapSet(_dvar,0.0);CHKERRQ(ierr);
     ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr);
 
+    // end the step early if an event occurred during it
+    if (_eventDetection) { ierr = locateEvent(obj);CHKERRQ(ierr); }
+
     // compute new deltaT for next time step
     // but call timeMonitor before updating to newDeltaT, to keep output
     // consistent while allowing for checkpointing
@@ -1165,6 +1294,8 @@ PetscErrorCode RK43::integrate(IntegratorContextEx *obj)
 
   }
 
+  if (_packedState) { ierr = resetPackedMap(_var);CHKERRQ(ierr); }
+
   _runTime += MPI_Wtime() - startTime;
 
   #if VERBOSE > 1
@@ -1173,3 +1304,855 @@ PetscErrorCode RK43::integrate(IntegratorContextEx *obj)
 
   return ierr;
 }
+
+
+//======================================================================
+//                  RK_2N child class
+//======================================================================
+
+// constructor, coefficients are set by the derived classes
+RK_2N::RK_2N(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType)
+  : OdeSolver(maxNumSteps,finalT,deltaT,controlType),
+  _minDeltaT(0),_maxDeltaT(finalT),
+  _totTol(1e-9),_kappa(0.9),_ord(3.0),
+  _numRejectedSteps(0),_numMinSteps(0),_numMaxSteps(0),_totErr(0)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_2N::constructor in odeSolver.cpp.\n");
+  #endif
+
+  double startTime = MPI_Wtime();
+
+  _errA.resize(2);
+  _errA.push_front(0);
+  _errA.push_front(0);
+
+  _runTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_2N::constructor in odeSolver.cpp.\n");
+  #endif
+}
+
+
+// destructor, frees intermediate vectors
+RK_2N::~RK_2N()
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_2N::destructor in odeSolver.cpp.\n");
+  #endif
+
+  destroyVector(_dvar);
+  destroyVector(_Q);
+  destroyVector(_dQ);
+  destroyVector(_err);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_2N::destructor in odeSolver.cpp.\n");
+  #endif
+}
+
+
+// print out various information about the method
+PetscErrorCode RK_2N::view()
+{
+  PetscErrorCode ierr = 0;
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"\nTime Integration summary:\n\n");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   integration algorithm: %s\n",_algName.c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of stages: %i\n",(int) _A.size());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   control scheme: %s\n",_controlType.c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   norm type used to measure error: %s\n",_normType.c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   variables used in determining time step = %s\n",vector2str(_errInds).c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   scale factors = %s\n",vector2str(_scale).c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   time interval: %g to %g\n",_initT,_finalT);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   permitted step size range: [%g,%g]\n",_minDeltaT,_maxDeltaT);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   total number of steps taken: %i/%i\n",_stepCount,_maxNumSteps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   final time reached: %g\n",_currT);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   tolerance: %g\n",_totTol);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of rejected steps: %i\n",_numRejectedSteps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times min step size enforced: %i\n",_numMinSteps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times max step size enforced: %i\n",_numMaxSteps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   total run time: %g\n",_runTime);CHKERRQ(ierr);
+  return 0;
+}
+
+
+// set tolerance levels
+PetscErrorCode RK_2N::setTolerance(const PetscReal tol)
+{
+  _totTol = tol;
+  return 0;
+}
+
+
+// set initial conditions on _var, and allocate the 2N registers
+PetscErrorCode RK_2N::setInitialConds(map<string,Vec>& var)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_2N::setInitialConds in odeSolver.cpp.\n");
+  #endif
+
+  double startTime = MPI_Wtime();
+  PetscErrorCode ierr = 0;
+  _var = var; // shallow copy
+
+  if (_packedState) {
+    ierr = createPackedMap(_dvar,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_Q,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_dQ,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_err,_var);CHKERRQ(ierr);
+  }
+  else {
+    for (map<string,Vec>::iterator it=var.begin(); it!=var.end(); it++ ) {
+      Vec dvar;
+      ierr = VecDuplicate(_var[it->first],&dvar); CHKERRQ(ierr);
+      ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
+      _dvar[it->first] = dvar;
+
+      Vec Q;
+      ierr = VecDuplicate(_var[it->first],&Q); CHKERRQ(ierr);
+      ierr = VecSet(Q,0.0); CHKERRQ(ierr);
+      _Q[it->first] = Q;
+
+      Vec dQ;
+      ierr = VecDuplicate(_var[it->first],&dQ); CHKERRQ(ierr);
+      ierr = VecSet(dQ,0.0); CHKERRQ(ierr);
+      _dQ[it->first] = dQ;
+
+      Vec err;
+      ierr = VecDuplicate(_var[it->first],&err); CHKERRQ(ierr);
+      ierr = VecSet(err,0.0); CHKERRQ(ierr);
+      _err[it->first] = err;
+    }
+  }
+
+  _runTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_2N::setInitialConds in odeSolver.cpp.\n");
+  #endif
+
+  return ierr;
+}
+
+
+// set error indices
+PetscErrorCode RK_2N::setErrInds(vector<string>& errInds) {
+  _errInds = errInds;
+  return 0;
+}
+
+
+// set error indices and scale
+PetscErrorCode RK_2N::setErrInds(vector<string>& errInds, vector<double> scale)
+{
+  _errInds = errInds;
+  _scale = scale;
+  return 0;
+}
+
+
+// set _minDeltaT and _maxDeltaT
+PetscErrorCode RK_2N::setTimeStepBounds(const PetscReal minDeltaT, const PetscReal maxDeltaT)
+{
+  double startTime = MPI_Wtime();
+  _minDeltaT = minDeltaT;
+  _maxDeltaT = maxDeltaT;
+  _runTime += MPI_Wtime() - startTime;
+  return 0;
+}
+
+
+// compute the time stepping size, depending on control type
+PetscReal RK_2N::computeStepSize(const PetscReal totErr)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_2N::computeStepSize in odeSolver.cpp.\n");
+  #endif
+
+  PetscReal stepRatio;
+
+  // if using integral feedback controller (I)
+  if (_controlType == "P") {
+    PetscReal alpha = 1./(1.+_ord);
+    stepRatio = _kappa*pow(_totTol/totErr,alpha);
+  }
+
+  //if using proportional-integral-derivative feedback (PID)
+  else if (_controlType == "PID") {
+    PetscReal alpha = 0.49/_ord;
+    PetscReal beta  = 0.34/_ord;
+    PetscReal gamma = 0.1/_ord;
+    if (_stepCount < 4) {
+      stepRatio = _kappa*pow(_totTol/totErr,1./(1.+_ord));
+    }
+    else {
+      stepRatio = _kappa * pow(_totTol/totErr,alpha)
+                         * pow(_errA[0]/_totTol,beta)
+                         * pow(_totTol/_errA[1],gamma);
+    }
+  }
+  else {
+    PetscPrintf(PETSC_COMM_WORLD,"ERROR: timeControlType not understood\n");
+    assert(0 > 1);
+  }
+
+  PetscReal deltaT = stepRatio*_deltaT;
+
+  // respect bounds on min and max possible step size
+  deltaT = min(_deltaT*5.0,deltaT); // cap growth rate of step size
+  deltaT= min(_maxDeltaT,deltaT); // absolute max
+  deltaT = max(_minDeltaT,deltaT);
+
+  if (_minDeltaT == deltaT) {
+    _numMinSteps++;
+  }
+  else if (_maxDeltaT == deltaT) {
+    _numMaxSteps++;
+  }
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_2N::computeStepSize in odeSolver.cpp.\n");
+  #endif
+
+  return deltaT;
+}
+
+
+// compute the L2 error (absolute/relative) from the accumulated error register
+PetscReal RK_2N::computeError()
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_2N::computeError in odeSolver.cpp.\n");
+  #endif
+
+  // error: the L2 norm of the embedded error estimate weighted by N (L2_absolute),
+  // or the max pointwise error relative to the solution (L2_relative), and a
+  // user-inputted scale factor
+  PetscScalar totErr = 0;
+  string normType = _normType.compare("L2_relative")==0 ? "max_relative" : _normType;
+  PetscErrorCode ierr = mapErrorNorm(totErr,_err,NULL,_Q,_errInds,_scale,normType);CHKERRQ(ierr);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_2N::computeError in odeSolver.cpp.\n");
+  #endif
+
+  return totErr;
+}
+
+
+// perform explicit low-storage RK time stepping, calling d_dt method
+PetscErrorCode RK_2N::integrate(IntegratorContextEx *obj)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_2N::integrate in odeSolver.cpp.\n");
+  #endif
+
+  double startTime = MPI_Wtime();
+  PetscErrorCode  ierr = 0;
+  PetscInt       attemptCount = 0;
+  PetscScalar    ctxErr = 0; // error reported by the context for the attempted step
+  int            stopIntegration = 0;
+  const size_t   numStages = _A.size();
+  assert(numStages > 0 && _B.size() == numStages && _C.size() == numStages && _E.size() == numStages);
+
+  // build default errInds
+  if (_errInds.size()==0) {
+    for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
+      _errInds.push_back(it->first);
+    }
+  }
+
+  // check that errInds is valid
+  for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
+    string key = _errInds[i];
+    if (_var.find(key) == _var.end()) {
+      PetscPrintf(PETSC_COMM_WORLD,"RK_2N ERROR: %s is not an element of explicitly integrated variable!\n",key.c_str());
+    }
+    assert(_var.find(key) != _var.end());
+  }
+
+  // set up scaling for elements in errInds
+  if (_scale.size() == 0) { // if 0 entries, set all to 1
+    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
+      _scale.push_back(1.0);
+    }
+  }
+  assert(_scale.size() == _errInds.size());
+
+  if (_finalT == _initT) { return ierr; }
+  if (_deltaT == 0) { _deltaT = (_finalT - _initT) / _maxNumSteps; }
+  if (_maxNumSteps == 0) { return ierr; }
+
+  // share storage of the integration variables with the packed stages
+  if (_packedState) { ierr = placePackedMap(_var);CHKERRQ(ierr); }
+
+  // set initial condition
+  ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr);
+
+  // perform time stepping
+  while (_stepCount < _maxNumSteps && _currT < _finalT) {
+    _stepCount++;
+    attemptCount = 0;
+    while (attemptCount < 100) {
+      attemptCount++;
+      if (attemptCount >= 100) { PetscPrintf(PETSC_COMM_WORLD,"   RK_2N WARNING: maximum number of attempts reached\n"); }
+
+      if (_currT + _deltaT > _finalT) { _deltaT = _finalT - _currT; }
+
+      // _dvar is overwritten by the stages, so after a rejected step restore f(t,var)
+      if (attemptCount > 1) {
+        ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr);
+      }
+
+      ierr = mapCopy(_var,_Q);CHKERRQ(ierr);
+      ierr = mapSet(_dQ,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_err,0.0);CHKERRQ(ierr);
+
+      // stage 1 uses _dvar = f(t,var); later stages overwrite _dvar with f(t + c_i*deltaT,Q)
+      for (size_t i = 0; i < numStages; i++) {
+        if (i > 0) {
+          if (i == numStages-1) { ierr = obj->beginLastStage();CHKERRQ(ierr); }
+          ierr = obj->d_dt(_currT+_C[i]*_deltaT,_Q,_dvar);CHKERRQ(ierr);
+        }
+        ierr = mapAXPY(_err,_E[i]*_deltaT,_dvar);CHKERRQ(ierr);
+        ierr = mapAXPBY(_dQ,_deltaT,_A[i],_dvar);CHKERRQ(ierr);
+        ierr = mapAXPY(_Q,_B[i],_dQ);CHKERRQ(ierr);
+      }
+
+      // calculate error, including any error the context reports for the step
+      ierr = obj->stepError(ctxErr);CHKERRQ(ierr);
+      _totErr = computeError() + ctxErr*_totTol;
+      if (_totErr < _totTol || _deltaT == _minDeltaT) { break; } // accept step
+      _deltaT = computeStepSize(_totErr);
+      ierr = obj->stepRejected();CHKERRQ(ierr);
+      _numRejectedSteps++;
+    }
+
+    // accept higher order solution as update
+    _currT = _currT+_deltaT;
+    ierr = mapCopy(_Q,_var);CHKERRQ(ierr);
+    ierr = obj->stepAccepted(false);CHKERRQ(ierr);
+    ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr);
+
+    // compute new deltaT for next time step
+    // but call timeMonitor before updating to newDeltaT, to keep output
+    // consistent while allowing for checkpointing
+    if (_totErr!=0.0) { _newDeltaT = computeStepSize(_totErr); }
+    _errA.push_front(_totErr); // record error for use when estimating time step
+
+    ierr = obj->timeMonitor(_currT,_deltaT,_stepCount,stopIntegration); CHKERRQ(ierr);
+    if (stopIntegration > 0) { PetscPrintf(PETSC_COMM_WORLD,"RK_2N: Detected stop time integration request.\n"); break; }
+
+    // now update deltaT
+    _deltaT = _newDeltaT;
+  }
+
+  if (_packedState) { ierr = resetPackedMap(_var);CHKERRQ(ierr); }
+
+  _runTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_2N::integrate in odeSolver.cpp.\n");
+  #endif
+
+  return ierr;
+}
+
+
+// Williamson's 3rd order 2N method, Butcher weights b = [1/6, 3/10, 8/15],
+// with embedded 2nd order weights bhat = [0, 3/5, 2/5]
+RK32_2N::RK32_2N(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType)
+  : RK_2N(maxNumSteps,finalT,deltaT,controlType)
+{
+  _algName = "low-storage runge-kutta (3,2), 2N";
+  _ord = 3.0;
+
+  PetscScalar A[] = {0., -5./9., -153./128.};
+  PetscScalar B[] = {1./3., 15./16., 8./15.};
+  PetscScalar C[] = {0., 1./3., 3./4.};
+  PetscScalar E[] = {1./6., -3./10., 2./15.};
+  _A.assign(A,A+3); _B.assign(B,B+3); _C.assign(C,C+3); _E.assign(E,E+3);
+}
+
+
+// Carpenter and Kennedy's 4th order 2N method, solution 3 of 5 stages
+// The error weights E = b - bhat were computed from the Butcher form of the method.
+RK43_2N::RK43_2N(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType)
+  : RK_2N(maxNumSteps,finalT,deltaT,controlType)
+{
+  _algName = "low-storage runge-kutta (4,3), 2N";
+  _ord = 4.0;
+
+  PetscScalar A[] = {0.,
+                     -567301805773./1357537059087.,
+                     -2404267990393./2016746695238.,
+                     -3550918686646./2091501179385.,
+                     -1275806237668./842570457699.};
+  PetscScalar B[] = {1432997174477./9575080441755.,
+                     5161836677717./13612068292357.,
+                     1720146321549./2090206949498.,
+                     3134564353537./4481467310338.,
+                     2277821191437./14882151754819.};
+  PetscScalar C[] = {0.,
+                     1432997174477./9575080441755.,
+                     2526269341429./6820363183101.,
+                     2006345519317./3224310063776.,
+                     2802321613138./2924317926251.};
+  PetscScalar E[] = {-0.10621564510023723,
+                     0.22837965272001509,
+                     -0.16168951666556422,
+                     0.036204637199672422,
+                     0.0033208718461139562};
+  _A.assign(A,A+5); _B.assign(B,B+5); _C.assign(C,C+5); _E.assign(E,E+5);
+}
+
+
+
+//======================================================================
+//                  RK_Embedded child class
+//======================================================================
+
+// constructor, coefficients are set by the derived classes
+RK_Embedded::RK_Embedded(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType)
+  : OdeSolver(maxNumSteps,finalT,deltaT,controlType),
+  _minDeltaT(0),_maxDeltaT(finalT),
+  _totTol(1e-9),_kappa(0.9),_ord(5.0),
+  _numRejectedSteps(0),_numMinSteps(0),_numMaxSteps(0),_totErr(0),
+  _isFSAL(0)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_Embedded::constructor in odeSolver.cpp.\n");
+  #endif
+
+  double startTime = MPI_Wtime();
+
+  _errA.resize(2);
+  _errA.push_front(0);
+  _errA.push_front(0);
+
+  _runTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_Embedded::constructor in odeSolver.cpp.\n");
+  #endif
+}
+
+
+// destructor, frees intermediate vectors
+RK_Embedded::~RK_Embedded()
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_Embedded::destructor in odeSolver.cpp.\n");
+  #endif
+
+  // _f[0] is _dvar
+  destroyVector(_dvar);
+  for (size_t i = 1; i < _f.size(); i++) { destroyVector(_f[i]); }
+  destroyVector(_Y);
+  destroyVector(_err);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_Embedded::destructor in odeSolver.cpp.\n");
+  #endif
+}
+
+
+// print out various information about the method
+PetscErrorCode RK_Embedded::view()
+{
+  PetscErrorCode ierr = 0;
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"\nTime Integration summary:\n\n");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   integration algorithm: %s\n",_algName.c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of stages: %i (FSAL: %s)\n",(int) _b.size(),_isFSAL ? "yes" : "no");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   control scheme: %s\n",_controlType.c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   norm type used to measure error: %s\n",_normType.c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   variables used in determining time step = %s\n",vector2str(_errInds).c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   scale factors = %s\n",vector2str(_scale).c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   time interval: %g to %g\n",_initT,_finalT);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   permitted step size range: [%g,%g]\n",_minDeltaT,_maxDeltaT);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   total number of steps taken: %i/%i\n",_stepCount,_maxNumSteps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   final time reached: %g\n",_currT);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   tolerance: %g\n",_totTol);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of rejected steps: %i\n",_numRejectedSteps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times min step size enforced: %i\n",_numMinSteps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times max step size enforced: %i\n",_numMaxSteps);CHKERRQ(ierr);
+  if (_eventDetection) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of located events: %i\n",_numEvents);CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   total run time: %g\n",_runTime);CHKERRQ(ierr);
+  return 0;
+}
+
+
+// set tolerance levels
+PetscErrorCode RK_Embedded::setTolerance(const PetscReal tol)
+{
+  _totTol = tol;
+  return 0;
+}
+
+
+// set initial conditions on _var, and allocate the stages
+PetscErrorCode RK_Embedded::setInitialConds(map<string,Vec>& var)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_Embedded::setInitialConds in odeSolver.cpp.\n");
+  #endif
+
+  double startTime = MPI_Wtime();
+  PetscErrorCode ierr = 0;
+  const size_t numStages = _b.size();
+  assert(numStages > 0);
+  _var = var; // shallow copy
+  _f.resize(numStages);
+
+  if (_packedState) {
+    ierr = createPackedMap(_dvar,_var);CHKERRQ(ierr);
+    for (size_t i = 1; i < numStages; i++) { ierr = createPackedMap(_f[i],_var);CHKERRQ(ierr); }
+    ierr = createPackedMap(_Y,_var);CHKERRQ(ierr);
+    ierr = createPackedMap(_err,_var);CHKERRQ(ierr);
+  }
+  else {
+    for (map<string,Vec>::iterator it=var.begin(); it!=var.end(); it++ ) {
+      Vec dvar;
+      ierr = VecDuplicate(_var[it->first],&dvar); CHKERRQ(ierr);
+      ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
+      _dvar[it->first] = dvar;
+
+      for (size_t i = 1; i < numStages; i++) {
+        Vec f;
+        ierr = VecDuplicate(_var[it->first],&f); CHKERRQ(ierr);
+        ierr = VecSet(f,0.0); CHKERRQ(ierr);
+        _f[i][it->first] = f;
+      }
+
+      Vec Y;
+      ierr = VecDuplicate(_var[it->first],&Y); CHKERRQ(ierr);
+      ierr = VecSet(Y,0.0); CHKERRQ(ierr);
+      _Y[it->first] = Y;
+
+      Vec err;
+      ierr = VecDuplicate(_var[it->first],&err); CHKERRQ(ierr);
+      ierr = VecSet(err,0.0); CHKERRQ(ierr);
+      _err[it->first] = err;
+    }
+  }
+  _f[0] = _dvar; // shallow copy
+  ierr = initDenseOutput();CHKERRQ(ierr);
+
+  _runTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_Embedded::setInitialConds in odeSolver.cpp.\n");
+  #endif
+
+  return ierr;
+}
+
+
+// set error indices
+PetscErrorCode RK_Embedded::setErrInds(vector<string>& errInds) {
+  _errInds = errInds;
+  return 0;
+}
+
+
+// set error indices and scale
+PetscErrorCode RK_Embedded::setErrInds(vector<string>& errInds, vector<double> scale)
+{
+  _errInds = errInds;
+  _scale = scale;
+  return 0;
+}
+
+
+// set _minDeltaT and _maxDeltaT
+PetscErrorCode RK_Embedded::setTimeStepBounds(const PetscReal minDeltaT, const PetscReal maxDeltaT)
+{
+  double startTime = MPI_Wtime();
+  _minDeltaT = minDeltaT;
+  _maxDeltaT = maxDeltaT;
+  _runTime += MPI_Wtime() - startTime;
+  return 0;
+}
+
+
+// compute the time stepping size, depending on control type
+PetscReal RK_Embedded::computeStepSize(const PetscReal totErr)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_Embedded::computeStepSize in odeSolver.cpp.\n");
+  #endif
+
+  PetscReal stepRatio;
+
+  // if using integral feedback controller (I)
+  if (_controlType == "P") {
+    PetscReal alpha = 1./(1.+_ord);
+    stepRatio = _kappa*pow(_totTol/totErr,alpha);
+  }
+
+  //if using proportional-integral-derivative feedback (PID)
+  else if (_controlType == "PID") {
+    PetscReal alpha = 0.49/_ord;
+    PetscReal beta  = 0.34/_ord;
+    PetscReal gamma = 0.1/_ord;
+    if (_stepCount < 4) {
+      stepRatio = _kappa*pow(_totTol/totErr,1./(1.+_ord));
+    }
+    else {
+      stepRatio = _kappa * pow(_totTol/totErr,alpha)
+                         * pow(_errA[0]/_totTol,beta)
+                         * pow(_totTol/_errA[1],gamma);
+    }
+  }
+  else {
+    PetscPrintf(PETSC_COMM_WORLD,"ERROR: timeControlType not understood\n");
+    assert(0 > 1);
+  }
+
+  PetscReal deltaT = stepRatio*_deltaT;
+
+  // respect bounds on min and max possible step size
+  deltaT = min(_deltaT*5.0,deltaT); // cap growth rate of step size
+  deltaT= min(_maxDeltaT,deltaT); // absolute max
+  deltaT = max(_minDeltaT,deltaT);
+
+  if (_minDeltaT == deltaT) {
+    _numMinSteps++;
+  }
+  else if (_maxDeltaT == deltaT) {
+    _numMaxSteps++;
+  }
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_Embedded::computeStepSize in odeSolver.cpp.\n");
+  #endif
+
+  return deltaT;
+}
+
+
+// compute the L2 error (absolute/relative) from the error estimate
+PetscReal RK_Embedded::computeError()
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_Embedded::computeError in odeSolver.cpp.\n");
+  #endif
+
+  // error: the L2 norm of the embedded error estimate weighted by N (L2_absolute),
+  // or the max pointwise error relative to the solution (L2_relative), and a
+  // user-inputted scale factor
+  PetscScalar totErr = 0;
+  string normType = _normType.compare("L2_relative")==0 ? "max_relative" : _normType;
+  PetscErrorCode ierr = mapErrorNorm(totErr,_err,NULL,_Y,_errInds,_scale,normType);CHKERRQ(ierr);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_Embedded::computeError in odeSolver.cpp.\n");
+  #endif
+
+  return totErr;
+}
+
+
+// perform explicit embedded RK time stepping, calling d_dt method
+PetscErrorCode RK_Embedded::integrate(IntegratorContextEx *obj)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting RK_Embedded::integrate in odeSolver.cpp.\n");
+  #endif
+
+  double startTime = MPI_Wtime();
+  PetscErrorCode  ierr = 0;
+  PetscInt       attemptCount = 0;
+  PetscScalar    ctxErr = 0; // error reported by the context for the attempted step
+  int            stopIntegration = 0;
+  const size_t   numStages = _b.size();
+  assert(numStages > 0 && _a.size() == numStages && _c.size() == numStages && _E.size() == numStages);
+
+  // check for FSAL property
+  _isFSAL = (_c[numStages-1] == 1.0 && _b[numStages-1] == 0.0);
+  for (size_t j = 0; j < numStages-1 && _isFSAL; j++) {
+    _isFSAL = (_a[numStages-1][j] == _b[j]);
+  }
+
+  // build default errInds
+  if (_errInds.size()==0) {
+    for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
+      _errInds.push_back(it->first);
+    }
+  }
+
+  // check that errInds is valid
+  for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
+    string key = _errInds[i];
+    if (_var.find(key) == _var.end()) {
+      PetscPrintf(PETSC_COMM_WORLD,"RK_Embedded ERROR: %s is not an element of explicitly integrated variable!\n",key.c_str());
+    }
+    assert(_var.find(key) != _var.end());
+  }
+
+  // set up scaling for elements in errInds
+  if (_scale.size() == 0) { // if 0 entries, set all to 1
+    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
+      _scale.push_back(1.0);
+    }
+  }
+  assert(_scale.size() == _errInds.size());
+
+  if (_finalT == _initT) { return ierr; }
+  if (_deltaT == 0) { _deltaT = (_finalT - _initT) / _maxNumSteps; }
+  if (_maxNumSteps == 0) { return ierr; }
+
+  // share storage of the integration variables with the packed stages
+  if (_packedState) { ierr = placePackedMap(_var);CHKERRQ(ierr); }
+
+  // set initial condition
+  ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr);
+  if (_eventDetection) { ierr = obj->eventFunction(_currT,_var,_dvar,_eventVal);CHKERRQ(ierr); }
+
+  // perform time stepping
+  vector<PetscScalar> alpha;
+  vector< map<string,Vec>* > f;
+  while (_stepCount < _maxNumSteps && _currT < _finalT) {
+    _stepCount++;
+    attemptCount = 0;
+    while (attemptCount < 100) {
+      attemptCount++;
+      if (attemptCount >= 100) { PetscPrintf(PETSC_COMM_WORLD,"   RK_Embedded WARNING: maximum number of attempts reached\n"); }
+
+      if (_currT + _deltaT > _finalT) { _deltaT = _finalT - _currT; }
+
+      // stage 1 is _f[0] = _dvar = f(t,var), which is not overwritten by the
+      // later stages, so it is still valid after a rejected step
+      // stage i: Y = var + deltaT*sum_j a_ij*f_j, f_i = f(t + c_i*deltaT,Y)
+      for (size_t i = 1; i < numStages; i++) {
+        alpha.clear(); f.clear();
+        for (size_t j = 0; j < i; j++) {
+          if (_a[i][j] != 0.0) { alpha.push_back(_a[i][j]*_deltaT); f.push_back(&_f[j]); }
+        }
+        ierr = mapWMAXPY(_Y,_var,alpha,f);CHKERRQ(ierr);
+        if (i == numStages-1) { ierr = obj->beginLastStage();CHKERRQ(ierr); }
+        ierr = obj->d_dt(_currT+_c[i]*_deltaT,_Y,_f[i]);CHKERRQ(ierr);
+      }
+
+      // solution, which for FSAL methods is the last stage value
+      if (!_isFSAL) {
+        alpha.clear(); f.clear();
+        for (size_t j = 0; j < numStages; j++) {
+          if (_b[j] != 0.0) { alpha.push_back(_b[j]*_deltaT); f.push_back(&_f[j]); }
+        }
+        ierr = mapWMAXPY(_Y,_var,alpha,f);CHKERRQ(ierr);
+      }
+
+      // error estimate: err = deltaT*sum_j E_j*f_j
+      alpha.clear(); f.clear();
+      for (size_t j = 0; j < numStages; j++) {
+        if (_E[j] != 0.0) { alpha.push_back(_E[j]*_deltaT); f.push_back(&_f[j]); }
+      }
+      ierr = mapSet(_err,0.0);CHKERRQ(ierr);
+      ierr = mapWMAXPY(_err,_err,alpha,f);CHKERRQ(ierr);
+
+      // calculate error, including any error the context reports for the step
+      ierr = obj->stepError(ctxErr);CHKERRQ(ierr);
+      _totErr = computeError() + ctxErr*_totTol;
+      if (_totErr < _totTol || _deltaT == _minDeltaT) { break; } // accept step
+      _deltaT = computeStepSize(_totErr);
+      ierr = obj->stepRejected();CHKERRQ(ierr);
+      _numRejectedSteps++;
+    }
+
+    // accept higher order solution as update
+    // for FSAL methods the last stage is f(t+deltaT,var), and the last call to
+    // d_dt was at the accepted solution
+    if (_denseOutput) { ierr = saveStepStart();CHKERRQ(ierr); }
+    _currT = _currT+_deltaT;
+    ierr = mapCopy(_Y,_var);CHKERRQ(ierr);
+    ierr = obj->stepAccepted(_isFSAL);CHKERRQ(ierr);
+    if (_isFSAL) { ierr = mapCopy(_f[numStages-1],_dvar);CHKERRQ(ierr); }
+    else { ierr = obj->d_dt(_currT,_var,_dvar);CHKERRQ(ierr); }
+
+    // end the step early if an event occurred during it
+    if (_eventDetection) { ierr = locateEvent(obj);CHKERRQ(ierr); }
+
+    // compute new deltaT for next time step
+    // but call timeMonitor before updating to newDeltaT, to keep output
+    // consistent while allowing for checkpointing
+    if (_totErr!=0.0) { _newDeltaT = computeStepSize(_totErr); }
+    _errA.push_front(_totErr); // record error for use when estimating time step
+
+    ierr = obj->timeMonitor(_currT,_deltaT,_stepCount,stopIntegration); CHKERRQ(ierr);
+    if (stopIntegration > 0) { PetscPrintf(PETSC_COMM_WORLD,"RK_Embedded: Detected stop time integration request.\n"); break; }
+
+    // now update deltaT
+    _deltaT = _newDeltaT;
+  }
+
+  if (_packedState) { ierr = resetPackedMap(_var);CHKERRQ(ierr); }
+
+  _runTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending RK_Embedded::integrate in odeSolver.cpp.\n");
+  #endif
+
+  return ierr;
+}
+
+
+// Tsitouras' 5(4) pair. The coefficients are only available in floating point.
+// The error weights E = b - bhat use the FSAL stage.
+RK54::RK54(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType)
+  : RK_Embedded(maxNumSteps,finalT,deltaT,controlType)
+{
+  _algName = "runge-kutta (5,4), Tsitouras";
+  _ord = 5.0;
+
+  PetscScalar c[] = {0., 0.161, 0.327, 0.9, 0.9800255409045097, 1., 1.};
+  PetscScalar b[] = {0.09646076681806523, 0.01, 0.4798896504144996, 1.379008574103742,
+                     -3.290069515436081, 2.324710524099774, 0.};
+  PetscScalar E[] = {-0.00178001105222577714, -0.0008164344596567469, 0.007880878010261995,
+                     -0.1447110071732629, 0.5823571654525552, -0.45808210592918697, 1./66.};
+  _c.assign(c,c+7); _b.assign(b,b+7); _E.assign(E,E+7);
+
+  _a.assign(7,vector<PetscScalar>());
+  PetscScalar a2[] = {0.161};
+  PetscScalar a3[] = {-0.008480655492356989, 0.335480655492357};
+  PetscScalar a4[] = {2.897153057105493, -6.359448489975075, 4.3622954328695815};
+  PetscScalar a5[] = {5.325864828439257, -11.748883564062828, 7.4955393428898365, -0.09249506636175525};
+  PetscScalar a6[] = {5.86145544294642, -12.92096931784711, 8.159367898576159, -0.071584973281401,
+                      -0.028269050394068383};
+  _a[1].assign(a2,a2+1); _a[2].assign(a3,a3+2); _a[3].assign(a4,a4+3);
+  _a[4].assign(a5,a5+4); _a[5].assign(a6,a6+5);
+  _a[6].assign(b,b+6); // FSAL
+}
+
+
+// Verner's 6(5) pair (DVERK), with Butcher weights
+// b    = [3/40, 0, 875/2244, 23/72, 264/1955, 0, 125/11592, 43/616]
+// bhat = [13/160, 0, 2375/5984, 5/16, 12/85, 3/44, 0, 0]
+RK65::RK65(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType)
+  : RK_Embedded(maxNumSteps,finalT,deltaT,controlType)
+{
+  _algName = "runge-kutta (6,5), Verner";
+  _ord = 6.0;
+
+  PetscScalar c[] = {0., 1./6., 4./15., 2./3., 5./6., 1., 1./15., 1.};
+  PetscScalar b[] = {3./40., 0., 875./2244., 23./72., 264./1955., 0., 125./11592., 43./616.};
+  PetscScalar E[] = {-1./160., 0., -125./17952., 1./144., -12./1955., -3./44., 125./11592., 43./616.};
+  _c.assign(c,c+8); _b.assign(b,b+8); _E.assign(E,E+8);
+
+  _a.assign(8,vector<PetscScalar>());
+  PetscScalar a2[] = {1./6.};
+  PetscScalar a3[] = {4./75., 16./75.};
+  PetscScalar a4[] = {5./6., -8./3., 5./2.};
+  PetscScalar a5[] = {-165./64., 55./6., -425./64., 85./96.};
+  PetscScalar a6[] = {12./5., -8., 4015./612., -11./36., 88./255.};
+  PetscScalar a7[] = {-8263./15000., 124./75., -643./680., -81./250., 2484./10625., 0.};
+  PetscScalar a8[] = {3501./1720., -300./43., 297275./52632., -319./2322., 24068./84065., 0., 3850./26703.};
+  _a[1].assign(a2,a2+1); _a[2].assign(a3,a3+2); _a[3].assign(a4,a4+3); _a[4].assign(a5,a5+4);
+  _a[5].assign(a6,a6+5); _a[6].assign(a7,a7+6); _a[7].assign(a8,a8+7);
+}
@@ -20,11 +20,26 @@ using namespace std;
  *  FEuler        forward Euler
  *  RK32          explicit Runge-Kutta (2,3)
  *  RK43          explicit Runge-Kutta (3,4)
+ *  RK32_2N       low-storage explicit Runge-Kutta (3,2)
+ *  RK43_2N       low-storage explicit Runge-Kutta (4,3)
+ *  RK54          explicit Runge-Kutta (5,4), Tsitouras, FSAL
+ *  RK65          explicit Runge-Kutta (6,5), Verner
  *
  * To obtain solutions at user-specified times, use FEuler and call setStepSize
- * in the routine f(t,y).
+ * in the routine f(t,y). Alternatively, with setDenseOutput(true), RK32, RK43,
+ * RK54, and RK65 keep y and y' at the start of the last accepted step, and
+ * interpolate returns y at any time within that step from the cubic Hermite
+ * interpolant, so output times do not constrain the step size.
+ * With setEventDetection(true), these methods also evaluate the event function
+ * of the object passed to integrate after each step. If it crossed zero from
+ * below during the step, the crossing is located on the interpolant and the
+ * step is ended there, before timeMonitor is called.
  *
  * y is represented as an array of one or more Vecs (PETSc data type).
+ * With setPackedState(true), y and the intermediate stages are each stored
+ * in one contiguous Vec, with the array entries being views into it, so
+ * each stage combination is a single vector operation. During integrate,
+ * the initial conditions array shares storage with the integrator.
  *
  * At minimum, the user must specify:
  *     QUANTITY               FUNCTION
@@ -67,18 +82,37 @@ public:
   double             _runTime;
   string             _controlType;
   string             _normType;
+  bool               _packedState; // if true, store each set of integration variables in one contiguous Vec
+  bool               _denseOutput; // if true, store y and y' at the start of each accepted step for interpolate
+  PetscReal          _prevT; // start time of the last accepted step
+  map<string,Vec>    _varPrev,_dvarPrev; // y and y' at _prevT
+  bool               _eventDetection; // if true, end steps at upward zero crossings of obj->eventFunction
+  PetscReal          _eventTol; // tolerance on the event time, relative to the step size
+  PetscScalar        _eventVal; // value of the event function at _currT
+  PetscInt           _numEvents;
+  map<string,Vec>    _varEv,_dvarEv; // y and y' at trial event times
 
   // for PID error control
   boost::circular_buffer<double> _errA;
   map<string,Vec> _y2,_y3,_y4;
 
   OdeSolver(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType);
-  virtual ~OdeSolver() {};
+  virtual ~OdeSolver();
 
   PetscErrorCode setTimeRange(const PetscReal initT,const PetscReal finalT);
   PetscErrorCode setInitialStepCount(const PetscReal stepCount);
   PetscErrorCode setStepSize(const PetscReal deltaT);
   PetscErrorCode setToleranceType(const string normType); // type of norm used for error control
+  PetscErrorCode setPackedState(const bool packedState); // must be called before setInitialConds
+  PetscErrorCode setDenseOutput(const bool denseOutput); // must be called before setInitialConds
+  PetscErrorCode initDenseOutput(); // allocate _varPrev and _dvarPrev, called by setInitialConds
+  PetscErrorCode saveStepStart(); // store _currT, y, and y' before accepting a step
+  PetscErrorCode setEventDetection(const bool eventDetection,const PetscReal eventTol); // must be called before setInitialConds
+  PetscErrorCode locateEvent(IntegratorContextEx *obj); // call after accepting a step and updating _dvar
+
+  // value of y at time within the last accepted step [_prevT,_currT]
+  virtual PetscErrorCode interpolate(const PetscReal time, map<string,Vec>& out);
+  virtual PetscErrorCode interpolateRate(const PetscReal time, map<string,Vec>& out); // y' at time
 
   virtual PetscErrorCode setTolerance(const PetscReal tol) = 0;
   virtual PetscErrorCode setTimeStepBounds(const PetscReal minDeltaT, const PetscReal maxDeltaT) = 0;
@@ -175,4 +209,127 @@ public:
   PetscErrorCode integrate(IntegratorContextEx *obj);
 };
 
+
+// Low-storage Runge-Kutta time-stepping in Williamson's 2N form:
+//    dQ = A_i*dQ + deltaT*f(t + c_i*deltaT,Q)
+//    Q  = Q + B_i*dQ
+// The embedded error estimate is accumulated as err = sum_i E_i*deltaT*f_i,
+// where E = b - bhat is the difference between the Butcher weights of the
+// method and of the lower order embedded method.
+// Besides the solution, this uses 4 vectors per integrated variable
+// (dvar, Q, dQ, err), compared to 7 for RK32 and 13 for RK43.
+// On a rejected step, f(t,var) is recomputed rather than stored.
+class RK_2N : public OdeSolver
+{
+public:
+
+  PetscReal   _minDeltaT,_maxDeltaT;
+  PetscReal   _totTol;
+  PetscReal   _kappa,_ord;
+  PetscInt    _numRejectedSteps,_numMinSteps,_numMaxSteps;
+  PetscReal   _totErr;
+
+  string              _algName; // for view
+  vector<PetscScalar> _A,_B,_C,_E; // 2N coefficients, nodes, and error weights
+  map<string,Vec>     _Q,_dQ,_err;
+
+  PetscReal computeStepSize(const PetscReal totErr);
+  PetscReal computeError();
+
+  // constructor and destructor
+  RK_2N(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType);
+  virtual ~RK_2N();
+
+  // various member functions
+  PetscErrorCode setTolerance(const PetscReal tol);
+  PetscErrorCode setTimeStepBounds(const PetscReal minDeltaT, const PetscReal maxDeltaT);
+  PetscErrorCode setInitialConds(map<string,Vec>& var);
+  PetscErrorCode setErrInds(vector<string>& errInds);
+  PetscErrorCode setErrInds(vector<string>& errInds, vector<double> scale);
+  PetscErrorCode view();
+  PetscErrorCode integrate(IntegratorContextEx *obj);
+};
+
+
+// 3rd order, 3 stage method from Williamson (1980): "Low-storage Runge-Kutta schemes",
+// with an embedded 2nd order method using bhat = [0, 3/5, 2/5]
+class RK32_2N : public RK_2N
+{
+public:
+  RK32_2N(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType);
+};
+
+
+// 4th order, 5 stage method from Carpenter and Kennedy (1994): "Fourth-order
+// 2N-storage Runge-Kutta schemes", with an embedded 3rd order method (the
+// minimum-norm choice of bhat among the 3rd order methods using the same stages)
+class RK43_2N : public RK_2N
+{
+public:
+  RK43_2N(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType);
+};
+
+
+// Embedded Runge-Kutta time-stepping for a general explicit Butcher tableau,
+// for higher order pairs that are worthwhile at tight tolerances.
+// The error estimate is err = deltaT*sum_i E_i*f_i, where E = b - bhat.
+// If the method is FSAL (first same as last: c_s = 1 and the last row of the
+// tableau is b), the last stage is f(t+deltaT,y_{n+1}) and is reused as the
+// first stage of the next step, so each step costs s-1 evaluations of d_dt.
+// Otherwise f(t+deltaT,y_{n+1}) is computed after the step, as in RK43, and
+// each step costs s evaluations.
+class RK_Embedded : public OdeSolver
+{
+public:
+
+  PetscReal   _minDeltaT,_maxDeltaT;
+  PetscReal   _totTol;
+  PetscReal   _kappa,_ord;
+  PetscInt    _numRejectedSteps,_numMinSteps,_numMaxSteps;
+  PetscReal   _totErr;
+
+  string                       _algName; // for view
+  vector< vector<PetscScalar> > _a; // strictly lower triangular part of the Butcher matrix, by row
+  vector<PetscScalar>          _b,_c,_E; // weights, nodes, and error weights
+  bool                         _isFSAL;
+  vector< map<string,Vec> >    _f; // stage rates, _f[0] is _dvar
+  map<string,Vec>              _Y,_err; // stage value (and solution), error estimate
+
+  PetscReal computeStepSize(const PetscReal totErr);
+  PetscReal computeError();
+
+  // constructor and destructor
+  RK_Embedded(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType);
+  virtual ~RK_Embedded();
+
+  // various member functions
+  PetscErrorCode setTolerance(const PetscReal tol);
+  PetscErrorCode setTimeStepBounds(const PetscReal minDeltaT, const PetscReal maxDeltaT);
+  PetscErrorCode setInitialConds(map<string,Vec>& var);
+  PetscErrorCode setErrInds(vector<string>& errInds);
+  PetscErrorCode setErrInds(vector<string>& errInds, vector<double> scale);
+  PetscErrorCode view();
+  PetscErrorCode integrate(IntegratorContextEx *obj);
+};
+
+
+// 5th order, 7 stage FSAL method with an embedded 4th order method, from
+// Tsitouras (2011): "Runge-Kutta pairs of order 5(4) satisfying only the first
+// column simplifying assumption"
+class RK54 : public RK_Embedded
+{
+public:
+  RK54(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType);
+};
+
+
+// 6th order, 8 stage method with an embedded 5th order method, from
+// Verner (1978): "Explicit Runge-Kutta methods with estimates of the local
+// truncation error" (the DVERK pair)
+class RK65 : public RK_Embedded
+{
+public:
+  RK65(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType);
+};
+
 #endif
@@ -5,7 +5,7 @@ using namespace std;
 OdeSolverImex::OdeSolverImex(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType)
 : _initT(0),_finalT(finalT),_currT(0),_deltaT(deltaT),
   _maxNumSteps(maxNumSteps),_stepCount(0),
-  _runTime(0),_controlType(controlType),_normType("L2_absolute"),
+  _runTime(0),_controlType(controlType),_normType("L2_absolute"),_packedState(0),
   _minDeltaT(0),_maxDeltaT(finalT),
   _totTol(1e-9),
   _numRejectedSteps(0),_numMinSteps(0),_numMaxSteps(0)
@@ -29,6 +29,13 @@ PetscErrorCode OdeSolverImex::setInitialStepCount(const PetscReal stepCount)
   return 0;
 }
 
+// store explicitly integrated variables and intermediate stages in contiguous Vecs
+PetscErrorCode OdeSolverImex::setPackedState(const bool packedState)
+{
+  _packedState = packedState;
+  return 0;
+}
+
 PetscErrorCode OdeSolverImex::setToleranceType(const string normType)
 {
 #if VERBOSE > 1
@@ -163,41 +170,52 @@ PetscErrorCode RK32_WBE::setInitialConds(map<string,Vec>& varEx,map<string,Vec>&
 
   // explicit part
   _varEx = varEx;
-  for (map<string,Vec>::iterator it=_varEx.begin(); it!=_varEx.end(); it++ ) {
-    Vec dvar;
-    ierr = VecDuplicate(_varEx[it->first],&dvar); CHKERRQ(ierr);
-    ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
-    _dvar[it->first] = dvar;
-
-    Vec varHalfdT;
-    ierr = VecDuplicate(_varEx[it->first],&varHalfdT); CHKERRQ(ierr);
-    ierr = VecSet(varHalfdT,0.0); CHKERRQ(ierr);
-    _k1[it->first] = varHalfdT;
-
-    Vec dvarHalfdT;
-    ierr = VecDuplicate(_varEx[it->first],&dvarHalfdT); CHKERRQ(ierr);
-    ierr = VecSet(dvarHalfdT,0.0); CHKERRQ(ierr);
-    _f1[it->first] = dvarHalfdT;
-
-    Vec vardT;
-    ierr = VecDuplicate(_varEx[it->first],&vardT); CHKERRQ(ierr);
-    ierr = VecSet(vardT,0.0); CHKERRQ(ierr);
-    _k2[it->first] = vardT;
-
-    Vec dvardT;
-    ierr = VecDuplicate(_varEx[it->first],&dvardT); CHKERRQ(ierr);
-    ierr = VecSet(dvardT,0.0); CHKERRQ(ierr);
-    _f2[it->first] = dvardT;
-
-    Vec var2nd;
-    ierr = VecDuplicate(_varEx[it->first],&var2nd); CHKERRQ(ierr);
-    ierr = VecSet(var2nd,0.0); CHKERRQ(ierr);
-    _y2[it->first] = var2nd;
-
-    Vec var3rd;
-    ierr = VecDuplicate(_varEx[it->first],&var3rd); CHKERRQ(ierr);
-    ierr = VecSet(var3rd,0.0); CHKERRQ(ierr);
-    _y3[it->first] = var3rd;
+  if (_packedState) {
+    ierr = createPackedMap(_dvar,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_k1,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_f1,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_k2,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_f2,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_y2,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_y3,_varEx);CHKERRQ(ierr);
+  }
+  else {
+    for (map<string,Vec>::iterator it=_varEx.begin(); it!=_varEx.end(); it++ ) {
+      Vec dvar;
+      ierr = VecDuplicate(_varEx[it->first],&dvar); CHKERRQ(ierr);
+      ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
+      _dvar[it->first] = dvar;
+
+      Vec varHalfdT;
+      ierr = VecDuplicate(_varEx[it->first],&varHalfdT); CHKERRQ(ierr);
+      ierr = VecSet(varHalfdT,0.0); CHKERRQ(ierr);
+      _k1[it->first] = varHalfdT;
+
+      Vec dvarHalfdT;
+      ierr = VecDuplicate(_varEx[it->first],&dvarHalfdT); CHKERRQ(ierr);
+      ierr = VecSet(dvarHalfdT,0.0); CHKERRQ(ierr);
+      _f1[it->first] = dvarHalfdT;
+
+      Vec vardT;
+      ierr = VecDuplicate(_varEx[it->first],&vardT); CHKERRQ(ierr);
+      ierr = VecSet(vardT,0.0); CHKERRQ(ierr);
+      _k2[it->first] = vardT;
+
+      Vec dvardT;
+      ierr = VecDuplicate(_varEx[it->first],&dvardT); CHKERRQ(ierr);
+      ierr = VecSet(dvardT,0.0); CHKERRQ(ierr);
+      _f2[it->first] = dvardT;
+
+      Vec var2nd;
+      ierr = VecDuplicate(_varEx[it->first],&var2nd); CHKERRQ(ierr);
+      ierr = VecSet(var2nd,0.0); CHKERRQ(ierr);
+      _y2[it->first] = var2nd;
+
+      Vec var3rd;
+      ierr = VecDuplicate(_varEx[it->first],&var3rd); CHKERRQ(ierr);
+      ierr = VecSet(var3rd,0.0); CHKERRQ(ierr);
+      _y3[it->first] = var3rd;
+    }
   }
 
   // implicit part, computed once per time step
@@ -299,53 +317,17 @@ PetscReal RK32_WBE::computeError()
 #if VERBOSE > 1
   PetscPrintf(PETSC_COMM_WORLD,"Starting RK32_WBE::computeError in odeSolverImex.cpp.\n");
 #endif
-  PetscErrorCode ierr = 0;
-  PetscScalar err = 0, _totErr = 0;
-
-  // if using absolute error for control
-  // error: the absolute L2 error, weighted by N and a user-inputted scale factor
-  // tolerance: the absolute tolerance
-  if (_normType.compare("L2_absolute")==0) {
-    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
-      string key = _errInds[i];
-      Vec errVec;
-      VecDuplicate(_y3[key],&errVec);
-      VecSet(errVec,0.0);
-      ierr = VecWAXPY(errVec,-1.0,_y3[key],_y2[key]); CHKERRQ(ierr);
-      VecNorm(errVec,NORM_2,&err);
-      VecDestroy(&errVec);
-
-      PetscInt N = 0;
-      VecGetSize(_y3[key],&N);
-      _totErr += err / (sqrt(N) * _scale[i]);
-    }
-  }
 
-  // if using relative error for control
-  // error: the absolute L2 error, scaled by the L2 norm of the solution
-  // and a user-inputted scale factor
-  // tolerance: the relative tolerance
-  if (_normType.compare("L2_relative")==0) {
-    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
-      string key = _errInds[i];
-      Vec errVec;
-      VecDuplicate(_y3[key],&errVec);
-      VecSet(errVec,0.0);
-      ierr = VecWAXPY(errVec,-1.0,_y3[key],_y2[key]); CHKERRQ(ierr);
-      VecNorm(errVec,NORM_2,&err);
-      VecDestroy(&errVec);
-
-      PetscReal s = 0;
-      VecNorm(_y3[key],NORM_2,&s);
-      _totErr += err / (s * _scale[i]);
-    }
-  }
+  // error: the L2 norm of y2 - y3, weighted by N (L2_absolute) or by the L2 norm
+  // of the solution (L2_relative), and a user-inputted scale factor
+  PetscScalar totErr = 0;
+  PetscErrorCode ierr = mapErrorNorm(totErr,_y2,&_y3,_y3,_errInds,_scale,_normType);CHKERRQ(ierr);
 
 #if VERBOSE > 1
   PetscPrintf(PETSC_COMM_WORLD,"Ending RK32_WBE::computeError in odeSolverImex.cpp.\n");
 #endif
 
-  return _totErr;
+  return totErr;
 }
 
 
@@ -389,6 +371,9 @@ PetscErrorCode RK32_WBE::integrate(IntegratorContextImex *obj)
   else if (_deltaT==0) { _deltaT = (_finalT-_initT)/_maxNumSteps; }
   if (_maxNumSteps == 0) { return ierr; }
 
+  // share storage of the explicitly integrated variables with the packed stages
+  if (_packedState) { ierr = placePackedMap(_varEx);CHKERRQ(ierr); }
+
   // set initial condition
   ierr = obj->d_dt(_currT,_varEx,_dvar);CHKERRQ(ierr);
   //~ ierr = obj->timeMonitor(_currT,_deltaT,_stepCount,stopIntegration); CHKERRQ(ierr);// write first step
@@ -403,35 +388,20 @@ PetscErrorCode RK32_WBE::integrate(IntegratorContextImex *obj)
       //~ierr = PetscPrintf(PETSC_COMM_WORLD,"   attemptCount=%i\n",attemptCount);CHKERRQ(ierr);
       if (_currT+_deltaT>_finalT) { _deltaT=_finalT-_currT; }
 
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        VecSet(_k1[it->first],0.0); VecSet(_f1[it->first],0.0);
-        VecSet(_k2[it->first],0.0); VecSet(_f2[it->first],0.0);
-        VecSet(_y2[it->first],0.0);
-        VecSet(_y3[it->first],0.0);
-      }
+      ierr = mapSet(_f1,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f2,0.0);CHKERRQ(ierr);
 
       // stage 1: integrate fields to _currT + 0.5*deltaT
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        ierr = VecWAXPY(_k1[it->first],0.5*_deltaT,_dvar[it->first],_varEx[it->first]);CHKERRQ(ierr);
-      }
+      ierr = mapWAXPY(_k1,0.5*_deltaT,_dvar,_varEx);CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+0.5*_deltaT,_k1,_f1);CHKERRQ(ierr);
 
       // stage 2: integrate fields to _currT + _deltaT
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        ierr = VecWAXPY(_k2[it->first],-_deltaT,_dvar[it->first],_varEx[it->first]);CHKERRQ(ierr);
-        ierr = VecAXPY(_k2[it->first],2*_deltaT,_f1[it->first]);CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k2,_varEx,{-_deltaT,2*_deltaT},{&_dvar,&_f1});CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+_deltaT,_k2,_f2);CHKERRQ(ierr);
 
       // 2nd and 3rd order update
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        ierr = VecWAXPY(_y2[it->first],0.5*_deltaT,_dvar[it->first],_varEx[it->first]);CHKERRQ(ierr);
-        ierr = VecAXPY(_y2[it->first],0.5*_deltaT,_f2[it->first]);CHKERRQ(ierr);
-
-        ierr = VecWAXPY(_y3[it->first],_deltaT/6.0,_dvar[it->first],_varEx[it->first]);CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],2*_deltaT/3.0,_f1[it->first]);CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],_deltaT/6.0,_f2[it->first]);CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_y2,_varEx,{0.5*_deltaT,0.5*_deltaT},{&_dvar,&_f2});CHKERRQ(ierr);
+      ierr = mapWMAXPY(_y3,_varEx,{_deltaT/6.0,2*_deltaT/3.0,_deltaT/6.0},{&_dvar,&_f1,&_f2});CHKERRQ(ierr);
 
       // calculate error
       _totErr = computeError();
@@ -444,11 +414,8 @@ PetscErrorCode RK32_WBE::integrate(IntegratorContextImex *obj)
 
     // accept 3rd order solution as update
     _currT = _currT+_deltaT;
-    for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-      VecSet(_varEx[it->first],0.0);
-      ierr = VecCopy(_y3[it->first],_varEx[it->first]);CHKERRQ(ierr);
-      VecSet(_dvar[it->first],0.0);
-    }
+    ierr = mapCopy(_y3,_varEx);CHKERRQ(ierr);
+    ierr = mapSet(_dvar,0.0);CHKERRQ(ierr);
 
     // update rates for explicit variables, and compute updated state for implicit variables
     ierr = obj->d_dt(_currT,_varEx,_dvar,_vardTIm,_varIm,_deltaT);CHKERRQ(ierr);
@@ -473,6 +440,8 @@ PetscErrorCode RK32_WBE::integrate(IntegratorContextImex *obj)
 
   }
 
+  if (_packedState) { ierr = resetPackedMap(_varEx);CHKERRQ(ierr); }
+
   _runTime += MPI_Wtime() - startTime;
 #if VERBOSE > 1
   PetscPrintf(PETSC_COMM_WORLD,"Ending RK32_WBE::integrate in odeSolver.cpp.\n");
@@ -606,72 +575,89 @@ PetscErrorCode RK43_WBE::setInitialConds(map<string,Vec>& varEx,map<string,Vec>&
 
   // explicit part
   _varEx = varEx;
-  for (map<string,Vec>::iterator it=varEx.begin(); it!=varEx.end(); it++ ) {
-    Vec dvar;
-    ierr = VecDuplicate(_varEx[it->first],&dvar); CHKERRQ(ierr);
-    ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
-    _dvar[it->first] = dvar;
-
-    Vec f2;
-    ierr = VecDuplicate(_varEx[it->first],&f2); CHKERRQ(ierr);
-    ierr = VecSet(f2,0.0); CHKERRQ(ierr);
-    _f2[it->first] = f2;
-
-    Vec f3;
-    ierr = VecDuplicate(_varEx[it->first],&f3); CHKERRQ(ierr);
-    ierr = VecSet(f3,0.0); CHKERRQ(ierr);
-    _f3[it->first] = f3;
-
-    Vec f4;
-    ierr = VecDuplicate(_varEx[it->first],&f4); CHKERRQ(ierr);
-    ierr = VecSet(f4,0.0); CHKERRQ(ierr);
-    _f4[it->first] = f4;
-
-    Vec f5;
-    ierr = VecDuplicate(_varEx[it->first],&f5); CHKERRQ(ierr);
-    ierr = VecSet(f5,0.0); CHKERRQ(ierr);
-    _f5[it->first] = f5;
-
-    Vec f6;
-    ierr = VecDuplicate(_varEx[it->first],&f6); CHKERRQ(ierr);
-    ierr = VecSet(f6,0.0); CHKERRQ(ierr);
-    _f6[it->first] = f6;
-
-    Vec k2;
-    ierr = VecDuplicate(_varEx[it->first],&k2); CHKERRQ(ierr);
-    ierr = VecSet(k2,0.0); CHKERRQ(ierr);
-    _k2[it->first] = k2;
-
-    Vec k3;
-    ierr = VecDuplicate(_varEx[it->first],&k3); CHKERRQ(ierr);
-    ierr = VecSet(k3,0.0); CHKERRQ(ierr);
-    _k3[it->first] = k3;
-
-    Vec k4;
-    ierr = VecDuplicate(_varEx[it->first],&k4); CHKERRQ(ierr);
-    ierr = VecSet(k4,0.0); CHKERRQ(ierr);
-    _k4[it->first] = k4;
-
-    Vec k5;
-    ierr = VecDuplicate(_varEx[it->first],&k5); CHKERRQ(ierr);
-    ierr = VecSet(k5,0.0); CHKERRQ(ierr);
-    _k5[it->first] = k5;
-
-    Vec k6;
-    ierr = VecDuplicate(_varEx[it->first],&k6); CHKERRQ(ierr);
-    ierr = VecSet(k6,0.0); CHKERRQ(ierr);
-    _k6[it->first] = k6;
-
-
-    Vec y3;
-    ierr = VecDuplicate(_varEx[it->first],&y3); CHKERRQ(ierr);
-    ierr = VecSet(y3,0.0); CHKERRQ(ierr);
-    _y3[it->first] = y3;
-
-    Vec y4;
-    ierr = VecDuplicate(_varEx[it->first],&y4); CHKERRQ(ierr);
-    ierr = VecSet(y4,0.0); CHKERRQ(ierr);
-    _y4[it->first] = y4;
+  if (_packedState) {
+    ierr = createPackedMap(_dvar,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_f2,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_f3,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_f4,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_f5,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_f6,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_k2,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_k3,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_k4,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_k5,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_k6,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_y3,_varEx);CHKERRQ(ierr);
+    ierr = createPackedMap(_y4,_varEx);CHKERRQ(ierr);
+  }
+  else {
+    for (map<string,Vec>::iterator it=varEx.begin(); it!=varEx.end(); it++ ) {
+      Vec dvar;
+      ierr = VecDuplicate(_varEx[it->first],&dvar); CHKERRQ(ierr);
+      ierr = VecSet(dvar,0.0); CHKERRQ(ierr);
+      _dvar[it->first] = dvar;
+
+      Vec f2;
+      ierr = VecDuplicate(_varEx[it->first],&f2); CHKERRQ(ierr);
+      ierr = VecSet(f2,0.0); CHKERRQ(ierr);
+      _f2[it->first] = f2;
+
+      Vec f3;
+      ierr = VecDuplicate(_varEx[it->first],&f3); CHKERRQ(ierr);
+      ierr = VecSet(f3,0.0); CHKERRQ(ierr);
+      _f3[it->first] = f3;
+
+      Vec f4;
+      ierr = VecDuplicate(_varEx[it->first],&f4); CHKERRQ(ierr);
+      ierr = VecSet(f4,0.0); CHKERRQ(ierr);
+      _f4[it->first] = f4;
+
+      Vec f5;
+      ierr = VecDuplicate(_varEx[it->first],&f5); CHKERRQ(ierr);
+      ierr = VecSet(f5,0.0); CHKERRQ(ierr);
+      _f5[it->first] = f5;
+
+      Vec f6;
+      ierr = VecDuplicate(_varEx[it->first],&f6); CHKERRQ(ierr);
+      ierr = VecSet(f6,0.0); CHKERRQ(ierr);
+      _f6[it->first] = f6;
+
+      Vec k2;
+      ierr = VecDuplicate(_varEx[it->first],&k2); CHKERRQ(ierr);
+      ierr = VecSet(k2,0.0); CHKERRQ(ierr);
+      _k2[it->first] = k2;
+
+      Vec k3;
+      ierr = VecDuplicate(_varEx[it->first],&k3); CHKERRQ(ierr);
+      ierr = VecSet(k3,0.0); CHKERRQ(ierr);
+      _k3[it->first] = k3;
+
+      Vec k4;
+      ierr = VecDuplicate(_varEx[it->first],&k4); CHKERRQ(ierr);
+      ierr = VecSet(k4,0.0); CHKERRQ(ierr);
+      _k4[it->first] = k4;
+
+      Vec k5;
+      ierr = VecDuplicate(_varEx[it->first],&k5); CHKERRQ(ierr);
+      ierr = VecSet(k5,0.0); CHKERRQ(ierr);
+      _k5[it->first] = k5;
+
+      Vec k6;
+      ierr = VecDuplicate(_varEx[it->first],&k6); CHKERRQ(ierr);
+      ierr = VecSet(k6,0.0); CHKERRQ(ierr);
+      _k6[it->first] = k6;
+
+
+      Vec y3;
+      ierr = VecDuplicate(_varEx[it->first],&y3); CHKERRQ(ierr);
+      ierr = VecSet(y3,0.0); CHKERRQ(ierr);
+      _y3[it->first] = y3;
+
+      Vec y4;
+      ierr = VecDuplicate(_varEx[it->first],&y4); CHKERRQ(ierr);
+      ierr = VecSet(y4,0.0); CHKERRQ(ierr);
+      _y4[it->first] = y4;
+    }
   }
 
   // implicit part, computed once per time step
@@ -785,52 +771,17 @@ PetscReal RK43_WBE::computeError()
 #if VERBOSE > 1
   PetscPrintf(PETSC_COMM_WORLD,"Starting RK43_WBE::computeError in odeSolverImex.cpp.\n");
 #endif
-  PetscErrorCode ierr = 0;
-  PetscScalar err = 0, _totErr = 0;
-
-  // if using absolute error for control
-  // error: the absolute L2 error, weighted by N and a user-inputted scale factor
-  // tolerance: the absolute tolerance
-  if (_normType.compare("L2_absolute")==0) {
-    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
-      string key = _errInds[i];
-      Vec errVec;
-      VecDuplicate(_y3[key],&errVec);
-      VecSet(errVec,0.0);
-      ierr = VecWAXPY(errVec,-1.0,_y4[key],_y3[key]); CHKERRQ(ierr);
-      VecNorm(errVec,NORM_2,&err);
-      VecDestroy(&errVec);
-
-      PetscInt N = 0;
-      VecGetSize(_y4[key],&N);
-      _totErr += err / (sqrt(N) * _scale[i]);
-    }
-  }
 
-  // if using relative error for control
-  // error: the absolute L2 error, scaled by the L2 norm of the solution
-  // and a user-inputted scale factor
-  // tolerance: the relative tolerance
-  if (_normType.compare("L2_relative")==0) {
-    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
-      string key = _errInds[i];
-      Vec errVec;
-      VecDuplicate(_y3[key],&errVec);
-      VecSet(errVec,0.0);
-      ierr = VecWAXPY(errVec,-1.0,_y4[key],_y3[key]); CHKERRQ(ierr);
-      VecNorm(errVec,NORM_2,&err);
-      VecDestroy(&errVec);
-
-      PetscReal s = 0;
-      VecNorm(_y4[key],NORM_2,&s);
-      _totErr += err / (s * _scale[i]);
-    }
-  }
+  // error: the L2 norm of y3 - y4, weighted by N (L2_absolute) or by the L2 norm
+  // of the solution (L2_relative), and a user-inputted scale factor
+  PetscScalar totErr = 0;
+  PetscErrorCode ierr = mapErrorNorm(totErr,_y3,&_y4,_y4,_errInds,_scale,_normType);CHKERRQ(ierr);
 
 #if VERBOSE > 1
   PetscPrintf(PETSC_COMM_WORLD,"Ending RK43_WBE::computeError in odeSolverImex.cpp.\n");
 #endif
-  return _totErr;
+
+  return totErr;
 }
 
 
@@ -919,6 +870,9 @@ PetscErrorCode RK43_WBE::integrate(IntegratorContextImex *obj)
   if (_maxNumSteps == 0) { return ierr; }
 
 
+  // share storage of the explicitly integrated variables with the packed stages
+  if (_packedState) { ierr = placePackedMap(_varEx);CHKERRQ(ierr); }
+
   // set initial condition
   ierr = obj->d_dt(_currT,_varEx,_dvar);CHKERRQ(ierr);
   _f1 = _dvar;
@@ -933,75 +887,38 @@ PetscErrorCode RK43_WBE::integrate(IntegratorContextImex *obj)
 
       if (_currT+_deltaT>_finalT) { _deltaT=_finalT-_currT; }
 
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        VecSet(_k2[it->first],0.0);
-        VecSet(_k3[it->first],0.0); VecSet(_k4[it->first],0.0);
-        VecSet(_k5[it->first],0.0); VecSet(_k6[it->first],0.0);
-        VecSet(_f2[it->first],0.0);
-        VecSet(_f3[it->first],0.0); VecSet(_f4[it->first],0.0);
-        VecSet(_f5[it->first],0.0); VecSet(_f6[it->first],0.0);
-      }
+      ierr = mapSet(_f2,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f3,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f4,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f5,0.0);CHKERRQ(ierr);
+      ierr = mapSet(_f6,0.0);CHKERRQ(ierr);
 
       // stage 1: k1 = var, compute f1 = f(k1)
       _f1 = _dvar;
 
       // stage 2: compute k2
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        ierr = VecWAXPY(_k2[it->first],a21*_deltaT,_f1[it->first],_varEx[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWAXPY(_k2,a21*_deltaT,_f1,_varEx);CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c2*_deltaT,_k2,_f2);CHKERRQ(ierr); // compute f2
 
       // stage 3: compute k3
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        ierr = VecWAXPY(_k3[it->first],a31*_deltaT,_f1[it->first],_varEx[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_k3[it->first],a32*_deltaT,_f2[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k3,_varEx,{a31*_deltaT,a32*_deltaT},{&_f1,&_f2});CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c3*_deltaT,_k3,_f3);CHKERRQ(ierr); // compute f3
 
       // stage 4
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        ierr = VecWAXPY(_k4[it->first],a41*_deltaT,_f1[it->first],_varEx[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k4[it->first],a42*_deltaT,_f2[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k4[it->first],a43*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k4,_varEx,{a41*_deltaT,a42*_deltaT,a43*_deltaT},{&_f1,&_f2,&_f3});CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c4*_deltaT,_k4,_f4);CHKERRQ(ierr); // compute f4
 
       // stage 5
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        ierr = VecWAXPY(_k5[it->first],a51*_deltaT,_f1[it->first],_varEx[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k5[it->first],a52*_deltaT,_f2[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k5[it->first],a53*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k5[it->first],a54*_deltaT,_f4[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k5,_varEx,{a51*_deltaT,a52*_deltaT,a53*_deltaT,a54*_deltaT},{&_f1,&_f2,&_f3,&_f4});CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c5*_deltaT,_k5,_f5);CHKERRQ(ierr); // compute f5
 
       // stage 6
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        ierr = VecWAXPY(_k6[it->first],a61*_deltaT,_f1[it->first],_varEx[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k6[it->first],a62*_deltaT,_f2[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k6[it->first],a63*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k6[it->first],a64*_deltaT,_f4[it->first]); CHKERRQ(ierr);
-        ierr =  VecAXPY(_k6[it->first],a65*_deltaT,_f5[it->first]); CHKERRQ(ierr);
-      }
+      ierr = mapWMAXPY(_k6,_varEx,{a61*_deltaT,a62*_deltaT,a63*_deltaT,a64*_deltaT,a65*_deltaT},{&_f1,&_f2,&_f3,&_f4,&_f5});CHKERRQ(ierr);
       ierr = obj->d_dt(_currT+c6*_deltaT,_k6,_f6);CHKERRQ(ierr); // compute f6
 
-      // 3rd and 4th order updates
-      for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-        ierr = VecWAXPY(_y3[it->first],hb1*_deltaT,_f1[it->first],_varEx[it->first]); CHKERRQ(ierr);
-        //~ ierr = VecAXPY(_y3[it->first],hb2*_deltaT,_f2[it->first]); CHKERRQ(ierr); // hb2 = 0
-        ierr = VecAXPY(_y3[it->first],hb3*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],hb4*_deltaT,_f4[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],hb5*_deltaT,_f5[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y3[it->first],hb6*_deltaT,_f6[it->first]); CHKERRQ(ierr);
-
-
-        ierr = VecWAXPY(_y4[it->first],b1*_deltaT,_f1[it->first],_varEx[it->first]); CHKERRQ(ierr);
-        //~ ierr = VecAXPY(_y4[it->first],b2*_deltaT,_f2[it->first]); CHKERRQ(ierr); // b2 = 0
-        ierr = VecAXPY(_y4[it->first],b3*_deltaT,_f3[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y4[it->first],b4*_deltaT,_f4[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y4[it->first],b5*_deltaT,_f5[it->first]); CHKERRQ(ierr);
-        ierr = VecAXPY(_y4[it->first],b6*_deltaT,_f6[it->first]); CHKERRQ(ierr);
-      }
+      // 3rd and 4th order updates (hb2 = b2 = 0)
+      ierr = mapWMAXPY(_y3,_varEx,{hb1*_deltaT,hb3*_deltaT,hb4*_deltaT,hb5*_deltaT,hb6*_deltaT},{&_f1,&_f3,&_f4,&_f5,&_f6});CHKERRQ(ierr);
+      ierr = mapWMAXPY(_y4,_varEx,{b1*_deltaT,b3*_deltaT,b4*_deltaT,b5*_deltaT,b6*_deltaT},{&_f1,&_f3,&_f4,&_f5,&_f6});CHKERRQ(ierr);
 
       // calculate error
       _totErr = computeError();
@@ -1014,10 +931,8 @@ PetscErrorCode RK43_WBE::integrate(IntegratorContextImex *obj)
     _currT = _currT+_deltaT;
 
     // accept 4th order solution as update
-    for (map<string,Vec>::iterator it = _varEx.begin(); it!=_varEx.end(); it++ ) {
-      ierr = VecCopy(_y4[it->first],_varEx[it->first]);CHKERRQ(ierr);
-      VecSet(_dvar[it->first],0.0);
-    }
+    ierr = mapCopy(_y4,_varEx);CHKERRQ(ierr);
+    ierr = mapSet(_dvar,0.0);CHKERRQ(ierr);
     // update rates for explicit variables, and compute updated state for implicit variables
     ierr = obj->d_dt(_currT,_varEx,_dvar,_vardTIm,_varIm,_deltaT);CHKERRQ(ierr);
 
@@ -1039,6 +954,8 @@ PetscErrorCode RK43_WBE::integrate(IntegratorContextImex *obj)
     _deltaT = _newDeltaT;
   }
 
+  if (_packedState) { ierr = resetPackedMap(_varEx);CHKERRQ(ierr); }
+
   _runTime += MPI_Wtime() - startTime;
 #if VERBOSE > 1
   PetscPrintf(PETSC_COMM_WORLD,"Ending RK43_WBE::integrate in odeSolver.cpp.\n");
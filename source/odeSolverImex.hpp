@@ -23,6 +23,8 @@ using namespace std;
  * Containers for integration:
  *   var          map<string,Vec> of explicitly integrated variables
  *   varIm    map<string,Vec> of implicitly integrated variables
+ * With setPackedState(true), var and the explicit intermediate stages are
+ * each stored in one contiguous Vec (see createPackedMap in genFuncs.hpp).
  *
  * SOLVER TYPE        ALGORITHM
  *  RK32_WBE        explicit part Runge-Kutta (2,3), implicit controlled by user
@@ -71,6 +73,7 @@ public:
   double                  _runTime;
   string                  _controlType;
   string                  _normType;
+  bool                    _packedState; // if true, store each set of explicit integration variables in one contiguous Vec
 
   PetscReal   _minDeltaT,_maxDeltaT;
   PetscReal   _totTol; // total tolerance, might be atol, or rtol, or a combination of both
@@ -86,6 +89,7 @@ public:
   // member functions
   PetscErrorCode setInitialStepCount(const PetscReal stepCount);
   PetscErrorCode setToleranceType(const string normType); // type of norm used for error control
+  PetscErrorCode setPackedState(const bool packedState); // must be called before setInitialConds
 
   // virtual member functions are declared in base class and redefined in derived class
   virtual PetscErrorCode setTimeRange(const PetscReal initT,const PetscReal finalT) = 0;
@@ -0,0 +1,471 @@
+#include "odeSolver_TS.hpp"
+
+using namespace std;
+
+//======================================================================
+//                  OdeSolver_TS child class
+//======================================================================
+
+OdeSolver_TS::OdeSolver_TS(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType,string tsType,string jacobianType)
+  : OdeSolver(maxNumSteps,finalT,deltaT,controlType),
+  _tsType(tsType),_jacobianType(jacobianType),
+  _minDeltaT(0),_maxDeltaT(finalT),_totTol(1e-9),
+  _numRhsEvals(0),_numJacEvals(0),
+  _obj(NULL),_ts(NULL),_J(NULL),_P(NULL),_X(NULL),_atol(NULL),_rtol(NULL),
+  _Xp(NULL),_F0(NULL),_Fh(NULL),_jacT(0)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting OdeSolver_TS::constructor in odeSolver_TS.cpp.\n");
+  #endif
+
+  assert(_tsType.compare("TSARKIMEX")==0 || _tsType.compare("TSROSW")==0 || _tsType.compare("TSBDF")==0);
+  assert(_jacobianType.compare("mf")==0 || _jacobianType.compare("diagonal")==0);
+
+  // not used for error control, but kept for checkpointing
+  _errA.resize(2);
+  _errA.push_front(0);
+  _errA.push_front(0);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending OdeSolver_TS::constructor in odeSolver_TS.cpp.\n");
+  #endif
+}
+
+
+OdeSolver_TS::~OdeSolver_TS()
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting OdeSolver_TS::destructor in odeSolver_TS.cpp.\n");
+  #endif
+
+  TSDestroy(&_ts);
+  MatDestroy(&_J);
+  MatDestroy(&_P);
+  VecDestroy(&_atol);
+  VecDestroy(&_rtol);
+  VecDestroy(&_Xp);
+  VecDestroy(&_F0);
+  VecDestroy(&_Fh);
+  destroyVector(_U);
+  destroyVector(_F);
+  destroyVector(_dvar);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending OdeSolver_TS::destructor in odeSolver_TS.cpp.\n");
+  #endif
+}
+
+
+// print out various information about the method
+PetscErrorCode OdeSolver_TS::view()
+{
+  PetscErrorCode ierr = 0;
+  PetscInt numRejectedSteps = 0, numNonlinearIts = 0, numLinearIts = 0;
+  if (_ts != NULL) {
+    ierr = TSGetStepRejections(_ts,&numRejectedSteps);CHKERRQ(ierr);
+    ierr = TSGetSNESIterations(_ts,&numNonlinearIts);CHKERRQ(ierr);
+    ierr = TSGetKSPIterations(_ts,&numLinearIts);CHKERRQ(ierr);
+  }
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"\nTime Integration summary:\n\n");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   integration algorithm: PETSc TS (%s)\n",_tsType.c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   Jacobian preconditioner: %s\n",_jacobianType.c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   norm type used to measure error: %s\n",_normType.c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   variables used in determining time step = %s\n",vector2str(_errInds).c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   scale factors = %s\n",vector2str(_scale).c_str());CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   time interval: %g to %g\n",_initT,_finalT);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   permitted step size range: [%g,%g]\n",_minDeltaT,_maxDeltaT);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   total number of steps taken: %i/%i\n",_stepCount,_maxNumSteps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   final time reached: %g\n",_currT);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   tolerance: %g\n",_totTol);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of rejected steps: %i\n",numRejectedSteps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of nonlinear iterations: %i\n",numNonlinearIts);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of linear iterations: %i\n",numLinearIts);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of Jacobian evaluations: %i\n",_numJacEvals);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of d_dt evaluations: %i\n",_numRhsEvals);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   total run time: %g\n",_runTime);CHKERRQ(ierr);
+  return 0;
+}
+
+
+PetscErrorCode OdeSolver_TS::setTolerance(const PetscReal tol)
+{
+  _totTol = tol;
+  return 0;
+}
+
+
+PetscErrorCode OdeSolver_TS::setTimeStepBounds(const PetscReal minDeltaT, const PetscReal maxDeltaT)
+{
+  _minDeltaT = minDeltaT;
+  _maxDeltaT = maxDeltaT;
+  return 0;
+}
+
+
+PetscErrorCode OdeSolver_TS::setErrInds(vector<string>& errInds)
+{
+  _errInds = errInds;
+  return 0;
+}
+
+
+PetscErrorCode OdeSolver_TS::setErrInds(vector<string>& errInds, vector<double> scale)
+{
+  _errInds = errInds;
+  _scale = scale;
+  return 0;
+}
+
+
+// set _var, and create the TS object and the Jacobian
+PetscErrorCode OdeSolver_TS::setInitialConds(map<string,Vec>& var)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting OdeSolver_TS::setInitialConds in odeSolver_TS.cpp.\n");
+  #endif
+
+  double startTime = MPI_Wtime();
+  PetscErrorCode ierr = 0;
+  _var = var;
+
+  // _dvar, and views for the arguments of the TS callbacks, which are given
+  // storage with VecPlaceArray before each call to d_dt
+  PetscInt nTot = 0;
+  for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
+    Vec dvar;
+    ierr = VecDuplicate(it->second,&dvar);CHKERRQ(ierr);
+    ierr = VecSet(dvar,0.0);CHKERRQ(ierr);
+    _dvar[it->first] = dvar;
+
+    MPI_Comm comm;
+    PetscInt n = 0, N = 0;
+    ierr = PetscObjectGetComm((PetscObject) it->second,&comm);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(it->second,&n);CHKERRQ(ierr);
+    ierr = VecGetSize(it->second,&N);CHKERRQ(ierr);
+    Vec u,f;
+    ierr = VecCreateMPIWithArray(comm,1,n,N,NULL,&u);CHKERRQ(ierr);
+    ierr = VecCreateMPIWithArray(comm,1,n,N,NULL,&f);CHKERRQ(ierr);
+    _U[it->first] = u;
+    _F[it->first] = f;
+    nTot += n;
+  }
+
+  ierr = TSCreate(PETSC_COMM_WORLD,&_ts);CHKERRQ(ierr);
+  ierr = TSSetProblemType(_ts,TS_NONLINEAR);CHKERRQ(ierr);
+  // the PETSc type name is the lower case solver type without "TS", e.g. TSARKIMEX = "arkimex"
+  string type = _tsType.substr(2);
+  transform(type.begin(),type.end(),type.begin(),::tolower);
+  ierr = TSSetType(_ts,type.c_str());CHKERRQ(ierr);
+  if (_tsType.compare("TSARKIMEX")==0) {
+    // treat the whole right-hand side implicitly
+    ierr = TSARKIMEXSetFullyImplicit(_ts,PETSC_TRUE);CHKERRQ(ierr);
+  }
+  ierr = TSSetApplicationContext(_ts,this);CHKERRQ(ierr);
+  ierr = TSSetRHSFunction(_ts,NULL,tsRhsFunction,this);CHKERRQ(ierr);
+  ierr = TSSetPostStep(_ts,tsPostStep);CHKERRQ(ierr);
+  ierr = TSSetExactFinalTime(_ts,TS_EXACTFINALTIME_MATCHSTEP);CHKERRQ(ierr);
+
+  // matrix-free Jacobian, with an optional diagonal preconditioner
+  ierr = MatCreateMFFD(PETSC_COMM_WORLD,nTot,nTot,PETSC_DETERMINE,PETSC_DETERMINE,&_J);CHKERRQ(ierr);
+  ierr = MatMFFDSetFunction(_J,mffdFunction,this);CHKERRQ(ierr);
+  if (_jacobianType.compare("diagonal")==0) {
+    ierr = MatCreateAIJ(PETSC_COMM_WORLD,nTot,nTot,PETSC_DETERMINE,PETSC_DETERMINE,1,NULL,0,NULL,&_P);CHKERRQ(ierr);
+    ierr = TSSetRHSJacobian(_ts,_J,_P,tsRhsJacobian,this);CHKERRQ(ierr);
+  }
+  else {
+    ierr = TSSetRHSJacobian(_ts,_J,_J,tsRhsJacobian,this);CHKERRQ(ierr);
+  }
+
+  SNES snes;
+  KSP ksp;
+  PC pc;
+  ierr = TSGetSNES(_ts,&snes);CHKERRQ(ierr);
+  ierr = SNESGetKSP(snes,&ksp);CHKERRQ(ierr);
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  if (_P != NULL) { ierr = PCSetType(pc,PCJACOBI);CHKERRQ(ierr); }
+  else { ierr = PCSetType(pc,PCNONE);CHKERRQ(ierr); }
+
+  _runTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending OdeSolver_TS::setInitialConds in odeSolver_TS.cpp.\n");
+  #endif
+
+  return ierr;
+}
+
+
+// give the views the storage of arr, in the order of the map
+PetscErrorCode OdeSolver_TS::placeViews(map<string,Vec>& views,PetscScalar *arr)
+{
+  PetscErrorCode ierr = 0;
+  PetscInt offset = 0;
+  for (map<string,Vec>::iterator it = views.begin(); it!=views.end(); it++ ) {
+    PetscInt n = 0;
+    ierr = VecGetLocalSize(it->second,&n);CHKERRQ(ierr);
+    ierr = VecPlaceArray(it->second,arr+offset);CHKERRQ(ierr);
+    offset += n;
+  }
+  return ierr;
+}
+
+PetscErrorCode OdeSolver_TS::resetViews(map<string,Vec>& views)
+{
+  PetscErrorCode ierr = 0;
+  for (map<string,Vec>::iterator it = views.begin(); it!=views.end(); it++ ) {
+    ierr = VecResetArray(it->second);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+
+// F = f(time,X), by calling d_dt on views of X and F
+PetscErrorCode OdeSolver_TS::rhs(const PetscReal time,Vec X,Vec F)
+{
+  PetscErrorCode ierr = 0;
+  const PetscScalar *x;
+  PetscScalar *f;
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(F,&f);CHKERRQ(ierr);
+  ierr = placeViews(_U,(PetscScalar*) x);CHKERRQ(ierr);
+  ierr = placeViews(_F,f);CHKERRQ(ierr);
+
+  ierr = _obj->d_dt(time,_U,_F);CHKERRQ(ierr);
+  _numRhsEvals++;
+
+  ierr = resetViews(_U);CHKERRQ(ierr);
+  ierr = resetViews(_F);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(F,&f);CHKERRQ(ierr);
+  return ierr;
+}
+
+
+// tolerances per entry of the solution for TSAdapt
+// variables not in errInds get an infinite tolerance, so they don't contribute
+// for L2_relative, the tolerance is also used as an absolute tolerance, so
+// that variables which pass through zero, such as slip, can be controlled
+PetscErrorCode OdeSolver_TS::setUpTolerances()
+{
+  PetscErrorCode ierr = 0;
+  const bool isRel = _normType.compare("L2_relative")==0;
+  if (_atol == NULL) { ierr = VecDuplicate(_X,&_atol);CHKERRQ(ierr); }
+  if (_rtol == NULL) { ierr = VecDuplicate(_X,&_rtol);CHKERRQ(ierr); }
+
+  PetscScalar *atol,*rtol;
+  ierr = VecGetArray(_atol,&atol);CHKERRQ(ierr);
+  ierr = VecGetArray(_rtol,&rtol);CHKERRQ(ierr);
+  PetscInt offset = 0;
+  for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
+    PetscInt n = 0;
+    ierr = VecGetLocalSize(it->second,&n);CHKERRQ(ierr);
+    PetscScalar a = PETSC_MAX_REAL, r = 0;
+    vector<string>::iterator ind = find(_errInds.begin(),_errInds.end(),it->first);
+    if (ind != _errInds.end()) {
+      a = _totTol * _scale[ind - _errInds.begin()];
+      r = isRel ? a : 0;
+    }
+    for (PetscInt j = 0; j < n; j++) {
+      atol[offset+j] = a;
+      rtol[offset+j] = r;
+    }
+    offset += n;
+  }
+  ierr = VecRestoreArray(_atol,&atol);CHKERRQ(ierr);
+  ierr = VecRestoreArray(_rtol,&rtol);CHKERRQ(ierr);
+
+  ierr = TSSetTolerances(_ts,0,_atol,0,_rtol);CHKERRQ(ierr);
+  return ierr;
+}
+
+
+// diagonal approximation of the Jacobian: each integrated variable is
+// perturbed at every point at once, and only the change in its own rate at the
+// same point is kept. This is exact for fields whose rate depends only on
+// their own local value, and approximates the rest by the row sums of the
+// variable's diagonal block.
+PetscErrorCode OdeSolver_TS::computeDiagonal(const PetscReal time,Vec X,Mat P)
+{
+  PetscErrorCode ierr = 0;
+  if (_Xp == NULL) {
+    ierr = VecDuplicate(X,&_Xp);CHKERRQ(ierr);
+    ierr = VecDuplicate(X,&_F0);CHKERRQ(ierr);
+    ierr = VecDuplicate(X,&_Fh);CHKERRQ(ierr);
+  }
+  ierr = rhs(time,X,_F0);CHKERRQ(ierr);
+
+  PetscInt nLocal = 0, Istart = 0, Iend = 0;
+  ierr = VecGetLocalSize(X,&nLocal);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(X,&Istart,&Iend);CHKERRQ(ierr);
+  vector<PetscScalar> diag(nLocal,0.0), h(nLocal,0.0);
+  const PetscReal sqrtEps = sqrt(PETSC_MACHINE_EPSILON);
+
+  PetscInt offset = 0;
+  for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
+    PetscInt n = 0;
+    ierr = VecGetLocalSize(it->second,&n);CHKERRQ(ierr);
+
+    PetscScalar *xp;
+    ierr = VecCopy(X,_Xp);CHKERRQ(ierr);
+    ierr = VecGetArray(_Xp,&xp);CHKERRQ(ierr);
+    for (PetscInt j = offset; j < offset+n; j++) {
+      h[j] = sqrtEps * max(abs(xp[j]),1.0);
+      xp[j] += h[j];
+    }
+    ierr = VecRestoreArray(_Xp,&xp);CHKERRQ(ierr);
+
+    // every process calls d_dt, even if it owns no part of this variable
+    ierr = rhs(time,_Xp,_Fh);CHKERRQ(ierr);
+
+    const PetscScalar *f0,*fh;
+    ierr = VecGetArrayRead(_F0,&f0);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(_Fh,&fh);CHKERRQ(ierr);
+    for (PetscInt j = offset; j < offset+n; j++) {
+      diag[j] = (fh[j] - f0[j]) / h[j];
+    }
+    ierr = VecRestoreArrayRead(_F0,&f0);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(_Fh,&fh);CHKERRQ(ierr);
+    offset += n;
+  }
+
+  for (PetscInt Ii = Istart; Ii < Iend; Ii++) {
+    ierr = MatSetValue(P,Ii,Ii,diag[Ii-Istart],INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  return ierr;
+}
+
+
+PetscErrorCode OdeSolver_TS::tsRhsFunction(TS ts,PetscReal time,Vec X,Vec F,void *ctx)
+{
+  OdeSolver_TS *solver = (OdeSolver_TS*) ctx;
+  return solver->rhs(time,X,F);
+}
+
+PetscErrorCode OdeSolver_TS::mffdFunction(void *ctx,Vec X,Vec F)
+{
+  OdeSolver_TS *solver = (OdeSolver_TS*) ctx;
+  return solver->rhs(solver->_jacT,X,F);
+}
+
+PetscErrorCode OdeSolver_TS::tsRhsJacobian(TS ts,PetscReal time,Vec X,Mat J,Mat P,void *ctx)
+{
+  PetscErrorCode ierr = 0;
+  OdeSolver_TS *solver = (OdeSolver_TS*) ctx;
+  solver->_jacT = time;
+  solver->_numJacEvals++;
+  ierr = MatMFFDSetBase(J,X,NULL);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(J,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(J,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  if (P != J) { ierr = solver->computeDiagonal(time,X,P);CHKERRQ(ierr); }
+  return ierr;
+}
+
+
+// after each accepted step, bring the integrated object up to date with the
+// new solution and call its timeMonitor
+PetscErrorCode OdeSolver_TS::tsPostStep(TS ts)
+{
+  PetscErrorCode ierr = 0;
+  void *ctx;
+  ierr = TSGetApplicationContext(ts,&ctx);CHKERRQ(ierr);
+  OdeSolver_TS *solver = (OdeSolver_TS*) ctx;
+
+  PetscReal time = 0, prevTime = 0, nextDeltaT = 0;
+  PetscInt stepCount = 0;
+  ierr = TSGetTime(ts,&time);CHKERRQ(ierr);
+  ierr = TSGetPrevTime(ts,&prevTime);CHKERRQ(ierr);
+  ierr = TSGetTimeStep(ts,&nextDeltaT);CHKERRQ(ierr);
+  ierr = TSGetStepNumber(ts,&stepCount);CHKERRQ(ierr);
+  solver->_currT = time;
+  solver->_deltaT = time - prevTime;
+  solver->_newDeltaT = nextDeltaT;
+  solver->_stepCount = stepCount;
+
+  // TS changed the array of _X directly, so the views in _var must be marked as changed
+  for (map<string,Vec>::iterator it = solver->_var.begin(); it!=solver->_var.end(); it++ ) {
+    ierr = PetscObjectStateIncrease((PetscObject) it->second);CHKERRQ(ierr);
+  }
+  ierr = solver->_obj->d_dt(time,solver->_var,solver->_dvar);CHKERRQ(ierr);
+  solver->_numRhsEvals++;
+
+  int stopIntegration = 0;
+  ierr = solver->_obj->timeMonitor(time,solver->_deltaT,stepCount,stopIntegration);CHKERRQ(ierr);
+  if (stopIntegration > 0) {
+    PetscPrintf(PETSC_COMM_WORLD,"OdeSolver_TS: Detected stop time integration request.\n");
+    ierr = TSSetConvergedReason(ts,TS_CONVERGED_USER);CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+
+PetscErrorCode OdeSolver_TS::integrate(IntegratorContextEx *obj)
+{
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Starting OdeSolver_TS::integrate in odeSolver_TS.cpp.\n");
+  #endif
+
+  double startTime = MPI_Wtime();
+  PetscErrorCode ierr = 0;
+  _obj = obj;
+
+  // build default errInds
+  if (_errInds.size()==0) {
+    for (map<string,Vec>::iterator it = _var.begin(); it!=_var.end(); it++ ) {
+      _errInds.push_back(it->first);
+    }
+  }
+
+  // check that errInds is valid
+  for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
+    string key = _errInds[i];
+    if (_var.find(key) == _var.end()) {
+      PetscPrintf(PETSC_COMM_WORLD,"OdeSolver_TS ERROR: %s is not an element of explicitly integrated variable!\n",key.c_str());
+    }
+    assert(_var.find(key) != _var.end());
+  }
+
+  // set up scaling for elements in errInds
+  if (_scale.size() == 0) { // if 0 entries, set all to 1
+    for(vector<int>::size_type i = 0; i != _errInds.size(); i++) {
+      _scale.push_back(1.0);
+    }
+  }
+  assert(_scale.size() == _errInds.size());
+
+  if (_finalT == _initT) { return ierr; }
+  if (_deltaT == 0) { _deltaT = (_finalT - _initT) / _maxNumSteps; }
+  if (_maxNumSteps == 0) { return ierr; }
+
+  // TS integrates the contiguous Vec that the integration variables are views into
+  ierr = placePackedMap(_var);CHKERRQ(ierr);
+  ierr = getPackedVec(_var,_X);CHKERRQ(ierr);
+  ierr = setUpTolerances();CHKERRQ(ierr);
+
+  TSAdapt adapt;
+  ierr = TSGetAdapt(_ts,&adapt);CHKERRQ(ierr);
+  ierr = TSAdaptSetStepLimits(adapt,_minDeltaT,_maxDeltaT);CHKERRQ(ierr);
+  ierr = TSSetTime(_ts,_currT);CHKERRQ(ierr);
+  ierr = TSSetTimeStep(_ts,_deltaT);CHKERRQ(ierr);
+  ierr = TSSetMaxTime(_ts,_finalT);CHKERRQ(ierr);
+  ierr = TSSetStepNumber(_ts,_stepCount);CHKERRQ(ierr);
+  ierr = TSSetMaxSteps(_ts,_maxNumSteps);CHKERRQ(ierr);
+  ierr = TSSetFromOptions(_ts);CHKERRQ(ierr);
+
+  ierr = TSSolve(_ts,_X);CHKERRQ(ierr);
+
+  ierr = TSGetTime(_ts,&_currT);CHKERRQ(ierr);
+  ierr = TSGetStepNumber(_ts,&_stepCount);CHKERRQ(ierr);
+  ierr = resetPackedMap(_var);CHKERRQ(ierr);
+  _X = NULL;
+
+  _runTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending OdeSolver_TS::integrate in odeSolver_TS.cpp.\n");
+  #endif
+
+  return ierr;
+}
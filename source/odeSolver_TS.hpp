@@ -0,0 +1,92 @@
+#ifndef ODESOLVER_TS_HPP_INCLUDED
+#define ODESOLVER_TS_HPP_INCLUDED
+
+#include <petscts.h>
+#include <string>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <assert.h>
+#include "integratorContextEx.hpp"
+#include "odeSolver.hpp"
+#include "genFuncs.hpp"
+
+using namespace std;
+
+/*
+ * Adapter which solves the system y' = f(t,y) of an IntegratorContextEx with
+ * a PETSc TS object, so that PETSc's implicit and linearly implicit methods
+ * can be used during long interseismic periods, when stiffness limits the
+ * step size of the explicit methods.
+ *
+ * SOLVER TYPE      ALGORITHM
+ *  TSARKIMEX     fully implicit additive Runge-Kutta
+ *  TSROSW        Rosenbrock-W
+ *  TSBDF         backward differentiation formulas
+ *
+ * y is packed into one contiguous Vec for TS, and the Vecs of the array
+ * given to setInitialConds are views into it during integrate.
+ * The Jacobian of f is applied matrix-free by finite differencing d_dt.
+ * It is preconditioned by
+ *  mf            nothing
+ *  diagonal      a pointwise (diagonal) approximation of the Jacobian,
+ *                computed with one extra d_dt per integrated variable. For
+ *                the quasi-dynamic problems this is the local Jacobian of the
+ *                fault fields, e.g. of the state variable.
+ *
+ * The error control uses TSAdapt, with the tolerance applied as an absolute
+ * (L2_absolute) or relative (L2_relative) tolerance, weighted by the scale
+ * factors of the variables in errInds. Variables not in errInds do not
+ * contribute to the error. Any TS setting can be changed from the command
+ * line with the usual PETSc options, e.g. -ts_arkimex_type 4.
+ */
+
+class OdeSolver_TS : public OdeSolver
+{
+public:
+
+  string      _tsType; // TSARKIMEX, TSROSW, or TSBDF
+  string      _jacobianType; // mf, or diagonal
+  PetscReal   _minDeltaT,_maxDeltaT;
+  PetscReal   _totTol;
+  PetscInt    _numRhsEvals; // number of calls to d_dt, including those for the Jacobian
+  PetscInt    _numJacEvals;
+
+  IntegratorContextEx *_obj;
+  TS              _ts;
+  Mat             _J,_P; // matrix-free Jacobian, and diagonal preconditioner
+  Vec             _X; // solution, shares storage with _var during integrate
+  Vec             _atol,_rtol; // tolerances per entry of _X
+  Vec             _Xp,_F0,_Fh; // for the diagonal preconditioner
+  map<string,Vec> _U,_F; // views of the arrays of the Vecs passed to the TS callbacks
+  PetscReal       _jacT; // time at which the Jacobian is linearized
+
+  // constructor and destructor
+  OdeSolver_TS(PetscInt maxNumSteps,PetscReal finalT,PetscReal deltaT,string controlType,string tsType,string jacobianType);
+  ~OdeSolver_TS();
+
+  // various member functions
+  PetscErrorCode setTolerance(const PetscReal tol);
+  PetscErrorCode setTimeStepBounds(const PetscReal minDeltaT, const PetscReal maxDeltaT);
+  PetscErrorCode setInitialConds(map<string,Vec>& var);
+  PetscErrorCode setErrInds(vector<string>& errInds);
+  PetscErrorCode setErrInds(vector<string>& errInds, vector<double> scale);
+  PetscErrorCode view();
+  PetscErrorCode integrate(IntegratorContextEx *obj);
+
+  // evaluate f(t,y) with y and f stored in contiguous Vecs
+  PetscErrorCode rhs(const PetscReal time,Vec X,Vec F);
+  PetscErrorCode placeViews(map<string,Vec>& views,PetscScalar *arr);
+  PetscErrorCode resetViews(map<string,Vec>& views);
+  PetscErrorCode setUpTolerances();
+  PetscErrorCode computeDiagonal(const PetscReal time,Vec X,Mat P);
+
+  // callbacks for TS
+  static PetscErrorCode tsRhsFunction(TS ts,PetscReal time,Vec X,Vec F,void *ctx);
+  static PetscErrorCode tsRhsJacobian(TS ts,PetscReal time,Vec X,Mat J,Mat P,void *ctx);
+  static PetscErrorCode mffdFunction(void *ctx,Vec X,Vec F);
+  static PetscErrorCode tsPostStep(TS ts);
+};
+
+#endif
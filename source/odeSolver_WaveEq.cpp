@@ -166,11 +166,10 @@ PetscErrorCode OdeSolver_WaveEq::integrate(IntegratorContext_WaveEq *obj)
     ierr = obj->d_dt(_currT,_deltaT,_varNext,_var,_varPrev);CHKERRQ(ierr);
 
     // accept time step and update
-    for (map<string,Vec>::iterator it = _var.begin(); it != _var.end(); it++ ) {
-      VecCopy(_var[it->first],_varPrev[it->first]);
-      VecCopy(_varNext[it->first],_var[it->first]);
-      VecSet(_varNext[it->first],0.0);
-    }
+    // rotate the buffers by swapping Vec handles: n -> n-1, n+1 -> n, and the
+    // old n-1 is reused as n+1 (d_dt overwrites every entry of varNext)
+    _varPrev.swap(_var);
+    _var.swap(_varNext);
 
     ierr = obj->timeMonitor(_currT,_deltaT,_stepCount,stopIntegration);CHKERRQ(ierr);
     if (stopIntegration > 0) { PetscPrintf(PETSC_COMM_WORLD,"OdeSolver WaveEq: Detected stop time integration request.\n"); break; }
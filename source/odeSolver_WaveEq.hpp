@@ -18,6 +18,7 @@ class OdeSolver_WaveEq
     PetscScalar             _initT,_finalT,_currT,_deltaT;
     PetscInt                _maxNumSteps,_stepCount;
     std::map<string,Vec>    _varNext,_var,_varPrev; // variable at time step: n+1, n, n-1
+    // (a ring of buffers whose roles rotate each step, so d_dt must write all of varNext)
     int                     _lenVar;
     double                  _runTime;
 
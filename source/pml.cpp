@@ -0,0 +1,198 @@
+#include "pml.hpp"
+
+#define FILENAME "pml.cpp"
+
+using namespace std;
+
+
+PerfectlyMatchedLayer::PerfectlyMatchedLayer(Domain& D,const PetscScalar thickness,const PetscScalar R)
+: _thickness(thickness),_R(R),_Ly(D._Ly),_Lz(D._Lz),_y(&D._y),_z(&D._z),
+  _sbp(NULL),_mu(NULL),_rho(NULL),
+  _zetaY(NULL),_zetaZ(NULL),_damping(NULL),_psiY(NULL),_psiZ(NULL),
+  _force(NULL),_uHalf(NULL),_du(NULL)
+{
+  assert(_thickness > 0 && _thickness < min(_Ly,_Lz));
+  assert(_R > 0 && _R < 1);
+
+  VecDuplicate(*_y,&_zetaY);
+  VecDuplicate(*_y,&_zetaZ);
+  VecDuplicate(*_y,&_damping);
+  VecDuplicate(*_y,&_psiY);
+  VecDuplicate(*_y,&_psiZ);
+  VecDuplicate(*_y,&_force);
+  VecDuplicate(*_y,&_uHalf);
+  VecDuplicate(*_y,&_du);
+  reset();
+}
+
+PerfectlyMatchedLayer::~PerfectlyMatchedLayer()
+{
+  VecDestroy(&_zetaY);
+  VecDestroy(&_zetaZ);
+  VecDestroy(&_damping);
+  VecDestroy(&_psiY);
+  VecDestroy(&_psiZ);
+  VecDestroy(&_force);
+  VecDestroy(&_uHalf);
+  VecDestroy(&_du);
+}
+
+
+// Compute the damping profiles. For a quadratic profile
+//   zeta(d) = zeta0 * (d/thickness)^2, with d the distance into the layer,
+// a reflection coefficient R at normal incidence requires
+//   zeta0 = 3*cs*log(1/R) / (2*thickness).
+PetscErrorCode PerfectlyMatchedLayer::setFields(SbpOps* sbp,const Vec& mu,const Vec& rho,const Vec& cs)
+{
+  PetscErrorCode ierr = 0;
+#if VERBOSE > 1
+  string funcName = "PerfectlyMatchedLayer::setFields";
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s.\n",funcName.c_str(),FILENAME);CHKERRQ(ierr);
+#endif
+
+  _sbp = sbp;
+  _mu = mu;
+  _rho = rho;
+
+  PetscInt           Ii,Istart,Iend;
+  PetscScalar       *zetaY,*zetaZ,*damping;
+  const PetscScalar *y,*z,*c;
+  ierr = VecGetOwnershipRange(_zetaY,&Istart,&Iend);CHKERRQ(ierr);
+  ierr = VecGetArray(_zetaY,&zetaY);CHKERRQ(ierr);
+  ierr = VecGetArray(_zetaZ,&zetaZ);CHKERRQ(ierr);
+  ierr = VecGetArray(_damping,&damping);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(*_y,&y);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(*_z,&z);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(cs,&c);CHKERRQ(ierr);
+  PetscInt Jj = 0;
+  for (Ii = Istart; Ii < Iend; Ii++) {
+    PetscScalar zeta0 = 3.0 * c[Jj] * log(1.0/_R) / (2.0 * _thickness);
+    PetscScalar dy = max(0.0, y[Jj] - (_Ly - _thickness)) / _thickness;
+    PetscScalar dz = max(0.0, z[Jj] - (_Lz - _thickness)) / _thickness;
+    zetaY[Jj] = zeta0 * dy * dy;
+    zetaZ[Jj] = zeta0 * dz * dz;
+    damping[Jj] = 0.5 * (zetaY[Jj] + zetaZ[Jj]);
+    Jj++;
+  }
+  ierr = VecRestoreArray(_zetaY,&zetaY);CHKERRQ(ierr);
+  ierr = VecRestoreArray(_zetaZ,&zetaZ);CHKERRQ(ierr);
+  ierr = VecRestoreArray(_damping,&damping);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(*_y,&y);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(*_z,&z);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(cs,&c);CHKERRQ(ierr);
+
+#if VERBOSE > 1
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s.\n",funcName.c_str(),FILENAME);CHKERRQ(ierr);
+#endif
+  return ierr;
+}
+
+
+PetscErrorCode PerfectlyMatchedLayer::reset()
+{
+  PetscErrorCode ierr = 0;
+  ierr = VecSet(_psiY,0.0); CHKERRQ(ierr);
+  ierr = VecSet(_psiZ,0.0); CHKERRQ(ierr);
+  return ierr;
+}
+
+
+// advance psiY and psiZ from the time of uPrev to the time of u, with
+// the decay term treated by the trapezoidal rule and Dy*u, Dz*u evaluated
+// at the midpoint (u + uPrev)/2
+PetscErrorCode PerfectlyMatchedLayer::updateAuxFields(const Vec& u,const Vec& uPrev,const PetscScalar deltaT)
+{
+  PetscErrorCode ierr = 0;
+#if VERBOSE > 1
+  string funcName = "PerfectlyMatchedLayer::updateAuxFields";
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s.\n",funcName.c_str(),FILENAME);CHKERRQ(ierr);
+#endif
+
+  assert(_sbp != NULL);
+  Mat Dy,Dz;
+  ierr = _sbp->getDs(Dy,Dz); CHKERRQ(ierr);
+  ierr = VecAXPBYPCZ(_uHalf,0.5,0.5,0.0,u,uPrev); CHKERRQ(ierr);
+
+  // psiY, with du = Dy*uHalf
+  ierr = MatMult(Dy,_uHalf,_du); CHKERRQ(ierr);
+  ierr = advance(_psiY,_zetaY,_zetaZ,deltaT); CHKERRQ(ierr);
+
+  // psiZ, with du = Dz*uHalf
+  ierr = MatMult(Dz,_uHalf,_du); CHKERRQ(ierr);
+  ierr = advance(_psiZ,_zetaZ,_zetaY,deltaT); CHKERRQ(ierr);
+
+#if VERBOSE > 1
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s.\n",funcName.c_str(),FILENAME);CHKERRQ(ierr);
+#endif
+  return ierr;
+}
+
+
+// psi = ((1 - dt*zeta/2)*psi + dt*mu*(zetaOther - zeta)*du) / (1 + dt*zeta/2)
+PetscErrorCode PerfectlyMatchedLayer::advance(Vec& psi,const Vec& zeta,const Vec& zetaOther,const PetscScalar deltaT)
+{
+  PetscErrorCode ierr = 0;
+
+  PetscInt           Ii,Istart,Iend;
+  PetscScalar       *p;
+  const PetscScalar *z1,*z2,*mu,*du;
+  ierr = VecGetOwnershipRange(psi,&Istart,&Iend);CHKERRQ(ierr);
+  ierr = VecGetArray(psi,&p);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(zeta,&z1);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(zetaOther,&z2);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(_mu,&mu);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(_du,&du);CHKERRQ(ierr);
+  PetscInt Jj = 0;
+  for (Ii = Istart; Ii < Iend; Ii++) {
+    p[Jj] = ((1.0 - 0.5*deltaT*z1[Jj])*p[Jj] + deltaT*mu[Jj]*(z2[Jj] - z1[Jj])*du[Jj]) / (1.0 + 0.5*deltaT*z1[Jj]);
+    Jj++;
+  }
+  ierr = VecRestoreArray(psi,&p);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(zeta,&z1);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(zetaOther,&z2);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(_mu,&mu);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(_du,&du);CHKERRQ(ierr);
+
+  return ierr;
+}
+
+
+// _force = Dy*psiY + Dz*psiZ - rho*zetaY*zetaZ*u
+PetscErrorCode PerfectlyMatchedLayer::computeForce(const Vec& u)
+{
+  PetscErrorCode ierr = 0;
+#if VERBOSE > 1
+  string funcName = "PerfectlyMatchedLayer::computeForce";
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s.\n",funcName.c_str(),FILENAME);CHKERRQ(ierr);
+#endif
+
+  Mat Dy,Dz;
+  ierr = _sbp->getDs(Dy,Dz); CHKERRQ(ierr);
+  ierr = MatMult(Dy,_psiY,_force); CHKERRQ(ierr);
+  ierr = MatMultAdd(Dz,_psiZ,_force,_force); CHKERRQ(ierr);
+
+  PetscInt           Ii,Istart,Iend;
+  PetscScalar       *f;
+  const PetscScalar *uA,*rho,*zetaY,*zetaZ;
+  ierr = VecGetOwnershipRange(_force,&Istart,&Iend);CHKERRQ(ierr);
+  ierr = VecGetArray(_force,&f);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(u,&uA);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(_rho,&rho);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(_zetaY,&zetaY);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(_zetaZ,&zetaZ);CHKERRQ(ierr);
+  PetscInt Jj = 0;
+  for (Ii = Istart; Ii < Iend; Ii++) {
+    f[Jj] -= rho[Jj] * zetaY[Jj] * zetaZ[Jj] * uA[Jj];
+    Jj++;
+  }
+  ierr = VecRestoreArray(_force,&f);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(u,&uA);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(_rho,&rho);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(_zetaY,&zetaY);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(_zetaZ,&zetaZ);CHKERRQ(ierr);
+
+#if VERBOSE > 1
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s.\n",funcName.c_str(),FILENAME);CHKERRQ(ierr);
+#endif
+  return ierr;
+}
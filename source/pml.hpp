@@ -0,0 +1,68 @@
+#ifndef PML_H_INCLUDED
+#define PML_H_INCLUDED
+
+#include <petscksp.h>
+#include <string>
+#include <cmath>
+#include <assert.h>
+#include "domain.hpp"
+#include "sbpOps.hpp"
+
+using namespace std;
+
+/*
+ * Perfectly matched layer (PML) for the fully dynamic antiplane wave equation
+ *    rho*u_tt = div(mu grad u)
+ * next to the right (y = Ly) and bottom (z = Lz) boundaries, so that outgoing
+ * waves are absorbed before they reach the truncated boundaries. Inside the
+ * layer the second order formulation of Grote and Sim (2010) is solved:
+ *    rho*(u_tt + (zy+zz)*u_t + zy*zz*u) = div(mu grad u) + Dy*psiY + Dz*psiZ
+ *    psiY_t = -zy*psiY + mu*(zz-zy)*Dy*u
+ *    psiZ_t = -zz*psiZ + mu*(zy-zz)*Dz*u
+ * where the damping profiles zy(y), zz(z) are zero outside the layer and grow
+ * quadratically to their maximum at the boundary, and psiY, psiZ are the
+ * auxiliary fields. Dy and Dz are the SBP first derivatives of the wave
+ * solver, so the layer works on the same (possibly variable spacing) grid,
+ * and the boundary conditions of the truncated domain are unchanged.
+ *
+ * Example usage, in each leapfrog step from u to uNext:
+ *    pml.updateAuxFields(u,uPrev,deltaT); // advance psiY, psiZ to the time of u
+ *    pml.computeForce(u);                 // _force = Dy*psiY + Dz*psiZ - rho*zy*zz*u
+ * and add dt^2/rho * _force to the right-hand side of the update, with
+ * _damping = (zy+zz)/2 added to the absorbing term ay. The bottom layer
+ * reaches the fault, so _damping must also be scattered to Fault_fd::_pmlDamping
+ * for the fault nodes inside it.
+ */
+
+class PerfectlyMatchedLayer
+{
+private:
+  // disable default copy constructor and assignment operator
+  PerfectlyMatchedLayer(const PerfectlyMatchedLayer &that);
+  PerfectlyMatchedLayer& operator=(const PerfectlyMatchedLayer &rhs);
+
+  PetscErrorCode advance(Vec& psi,const Vec& zeta,const Vec& zetaOther,const PetscScalar deltaT);
+
+public:
+  const PetscScalar _thickness; // (km) thickness of the layer
+  const PetscScalar _R; // theoretical reflection coefficient of the layer
+  PetscScalar       _Ly,_Lz;
+  Vec              *_y,*_z;
+  SbpOps           *_sbp; // not owned
+  Vec               _mu,_rho; // not owned
+  Vec               _zetaY,_zetaZ; // damping profiles
+  Vec               _damping; // (zetaY + zetaZ)/2, added to the absorbing term ay
+  Vec               _psiY,_psiZ; // auxiliary fields
+  Vec               _force; // Dy*psiY + Dz*psiZ - rho*zetaY*zetaZ*u
+  Vec               _uHalf,_du; // work arrays
+
+  PerfectlyMatchedLayer(Domain& D,const PetscScalar thickness,const PetscScalar R);
+  ~PerfectlyMatchedLayer();
+
+  PetscErrorCode setFields(SbpOps* sbp,const Vec& mu,const Vec& rho,const Vec& cs);
+  PetscErrorCode reset(); // discard the auxiliary fields, e.g. when the fully dynamic phase starts
+  PetscErrorCode updateAuxFields(const Vec& u,const Vec& uPrev,const PetscScalar deltaT);
+  PetscErrorCode computeForce(const Vec& u);
+};
+
+#endif
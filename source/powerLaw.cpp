@@ -753,10 +753,14 @@ PowerLaw::PowerLaw(Domain& D,std::string bcRType,std::string bcTType,std::string
 : _D(&D),_file(D._file),_delim(D._delim),_inputDir(D._inputDir),_outputDir(D._outputDir),
   _order(D._order),_Ny(D._Ny),_Nz(D._Nz),_Ly(D._Ly),_Lz(D._Lz),_y(&D._y),_z(&D._z),
   _isMMS(D._isMMS),_wDiffCreep("no"), _wDislCreep("yes"),_wPlasticity("no"),_wLinearMaxwell("no"),
+  _viscKernelPlastic(0),_viscKernelDisl(0),_viscKernelDiff(0),
   _plastic(NULL),_disl(NULL),_diff(NULL),
   _mu(NULL),_rho(NULL),_cs(NULL),_effVisc(NULL),_T(NULL),_grainSize(NULL),_effViscCap(1e30),
+  _lagViscosity("no"),_lagViscosityTol(1e-2),_viscIsStale(1),_sdevLag(NULL),_viscComputeCount(0),_viscLagCount(0),
+  _measureViscLag(0),_viscLagErr(0),_effViscLag(NULL),
   _u(NULL),_surfDisp(NULL),_sxy(NULL),_sxz(NULL),_sdev(NULL),
   _gTxy(NULL),_gVxy(NULL),_dgVxy(NULL),_gTxz(NULL),_gVxz(NULL),_dgVxz(NULL),_dgVdev(NULL),_dgVdev_disl(NULL),
+  _viscStrainTimeIntType("explicit"),_viscBeNewtonMaxIts(50),_viscBeNewtonTol(1e-12),_viscBeTime(0),_viscBeCount(0),_viscBeMaxIts(0),_viscBeFailures(0),
   _linSolver("unspecified"),_bcRType(bcRType),_bcTType(bcTType),_bcLType(bcLType),_bcBType(bcBType),
   _rhs(NULL),_bcT(NULL),_bcR(NULL),_bcB(NULL),_bcL(NULL),_bcRShift(NULL),
   _ksp(NULL),_pc(NULL),_kspTol(1e-10),_sbp(NULL),_B(NULL),_C(NULL),
@@ -785,6 +789,7 @@ PowerLaw::PowerLaw(Domain& D,std::string bcRType,std::string bcTType,std::string
   if (_wDiffCreep == "yes") {
     _diff = new DiffusionCreep(*_y,*_z,_file,_delim);
   }
+  setViscosityKernel();
 
   // set up matrix operators and KSP environment
   setUpSBPContext(D); // set up matrix operators
@@ -825,6 +830,8 @@ PowerLaw::~PowerLaw()
   VecDestroy(&_gTxy); VecDestroy(&_gVxy); VecDestroy(&_dgVxy);
   VecDestroy(&_gTxz); VecDestroy(&_gVxz); VecDestroy(&_dgVxz);
   VecDestroy(&_dgVdev); VecDestroy(&_dgVdev_disl);
+  VecDestroy(&_sdevLag);
+  VecDestroy(&_effViscLag);
 
   // linear system
   KSPDestroy(&_ksp);
@@ -905,6 +912,15 @@ PetscErrorCode PowerLaw::loadSettings(const char *file)
     // cap on viscosity
     else if (var.compare("maxEffVisc")==0) { _effViscCap = atof( rhs.c_str() ); }
 
+    // time integration of viscous strains
+    else if (var.compare("viscStrainTimeIntType")==0) { _viscStrainTimeIntType = rhs.c_str(); }
+    else if (var.compare("viscBeNewtonMaxIts")==0) { _viscBeNewtonMaxIts = atoi( rhs.c_str() ); }
+    else if (var.compare("viscBeNewtonTol")==0) { _viscBeNewtonTol = atof( rhs.c_str() ); }
+
+    // lagging effective viscosity across Runge-Kutta stages
+    else if (var.compare("lagViscosity")==0) { _lagViscosity = rhs.c_str(); }
+    else if (var.compare("lagViscosityTol")==0) { _lagViscosityTol = atof( rhs.c_str() ); }
+
   }
 
   #if VERBOSE > 1
@@ -928,6 +944,13 @@ PetscErrorCode PowerLaw::checkInput()
   assert(_wDiffCreep.compare("yes") == 0 || _wDiffCreep.compare("no") == 0 );
   assert(_wDislCreep.compare("yes") == 0 || _wDislCreep.compare("no") == 0 );
   assert(_wLinearMaxwell.compare("yes") == 0 || _wLinearMaxwell.compare("no") == 0 );
+  assert(_viscStrainTimeIntType.compare("explicit") == 0 || _viscStrainTimeIntType.compare("implicit") == 0 );
+  if (_viscStrainTimeIntType.compare("implicit") == 0) {
+    assert(_viscBeNewtonMaxIts >= 1);
+    assert(_viscBeNewtonTol >= 1e-14);
+  }
+  assert(_lagViscosity.compare("yes") == 0 || _lagViscosity.compare("no") == 0 );
+  assert(_lagViscosityTol > 0);
 
   assert(_linSolver.compare("MUMPSCHOLESKY") == 0 ||
          _linSolver.compare("MUMPSLU") == 0 ||
@@ -1167,7 +1190,15 @@ PetscErrorCode PowerLaw::setupKSP(KSP& ksp,PC& pc,Mat& A)
     PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
   #endif
 
-  if (_linSolver.compare("AMG")==0) { // algebraic multigrid from HYPRE
+  // 1D problems: banded LU on rank 0 in place of MUMPS
+  if ((_Ny == 1 || _Nz == 1) && (_linSolver.compare("MUMPSCHOLESKY")==0 || _linSolver.compare("MUMPSLU")==0)) {
+    ierr = KSPSetType(ksp,KSPPREONLY);                                  CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,A,A);                                    CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp,PETSC_FALSE);                  CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp,&pc);                                           CHKERRQ(ierr);
+    ierr = BandedLUShell::setPCType(pc);                                CHKERRQ(ierr);
+  }
+  else if (_linSolver.compare("AMG")==0) { // algebraic multigrid from HYPRE
     // uses HYPRE's solver AMG (not HYPRE's preconditioners)
     ierr = KSPSetType(ksp,KSPRICHARDSON);                               CHKERRQ(ierr);
     ierr = KSPSetOperators(ksp,A,A);                                    CHKERRQ(ierr);
@@ -1485,7 +1516,8 @@ PetscErrorCode PowerLaw::addViscStrainRates_MMSSource(const PetscScalar time,Vec
   return ierr;
 }
 
-// limited by Maxwell time
+// limited by Maxwell time if viscous strains are integrated explicitly
+// the implicit update is unconditionally stable, so imposes no limit
 PetscErrorCode PowerLaw::computeMaxTimeStep(PetscScalar& maxTimeStep)
 {
   PetscErrorCode ierr = 0;
@@ -1495,6 +1527,11 @@ PetscErrorCode PowerLaw::computeMaxTimeStep(PetscScalar& maxTimeStep)
     CHKERRQ(ierr);
   #endif
 
+  if (_viscStrainTimeIntType.compare("implicit")==0) {
+    maxTimeStep = PETSC_MAX_REAL;
+    return ierr;
+  }
+
   Vec Tmax;
   VecDuplicate(_u,&Tmax);
   VecSet(Tmax,0.0);
@@ -1545,8 +1582,37 @@ PetscErrorCode PowerLaw::updateFields(const PetscScalar time,const map<string,Ve
   #endif
 
   // if integrating viscous strains in time
-  VecCopy(varEx.find("gVxy")->second,_gVxy);
-  VecCopy(varEx.find("gVxz")->second,_gVxz);
+  if (varEx.find("gVxy") != varEx.end()) {
+    VecCopy(varEx.find("gVxy")->second,_gVxy);
+    VecCopy(varEx.find("gVxz")->second,_gVxz);
+  }
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+// for implicit-explicit time stepping: if viscous strains are integrated
+// implicitly they are stored in varIm, otherwise in varEx
+PetscErrorCode PowerLaw::initiateIntegrand(const PetscScalar time,map<string,Vec>& varEx,map<string,Vec>& varIm)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "PowerLaw::initiateIntegrand()";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  if (_viscStrainTimeIntType.compare("explicit")==0) {
+    ierr = initiateIntegrand(time,varEx); CHKERRQ(ierr);
+    return ierr;
+  }
+
+  if (varIm.find("gVxy") != varIm.end() ) { VecCopy(_gVxy,varIm["gVxy"]); }
+  else { Vec vargxyP; VecDuplicate(_u,&vargxyP); VecCopy(_gVxy,vargxyP); varIm["gVxy"] = vargxyP; }
+
+  if (varIm.find("gVxz") != varIm.end() ) { VecCopy(_gVxz,varIm["gVxz"]); }
+  else { Vec vargxzP; VecDuplicate(_u,&vargxzP); VecCopy(_gVxz,vargxzP); varIm["gVxz"] = vargxzP; }
 
   #if VERBOSE > 1
     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
@@ -1554,6 +1620,216 @@ PetscErrorCode PowerLaw::updateFields(const PetscScalar time,const map<string,Ve
   return ierr;
 }
 
+PetscErrorCode PowerLaw::updateFields(const PetscScalar time,const map<string,Vec>& varEx,const map<string,Vec>& varImo)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "PowerLaw::updateFields()";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  ierr = updateFields(time,varEx); CHKERRQ(ierr);
+
+  if (varImo.find("gVxy") != varImo.end()) {
+    VecCopy(varImo.find("gVxy")->second,_gVxy);
+    VecCopy(varImo.find("gVxz")->second,_gVxz);
+  }
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+// backward Euler update of viscous strains, gV = gVo + dt * tau/effVisc(tau),
+// with the total strains (and so u) held fixed over the step.
+// tau = mu*(gT + SAT - gV) is the stress driving viscous flow, and is parallel to
+// the trial stress mu*(gT + SAT - gVo), so each point requires only a scalar solve for
+// its magnitude s:
+//    s/mu + dt * s * (1/maxEffVisc + A_disl*s^(n_disl-1) + A_diff*s^(n_diff-1)) = |gT + SAT - gVo|,
+// where A_disl and A_diff include the temperature and grain size dependence.
+// The left side is convex and increasing in s, so Newton's method started from the
+// elastic trial stress converges monotonically, to viscBeNewtonTol relative to s within
+// viscBeNewtonMaxIts iterations. Plasticity limits s to the yield stress, with plastic
+// flow accommodating the remaining strain.
+PetscErrorCode PowerLaw::be(const PetscScalar time,Vec& gVxy,Vec& gVxz,const Vec& gVxyo,const Vec& gVxzo,const PetscScalar dt)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "PowerLaw::be";
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s: time=%.15e\n",funcName.c_str(),FILENAME,time);
+    CHKERRQ(ierr);
+  #endif
+  double startTime = MPI_Wtime();
+
+  const bool isLinear = _wLinearMaxwell.compare("yes")==0;
+  const bool isPlastic = _viscKernelPlastic, isDisl = _viscKernelDisl, isDiff = _viscKernelDiff;
+
+  // SAT terms enter the stress driving viscous flow, as in computeViscStrainRates
+  Vec SAT;
+  VecDuplicate(_gTxy,&SAT);
+  ierr = computeViscousStrainRateSAT(_u,_bcL,_bcR,SAT); CHKERRQ(ierr);
+
+  PetscScalar const *mu,*gTxy,*gTxz=0,*sat,*gxyo,*gxzo,*T=0,*d=0;
+  PetscScalar const *A1=0,*B1=0,*n1=0,*A2=0,*B2=0,*n2=0,*m2=0,*ys=0;
+  PetscScalar *gxy,*gxz,*dgxy,*dgxz,*sxy,*sxz,*effVisc,*inv1=0,*inv2=0,*invP=0;
+  VecGetArrayRead(_mu,&mu);
+  VecGetArrayRead(_gTxy,&gTxy);
+  if (_Nz > 1) { VecGetArrayRead(_gTxz,&gTxz); }
+  VecGetArrayRead(SAT,&sat);
+  VecGetArrayRead(gVxyo,&gxyo);
+  VecGetArrayRead(gVxzo,&gxzo);
+  VecGetArray(gVxy,&gxy);
+  VecGetArray(gVxz,&gxz);
+  VecGetArray(_dgVxy,&dgxy);
+  VecGetArray(_dgVxz,&dgxz);
+  VecGetArray(_sxy,&sxy);
+  VecGetArray(_sxz,&sxz);
+  VecGetArray(_effVisc,&effVisc);
+  if (isDisl || isDiff) { VecGetArrayRead(_T,&T); }
+  if (isDisl) {
+    VecGetArrayRead(_disl->_A,&A1);
+    VecGetArrayRead(_disl->_QR,&B1);
+    VecGetArrayRead(_disl->_n,&n1);
+    VecGetArray(_disl->_invEffVisc,&inv1);
+  }
+  if (isDiff) {
+    VecGetArrayRead(_grainSize,&d);
+    VecGetArrayRead(_diff->_A,&A2);
+    VecGetArrayRead(_diff->_QR,&B2);
+    VecGetArrayRead(_diff->_n,&n2);
+    VecGetArrayRead(_diff->_m,&m2);
+    VecGetArray(_diff->_invEffVisc,&inv2);
+  }
+  if (isPlastic) {
+    VecGetArrayRead(_plastic->_yieldStress,&ys);
+    VecGetArray(_plastic->_invEffVisc,&invP);
+  }
+
+  PetscInt Ii,Istart,Iend;
+  VecGetOwnershipRange(gVxy,&Istart,&Iend);
+  PetscInt Jj = 0, maxItsUsed = 0, numFailed = 0;
+  for (Ii=Istart;Ii<Iend;Ii++) {
+    const PetscScalar gxyo_j = gxyo[Jj], gxzo_j = gxzo[Jj];
+
+    // elastic trial strain
+    PetscScalar rxy = gTxy[Jj] + sat[Jj] - gxyo_j;
+    PetscScalar rxz = (_Nz > 1) ? gTxz[Jj] - gxzo_j : 0.0;
+    PetscScalar R = sqrt(rxy*rxy + rxz*rxz);
+
+    // coefficients of s in 1/effVisc(s) = c0 + a1*s^(n1-1) + a2*s^(n2-1)
+    PetscScalar c0 = isLinear ? 1.0/effVisc[Jj] : 1.0/_effViscCap;
+    PetscScalar a1 = 0, e1 = 0, a2 = 0, e2 = 0;
+    if (isDisl) { a1 = 1e3 * A1[Jj] * exp(-B1[Jj]/T[Jj]); e1 = n1[Jj] - 1.0; }
+    if (isDiff) { a2 = 1e3 * A2[Jj] * exp(-B2[Jj]/T[Jj]) * pow(d[Jj],-m2[Jj]); e2 = n2[Jj] - 1.0; }
+
+    // Newton iteration for stress magnitude s
+    PetscScalar s = mu[Jj] * R, phi = c0;
+    PetscInt its = 0;
+    if (R > 0) {
+      bool converged = 0;
+      while (its < _viscBeNewtonMaxIts && !converged) {
+        PetscScalar p1 = (a1 > 0) ? a1*pow(s,e1) : 0.0;
+        PetscScalar p2 = (a2 > 0) ? a2*pow(s,e2) : 0.0;
+        phi = c0 + p1 + p2;
+        PetscScalar f = s/mu[Jj] + dt*s*phi - R;
+        PetscScalar df = 1.0/mu[Jj] + dt*(phi + e1*p1 + e2*p2);
+        PetscScalar ds = f/df;
+        s = max(s - ds, 0.5*s); // f is convex, so s decreases monotonically
+        its++;
+        converged = abs(ds) <= _viscBeNewtonTol*s;
+      }
+      if (!converged) { numFailed++; }
+    }
+    maxItsUsed = max(maxItsUsed,its);
+
+    // plastic flow: cap stress at yield stress
+    bool isYielding = isPlastic && R > 0 && s > ys[Jj];
+    if (isYielding) { s = ys[Jj]; }
+
+    // 1 / effective viscosity of each mechanism at final stress
+    PetscScalar p1 = (a1 > 0) ? a1*pow(s,e1) : 0.0;
+    PetscScalar p2 = (a2 > 0) ? a2*pow(s,e2) : 0.0;
+    PetscScalar pP = isYielding ? (R - s/mu[Jj])/(dt*s) - (c0 + p1 + p2) : 0.0;
+    phi = c0 + p1 + p2 + pP;
+
+    // stress components, parallel to trial strain
+    PetscScalar txy = (R > 0) ? s*rxy/R : 0.0;
+    PetscScalar txz = (R > 0) ? s*rxz/R : 0.0;
+
+    // update viscous strains, rates, and stresses
+    gxy[Jj] = gxyo_j + rxy - txy/mu[Jj];
+    gxz[Jj] = gxzo_j + rxz - txz/mu[Jj];
+    dgxy[Jj] = (gxy[Jj] - gxyo_j)/dt;
+    dgxz[Jj] = (gxz[Jj] - gxzo_j)/dt;
+    sxy[Jj] = txy - mu[Jj]*sat[Jj];
+    sxz[Jj] = txz;
+
+    if (isDisl) { inv1[Jj] = p1; }
+    if (isDiff) { inv2[Jj] = p2; }
+    if (isPlastic) { invP[Jj] = pP; }
+    if (!isLinear) { effVisc[Jj] = 1.0/phi; }
+    Jj++;
+  }
+
+  VecRestoreArrayRead(_mu,&mu);
+  VecRestoreArrayRead(_gTxy,&gTxy);
+  if (_Nz > 1) { VecRestoreArrayRead(_gTxz,&gTxz); }
+  VecRestoreArrayRead(SAT,&sat);
+  VecRestoreArrayRead(gVxyo,&gxyo);
+  VecRestoreArrayRead(gVxzo,&gxzo);
+  VecRestoreArray(gVxy,&gxy);
+  VecRestoreArray(gVxz,&gxz);
+  VecRestoreArray(_dgVxy,&dgxy);
+  VecRestoreArray(_dgVxz,&dgxz);
+  VecRestoreArray(_sxy,&sxy);
+  VecRestoreArray(_sxz,&sxz);
+  VecRestoreArray(_effVisc,&effVisc);
+  if (isDisl || isDiff) { VecRestoreArrayRead(_T,&T); }
+  if (isDisl) {
+    VecRestoreArrayRead(_disl->_A,&A1);
+    VecRestoreArrayRead(_disl->_QR,&B1);
+    VecRestoreArrayRead(_disl->_n,&n1);
+    VecRestoreArray(_disl->_invEffVisc,&inv1);
+  }
+  if (isDiff) {
+    VecRestoreArrayRead(_grainSize,&d);
+    VecRestoreArrayRead(_diff->_A,&A2);
+    VecRestoreArrayRead(_diff->_QR,&B2);
+    VecRestoreArrayRead(_diff->_n,&n2);
+    VecRestoreArrayRead(_diff->_m,&m2);
+    VecRestoreArray(_diff->_invEffVisc,&inv2);
+  }
+  if (isPlastic) {
+    VecRestoreArrayRead(_plastic->_yieldStress,&ys);
+    VecRestoreArray(_plastic->_invEffVisc,&invP);
+  }
+  VecDestroy(&SAT);
+
+  VecCopy(gVxy,_gVxy);
+  VecCopy(gVxz,_gVxz);
+  ierr = computeSDev(); CHKERRQ(ierr);
+  ierr = computeDevViscStrainRates(); CHKERRQ(ierr);
+
+  // statistics
+  PetscInt maxItsAll = 0, numFailedAll = 0;
+  MPI_Allreduce(&maxItsUsed,&maxItsAll,1,MPIU_INT,MPI_MAX,PETSC_COMM_WORLD);
+  MPI_Allreduce(&numFailed,&numFailedAll,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+  _viscBeMaxIts = max(_viscBeMaxIts,maxItsAll);
+  if (numFailedAll > 0) {
+    _viscBeFailures++;
+    PetscPrintf(PETSC_COMM_WORLD,"WARNING: implicit viscous strain update did not converge at %i points.\n",numFailedAll);
+  }
+  _viscBeCount++;
+  _viscBeTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s: time=%.15e\n",funcName.c_str(),FILENAME,time);
+    CHKERRQ(ierr);
+  #endif
+  return ierr;
+}
+
 PetscErrorCode PowerLaw::updateTemperature(const Vec& T)
 {
   PetscErrorCode ierr = 0;
@@ -1671,6 +1947,24 @@ PetscErrorCode PowerLaw::computeViscStrainSourceTerms(Vec& out,Vec& gxy, Vec& gx
 }
 
 
+// decide which deformation mechanisms computeViscosity includes, so that
+// the string options are not tested on every call
+PetscErrorCode PowerLaw::setViscosityKernel()
+{
+  PetscErrorCode ierr = 0;
+
+  const bool isLinear = _wLinearMaxwell.compare("yes")==0;
+  _viscKernelPlastic = !isLinear && _wPlasticity.compare("yes")==0 && _plastic!=NULL;
+  _viscKernelDisl = !isLinear && _wDislCreep.compare("yes")==0 && _disl!=NULL;
+  _viscKernelDiff = !isLinear && _wDiffCreep.compare("yes")==0 && _diff!=NULL;
+
+  return ierr;
+}
+
+// 1 / effVisc = 1/(plastic eff visc) + 1/(disl eff visc) + 1/(diff eff visc) + 1/(max eff visc)
+// Each mechanism's 1/(eff visc) and effVisc are computed in a single sweep over the
+// body, with s^(n-1) evaluated as exp((n-1)*log(s)). The mechanism flags are loop
+// invariant, so the compiler can generate a separate loop for each combination.
 PetscErrorCode PowerLaw::computeViscosity(const PetscScalar viscCap)
 {
   PetscErrorCode ierr = 0;
@@ -1684,17 +1978,78 @@ PetscErrorCode PowerLaw::computeViscosity(const PetscScalar viscCap)
     return ierr;
   }
 
-  // estimate 1 / (effective viscosity) based on strain rate
-  if (_wPlasticity.compare("yes")==0) { _plastic->computeInvEffVisc(_dgVdev); }
-  if (_wDislCreep.compare("yes")==0) { _disl->computeInvEffVisc(_T,_sdev); }
-  if (_wDiffCreep.compare("yes")==0) { _diff->computeInvEffVisc(_T,_sdev,_grainSize); }
+  const bool isPlastic = _viscKernelPlastic, isDisl = _viscKernelDisl, isDiff = _viscKernelDiff;
+  const PetscScalar invCap = 1.0/_effViscCap;
+  const PetscScalar sMin = 1e-300; // avoid log(0); s^(n-1) still -> 0 for n > 1, and = 1 for n = 1
+
+  PetscScalar const *s,*T=0,*dg=0,*sy=0,*A1=0,*B1=0,*n1=0,*A2=0,*B2=0,*n2=0,*m2=0,*d=0;
+  PetscScalar *effVisc,*invP=0,*inv1=0,*inv2=0;
+  VecGetArrayRead(_sdev,&s);
+  VecGetArray(_effVisc,&effVisc);
+  if (isDisl || isDiff) { VecGetArrayRead(_T,&T); }
+  if (isPlastic) {
+    VecGetArrayRead(_dgVdev,&dg);
+    VecGetArrayRead(_plastic->_yieldStress,&sy);
+    VecGetArray(_plastic->_invEffVisc,&invP);
+  }
+  if (isDisl) {
+    VecGetArrayRead(_disl->_A,&A1);
+    VecGetArrayRead(_disl->_QR,&B1);
+    VecGetArrayRead(_disl->_n,&n1);
+    VecGetArray(_disl->_invEffVisc,&inv1);
+  }
+  if (isDiff) {
+    VecGetArrayRead(_grainSize,&d);
+    VecGetArrayRead(_diff->_A,&A2);
+    VecGetArrayRead(_diff->_QR,&B2);
+    VecGetArrayRead(_diff->_n,&n2);
+    VecGetArrayRead(_diff->_m,&m2);
+    VecGetArray(_diff->_invEffVisc,&inv2);
+  }
+
+  PetscInt Istart,Iend;
+  VecGetOwnershipRange(_effVisc,&Istart,&Iend);
+  const PetscInt N = Iend - Istart;
+  for (PetscInt Jj = 0; Jj < N; Jj++) {
+    PetscScalar inv = invCap;
+    const PetscScalar logs = log(max(s[Jj],sMin));
+    if (isPlastic) {
+      invP[Jj] = dg[Jj] / sy[Jj];
+      inv += invP[Jj];
+    }
+    if (isDisl) {
+      inv1[Jj] = 1e3 * A1[Jj] * exp((n1[Jj]-1.0)*logs - B1[Jj]/T[Jj]);
+      inv += inv1[Jj];
+    }
+    if (isDiff) {
+      inv2[Jj] = 1e3 * A2[Jj] * exp((n2[Jj]-1.0)*logs - B2[Jj]/T[Jj] - m2[Jj]*log(d[Jj]));
+      inv += inv2[Jj];
+    }
+    effVisc[Jj] = 1.0/inv;
+  }
 
-  // 1 / effVisc = 1/(plastic eff visc) + 1/(disl eff visc) + 1/(diff eff visc) + 1/(max eff visc)
-  VecSet(_effVisc,1.0/_effViscCap);
-  if (_wPlasticity.compare("yes")==0) { VecAXPY(_effVisc,1.0,_plastic->_invEffVisc); }
-  if (_wDislCreep.compare("yes")==0) { VecAXPY(_effVisc,1.0,_disl->_invEffVisc); }
-  if (_wDiffCreep.compare("yes")==0) { VecAXPY(_effVisc,1.0,_diff->_invEffVisc); }
-  VecReciprocal(_effVisc);
+  VecRestoreArrayRead(_sdev,&s);
+  VecRestoreArray(_effVisc,&effVisc);
+  if (isDisl || isDiff) { VecRestoreArrayRead(_T,&T); }
+  if (isPlastic) {
+    VecRestoreArrayRead(_dgVdev,&dg);
+    VecRestoreArrayRead(_plastic->_yieldStress,&sy);
+    VecRestoreArray(_plastic->_invEffVisc,&invP);
+  }
+  if (isDisl) {
+    VecRestoreArrayRead(_disl->_A,&A1);
+    VecRestoreArrayRead(_disl->_QR,&B1);
+    VecRestoreArrayRead(_disl->_n,&n1);
+    VecRestoreArray(_disl->_invEffVisc,&inv1);
+  }
+  if (isDiff) {
+    VecRestoreArrayRead(_grainSize,&d);
+    VecRestoreArrayRead(_diff->_A,&A2);
+    VecRestoreArrayRead(_diff->_QR,&B2);
+    VecRestoreArrayRead(_diff->_n,&n2);
+    VecRestoreArrayRead(_diff->_m,&m2);
+    VecRestoreArray(_diff->_invEffVisc,&inv2);
+  }
 
   #if VERBOSE > 1
     ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
@@ -1704,6 +2059,110 @@ PetscErrorCode PowerLaw::computeViscosity(const PetscScalar viscCap)
 }
 
 
+// compute effective viscosity, or reuse the previous value if lagViscosity = yes.
+// The viscosity is recomputed at the first call after markViscosityStale or
+// measureViscosityLag, and whenever the deviatoric stress has changed by more
+// than lagViscosityTol (relative) at any point since it was last computed.
+PetscErrorCode PowerLaw::updateViscosity()
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "PowerLaw::updateViscosity";
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+    CHKERRQ(ierr);
+  #endif
+
+  if (_lagViscosity.compare("no")==0) {
+    ierr = computeViscosity(_effViscCap); CHKERRQ(ierr);
+    return ierr;
+  }
+
+  bool recompute = _viscIsStale || _sdevLag == NULL;
+  if (!recompute) {
+    // max relative change in deviatoric stress
+    PetscScalar const *s,*s0;
+    VecGetArrayRead(_sdev,&s);
+    VecGetArrayRead(_sdevLag,&s0);
+    PetscInt Istart,Iend;
+    VecGetOwnershipRange(_sdev,&Istart,&Iend);
+    PetscScalar maxChange = 0;
+    for (PetscInt Jj = 0; Jj < Iend-Istart; Jj++) {
+      maxChange = max(maxChange, abs(s[Jj] - s0[Jj]) / max(abs(s0[Jj]),1e-14));
+    }
+    VecRestoreArrayRead(_sdev,&s);
+    VecRestoreArrayRead(_sdevLag,&s0);
+
+    PetscScalar maxChangeAll = 0;
+    MPI_Allreduce(&maxChange,&maxChangeAll,1,MPIU_SCALAR,MPI_MAX,PETSC_COMM_WORLD);
+    recompute = maxChangeAll > _lagViscosityTol;
+  }
+
+  // the value that would have been lagged, to measure the lag against
+  bool measure = _measureViscLag && _sdevLag != NULL;
+  if (measure) {
+    if (_effViscLag == NULL) { VecDuplicate(_effVisc,&_effViscLag); }
+    VecCopy(_effVisc,_effViscLag);
+  }
+
+  if (recompute) {
+    ierr = computeViscosity(_effViscCap); CHKERRQ(ierr);
+    if (_sdevLag == NULL) { VecDuplicate(_sdev,&_sdevLag); }
+    VecCopy(_sdev,_sdevLag);
+    _viscIsStale = 0;
+    _viscComputeCount++;
+  }
+  else { _viscLagCount++; }
+
+  if (measure) {
+    PetscScalar const *eta,*eta0;
+    VecGetArrayRead(_effVisc,&eta);
+    VecGetArrayRead(_effViscLag,&eta0);
+    PetscInt Istart,Iend;
+    VecGetOwnershipRange(_effVisc,&Istart,&Iend);
+    PetscScalar maxDiff = 0;
+    for (PetscInt Jj = 0; Jj < Iend-Istart; Jj++) {
+      maxDiff = max(maxDiff, abs(eta[Jj] - eta0[Jj]) / max(abs(eta[Jj]),1e-14));
+    }
+    VecRestoreArrayRead(_effVisc,&eta);
+    VecRestoreArrayRead(_effViscLag,&eta0);
+    MPI_Allreduce(&maxDiff,&_viscLagErr,1,MPIU_SCALAR,MPI_MAX,PETSC_COMM_WORLD);
+  }
+  _measureViscLag = 0;
+
+  #if VERBOSE > 1
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+    CHKERRQ(ierr);
+  #endif
+  return ierr;
+}
+
+PetscErrorCode PowerLaw::markViscosityStale()
+{
+  _viscIsStale = 1;
+  return 0;
+}
+
+// Called before the last stage of a time step: the viscosity used there is
+// fresh, and the relative difference from the lagged value it replaces is
+// kept for getViscosityLagError.
+PetscErrorCode PowerLaw::measureViscosityLag()
+{
+  if (_lagViscosity.compare("no")==0) { return 0; }
+  _viscIsStale = 1;
+  _measureViscLag = 1;
+  return 0;
+}
+
+// error of lagging the viscosity in the step just attempted, relative to
+// lagViscosityTol, so that err > 1 means the lag was unsafe
+PetscErrorCode PowerLaw::getViscosityLagError(PetscScalar& err)
+{
+  err = _viscLagErr / _lagViscosityTol;
+  _viscLagErr = 0;
+  return 0;
+}
+
+
 PetscErrorCode PowerLaw::computeViscStrainRates(const PetscScalar time,const Vec& gVxy, const Vec& gVxz,
   Vec& gVxy_t, Vec& gVxz_t)
 {
@@ -2231,6 +2690,13 @@ PetscErrorCode PowerLaw::writeDomain(const string outputDir)
   ierr = PetscViewerASCIIPrintf(viewer,"wDislCreep = %s\n",_wDislCreep.c_str());CHKERRQ(ierr);
 
   ierr = PetscViewerASCIIPrintf(viewer,"effViscCap = %.15e\n",_effViscCap);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"viscStrainTimeIntType = %s\n",_viscStrainTimeIntType.c_str());CHKERRQ(ierr);
+  if (_viscStrainTimeIntType.compare("implicit")==0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"viscBeNewtonMaxIts = %i\n",_viscBeNewtonMaxIts);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"viscBeNewtonTol = %.15e\n",_viscBeNewtonTol);CHKERRQ(ierr);
+  }
+  ierr = PetscViewerASCIIPrintf(viewer,"lagViscosity = %s\n",_lagViscosity.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"lagViscosityTol = %.15e\n",_lagViscosityTol);CHKERRQ(ierr);
 
 
   PetscMPIInt size;
@@ -2385,6 +2851,17 @@ PetscErrorCode PowerLaw::view(const double totRunTime)
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times linear system was solved: %i\n",_linSolveCount);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent solving linear system (s): %g\n",_linSolveTime);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   %% integration time spent solving linear system: %g\n",_linSolveTime/totRunTime*100.);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"   viscous strain time integration = %s\n",_viscStrainTimeIntType.c_str());CHKERRQ(ierr);
+  if (_lagViscosity.compare("yes")==0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times effective viscosity was computed: %i\n",_viscComputeCount);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of times effective viscosity was lagged: %i\n",_viscLagCount);CHKERRQ(ierr);
+  }
+  if (_viscStrainTimeIntType.compare("implicit")==0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of implicit viscous strain updates: %i\n",_viscBeCount);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent in implicit viscous strain updates (s): %g\n",_viscBeTime);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   max pointwise Newton iterations: %i\n",_viscBeMaxIts);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   updates with unconverged points: %i\n",_viscBeFailures);CHKERRQ(ierr);
+  }
 
   //~ ierr = PetscPrintf(PETSC_COMM_WORLD,"   misc time (s): %g\n",_miscTime);CHKERRQ(ierr);
   //~ ierr = PetscPrintf(PETSC_COMM_WORLD,"   %% misc time: %g\n",_miscTime/_integrateTime*100.);CHKERRQ(ierr);
@@ -11,6 +11,7 @@
 #include "sbpOps.hpp"
 #include "sbpOps_m_constGrid.hpp"
 #include "sbpOps_m_varGrid.hpp"
+#include "bandedLU.hpp"
 
 using namespace std;
 
@@ -128,6 +129,7 @@ class PowerLaw
     Vec                 *_y,*_z; // to handle variable grid spacing
     const bool           _isMMS; // true if running mms test
     std::string          _wDiffCreep, _wDislCreep,_wPlasticity,_wLinearMaxwell;
+    bool                 _viscKernelPlastic,_viscKernelDisl,_viscKernelDiff; // active mechanisms, set by setViscosityKernel
 
 
     // deformation mechanisms
@@ -142,6 +144,18 @@ class PowerLaw
     std::vector<double>   _effViscVals_lm,_effViscDepths_lm; // linear Maxwell effective viscosity values
     PetscScalar           _effViscCap; // imposed upper limit on effective viscosity
 
+    // lagging effective viscosity: if lagViscosity = yes, the viscosity is computed at each
+    // accepted solution and then held fixed across the stages of the next step, unless the
+    // deviatoric stress has changed by more than lagViscosityTol (relative) since it was computed
+    std::string           _lagViscosity;
+    PetscScalar           _lagViscosityTol;
+    bool                  _viscIsStale;
+    Vec                   _sdevLag; // deviatoric stress when viscosity was last computed
+    PetscInt              _viscComputeCount,_viscLagCount;
+    bool                  _measureViscLag; // compare the lagged viscosity to the fresh one at the next update
+    PetscScalar           _viscLagErr; // max relative difference between lagged and fresh viscosity
+    Vec                   _effViscLag; // lagged viscosity, for that comparison
+
     // displacement, strains, and strain rates
     Vec                   _u,_surfDisp;
     Vec                   _sxy,_sxz,_sdev; // sigma_xz (MPa), deviatoric stress (MPa)
@@ -149,6 +163,18 @@ class PowerLaw
     Vec                   _gTxz,_gVxz,_dgVxz; // total strain, viscous strain, and viscous strain rate
     Vec                   _dgVdev,_dgVdev_disl; // deviatoric strain and strain rate
 
+    // time integration of viscous strains
+    // explicit: gVxy, gVxz are integrated by the RK method, dt limited by the Maxwell time
+    // implicit: gVxy, gVxz are in varIm, updated pointwise by backward Euler (IMEX time integrators only)
+    //   from the fault rates of the completed explicit step. The IMEX error estimate compares two
+    //   explicit solutions, so gVxy, gVxz are not part of error control; the step size is set
+    //   by the fault and the other explicit fields.
+    std::string           _viscStrainTimeIntType;
+    PetscInt              _viscBeNewtonMaxIts; // max Newton iterations per point in be
+    PetscScalar           _viscBeNewtonTol; // relative tolerance on the stress magnitude in be
+    double                _viscBeTime;
+    PetscInt              _viscBeCount,_viscBeMaxIts,_viscBeFailures;
+
     // linear system data
     std::string           _linSolver;
     std::string           _bcRType,_bcTType,_bcLType,_bcBType; // BC options: Neumann, Dirichlet
@@ -223,13 +249,23 @@ class PowerLaw
     PetscErrorCode computeStresses();
     PetscErrorCode computeSDev();
     PetscErrorCode computeDevViscStrainRates(); // deviatoric strains and strain rates
+    PetscErrorCode setViscosityKernel(); // must be called if _wDiffCreep etc are changed
     PetscErrorCode computeViscosity(const PetscScalar viscCap);
+    PetscErrorCode updateViscosity(); // computeViscosity, subject to lagging
+    PetscErrorCode markViscosityStale(); // recompute the viscosity at the next update
+    PetscErrorCode measureViscosityLag(); // recompute it, and measure the lag, at the next update
+    PetscErrorCode getViscosityLagError(PetscScalar& err); // measured lag relative to lagViscosityTol
     PetscErrorCode computeU();
     PetscErrorCode setRHS();
     PetscErrorCode changeBCTypes(std::string bcRTtype,std::string bcTTtype,std::string bcLTtype,std::string bcBTtype);
     PetscErrorCode setSurfDisp();
     PetscErrorCode getStresses(Vec& sxy, Vec& sxz, Vec& sdev);
 
+    // methods for implicit-explicit time stepping
+    PetscErrorCode initiateIntegrand(const PetscScalar time,map<string,Vec>& varEx,map<string,Vec>& varIm);
+    PetscErrorCode updateFields(const PetscScalar time,const map<string,Vec>& varEx,const map<string,Vec>& varImo);
+    PetscErrorCode be(const PetscScalar time,Vec& gVxy,Vec& gVxz,const Vec& gVxyo,const Vec& gVxzo,const PetscScalar dt);
+
 
 
 
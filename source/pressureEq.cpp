@@ -5,7 +5,8 @@
 using namespace std;
 
 // constructor for PressureEq
-// by default, uses AMG for preconditioning
+// by default, uses a banded direct solve for backward Euler, and Newton's method
+// if permeability is pressure dependent
 // default explicit time integration, permeability not slip- or pressure dependent
 // bottom boundary condition Q
 PressureEq::PressureEq(Domain &D)
@@ -18,7 +19,10 @@ PressureEq::PressureEq(Domain &D)
   _n_p(NULL), _beta_p(NULL), _k_p(NULL), _eta_p(NULL), _rho_f(NULL), _g(9.8),
   _bcB_ratio(1.0), _bcB_type("Q"),
   _maxBeIteration(1), _minBeDifference(0.01),
-  _linSolver("AMG"), _ksp(NULL), _kspTol(1e-10), _sbp(NULL), _linSolveCount(0),
+  _permPressureSolver("Newton"), _maxBeNewtonIteration(20), _beNewtonTol(1e-10),
+  _beNewtonIts(0), _beNewtonSolves(0), _beNewtonFailures(0), _beNewtonMaxIts(0),
+  _linSolver("BANDED"), _ksp(NULL), _kspTol(1e-10), _sbp(NULL), _linSolveCount(0),
+  _beScatter(NULL), _nwtIsSetUp(0), _nwtBcFac(0.0), _nwtBcImpose(0.0),
   _writeTime(0), _linSolveTime(0), _ptTime(0), _startTime(0), _miscTime(0), _invTime(0)
 {
   #if VERBOSE > 1
@@ -117,6 +121,9 @@ PressureEq::~PressureEq()
 
   KSPDestroy(&_ksp);
   VecScatterDestroy(&_scatters);
+  VecScatterDestroy(&_beScatter);
+  VecDestroy(&_beSeq);
+  VecDestroy(&_beSeqScale);
 
   #if VERBOSE > 1
     PetscPrintf(PETSC_COMM_WORLD, "Ending %s in %s\n", funcName.c_str(), FILENAME);
@@ -124,6 +131,38 @@ PressureEq::~PressureEq()
 }
 
 
+// time step limit for accuracy of backward Euler: the time for pressure to diffuse
+// across one grid cell, based on the average grid spacing
+PetscErrorCode PressureEq::computeMaxTimeStep(PetscScalar& maxTimeStep)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "PressureEq::computeMaxTimeStep()";
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "Starting %s in %s\n", funcName.c_str(), FILENAME);
+    CHKERRQ(ierr);
+  #endif
+
+  // hydraulic diffusivity: k / (eta * n * beta)
+  Vec D;
+  VecDuplicate(_k_p, &D);
+  VecPointwiseDivide(D, _k_p, _eta_p);
+  VecPointwiseDivide(D, D, _n_p);
+  VecPointwiseDivide(D, D, _beta_p);
+  PetscScalar maxD;
+  VecMax(D, NULL, &maxD);
+  VecDestroy(&D);
+
+  PetscScalar h = _L / (_N - 1.0);
+  maxTimeStep = h * h / maxD;
+
+  #if VERBOSE > 1
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "Ending %s in %s\n", funcName.c_str(), FILENAME);
+    CHKERRQ(ierr);
+  #endif
+  return ierr;
+}
+
+
 // return pressure: copy _p to P
 PetscErrorCode PressureEq::getPressure(Vec &P)
 {
@@ -239,7 +278,7 @@ PetscErrorCode PressureEq::loadSettings(const char *file)
     rhs = rhs.substr(0, pos);
 
     if (var.compare("guessSteadyStateICs") == 0) { _guessSteadyStateICs = atoi(rhs.c_str()); }
-    else if (var.compare("linSolver") == 0) { _linSolver = rhs.c_str(); }
+    else if (var.compare("hydraulicLinSolver") == 0) { _linSolver = rhs.c_str(); }
     else if (var.compare("hydraulicTimeIntType") == 0) { _hydraulicTimeIntType = rhs.c_str(); }
     else if (var.compare("bcB_ratio") == 0) { _bcB_ratio = atof(rhs.c_str()); }
     else if (var.compare("bcB_type") == 0) { _bcB_type = rhs.c_str(); }
@@ -281,6 +320,9 @@ PetscErrorCode PressureEq::loadSettings(const char *file)
     else if (var.compare("sigma_pDepths") == 0) { loadVectorFromInputFile(rhsFull, _sigma_pDepths); }
     else if (var.compare("maxBeIteration") == 0) { _maxBeIteration = (int)atof(rhs.c_str()); }
     else if (var.compare("minBeDifference") == 0) { _minBeDifference = atof(rhs.c_str()); }
+    else if (var.compare("permPressureSolver") == 0) { _permPressureSolver = rhs.c_str(); }
+    else if (var.compare("maxBeNewtonIteration") == 0) { _maxBeNewtonIteration = (int)atof(rhs.c_str()); }
+    else if (var.compare("beNewtonTol") == 0) { _beNewtonTol = atof(rhs.c_str()); }
   }
 
   #if VERBOSE > 1
@@ -554,6 +596,10 @@ PetscErrorCode PressureEq::checkInput()
   assert(_permSlipDependent.compare("no") == 0 || _permSlipDependent.compare("yes") == 0 );
   assert(_permPressureDependent.compare("no") == 0 || _permPressureDependent.compare("yes") == 0 );
   assert(_bcB_type.compare("Q") == 0 || _bcB_type.compare("Dp") == 0);
+  assert(_linSolver.compare("BANDED") == 0 || _linSolver.compare("AMG") == 0);
+  assert(_permPressureSolver.compare("Newton") == 0 || _permPressureSolver.compare("Picard") == 0);
+  assert(_maxBeNewtonIteration > 0);
+  assert(_beNewtonTol > 0);
 
   #if VERBOSE > 1
     PetscPrintf(PETSC_COMM_WORLD, "Ending %s in %s\n", funcName.c_str(), FILENAME);
@@ -711,6 +757,11 @@ PetscErrorCode PressureEq::setUpBe(Domain &D)
     CHKERRQ(ierr);
   #endif
 
+  // the banded solver is set up on first use
+  if (_linSolver.compare("BANDED") == 0) {
+    return ierr;
+  }
+
   Mat D2;
   _sbp->getA(D2);
   Mat H;
@@ -823,15 +874,23 @@ PetscErrorCode PressureEq::computeInitialSteadyStatePressure(Domain &D)
   Mat D2;
   _sbp->getA(D2);
 
-  ierr = KSPSetType(ksp, KSPRICHARDSON); CHKERRQ(ierr);
-  ierr = KSPSetOperators(ksp, D2, D2); CHKERRQ(ierr);
-  ierr = KSPSetReusePreconditioner(ksp, PETSC_FALSE); CHKERRQ(ierr);
-  ierr = KSPGetPC(ksp, &pc); CHKERRQ(ierr);
-  ierr = PCSetType(pc, PCHYPRE); CHKERRQ(ierr);
-  ierr = PCHYPRESetType(pc, "boomeramg"); CHKERRQ(ierr);
-  ierr = KSPSetTolerances(ksp, _kspTol, PETSC_DEFAULT, PETSC_DEFAULT, PETSC_DEFAULT); CHKERRQ(ierr);
-  ierr = PCFactorSetLevels(pc, 4); CHKERRQ(ierr);
-  ierr = KSPSetInitialGuessNonzero(ksp, PETSC_TRUE); CHKERRQ(ierr);
+  if (_linSolver.compare("BANDED") == 0) {
+    ierr = KSPSetType(ksp, KSPPREONLY); CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp, D2, D2); CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp, &pc); CHKERRQ(ierr);
+    ierr = BandedLUShell::setPCType(pc); CHKERRQ(ierr);
+  }
+  else {
+    ierr = KSPSetType(ksp, KSPRICHARDSON); CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp, D2, D2); CHKERRQ(ierr);
+    ierr = KSPSetReusePreconditioner(ksp, PETSC_FALSE); CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp, &pc); CHKERRQ(ierr);
+    ierr = PCSetType(pc, PCHYPRE); CHKERRQ(ierr);
+    ierr = PCHYPRESetType(pc, "boomeramg"); CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp, _kspTol, PETSC_DEFAULT, PETSC_DEFAULT, PETSC_DEFAULT); CHKERRQ(ierr);
+    ierr = PCFactorSetLevels(pc, 4); CHKERRQ(ierr);
+    ierr = KSPSetInitialGuessNonzero(ksp, PETSC_TRUE); CHKERRQ(ierr);
+  }
 
   // perform computation of preconditioners now, rather than on first use
   ierr = KSPSetUp(ksp); CHKERRQ(ierr);
@@ -1447,6 +1506,11 @@ PetscErrorCode PressureEq::be(const PetscScalar time, const map<string, Vec> &va
 
   VecCopy(varImo.find("pressure")->second, _p);
 
+  if (_permPressureDependent.compare("yes") == 0 && _permPressureSolver.compare("Newton") == 0 && !_nwtIsSetUp) {
+    ierr = setUpBe_newton(); CHKERRQ(ierr);
+  }
+  const bool isNewton = (_permPressureDependent.compare("yes") == 0 && _permPressureSolver.compare("Newton") == 0);
+
   Vec rhog, rhog_y;
   VecDuplicate(_p, &rhog);
   VecDuplicate(_p, &rhog_y);
@@ -1464,31 +1528,56 @@ PetscErrorCode PressureEq::be(const PetscScalar time, const map<string, Vec> &va
   Vec rho_n_beta; // rho_n_beta = 1/(rho * n * beta)
   VecDuplicate(_p, &rho_n_beta);
 
+  Vec rowScale; // row scaling of D2 for the banded solver
+  VecDuplicate(_p, &rowScale);
+
   Mat Diag_rho_n_beta = NULL;
   Mat D2_rho_n_beta = NULL;
+  Mat tmp2 = NULL;
+  const bool isBanded = (_linSolver.compare("BANDED") == 0);
 
-  Mat H;
-  _sbp->getH(H);
-  MatDuplicate(H, MAT_DO_NOT_COPY_VALUES, &Diag_rho_n_beta);
-  Mat D2;
-  _sbp->getA(D2);
-  MatMatMult(Diag_rho_n_beta, D2, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &D2_rho_n_beta);
+  // the banded solver assembles H - dt/(rho*n*beta)*D2 directly in band storage
+  if (!isBanded && !isNewton) {
+    Mat H;
+    _sbp->getH(H);
+    MatDuplicate(H, MAT_DO_NOT_COPY_VALUES, &Diag_rho_n_beta);
+    Mat D2;
+    _sbp->getA(D2);
+    MatMatMult(Diag_rho_n_beta, D2, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &D2_rho_n_beta);
+    Mat J, Jinv, qy, rz, yq, zr;
+    ierr = _sbp->getCoordTrans(J, Jinv, qy, rz, yq, zr); CHKERRQ(ierr);
+    MatMatMult(Jinv, D2_rho_n_beta, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &tmp2);
+  }
 
   Vec Hxp;
   VecDuplicate(_p, &Hxp);
 
   Vec tmp1;
   VecDuplicate(_p, &tmp1);
-  Mat tmp2;
-  Mat J, Jinv, qy, rz, yq, zr;
-  ierr = _sbp->getCoordTrans(J, Jinv, qy, rz, yq, zr); CHKERRQ(ierr);
-  MatMatMult(Jinv, D2_rho_n_beta, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &tmp2);
 
   if (_permPressureDependent.compare("no") == 0){
     _maxBeIteration = 1;
   }
 
-  for (int i = 0; i < _maxBeIteration; i++) {
+  // fully implicit in permeability: solve the nonlinear system with Newton's method,
+  // then bring k, the SBP coefficient, and the boundary terms up to date with the new pressure
+  if (isNewton) {
+    double tmpTime = MPI_Wtime();
+    ierr = solveBe_newton(varImo.find("pressure")->second, dt, _p); CHKERRQ(ierr);
+    _invTime += MPI_Wtime() - tmpTime;
+
+    tmpTime = MPI_Wtime();
+    updatePermPressureDependent();
+    Vec coeff;
+    computeVariableCoefficient(coeff);
+    _sbp->updateVarCoeff(coeff);
+    updateBoundaryCoefficient(coeff);
+    VecDestroy(&coeff);
+    _miscTime += MPI_Wtime() - tmpTime;
+  }
+
+  // otherwise Picard iteration, lagging permeability by one iteration
+  for (int i = 0; i < _maxBeIteration && !isNewton; i++) {
     double tmpTime = MPI_Wtime();
     if (_permPressureDependent.compare("yes") == 0)
     {
@@ -1524,9 +1613,10 @@ PetscErrorCode PressureEq::be(const PetscScalar time, const map<string, Vec> &va
     VecPointwiseDivide(rho_n_beta, rho_n_beta, _rho_f);
     VecPointwiseDivide(rho_n_beta, rho_n_beta, _n_p);
     VecPointwiseDivide(rho_n_beta, rho_n_beta, _beta_p);
-    MatDiagonalSet(Diag_rho_n_beta, rho_n_beta, INSERT_VALUES);
-
-    MatMatMult(Diag_rho_n_beta, D2, MAT_REUSE_MATRIX, PETSC_DEFAULT, &D2_rho_n_beta); // 1/(rho * n * beta) D2
+    if (!isBanded) {
+      MatDiagonalSet(Diag_rho_n_beta, rho_n_beta, INSERT_VALUES);
+      MatMatMult(Diag_rho_n_beta, D2, MAT_REUSE_MATRIX, PETSC_DEFAULT, &D2_rho_n_beta); // 1/(rho * n * beta) D2
+    }
 
     if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
       Mat J, Jinv, qy, rz, yq, zr;
@@ -1535,16 +1625,26 @@ PetscErrorCode PressureEq::be(const PetscScalar time, const map<string, Vec> &va
       ierr = MatMult(Jinv, rhs, tmp1);
       VecCopy(tmp1, rhs);
 
-      MatMatMult(Jinv, D2_rho_n_beta, MAT_REUSE_MATRIX, PETSC_DEFAULT, &tmp2);
-      MatCopy(tmp2, D2_rho_n_beta, SAME_NONZERO_PATTERN);
+      if (isBanded) {
+        MatGetDiagonal(Jinv, tmp1);
+        VecPointwiseMult(rowScale, rho_n_beta, tmp1); // Jinv/(rho * n * beta)
+      }
+      else {
+        MatMatMult(Jinv, D2_rho_n_beta, MAT_REUSE_MATRIX, PETSC_DEFAULT, &tmp2);
+        MatCopy(tmp2, D2_rho_n_beta, SAME_NONZERO_PATTERN);
+      }
+    }
+    else if (isBanded) {
+      VecCopy(rho_n_beta, rowScale);
     }
 
     _sbp->H(rhog_y, temp);
     VecAXPY(rhs, -1.0, temp); // - D1(rho^2*g * k/eta) + SAT
 
-    MatScale(D2_rho_n_beta, -dt);
-
-    MatAXPY(D2_rho_n_beta, 1, H, SUBSET_NONZERO_PATTERN); // H - dt/(rho*n*beta)*D2
+    if (!isBanded) {
+      MatScale(D2_rho_n_beta, -dt);
+      MatAXPY(D2_rho_n_beta, 1, H, SUBSET_NONZERO_PATTERN); // H - dt/(rho*n*beta)*D2
+    }
 
     VecPointwiseMult(rhs, rhs, rho_n_beta); //1/(rho * n * beta) * ( - D1(rho^2*g * k/eta) + SAT)
 
@@ -1555,8 +1655,13 @@ PetscErrorCode PressureEq::be(const PetscScalar time, const map<string, Vec> &va
     VecAXPY(rhs, 1, Hxp);
 
     tmpTime = MPI_Wtime();
-    ierr = KSPSetOperators(_ksp, D2_rho_n_beta, D2_rho_n_beta); CHKERRQ(ierr);
-    ierr = KSPSolve(_ksp, rhs, _p); CHKERRQ(ierr);
+    if (isBanded) {
+      ierr = solveBe_banded(D2, H, rowScale, dt, rhs, _p); CHKERRQ(ierr);
+    }
+    else {
+      ierr = KSPSetOperators(_ksp, D2_rho_n_beta, D2_rho_n_beta); CHKERRQ(ierr);
+      ierr = KSPSolve(_ksp, rhs, _p); CHKERRQ(ierr);
+    }
 
     // calculate relative error
     PetscReal err=0.0, s=0.0;
@@ -1588,6 +1693,7 @@ PetscErrorCode PressureEq::be(const PetscScalar time, const map<string, Vec> &va
   VecDestroy(&temp);
   VecDestroy(&rhs);
   VecDestroy(&rho_n_beta);
+  VecDestroy(&rowScale);
   VecDestroy(&Hxp);
   VecDestroy(&p_prev);
   MatDestroy(&Diag_rho_n_beta);
@@ -1604,6 +1710,385 @@ PetscErrorCode PressureEq::be(const PetscScalar time, const map<string, Vec> &va
 }
 
 
+// set up the banded solver on first use: store D2 and H on rank 0, so that a constant
+// D2 is gathered only once. v is any Vec with the layout of p.
+PetscErrorCode PressureEq::setUpBe_banded(const Mat &D2, const Mat &H, const Vec &v)
+{
+  PetscErrorCode ierr = 0;
+
+  #if VERBOSE > 1
+    string funcName = "PressureEq::setUpBe_banded";
+    PetscPrintf(PETSC_COMM_WORLD, "Starting %s in %s\n", funcName.c_str(), FILENAME);
+  #endif
+
+  PetscMPIInt rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+
+  PetscInt bw = 0;
+  ierr = BandedLU::computeBandwidth(D2, bw); CHKERRQ(ierr);
+  ierr = _beD2.setSize(_N, bw); CHKERRQ(ierr);
+  ierr = _beD2.setFromMat(D2); CHKERRQ(ierr);
+
+  BandedLU Hband(_N, 0);
+  ierr = Hband.setFromMat(H); CHKERRQ(ierr);
+  if (rank == 0) {
+    _beHdiag.resize(_N);
+    for (PetscInt i = 0; i < _N; i++) { _beHdiag[i] = Hband.getValue(i, i); }
+  }
+
+  ierr = VecScatterCreateToZero(v, &_beScatter, &_beSeq); CHKERRQ(ierr);
+  ierr = VecDuplicate(_beSeq, &_beSeqScale); CHKERRQ(ierr);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD, "Ending %s in %s\n", funcName.c_str(), FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// banded direct solve of (H - dt*diag(rowScale)*D2) p = rhs
+// rowScale and rhs are gathered to rank 0, where the system is formed from the stored D2 band
+// and factored in O(N)
+PetscErrorCode PressureEq::solveBe_banded(const Mat &D2, const Mat &H, const Vec &rowScale, const PetscScalar dt, const Vec &rhs, Vec &p)
+{
+  PetscErrorCode ierr = 0;
+
+  #if VERBOSE > 1
+    string funcName = "PressureEq::solveBe_banded";
+    PetscPrintf(PETSC_COMM_WORLD, "Starting %s in %s\n", funcName.c_str(), FILENAME);
+  #endif
+
+  PetscMPIInt rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+
+  // D2 only changes if permeability is slip- or pressure-dependent
+  if (_beScatter == NULL) {
+    ierr = setUpBe_banded(D2, H, rhs); CHKERRQ(ierr);
+  }
+  else if (_permSlipDependent.compare("yes") == 0 || _permPressureDependent.compare("yes") == 0) {
+    ierr = _beD2.setFromMat(D2); CHKERRQ(ierr);
+  }
+
+  ierr = VecScatterBegin(_beScatter, rowScale, _beSeqScale, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_beScatter, rowScale, _beSeqScale, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterBegin(_beScatter, rhs, _beSeq, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_beScatter, rhs, _beSeq, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+
+  if (rank == 0) {
+    const PetscScalar *s;
+    PetscScalar *b;
+    const PetscInt w = 2 * _beD2._bw + 1;
+    ierr = VecGetArrayRead(_beSeqScale, &s); CHKERRQ(ierr);
+    ierr = VecGetArray(_beSeq, &b); CHKERRQ(ierr);
+
+    // H - dt * rowScale * D2, row by row, in the work band
+    _beLU = _beD2;
+    for (PetscInt i = 0; i < _N; i++) {
+      const PetscScalar f = -dt * s[i];
+      for (PetscInt k = 0; k < w; k++) { _beLU._a[i * w + k] *= f; }
+      _beLU.addValue(i, i, _beHdiag[i]);
+    }
+    ierr = _beLU.factor(); CHKERRQ(ierr);
+    ierr = _beLU.solve(b, b); CHKERRQ(ierr);
+
+    ierr = VecRestoreArray(_beSeq, &b); CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(_beSeqScale, &s); CHKERRQ(ierr);
+  }
+
+  ierr = VecScatterBegin(_beScatter, _beSeq, p, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_beScatter, _beSeq, p, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD, "Ending %s in %s\n", funcName.c_str(), FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// gather a Vec onto rank 0 as a std::vector (empty on other ranks)
+PetscErrorCode PressureEq::scatterToZero(const Vec &v, vector<PetscScalar> &out)
+{
+  PetscErrorCode ierr = 0;
+  PetscMPIInt rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+
+  ierr = VecScatterBegin(_beScatter, v, _beSeq, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_beScatter, v, _beSeq, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  out.clear();
+  if (rank == 0) {
+    const PetscScalar *s;
+    ierr = VecGetArrayRead(_beSeq, &s); CHKERRQ(ierr);
+    out.assign(s, s + _N);
+    ierr = VecRestoreArrayRead(_beSeq, &s); CHKERRQ(ierr);
+  }
+
+  return ierr;
+}
+
+
+// set up the Newton solve for pressure-dependent permeability
+// D2 is affine in the coefficient rho_f*k/eta, so it is probed once and stored as
+// a banded function of the coefficient; every other term of the backward Euler
+// system is independent of permeability and is gathered to rank 0 here.
+PetscErrorCode PressureEq::setUpBe_newton()
+{
+  PetscErrorCode ierr = 0;
+
+  #if VERBOSE > 1
+    string funcName = "PressureEq::setUpBe_newton";
+    PetscPrintf(PETSC_COMM_WORLD, "Starting %s in %s\n", funcName.c_str(), FILENAME);
+  #endif
+
+  double startTime = MPI_Wtime();
+  PetscMPIInt rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+
+  Mat D2, H, Dy, Dz;
+  _sbp->getA(D2);
+  _sbp->getH(H);
+  if (_beScatter == NULL) {
+    ierr = setUpBe_banded(D2, H, _p); CHKERRQ(ierr);
+  }
+
+  // D2 as a function of the coefficient; probing changes _sbp's coefficient, so restore it
+  Vec coeff;
+  PetscBool isAffine = PETSC_FALSE;
+  computeVariableCoefficient(coeff);
+  ierr = _nwtD2.setFromSbp(_sbp, coeff, isAffine); CHKERRQ(ierr);
+  _sbp->updateVarCoeff(coeff);
+  VecDestroy(&coeff);
+  if (!isAffine) {
+    PetscPrintf(PETSC_COMM_WORLD, "NOTE: SBP operator is not affine in its coefficient, so using Picard iteration for pressure-dependent permeability\n");
+    _permPressureSolver = "Picard";
+    _miscTime += MPI_Wtime() - startTime;
+    return ierr;
+  }
+
+  // Dz, for the gravity term
+  PetscInt bw = 0;
+  _sbp->getDs(Dy, Dz);
+  ierr = BandedLU::computeBandwidth(Dz, bw); CHKERRQ(ierr);
+  ierr = _nwtDz.setSize(_N, bw); CHKERRQ(ierr);
+  ierr = _nwtDz.setFromMat(Dz); CHKERRQ(ierr);
+
+  // response of the boundary terms to a unit flux at the bottom (bcL and bcT are 0)
+  Vec unitB, r1;
+  VecDuplicate(_bcB, &unitB);
+  VecSet(unitB, 1.0);
+  VecDuplicate(_p, &r1);
+  ierr = _sbp->setRhs(r1, _bcL, _bcL, _bcT, unitB); CHKERRQ(ierr);
+  ierr = scatterToZero(r1, _nwtR1); CHKERRQ(ierr);
+  VecDestroy(&unitB);
+
+  // row scalings: 1/(rho*n*beta) for the gravity term, and Jinv/(rho*n*beta) for D2 and the boundary terms
+  Vec rho_n_beta;
+  VecDuplicate(_p, &rho_n_beta);
+  VecSet(rho_n_beta, 1.0);
+  VecPointwiseDivide(rho_n_beta, rho_n_beta, _rho_f);
+  VecPointwiseDivide(rho_n_beta, rho_n_beta, _n_p);
+  VecPointwiseDivide(rho_n_beta, rho_n_beta, _beta_p);
+  ierr = scatterToZero(rho_n_beta, _nwtScaleG); CHKERRQ(ierr);
+  if (_D->_gridSpacingType.compare("variableGridSpacing") == 0) {
+    Mat J, Jinv, qy, rz, yq, zr;
+    ierr = _sbp->getCoordTrans(J, Jinv, qy, rz, yq, zr); CHKERRQ(ierr);
+    MatGetDiagonal(Jinv, r1);
+    VecPointwiseMult(r1, r1, rho_n_beta);
+    ierr = scatterToZero(r1, _nwtScaleA); CHKERRQ(ierr);
+  }
+  else {
+    _nwtScaleA = _nwtScaleG;
+  }
+  VecDestroy(&rho_n_beta);
+  VecDestroy(&r1);
+
+  // material properties entering k(p) and the coefficient
+  ierr = scatterToZero(_rho_f, _nwtRho); CHKERRQ(ierr);
+  ierr = scatterToZero(_eta_p, _nwtEta); CHKERRQ(ierr);
+  ierr = scatterToZero(_kmin2_p, _nwtKmin2); CHKERRQ(ierr);
+  ierr = scatterToZero(_sigma_p, _nwtSigma); CHKERRQ(ierr);
+  ierr = scatterToZero(_sN, _nwtSN); CHKERRQ(ierr);
+
+  // bottom boundary, see updateBoundaryCoefficient
+  _nwtBcImpose = 0.0;
+  if (_bcB_type.compare("Dp") == 0) {
+    _nwtBcFac = _g * (1.0 + _bcB_ratio);
+  }
+  else {
+    _nwtBcFac = _g;
+    VecSum(_bcB_impose, &_nwtBcImpose);
+  }
+
+  // Jacobian band: D2, its derivative with respect to the coefficient, Dz, and the boundary terms
+  if (rank == 0) {
+    PetscInt bwJ = max(max(_nwtD2._bw, _nwtD2._rc), _nwtDz._bw);
+    for (PetscInt i = 0; i < _N; i++) {
+      if (_nwtR1[i] != 0.0) { bwJ = max(bwJ, _N - 1 - i); }
+    }
+    ierr = _nwtA.setSize(_N, _nwtD2._bw); CHKERRQ(ierr);
+    ierr = _nwtJ.setSize(_N, bwJ); CHKERRQ(ierr);
+  }
+
+  _nwtIsSetUp = 1;
+  _miscTime += MPI_Wtime() - startTime;
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD, "Ending %s in %s\n", funcName.c_str(), FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// residual of the backward Euler system with permeability evaluated at the new pressure, on rank 0
+//   F(p) = H (p - p_old) - dt Jinv/(rho*n*beta) (D2(c) p - r1 bcB(c)) + dt/(rho*n*beta) H Dz(g rho_f c),
+// where c = rho_f k(p) / eta, k(p) = (k_slip - kmin2) exp((p - sN)/sigma) + kmin2.
+// If formJacobian = 1, also forms the exact Jacobian dF/dp in _nwtJ, using
+// dc/dp = rho_f (k - kmin2) / (sigma eta).
+PetscErrorCode PressureEq::computeBeResidual_newton(const vector<PetscScalar> &p, const vector<PetscScalar> &p_old, const vector<PetscScalar> &k_slip, const PetscScalar dt, vector<PetscScalar> &F, const int formJacobian)
+{
+  PetscErrorCode ierr = 0;
+  const PetscInt N = _N;
+  vector<PetscScalar> c(N), dc(N), gc(N), D2p(N), Dzgc(N), rowScale(N);
+
+  for (PetscInt i = 0; i < N; i++) {
+    const PetscScalar k = (k_slip[i] - _nwtKmin2[i]) * exp((p[i] - _nwtSN[i]) / _nwtSigma[i]) + _nwtKmin2[i];
+    c[i] = _nwtRho[i] * k / _nwtEta[i];
+    dc[i] = _nwtRho[i] * (k - _nwtKmin2[i]) / (_nwtSigma[i] * _nwtEta[i]);
+    gc[i] = _g * _nwtRho[i] * c[i];
+  }
+  const PetscScalar bcB = _nwtBcFac * _nwtRho[N-1] * c[N-1] + _nwtBcImpose;
+
+  ierr = _nwtD2.assemble(c.data(), _nwtA); CHKERRQ(ierr);
+  ierr = _nwtA.mult(p.data(), D2p.data()); CHKERRQ(ierr);
+  ierr = _nwtDz.mult(gc.data(), Dzgc.data()); CHKERRQ(ierr);
+
+  F.resize(N);
+  for (PetscInt i = 0; i < N; i++) {
+    F[i] = _beHdiag[i] * (p[i] - p_old[i])
+         - dt * _nwtScaleA[i] * (D2p[i] - _nwtR1[i] * bcB)
+         + dt * _nwtScaleG[i] * _beHdiag[i] * Dzgc[i];
+  }
+
+  if (formJacobian) {
+    ierr = _nwtJ.zeroEntries(); CHKERRQ(ierr);
+
+    // H - dt Jinv/(rho*n*beta) D2(c)
+    for (PetscInt i = 0; i < N; i++) {
+      rowScale[i] = -dt * _nwtScaleA[i];
+      const PetscInt jStart = max((PetscInt) 0, i - _nwtA._bw), jEnd = min(N - 1, i + _nwtA._bw);
+      for (PetscInt j = jStart; j <= jEnd; j++) { _nwtJ.setValue(i, j, rowScale[i] * _nwtA.getValue(i, j)); }
+      _nwtJ.addValue(i, i, _beHdiag[i]);
+    }
+
+    // dependence of D2 on the coefficient
+    ierr = _nwtD2.addCoeffDerivative(p.data(), rowScale.data(), dc.data(), _nwtJ); CHKERRQ(ierr);
+
+    // dependence of the bottom boundary flux on the coefficient at z = L
+    const PetscScalar dbcB = _nwtBcFac * _nwtRho[N-1] * dc[N-1];
+    for (PetscInt i = 0; i < N; i++) {
+      if (_nwtR1[i] != 0.0) { _nwtJ.addValue(i, N-1, dt * _nwtScaleA[i] * _nwtR1[i] * dbcB); }
+    }
+
+    // dependence of the gravity term on the coefficient
+    for (PetscInt i = 0; i < N; i++) {
+      const PetscInt kStart = max((PetscInt) 0, i - _nwtDz._bw), kEnd = min(N - 1, i + _nwtDz._bw);
+      const PetscScalar f = dt * _nwtScaleG[i] * _beHdiag[i];
+      for (PetscInt k = kStart; k <= kEnd; k++) {
+        _nwtJ.addValue(i, k, f * _nwtDz.getValue(i, k) * _g * _nwtRho[k] * dc[k]);
+      }
+    }
+  }
+
+  return ierr;
+}
+
+
+// backward Euler with permeability fully implicit in pressure, solved with Newton's method
+// the iteration is done on rank 0 in band storage, with a backtracking line search on ||F||
+PetscErrorCode PressureEq::solveBe_newton(const Vec &p_old, const PetscScalar dt, Vec &p)
+{
+  PetscErrorCode ierr = 0;
+
+  #if VERBOSE > 1
+    string funcName = "PressureEq::solveBe_newton";
+    PetscPrintf(PETSC_COMM_WORLD, "Starting %s in %s\n", funcName.c_str(), FILENAME);
+  #endif
+
+  PetscMPIInt rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+
+  vector<PetscScalar> pOld, kSlip;
+  ierr = scatterToZero(p_old, pOld); CHKERRQ(ierr);
+  ierr = scatterToZero(_k_slip, kSlip); CHKERRQ(ierr);
+
+  int its = 0, converged = 0;
+  PetscScalar normF = 0.0;
+  if (rank == 0) {
+    const PetscInt N = _N;
+    vector<PetscScalar> pk(pOld), F, dp(N), pTrial(N), FTrial;
+    ierr = computeBeResidual_newton(pk, pOld, kSlip, dt, F, 1); CHKERRQ(ierr);
+    normF = 0.0;
+    for (PetscInt i = 0; i < N; i++) { normF += F[i] * F[i]; }
+    normF = sqrt(normF);
+
+    while (its < _maxBeNewtonIteration && !converged) {
+      its++;
+      ierr = _nwtJ.factor(); CHKERRQ(ierr);
+      ierr = _nwtJ.solve(F.data(), dp.data()); CHKERRQ(ierr);
+
+      // halve the step until the residual decreases; the Jacobian is formed at each trial
+      // point, so on exit it belongs to the accepted iterate
+      PetscScalar lambda = 1.0, normFTrial = 0.0;
+      for (int ls = 0; ls < 8; ls++) {
+        for (PetscInt i = 0; i < N; i++) { pTrial[i] = pk[i] - lambda * dp[i]; }
+        ierr = computeBeResidual_newton(pTrial, pOld, kSlip, dt, FTrial, 1); CHKERRQ(ierr);
+        normFTrial = 0.0;
+        for (PetscInt i = 0; i < N; i++) { normFTrial += FTrial[i] * FTrial[i]; }
+        normFTrial = sqrt(normFTrial);
+        if (normFTrial < normF || ls == 7) { break; }
+        lambda *= 0.5;
+      }
+      pk.swap(pTrial);
+      F.swap(FTrial);
+      normF = normFTrial;
+
+      PetscScalar normDp = 0.0, normP = 0.0;
+      for (PetscInt i = 0; i < N; i++) { normDp += dp[i] * dp[i]; normP += pk[i] * pk[i]; }
+      normDp = lambda * sqrt(normDp);
+      normP = sqrt(normP);
+      converged = (normDp <= _beNewtonTol * normP) || (normF == 0.0);
+
+      #if VERBOSE > 1
+        PetscPrintf(PETSC_COMM_SELF, "   Newton it %i: ||F|| = %.15e, ||dp||/||p|| = %.15e, step length = %g\n", its, normF, normDp / normP, lambda);
+      #endif
+    }
+
+    PetscScalar *s;
+    ierr = VecGetArray(_beSeq, &s); CHKERRQ(ierr);
+    for (PetscInt i = 0; i < N; i++) { s[i] = pk[i]; }
+    ierr = VecRestoreArray(_beSeq, &s); CHKERRQ(ierr);
+  }
+  MPI_Bcast(&its, 1, MPI_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&converged, 1, MPI_INT, 0, PETSC_COMM_WORLD);
+  MPI_Bcast(&normF, 1, MPIU_SCALAR, 0, PETSC_COMM_WORLD);
+
+  ierr = VecScatterBegin(_beScatter, _beSeq, p, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_beScatter, _beSeq, p, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+
+  _beNewtonSolves++;
+  _beNewtonIts += its;
+  _beNewtonMaxIts = max(_beNewtonMaxIts, its);
+  if (!converged) {
+    _beNewtonFailures++;
+    PetscPrintf(PETSC_COMM_WORLD, "WARNING: PressureEq Newton solve did not converge in %i iterations, ||F|| = %g\n", its, normF);
+  }
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD, "Ending %s in %s\n", funcName.c_str(), FILENAME);
+  #endif
+  return ierr;
+}
+
+
 // TODO: check why is everything commented out here
 // backward Euler implicit solve for MMS test
 // new result goes in varIm
@@ -1856,6 +2341,11 @@ PetscErrorCode PressureEq::view(const double totRunTime)
   ierr = PetscPrintf(PETSC_COMM_WORLD, "   %% integration time spent computing pressure rate: %g\n", _ptTime / totRunTime * 100.); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "   delete and create SBP (s): %g\n", _miscTime); CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD, "   inversion (s): %g\n", _invTime); CHKERRQ(ierr);
+  if (_permPressureDependent.compare("yes") == 0 && _permPressureSolver.compare("Newton") == 0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "   Newton solves for pressure-dependent permeability: %i\n", _beNewtonSolves); CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "   Newton iterations: total %i, mean %g, max %i\n", _beNewtonIts, (double) _beNewtonIts / max(_beNewtonSolves, 1), _beNewtonMaxIts); CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "   Newton solves that did not converge: %i\n", _beNewtonFailures); CHKERRQ(ierr);
+  }
   ierr = PetscPrintf(PETSC_COMM_WORLD, "\n"); CHKERRQ(ierr);
   return ierr;
 }
@@ -1883,6 +2373,8 @@ PetscErrorCode PressureEq::writeContext(const string outputDir)
 
   ierr = PetscViewerASCIIPrintf(viewer, "g = %.15e\n", _g); CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer, "hydraulicTimeIntType = %s\n", _hydraulicTimeIntType.c_str()); CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer, "hydraulicLinSolver = %s\n", _linSolver.c_str()); CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer, "permPressureSolver = %s\n", _permPressureSolver.c_str()); CHKERRQ(ierr);
   ierr = PetscViewerDestroy(&viewer); CHKERRQ(ierr);
 
   // write material parameters
@@ -12,6 +12,7 @@
 #include "sbpOps.hpp"
 #include "sbpOps_m_constGrid.hpp"
 #include "sbpOps_m_varGrid.hpp"
+#include "bandedLU.hpp"
 #include "integratorContextEx.hpp"
 #include "integratorContextImex.hpp"
 
@@ -65,12 +66,34 @@ private:
   int _maxBeIteration;
   double _minBeDifference;
 
+  // nonlinear solve for pressure-dependent permeability in backward Euler
+  string _permPressureSolver; // "Newton" or "Picard"
+  int _maxBeNewtonIteration;
+  PetscScalar _beNewtonTol; // relative tolerance on the Newton update
+  int _beNewtonIts, _beNewtonSolves, _beNewtonFailures, _beNewtonMaxIts;
+
   // linear system
-  string _linSolver;
+  string _linSolver; // "BANDED" or "AMG"
   KSP _ksp;
   PetscScalar _kspTol;
   SbpOps *_sbp;
   int _linSolveCount;
+
+  // banded direct solve for backward Euler, on rank 0 (linSolver = BANDED)
+  BandedLU _beD2; // D2, refreshed only if permeability changes
+  BandedLU _beLU; // work band for H - dt/(rho*n*beta)*D2, formed from _beD2 at each solve
+  vector<PetscScalar> _beHdiag; // diagonal of H, on rank 0
+  VecScatter _beScatter;
+  Vec _beSeq = NULL, _beSeqScale = NULL;
+
+  // Newton solve on rank 0 (permPressureSolver = Newton), in band storage
+  int _nwtIsSetUp;
+  BandedCoeffOp _nwtD2; // D2 as a function of the coefficient rho*k/eta
+  BandedLU _nwtDz, _nwtA, _nwtJ; // Dz, D2 at current iterate, Jacobian
+  vector<PetscScalar> _nwtR1; // boundary rhs for unit bcB
+  vector<PetscScalar> _nwtRho, _nwtEta, _nwtKmin2, _nwtSigma, _nwtSN;
+  vector<PetscScalar> _nwtScaleA, _nwtScaleG; // row scalings: Jinv/(rho*n*beta) and 1/(rho*n*beta)
+  PetscScalar _nwtBcFac, _nwtBcImpose; // bcB = bcFac * rho_f * (rho_f*k/eta) at z = L, + bcImpose
   Vec _bcL = NULL, _bcT = NULL, _bcB = NULL, _bcB_gravity = NULL, _bcB_impose = NULL;
   Vec _p_t = NULL;
 
@@ -107,6 +130,12 @@ private:
   PetscErrorCode computeInitialSteadyStatePressure(Domain &D);
   PetscErrorCode setUpBe(Domain &D);
   PetscErrorCode setupKSP(const Mat &A);
+  PetscErrorCode setUpBe_banded(const Mat &D2, const Mat &H, const Vec &v);
+  PetscErrorCode solveBe_banded(const Mat &D2, const Mat &H, const Vec &rowScale, const PetscScalar dt, const Vec &rhs, Vec &p);
+  PetscErrorCode scatterToZero(const Vec &v, vector<PetscScalar> &out);
+  PetscErrorCode setUpBe_newton();
+  PetscErrorCode computeBeResidual_newton(const vector<PetscScalar> &p, const vector<PetscScalar> &p_old, const vector<PetscScalar> &k_slip, const PetscScalar dt, vector<PetscScalar> &F, const int formJacobian);
+  PetscErrorCode solveBe_newton(const Vec &p_old, const PetscScalar dt, Vec &p);
   PetscErrorCode updatePermPressureDependent();
 
 
@@ -119,6 +148,7 @@ public:
   PetscErrorCode getPressure(Vec& P);
   PetscErrorCode setPressure(const Vec& P);
   PetscErrorCode getPermeability(Vec& K);
+  PetscErrorCode computeMaxTimeStep(PetscScalar& maxTimeStep); // diffusion time across one grid cell
   PetscErrorCode setPremeability(const Vec& K);
 
   PetscErrorCode setFields(Domain &D);
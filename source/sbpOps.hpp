@@ -84,6 +84,7 @@ class SbpOps
     // functions to compute various derivatives of input vectors
     virtual PetscErrorCode Dy(const Vec &in, Vec &out) = 0; // out = Dy * in
     virtual PetscErrorCode muxDy(const Vec &in, Vec &out) = 0; // out = mu * Dy * in
+    virtual PetscErrorCode muxDy_y0(const Vec &in, Vec &out) = 0; // out = mu * Dy * in, only at y=0
     virtual PetscErrorCode Dyxmu(const Vec &in, Vec &out) = 0; // out = Dy * mu * in
     virtual PetscErrorCode Dz(const Vec &in, Vec &out) = 0; // out = Dz * in
     virtual PetscErrorCode muxDz(const Vec &in, Vec &out) = 0; // out = mu * Dz * in
@@ -70,6 +70,7 @@ class SbpOps_m_constGrid : public SbpOps
     Mat _E0y_Iz,_ENy_Iz,_Iy_E0z,_Iy_ENz;
     Mat _muxBySy_IzT,_Iy_muxBzSzT;
     Mat _BSy_Iz, _Iy_BSz;
+    Mat _muxDy_y0; // rows of mu*Dy at y=0, constructed on first use
 
 
     //~ SbpOps_m_constGrid(Domain&D,PetscInt Ny, PetscInt Nz,Vec& muVec,string bcT,string bcR,string bcB, string bcL, string type);
@@ -103,6 +104,7 @@ class SbpOps_m_constGrid : public SbpOps
     // the exact same interface to the as the matrix version).
     PetscErrorCode Dy(const Vec &in, Vec &out); // out = Dy * in
     PetscErrorCode muxDy(const Vec &in, Vec &out); // out = mu * Dy * in
+    PetscErrorCode muxDy_y0(const Vec &in, Vec &out); // out = mu * Dy * in, evaluated only at y=0
     PetscErrorCode Dyxmu(const Vec &in, Vec &out); // out = Dy * mu * in
     PetscErrorCode Dz(const Vec &in, Vec &out); // out = Dz * in
     PetscErrorCode muxDz(const Vec &in, Vec &out); // out = mu * Dz * in
@@ -73,6 +73,7 @@ SbpOps_m_varGrid::~SbpOps_m_varGrid()
   MatDestroy(&_E0y_Iz); MatDestroy(&_ENy_Iz); MatDestroy(&_Iy_E0z); MatDestroy(&_Iy_ENz);
   MatDestroy(&_muxBySy_IzT); MatDestroy(&_Iy_muxBzSzT);
   MatDestroy(&_BSy_Iz); MatDestroy(&_Iy_BSz);
+  MatDestroy(&_muxDy_y0);
 
   MatDestroy(&_muqy); MatDestroy(&_murz);
   MatDestroy(&_yq); MatDestroy(&_zr);
@@ -116,6 +117,7 @@ PetscErrorCode SbpOps_m_varGrid::setMatsToNull()
   _E0y_Iz = NULL; _ENy_Iz = NULL; _Iy_E0z = NULL; _Iy_ENz = NULL;
   _muxBySy_IzT = NULL; _Iy_muxBzSzT = NULL;
   _BSy_Iz = NULL; _Iy_BSz = NULL;
+  _muxDy_y0 = NULL;
 
   _muqy = NULL; _murz = NULL;
   _yq = NULL; _zr = NULL;_qy = NULL; _rz = NULL;
@@ -539,6 +541,7 @@ PetscErrorCode SbpOps_m_varGrid::updateVarCoeff(const Vec& coeff)
   #endif
 
   MatDestroy(&_D2);
+  MatDestroy(&_muxDy_y0);
 
   // update coefficient Vec and Mat
   VecCopy(coeff,_muVec);
@@ -1637,6 +1640,30 @@ PetscErrorCode SbpOps_m_varGrid::muxDy(const Vec &in, Vec &out)
   return ierr;
 };
 
+// out = mu * Dy * in, evaluated only at y=0 (out has length Nz)
+PetscErrorCode SbpOps_m_varGrid::muxDy_y0(const Vec &in, Vec &out)
+{
+  PetscErrorCode ierr = 0;
+#if VERBOSE > 1
+  string funcName = "SbpOps_m_varGrid::muxDy_y0";
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s.\n",funcName.c_str(),FILENAME);CHKERRQ(ierr);
+#endif
+
+  // extract the y=0 rows of mu*Dy on first use: e0y^T * mu * Dy
+  if (_muxDy_y0 == NULL) {
+    Mat muxDy;
+    ierr = MatMatMult(_mu,_Dy_Iz,MAT_INITIAL_MATRIX,1.,&muxDy); CHKERRQ(ierr);
+    ierr = MatTransposeMatMult(_e0y_Iz,muxDy,MAT_INITIAL_MATRIX,1.,&_muxDy_y0); CHKERRQ(ierr);
+    MatDestroy(&muxDy);
+  }
+  ierr = MatMult(_muxDy_y0,in,out); CHKERRQ(ierr);
+
+#if VERBOSE > 1
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s.\n",funcName.c_str(),FILENAME);CHKERRQ(ierr);
+#endif
+  return ierr;
+};
+
 // out = Dy * mu * in
 PetscErrorCode SbpOps_m_varGrid::Dyxmu(const Vec &in, Vec &out)
 {
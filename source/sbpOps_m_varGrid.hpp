@@ -72,6 +72,7 @@ public:
     Mat _E0y_Iz,_ENy_Iz,_Iy_E0z,_Iy_ENz;
     Mat _muxBySy_IzT,_Iy_muxBzSzT;
     Mat _BSy_Iz, _Iy_BSz;
+    Mat _muxDy_y0; // rows of mu*Dy at y=0, constructed on first use
 
 
     SbpOps_m_varGrid(const int order,const PetscInt Ny,const PetscInt Nz,const PetscScalar Ly, const PetscScalar Lz,Vec& muVec);
@@ -104,6 +105,7 @@ public:
     // the exact same interface to the as the matrix version).
     PetscErrorCode Dy(const Vec &in, Vec &out); // out = Dy * in
     PetscErrorCode muxDy(const Vec &in, Vec &out); // out = mu * Dy * in
+    PetscErrorCode muxDy_y0(const Vec &in, Vec &out); // out = mu * Dy * in, evaluated only at y=0
     PetscErrorCode Dyxmu(const Vec &in, Vec &out); // out = Dy * mu * in
     PetscErrorCode Dz(const Vec &in, Vec &out); // out = Dz * in
     PetscErrorCode muxDz(const Vec &in, Vec &out); // out = mu * Dz * in
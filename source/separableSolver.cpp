@@ -0,0 +1,330 @@
+#include "separableSolver.hpp"
+
+#define FILENAME "separableSolver.cpp"
+
+using namespace std;
+
+
+SeparableSolver::SeparableSolver(const int order,const PetscInt Ny,const PetscInt Nz,
+  const PetscScalar Ly,const PetscScalar Lz,const Vec& muL,const string compatibilityType,
+  const string bcR,const string bcT,const string bcL,const string bcB)
+: _order(order),_Ny(Ny),_Nz(Nz),_Ly(Ly),_Lz(Lz),_muL(NULL),
+  _compatibilityType(compatibilityType),
+  _bcRType(bcR),_bcTType(bcT),_bcLType(bcL),_bcBType(bcB),
+  _eigDir('y'),_Ne(0),_Nb(0),
+  _b0(0),_b1(0),_k0(0),_k1(0),
+  _lineE(NULL),_lineB(NULL),_toE(NULL),_transpose(NULL),_rank(0)
+{
+  #if VERBOSE > 1
+    string funcName = "SeparableSolver::SeparableSolver";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  assert(Ny > 1 && Nz > 1);
+  VecDuplicate(muL,&_muL);
+  VecCopy(muL,_muL);
+  MPI_Comm_rank(PETSC_COMM_WORLD,&_rank);
+
+  // diagonalize the smaller dimension, use banded solves in the larger one
+  if (_Ny <= _Nz) { _eigDir = 'y'; _Ne = _Ny; _Nb = _Nz; }
+  else { _eigDir = 'z'; _Ne = _Nz; _Nb = _Ny; }
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+}
+
+
+SeparableSolver::~SeparableSolver()
+{
+  VecDestroy(&_muL);
+  VecDestroy(&_lineE);
+  VecDestroy(&_lineB);
+  VecScatterDestroy(&_toE);
+  VecScatterDestroy(&_transpose);
+}
+
+
+// construct 1D operators, solve the generalized eigenproblem, and factor the banded systems
+PetscErrorCode SeparableSolver::setUp()
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "SeparableSolver::setUp";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  // 1D operator in y with unit coefficient, and 1D operator in z with coefficient mu(z)
+  Vec onesNy;
+  ierr = VecCreate(PETSC_COMM_WORLD,&onesNy); CHKERRQ(ierr);
+  ierr = VecSetSizes(onesNy,PETSC_DECIDE,_Ny); CHKERRQ(ierr);
+  ierr = VecSetFromOptions(onesNy); CHKERRQ(ierr);
+  ierr = VecSet(onesNy,1.0); CHKERRQ(ierr);
+
+  SbpOps* opY = new SbpOps_m_constGrid(_order,_Ny,1,_Ly,_Lz,onesNy);
+  SbpOps* opZ = new SbpOps_m_constGrid(_order,1,_Nz,_Ly,_Lz,_muL);
+  SbpOps* ops[2] = {opY,opZ};
+  for (int i = 0; i < 2; i++) {
+    ops[i]->setCompatibilityType(_compatibilityType);
+    ops[i]->setBCTypes(_bcRType,_bcTType,_bcLType,_bcBType);
+    ops[i]->setMultiplyByH(1);
+    ops[i]->setLaplaceType("yz");
+    ops[i]->computeMatrices();
+  }
+
+  // copy 1D operators into band storage on rank 0
+  Mat Ay,Az,Hy,Hz,Mz,muqy,murz;
+  ierr = opY->getA(Ay); CHKERRQ(ierr);
+  ierr = opZ->getA(Az); CHKERRQ(ierr);
+  ierr = opY->getH(Hy); CHKERRQ(ierr);
+  ierr = opZ->getH(Hz); CHKERRQ(ierr);
+  ierr = opZ->getMus(Mz,muqy,murz); CHKERRQ(ierr);
+
+  PetscInt bwY = 0, bwZ = 0;
+  ierr = BandedLU::computeBandwidth(Ay,bwY); CHKERRQ(ierr);
+  ierr = BandedLU::computeBandwidth(Az,bwZ); CHKERRQ(ierr);
+  BandedLU bAy(_Ny,bwY), bAz(_Nz,bwZ), bHy(_Ny,0), bHz(_Nz,0), bMz(_Nz,0);
+  ierr = bAy.setFromMat(Ay); CHKERRQ(ierr);
+  ierr = bAz.setFromMat(Az); CHKERRQ(ierr);
+  ierr = bHy.setFromMat(Hy); CHKERRQ(ierr);
+  ierr = bHz.setFromMat(Hz); CHKERRQ(ierr);
+  ierr = bMz.setFromMat(Mz); CHKERRQ(ierr);
+
+  delete opY;
+  delete opZ;
+  VecDestroy(&onesNy);
+
+  // A = E (x) Db + De (x) G for eigDir = y, or A = Db (x) E + G (x) De for eigDir = z
+  BandedLU *E, *G;
+  vector<PetscScalar> De(_Ne), Db(_Nb);
+  E = (_eigDir == 'y') ? &bAy : &bAz;
+  G = (_eigDir == 'y') ? &bAz : &bAy;
+  if (_rank == 0) {
+    if (_eigDir == 'y') {
+      for (PetscInt i = 0; i < _Ny; i++) { De[i] = bHy.getValue(i,i); }
+      for (PetscInt j = 0; j < _Nz; j++) { Db[j] = bHz.getValue(j,j) * bMz.getValue(j,j); }
+    }
+    else {
+      for (PetscInt j = 0; j < _Nz; j++) { De[j] = bHz.getValue(j,j) * bMz.getValue(j,j); }
+      for (PetscInt i = 0; i < _Ny; i++) { Db[i] = bHy.getValue(i,i); }
+    }
+  }
+
+  // the 1D problems along b are factored on the rank that owns their mode
+  MPI_Bcast(De.data(),_Ne,MPIU_SCALAR,0,PETSC_COMM_WORLD);
+  MPI_Bcast(Db.data(),_Nb,MPIU_SCALAR,0,PETSC_COMM_WORLD);
+  ierr = G->bcast(PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+  // the eigen decomposition is computed on rank 0 and broadcast, so that
+  // every rank uses the same eigenvectors
+  // S = De^-1/2 E De^-1/2 is symmetric, S = Q Lambda Q^T, and V = De^-1/2 Q
+  vector<PetscScalar> S(_Ne*_Ne,0.0);
+  vector<PetscReal> lambda(_Ne);
+  if (_rank == 0) {
+    for (PetscInt c = 0; c < _Ne; c++) {
+      for (PetscInt r = max((PetscInt) 0,c-E->_bw); r <= min(_Ne-1,c+E->_bw); r++) {
+        S[r + c*_Ne] = 0.5*(E->getValue(r,c) + E->getValue(c,r)) / sqrt(De[r]*De[c]);
+      }
+    }
+
+    PetscBLASInt n,lwork,info;
+    ierr = PetscBLASIntCast(_Ne,&n); CHKERRQ(ierr);
+    lwork = 3*n;
+    vector<PetscScalar> work(lwork);
+    LAPACKsyev_("V","U",&n,S.data(),&n,lambda.data(),work.data(),&lwork,&info);
+    if (info != 0) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"ERROR: LAPACK syev failed in SeparableSolver::setUp, info = %i\n",(int) info);
+      assert(0);
+    }
+  }
+  MPI_Bcast(S.data(),_Ne*_Ne,MPIU_SCALAR,0,PETSC_COMM_WORLD);
+  MPI_Bcast(lambda.data(),_Ne,MPIU_REAL,0,PETSC_COMM_WORLD);
+
+  _V.resize(_Ne*_Ne);
+  for (PetscInt c = 0; c < _Ne; c++) {
+    for (PetscInt r = 0; r < _Ne; r++) { _V[r + c*_Ne] = S[r + c*_Ne] / sqrt(De[r]); }
+  }
+
+  // split the lines along e, and the modes, over the ranks
+  PetscInt nbLocal = PETSC_DECIDE, nkLocal = PETSC_DECIDE, Istart, Iend;
+  ierr = PetscSplitOwnership(PETSC_COMM_WORLD,&nbLocal,&_Nb); CHKERRQ(ierr);
+  ierr = PetscSplitOwnership(PETSC_COMM_WORLD,&nkLocal,&_Ne); CHKERRQ(ierr);
+  VecDestroy(&_lineE);
+  VecDestroy(&_lineB);
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,nbLocal*_Ne,_Ny*_Nz,&_lineE); CHKERRQ(ierr);
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,nkLocal*_Nb,_Ny*_Nz,&_lineB); CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(_lineE,&Istart,&Iend); CHKERRQ(ierr);
+  _b0 = Istart/_Ne; _b1 = Iend/_Ne;
+  ierr = VecGetOwnershipRange(_lineB,&Istart,&Iend); CHKERRQ(ierr);
+  _k0 = Istart/_Nb; _k1 = Iend/_Nb;
+
+  // transpose: entry (k,b) is at b*Ne + k in _lineE, and at k*Nb + b in _lineB
+  vector<PetscInt> ix,iy;
+  for (PetscInt k = _k0; k < _k1; k++) {
+    for (PetscInt b = 0; b < _Nb; b++) { ix.push_back(b*_Ne + k); iy.push_back(k*_Nb + b); }
+  }
+  VecScatterDestroy(&_transpose);
+  ierr = createScatter(_lineE,ix,_lineB,iy,_transpose); CHKERRQ(ierr);
+
+  // factor (lambda_k * Db + G) for each local mode k
+  _lu.assign(_k1-_k0,BandedLU(_Nb,G->_bw));
+  for (PetscInt k = _k0; k < _k1; k++) {
+    _lu[k-_k0]._a = G->_a;
+    for (PetscInt i = 0; i < _Nb; i++) { _lu[k-_k0].addValue(i,i,lambda[k]*Db[i]); }
+    ierr = _lu[k-_k0].factor(); CHKERRQ(ierr);
+  }
+
+  _work.resize(_Ne*(_b1-_b0));
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// solve A u = rhs
+PetscErrorCode SeparableSolver::solve(const Vec& rhs, Vec& u)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    string funcName = "SeparableSolver::solve";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  // entry (e,b) is at b*Ne + e in _lineE, and at i*Nz + j in rhs and u
+  if (_toE == NULL) {
+    vector<PetscInt> ix,iy;
+    for (PetscInt b = _b0; b < _b1; b++) {
+      for (PetscInt e = 0; e < _Ne; e++) {
+        PetscInt i = (_eigDir == 'y') ? e : b;
+        PetscInt j = (_eigDir == 'y') ? b : e;
+        ix.push_back(i*_Nz + j);
+        iy.push_back(b*_Ne + e);
+      }
+    }
+    ierr = createScatter(rhs,ix,_lineE,iy,_toE); CHKERRQ(ierr);
+  }
+
+  // the local lines along e form a column-major Ne x nb array B
+  PetscScalar *B, *W;
+  PetscBLASInt ne,nb;
+  const PetscScalar one = 1.0, zero = 0.0;
+  ierr = PetscBLASIntCast(_Ne,&ne); CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(_b1-_b0,&nb); CHKERRQ(ierr);
+
+  // W = V^T B
+  ierr = VecScatterBegin(_toE,rhs,_lineE,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_toE,rhs,_lineE,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecGetArray(_lineE,&B); CHKERRQ(ierr);
+  if (nb > 0) {
+    BLASgemm_("T","N",&ne,&nb,&ne,&one,_V.data(),&ne,B,&ne,&zero,_work.data(),&ne);
+    copy(_work.begin(),_work.end(),B);
+  }
+  ierr = VecRestoreArray(_lineE,&B); CHKERRQ(ierr);
+
+  // banded solve for each local mode
+  ierr = VecScatterBegin(_transpose,_lineE,_lineB,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_transpose,_lineE,_lineB,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecGetArray(_lineB,&W); CHKERRQ(ierr);
+  for (PetscInt k = _k0; k < _k1; k++) {
+    ierr = _lu[k-_k0].solve(&W[(k-_k0)*_Nb],&W[(k-_k0)*_Nb]); CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(_lineB,&W); CHKERRQ(ierr);
+  ierr = VecScatterBegin(_transpose,_lineB,_lineE,INSERT_VALUES,SCATTER_REVERSE); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_transpose,_lineB,_lineE,INSERT_VALUES,SCATTER_REVERSE); CHKERRQ(ierr);
+
+  // U = V W
+  ierr = VecGetArray(_lineE,&B); CHKERRQ(ierr);
+  if (nb > 0) {
+    BLASgemm_("N","N",&ne,&nb,&ne,&one,_V.data(),&ne,B,&ne,&zero,_work.data(),&ne);
+    copy(_work.begin(),_work.end(),B);
+  }
+  ierr = VecRestoreArray(_lineE,&B); CHKERRQ(ierr);
+  ierr = VecScatterBegin(_toE,_lineE,u,INSERT_VALUES,SCATTER_REVERSE); CHKERRQ(ierr);
+  ierr = VecScatterEnd(_toE,_lineE,u,INSERT_VALUES,SCATTER_REVERSE); CHKERRQ(ierr);
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// compare against the assembled operator: relErr = ||u - A^-1 A u|| / ||u|| for random u
+PetscErrorCode SeparableSolver::verify(const Mat& A, PetscScalar& relErr)
+{
+  PetscErrorCode ierr = 0;
+  Vec u,b,uS;
+  PetscScalar normU,normErr;
+
+  ierr = MatCreateVecs(A,&u,&b); CHKERRQ(ierr);
+  ierr = VecDuplicate(u,&uS); CHKERRQ(ierr);
+  ierr = VecSetRandom(u,NULL); CHKERRQ(ierr);
+  ierr = MatMult(A,u,b); CHKERRQ(ierr);
+  ierr = solve(b,uS); CHKERRQ(ierr);
+
+  ierr = VecNorm(u,NORM_2,&normU); CHKERRQ(ierr);
+  ierr = VecAXPY(uS,-1.0,u); CHKERRQ(ierr);
+  ierr = VecNorm(uS,NORM_2,&normErr); CHKERRQ(ierr);
+  relErr = normErr / normU;
+
+  VecDestroy(&u);
+  VecDestroy(&b);
+  VecDestroy(&uS);
+
+  // the scatter was built from A's layout, which may differ from the solution Vec's
+  VecScatterDestroy(&_toE);
+
+  return ierr;
+}
+
+
+// scatter from x to y, with x[ix[n]] sent to y[iy[n]]
+PetscErrorCode SeparableSolver::createScatter(const Vec& x,const vector<PetscInt>& ix,const Vec& y,const vector<PetscInt>& iy,VecScatter& scatter)
+{
+  PetscErrorCode ierr = 0;
+  IS isx,isy;
+  ierr = ISCreateGeneral(PETSC_COMM_WORLD,(PetscInt) ix.size(),ix.data(),PETSC_COPY_VALUES,&isx); CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_WORLD,(PetscInt) iy.size(),iy.data(),PETSC_COPY_VALUES,&isy); CHKERRQ(ierr);
+  ierr = VecScatterCreate(x,isx,y,isy,&scatter); CHKERRQ(ierr);
+  ISDestroy(&isx);
+  ISDestroy(&isy);
+  return ierr;
+}
+
+
+// check whether mu varies only with depth
+// muL must already be allocated with the layout of the y=0 boundary Vecs
+PetscErrorCode SeparableSolver::isDepthLayered(const Vec& mu,VecScatter& body2L,const PetscInt Ny,Vec& muL,PetscBool& isLayered)
+{
+  PetscErrorCode ierr = 0;
+  Vec muRep;
+  PetscScalar normMu,normDiff;
+
+  ierr = VecScatterBegin(body2L,mu,muL,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(body2L,mu,muL,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+
+  ierr = VecDuplicate(mu,&muRep); CHKERRQ(ierr);
+  ierr = repVec(muRep,muL,Ny); CHKERRQ(ierr);
+  ierr = VecNorm(mu,NORM_INFINITY,&normMu); CHKERRQ(ierr);
+  ierr = VecAXPY(muRep,-1.0,mu); CHKERRQ(ierr);
+  ierr = VecNorm(muRep,NORM_INFINITY,&normDiff); CHKERRQ(ierr);
+  VecDestroy(&muRep);
+
+  isLayered = (normDiff <= 1e-12*normMu) ? PETSC_TRUE : PETSC_FALSE;
+
+  return ierr;
+}
+
+
+// apply the separable solver as a preconditioner, for use with KSPPREONLY
+PetscErrorCode SeparableSolver::applyPC(PC pc,Vec x,Vec y)
+{
+  PetscErrorCode ierr = 0;
+  void *ctx;
+  ierr = PCShellGetContext(pc,&ctx); CHKERRQ(ierr);
+  SeparableSolver *sep = (SeparableSolver*) ctx;
+  ierr = sep->solve(x,y); CHKERRQ(ierr);
+  return ierr;
+}
@@ -0,0 +1,98 @@
+#ifndef SEPARABLESOLVER_H_INCLUDED
+#define SEPARABLESOLVER_H_INCLUDED
+
+#include <petscksp.h>
+#include <petscblaslapack.h>
+#include <string>
+#include <cmath>
+#include <assert.h>
+#include <vector>
+
+#include "genFuncs.hpp"
+#include "bandedLU.hpp"
+#include "sbpOps.hpp"
+#include "sbpOps_m_constGrid.hpp"
+
+using namespace std;
+
+/*
+ * Direct solver for the SBP-SAT momentum balance operator when the shear
+ * modulus varies only with depth, mu = mu(z), on a constant grid.
+ *
+ * In that case the operator (with multiplyByH = 1) separates exactly into
+ *    A = Ay (x) (Hz*Mz) + Hy (x) Az,
+ * where Ay is the 1D operator in y with unit coefficient, Az the 1D operator
+ * in z with coefficient mu(z), and Hy, Hz, Mz are diagonal. The generalized
+ * eigenproblem in the smaller of the two dimensions is solved once with LAPACK,
+ * after which each solve consists of two dense transforms and one banded
+ * solve per mode.
+ *
+ * The work is distributed over the ranks by whole lines of the grid. With
+ * e the index in the eigen dimension, b the index in the banded dimension,
+ * and P ranks, each solve
+ *   1. scatters rhs to lines along e (each rank owns about Nb/P of them),
+ *   2. transforms them to the modes, W = V^T B, with one dense product,
+ *   3. transposes W to lines along b (each rank owns about Ne/P modes),
+ *   4. solves the banded system of each local mode,
+ * and reverses steps 1-3. The cost per rank is O(Ne^2*Nb/P) for the dense
+ * products and O(Ne*Nb*bw/P) for the banded solves, and each transpose is
+ * an all-to-all exchange of the whole field. The dense products make this
+ * O(N^1.5) work in total for N = Ny*Nz, so it is faster than a sparse
+ * direct solve only while Ne is moderate. The eigen decomposition (O(Ne^3))
+ * is computed on rank 0 once, and broadcast.
+ *
+ * Example usage:
+ *    SeparableSolver sep(order,Ny,Nz,Ly,Lz,muL,compatibilityType,bcR,bcT,bcL,bcB);
+ *    sep.setUp();
+ *    sep.verify(A,relErr); // optional: check against the assembled 2D operator
+ *    sep.solve(rhs,u);
+ */
+
+class SeparableSolver
+{
+private:
+  // disable default copy constructor and assignment operator
+  SeparableSolver(const SeparableSolver &that);
+  SeparableSolver& operator=(const SeparableSolver &rhs);
+
+  PetscErrorCode createScatter(const Vec& x,const vector<PetscInt>& ix,const Vec& y,const vector<PetscInt>& iy,VecScatter& scatter);
+
+public:
+  const int         _order;
+  const PetscInt    _Ny,_Nz;
+  const PetscScalar _Ly,_Lz;
+  Vec               _muL; // shear modulus as a function of depth (size Nz)
+  string            _compatibilityType;
+  string            _bcRType,_bcTType,_bcLType,_bcBType;
+
+  char              _eigDir; // 'y' or 'z': dimension diagonalized by the eigen decomposition
+  PetscInt          _Ne,_Nb; // sizes of eigen dimension and banded dimension
+  vector<PetscScalar> _V; // Ne x Ne eigenvectors (column-major), V^T De V = I
+  vector<BandedLU>  _lu; // factors of (lambda_k * Db + G), one per local mode
+  vector<PetscScalar> _work; // work array for the local lines along e
+
+  PetscInt          _b0,_b1; // local lines along e: b in [b0,b1)
+  PetscInt          _k0,_k1; // local modes: k in [k0,k1)
+  Vec               _lineE; // field by lines along e, index b*Ne + e
+  Vec               _lineB; // field by modes, index k*Nb + b
+  VecScatter        _toE; // from the body Vec (index i*Nz + j) to _lineE
+  VecScatter        _transpose; // from _lineE to _lineB
+  PetscMPIInt       _rank;
+
+  SeparableSolver(const int order,const PetscInt Ny,const PetscInt Nz,
+    const PetscScalar Ly,const PetscScalar Lz,const Vec& muL,const string compatibilityType,
+    const string bcR,const string bcT,const string bcL,const string bcB);
+  ~SeparableSolver();
+
+  PetscErrorCode setUp(); // build 1D operators, eigen decomposition, and factors
+  PetscErrorCode solve(const Vec& rhs, Vec& u);
+  PetscErrorCode verify(const Mat& A, PetscScalar& relErr); // relative error of solve for random u
+
+  // check whether mu (body field) varies only with depth, and if so return mu at y=0
+  static PetscErrorCode isDepthLayered(const Vec& mu,VecScatter& body2L,const PetscInt Ny,Vec& muL,PetscBool& isLayered);
+
+  // for use with PCSHELL
+  static PetscErrorCode applyPC(PC pc,Vec x,Vec y);
+};
+
+#endif
@@ -9,6 +9,8 @@ strikeSlip_linearElastic_fd::strikeSlip_linearElastic_fd(Domain&D)
 : _D(&D),_delim(D._delim),_isMMS(D._isMMS),
   _order(D._order),_Ny(D._Ny),_Nz(D._Nz), _Ly(D._Ly),_Lz(D._Lz),
   _deltaT(-1), _CFL(-1),_y(&D._y),_z(&D._z),_alphay(NULL),
+  _waveOp(NULL),_waveCu(NULL),_waveCuPrev(NULL),_faultD2uScale(NULL),_waveDeltaT(0),
+  _pml("no"),_pmlThickness(-1),_pmlR(1e-3),_pmlLayer(NULL),_waveCf(NULL),
   _inputDir(D._inputDir),_outputDir(D._outputDir),_vL(1e-9),
   _initialConditions("u"),_guessSteadyStateICs(0),_faultTypeScale(2.0),
   _maxStepCount(1e8), _stride1D(1),_stride2D(1),
@@ -41,6 +43,13 @@ strikeSlip_linearElastic_fd::strikeSlip_linearElastic_fd(Domain&D)
   _rho = _material->_rho;
   _mu = _material->_mu;
   computePenaltyVectors();
+  if (_pml.compare("yes")==0) {
+    _pmlLayer = new PerfectlyMatchedLayer(D,_pmlThickness,_pmlR);
+    _pmlLayer->setFields(_material->_sbp,_mu,_rho,_cs);
+    // the layer's damping also acts on fault nodes inside it
+    VecScatterBegin(*_body2fault, _pmlLayer->_damping, _fault->_pmlDamping, INSERT_VALUES, SCATTER_FORWARD);
+    VecScatterEnd(*_body2fault, _pmlLayer->_damping, _fault->_pmlDamping, INSERT_VALUES, SCATTER_FORWARD);
+  }
 
   computeTimeStep(); // compute time step
 
@@ -73,6 +82,12 @@ strikeSlip_linearElastic_fd::~strikeSlip_linearElastic_fd()
   PetscViewerDestroy(&_timeV2D);
 
   VecDestroy(&_ay);
+  MatDestroy(&_waveOp);
+  VecDestroy(&_waveCu);
+  VecDestroy(&_waveCuPrev);
+  VecDestroy(&_faultD2uScale);
+  VecDestroy(&_waveCf);
+  delete _pmlLayer; _pmlLayer = NULL;
 
   delete _quadWaveEx;      _quadWaveEx = NULL;
   delete _material;        _material = NULL;
@@ -121,6 +136,9 @@ PetscErrorCode strikeSlip_linearElastic_fd::loadSettings(const char *file)
     else if (var.compare("maxTime")==0) { _maxTime = atof( rhs.c_str() ); }
     else if (var.compare("deltaT")==0) { _deltaT = atof( rhs.c_str() ); }
     else if (var.compare("CFL")==0) { _CFL = atof( rhs.c_str() ); }
+    else if (var.compare("pml")==0) { _pml = rhs.c_str(); }
+    else if (var.compare("pmlThickness")==0) { _pmlThickness = atof( rhs.c_str() ); }
+    else if (var.compare("pmlReflection")==0) { _pmlR = atof( rhs.c_str() ); }
 
     else if (var.compare("center_y")==0) { _yCenterU = atof( rhs.c_str() ); }
     else if (var.compare("center_z")==0) { _zCenterU = atof( rhs.c_str() ); }
@@ -165,6 +183,12 @@ PetscErrorCode strikeSlip_linearElastic_fd::checkInput()
   // assert(_stride2D >= 1);
   assert(_atol >= 1e-14);
 
+  assert(_pml.compare("yes")==0 || _pml.compare("no")==0);
+  if (_pml.compare("yes")==0) {
+    assert(_pmlThickness > 0);
+    assert(_pmlR > 0 && _pmlR < 1);
+  }
+
   // check boundary condition types for momentum balance equation
   assert(_bcRType.compare("freeSurface")==0 || _bcRType.compare("outGoingCharacteristics")==0);
   assert(_bcLType.compare("symmFault")==0 || _bcRType.compare("rigidFault")==0);
@@ -362,6 +386,11 @@ PetscErrorCode strikeSlip_linearElastic_fd::writeContext()
   ierr = PetscViewerASCIIPrintf(viewer,"maxTime = %.15e # (s)\n",_maxTime);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"deltaT = %.15e # (s)\n",_deltaT);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"atol = %.15e\n",_atol);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"pml = %s\n",_pml.c_str());CHKERRQ(ierr);
+  if (_pml.compare("yes")==0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"pmlThickness = %.15e # (km)\n",_pmlThickness);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"pmlReflection = %.15e\n",_pmlR);CHKERRQ(ierr);
+  }
   ierr = PetscViewerASCIIPrintf(viewer,"timeIntInds = %s\n",vector2str(_timeIntInds).c_str());CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
 
@@ -452,26 +481,25 @@ PetscErrorCode strikeSlip_linearElastic_fd::propagateWaves(const PetscScalar tim
 
 double startPropagation = MPI_Wtime();
 
-  // compute D2u = (Dyy+Dzz)*u
-  Vec D2u, temp;
-  VecDuplicate(*_y, &D2u);
-  VecDuplicate(*_y, &temp);
-  Mat A; _material->_sbp->getA(A);
-  ierr = MatMult(A, var.find("u")->second, temp);
-  ierr = _material->_sbp->Hinv(temp, D2u);
-  VecDestroy(&temp);
-  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
-      Mat J,Jinv,qy,rz,yq,zr;
-      ierr = _material->_sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
-      Vec temp;
-      VecDuplicate(D2u, &temp);
-      MatMult(Jinv, D2u, temp);
-      VecCopy(temp, D2u);
-      VecDestroy(&temp);
+  if (_waveOp == NULL || deltaT != _waveDeltaT) {
+    ierr = constructWaveOperator(deltaT); CHKERRQ(ierr);
+  }
+
+  // uNext = dt^2/(rho*(1+dt*ay)) * D2u, with D2u = Jinv*Hinv*A*u = (Dyy+Dzz)*u
+  ierr = MatMult(_waveOp, var.find("u")->second, varNext["u"]); CHKERRQ(ierr);
+
+  // perfectly matched layer: add dt^2/(rho*(1+dt*ay)) * (Dy*psiY + Dz*psiZ - rho*zetaY*zetaZ*u)
+  if (_pmlLayer != NULL) {
+    ierr = _pmlLayer->updateAuxFields(var.find("u")->second, varPrev.find("u")->second, deltaT); CHKERRQ(ierr);
+    ierr = _pmlLayer->computeForce(var.find("u")->second); CHKERRQ(ierr);
+    ierr = VecPointwiseMult(_pmlLayer->_force, _pmlLayer->_force, _waveCf); CHKERRQ(ierr);
+    ierr = VecAXPY(varNext["u"], 1.0, _pmlLayer->_force); CHKERRQ(ierr);
   }
-  ierr = VecScatterBegin(*_body2fault, D2u, _fault->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
-  ierr = VecScatterEnd(*_body2fault, D2u, _fault->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
 
+  // the fault needs D2u itself, so undo the scaling on the fault only
+  ierr = VecScatterBegin(*_body2fault, varNext["u"], _fault->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(*_body2fault, varNext["u"], _fault->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecPointwiseMult(_fault->_d2u, _fault->_d2u, _faultD2uScale); CHKERRQ(ierr);
 
 
   // Propagate waves and compute displacement at the next time step
@@ -479,35 +507,121 @@ double startPropagation = MPI_Wtime();
 
   PetscInt       Ii,Istart,Iend;
   PetscScalar   *uNextA; // changed in this loop
-  const PetscScalar   *u, *uPrev, *d2u, *ay, *rho; // unchchanged in this loop
+  const PetscScalar   *u, *uPrev, *cu, *cuPrev; // unchchanged in this loop
   ierr = VecGetArray(varNext["u"], &uNextA);
   ierr = VecGetArrayRead(var.find("u")->second, &u);
   ierr = VecGetArrayRead(varPrev.find("u")->second, &uPrev);
-  ierr = VecGetArrayRead(_ay, &ay);
-  ierr = VecGetArrayRead(D2u, &d2u);
-  ierr = VecGetArrayRead(_rho, &rho);
+  ierr = VecGetArrayRead(_waveCu, &cu);
+  ierr = VecGetArrayRead(_waveCuPrev, &cuPrev);
 
   ierr = VecGetOwnershipRange(varNext["u"],&Istart,&Iend);CHKERRQ(ierr);
   PetscInt       Jj = 0;
   for (Ii = Istart; Ii < Iend; Ii++){
-    PetscScalar c1 = deltaT*deltaT / rho[Jj];
-    PetscScalar c2 = deltaT*ay[Jj] - 1.0;
-    PetscScalar c3 = deltaT*ay[Jj] + 1.0;
-
-    uNextA[Jj] = (c1*d2u[Jj] + 2.*u[Jj] + c2*uPrev[Jj]) / c3;
+    uNextA[Jj] += cu[Jj]*u[Jj] + cuPrev[Jj]*uPrev[Jj];
     Jj++;
   }
   ierr = VecRestoreArray(varNext["u"], &uNextA);
   ierr = VecRestoreArrayRead(var.find("u")->second, &u);
   ierr = VecRestoreArrayRead(varPrev.find("u")->second, &uPrev);
+  ierr = VecRestoreArrayRead(_waveCu, &cu);
+  ierr = VecRestoreArrayRead(_waveCuPrev, &cuPrev);
+
+_propagateTime += MPI_Wtime() - startPropagation;
+
+  #if VERBOSE > 1
+     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// Construct the scaled operator and coefficients for the leapfrog update
+//   uNext = _waveOp*u + _waveCu.*u + _waveCuPrev.*uPrev
+// which, with c2 = dt*ay - 1 and c3 = dt*ay + 1, is
+//   uNext = (dt^2/rho * Jinv*Hinv*A*u + 2*u + c2*uPrev) / c3
+// Jinv and Hinv are diagonal, so they are folded into the rows of a copy of A.
+// Must be reconstructed if deltaT or the boundary conditions of A change.
+PetscErrorCode strikeSlip_linearElastic_fd::constructWaveOperator(const PetscScalar deltaT)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    std::string funcName = "strikeSlip_linearElastic_fd::constructWaveOperator";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  // diagonal of Jinv*Hinv
+  Vec rowScale, temp;
+  VecDuplicate(*_y, &rowScale);
+  VecDuplicate(*_y, &temp);
+  VecSet(temp, 1.0);
+  ierr = _material->_sbp->Hinv(temp, rowScale); CHKERRQ(ierr);
+  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
+    Mat J,Jinv,qy,rz,yq,zr;
+    ierr = _material->_sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
+    ierr = MatMult(Jinv, rowScale, temp); CHKERRQ(ierr);
+    ierr = VecCopy(temp, rowScale); CHKERRQ(ierr);
+  }
+
+  if (_waveCu == NULL) {
+    VecDuplicate(*_y, &_waveCu);
+    VecDuplicate(*_y, &_waveCuPrev);
+    VecDuplicate(_fault->_d2u, &_faultD2uScale);
+  }
+  if (_pmlLayer != NULL && _waveCf == NULL) { VecDuplicate(*_y, &_waveCf); }
+
+  // temp is reused for rho*c3/dt^2, the inverse of the scaling applied to D2u
+  PetscInt       Ii,Istart,Iend;
+  PetscScalar   *scale, *invScale, *cu, *cuPrev, *cf = NULL;
+  const PetscScalar *ay, *rho, *pmlDamping = NULL;
+  ierr = VecGetArray(rowScale, &scale);
+  ierr = VecGetArray(temp, &invScale);
+  ierr = VecGetArray(_waveCu, &cu);
+  ierr = VecGetArray(_waveCuPrev, &cuPrev);
+  ierr = VecGetArrayRead(_ay, &ay);
+  ierr = VecGetArrayRead(_rho, &rho);
+  if (_pmlLayer != NULL) {
+    ierr = VecGetArray(_waveCf, &cf);
+    ierr = VecGetArrayRead(_pmlLayer->_damping, &pmlDamping);
+  }
+  ierr = VecGetOwnershipRange(rowScale,&Istart,&Iend);CHKERRQ(ierr);
+  PetscInt       Jj = 0;
+  for (Ii = Istart; Ii < Iend; Ii++){
+    PetscScalar a = ay[Jj];
+    if (pmlDamping != NULL) { a += pmlDamping[Jj]; }
+    PetscScalar c1 = deltaT*deltaT / rho[Jj];
+    PetscScalar c2 = deltaT*a - 1.0;
+    PetscScalar c3 = deltaT*a + 1.0;
+
+    scale[Jj] *= c1 / c3;
+    invScale[Jj] = c3 / c1;
+    cu[Jj] = 2.0 / c3;
+    cuPrev[Jj] = c2 / c3;
+    if (cf != NULL) { cf[Jj] = c1 / c3; }
+    Jj++;
+  }
+  if (_pmlLayer != NULL) {
+    ierr = VecRestoreArray(_waveCf, &cf);
+    ierr = VecRestoreArrayRead(_pmlLayer->_damping, &pmlDamping);
+  }
+  ierr = VecRestoreArray(rowScale, &scale);
+  ierr = VecRestoreArray(temp, &invScale);
+  ierr = VecRestoreArray(_waveCu, &cu);
+  ierr = VecRestoreArray(_waveCuPrev, &cuPrev);
   ierr = VecRestoreArrayRead(_ay, &ay);
-  ierr = VecRestoreArrayRead(D2u, &d2u);
   ierr = VecRestoreArrayRead(_rho, &rho);
 
-  VecDestroy(&D2u);
+  ierr = VecScatterBegin(*_body2fault, temp, _faultD2uScale, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(*_body2fault, temp, _faultD2uScale, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
 
+  // _waveOp = diag(rowScale) * A
+  Mat A; _material->_sbp->getA(A);
+  MatDestroy(&_waveOp);
+  ierr = MatDuplicate(A, MAT_COPY_VALUES, &_waveOp); CHKERRQ(ierr);
+  ierr = MatDiagonalScale(_waveOp, rowScale, NULL); CHKERRQ(ierr);
+  _waveDeltaT = deltaT;
 
-_propagateTime += MPI_Wtime() - startPropagation;
+  VecDestroy(&rowScale);
+  VecDestroy(&temp);
 
   #if VERBOSE > 1
      PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
@@ -18,6 +18,7 @@
 #include "sbpOps_m_varGrid.hpp"
 #include "fault.hpp"
 #include "pressureEq.hpp"
+#include "pml.hpp"
 #include "heatEquation.hpp"
 #include "linearElastic.hpp"
 
@@ -51,6 +52,13 @@ private:
 
   Vec             _mu, _rho, _cs, _ay;
   Vec             _alphay;
+  Mat             _waveOp; // scaled spatial operator for the wave equation, see constructWaveOperator
+  Vec             _waveCu,_waveCuPrev,_faultD2uScale;
+  PetscScalar     _waveDeltaT; // deltaT for which _waveOp was constructed
+  string          _pml; // yes: perfectly matched layer on the right and bottom boundaries when fully dynamic
+  PetscScalar     _pmlThickness,_pmlR; // (km) thickness of the layer, and its reflection coefficient
+  PerfectlyMatchedLayer *_pmlLayer;
+  Vec             _waveCf; // dt^2/(rho*(1+dt*ay)), scales the force from the layer
   string          _inputDir;
   string          _outputDir; // output data
   PetscScalar     _vL;
@@ -104,6 +112,7 @@ public:
   PetscErrorCode integrate(); // will call OdeSolver method by same name
   PetscErrorCode initiateIntegrand();
   PetscErrorCode propagateWaves(const PetscScalar time, const PetscScalar deltaT, map<string,Vec>& varNext, const map<string,Vec>& var, const map<string,Vec>& varPrev);
+  PetscErrorCode constructWaveOperator(const PetscScalar deltaT);
 
   // explicit time-stepping methods
   PetscErrorCode d_dt(const PetscScalar time, const PetscScalar deltaT, map<string,Vec>& varNext, const map<string,Vec>& var, const map<string,Vec>& varPrev);
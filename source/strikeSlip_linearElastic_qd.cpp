@@ -10,11 +10,14 @@ StrikeSlip_LinearElastic_qd::StrikeSlip_LinearElastic_qd(Domain &D)
   _thermalCoupling("no"),_heatEquationType("transient"),
   _hydraulicCoupling("no"),_hydraulicTimeIntType("explicit"),
   _guessSteadyStateICs(0),_forcingType("no"),_faultTypeScale(2.0),
+  _multirateCoupling("no"),_multirateTol(1e-2),_multirateDtFactor(1.0),
+  _heSched(NULL),_pSched(NULL),
   _timeIntegrator("RK43"),_timeControlType("PID"),
   _stride1D(1),_stride2D(1),
   _maxStepCount(1e8),_initTime(0),_currTime(0),_maxTime(1e15),
   _minDeltaT(-1),_maxDeltaT(1e10),
-  _stepCount(0),_timeStepTol(1e-8),_initDeltaT(1e-3),_normType("L2_absolute"),
+  _stepCount(0),_timeStepTol(1e-8),_initDeltaT(1e-3),_normType("L2_absolute"),_packedState("no"),_tsJacobian("mf"),
+  _outputInterval(0),_outputCount(0),_outputTime0(0),
   _integrateTime(0),_writeTime(0),_linSolveTime(0),_factorTime(0),
   _startTime(MPI_Wtime()),_totalRunTime(0),
   _miscTime(0),_timeV1D(NULL),_dtimeV1D(NULL),_timeV2D(NULL),_dtimeV2D(NULL),
@@ -28,6 +31,7 @@ StrikeSlip_LinearElastic_qd::StrikeSlip_LinearElastic_qd(Domain &D)
   #endif
 
   loadSettings(D._file);
+  _outputTime0 = _initTime;
 
   // if checkpoint number > 0 (i.e. there has been a checkpoint already), load _initTime from checkpoint file
   if (_D->_ckptNumber > 0) {
@@ -36,6 +40,8 @@ StrikeSlip_LinearElastic_qd::StrikeSlip_LinearElastic_qd(Domain &D)
     _guessSteadyStateICs = 0;
     loadValueFromCheckpoint(_outputDir, "chkpt_deltaT", _initDeltaT);
     loadValueFromCheckpoint(_outputDir, "chkpt_stepCount", _stepCount);
+    loadValueFromCheckpoint(_outputDir, "chkpt_outputCount", _outputCount);
+    loadValueFromCheckpoint(_outputDir, "chkpt_outputTime0", _outputTime0);
   }
 
   checkInput();
@@ -56,6 +62,13 @@ StrikeSlip_LinearElastic_qd::StrikeSlip_LinearElastic_qd(Domain &D)
   if (_hydraulicCoupling != "no") { _p = new PressureEq(D); }
   else if (_hydraulicCoupling == "coupled") { _fault->setSNEff(_p->_p); }
 
+  // multirate coupling
+  if (_multirateCoupling == "yes") {
+    if (_thermalCoupling != "no") { _heSched = new MultirateScheduler("heat equation",_multirateTol); }
+    if (_hydraulicCoupling != "no") { _pSched = new MultirateScheduler("pressure equation",_multirateTol); }
+    setMultirateMaxTimeSteps();
+  }
+
   // initiate momentum balance equation
   if (_guessSteadyStateICs == 1) {
     _material = new LinearElastic(D,_mat_bcRType,_mat_bcTType,"Neumann",_mat_bcBType);
@@ -103,6 +116,9 @@ StrikeSlip_LinearElastic_qd::~StrikeSlip_LinearElastic_qd()
     }
   }
 
+  destroyVector(_varOut);
+  destroyVector(_dvarOut);
+
   PetscViewerDestroy(&_timeV1D);
   PetscViewerDestroy(&_dtimeV1D);
   PetscViewerDestroy(&_timeV2D);
@@ -113,6 +129,8 @@ StrikeSlip_LinearElastic_qd::~StrikeSlip_LinearElastic_qd()
   delete _fault;       _fault = NULL;
   delete _he;          _he = NULL;
   delete _p;           _p = NULL;
+  delete _heSched;     _heSched = NULL;
+  delete _pSched;      _pSched = NULL;
 
   VecDestroy(&_forcingTerm);
   VecDestroy(&_forcingTermPlain);
@@ -160,6 +178,9 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::loadSettings(const char *file)
     else if (var.compare("stateLaw")==0) { _stateLaw = rhs.c_str(); }
     else if (var.compare("guessSteadyStateICs")==0) { _guessSteadyStateICs = atoi( rhs.c_str() ); }
     else if (var.compare("forcingType")==0) { _forcingType = rhs.c_str(); }
+    else if (var.compare("multirateCoupling")==0) { _multirateCoupling = rhs.c_str(); }
+    else if (var.compare("multirateTol")==0) { _multirateTol = atof( rhs.c_str() ); }
+    else if (var.compare("multirateDtFactor")==0) { _multirateDtFactor = atof( rhs.c_str() ); }
 
     // time integration properties
     else if (var.compare("timeIntegrator")==0) { _timeIntegrator = rhs; }
@@ -176,6 +197,10 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::loadSettings(const char *file)
     else if (var.compare("timeIntInds")==0) { loadVectorFromInputFile(rhsFull,_timeIntInds); }
     else if (var.compare("scale")==0) { loadVectorFromInputFile(rhsFull,_scale); }
     else if (var.compare("normType")==0) { _normType = rhs.c_str(); }
+    else if (var.compare("packedState")==0) { _packedState = rhs.c_str(); }
+    else if (var.compare("tsJacobian")==0) { _tsJacobian = rhs.c_str(); }
+    else if (var.compare("outputTimes")==0) { loadVectorFromInputFile(rhsFull,_outputTimes); }
+    else if (var.compare("outputInterval")==0) { _outputInterval = atof( rhs.c_str() ); }
     else if (var.compare("vL")==0) { _vL = atof( rhs.c_str() ); }
     else if (var.compare("bodyForce")==0) { _forcingVal = atof( rhs.c_str() ); }
 
@@ -218,11 +243,40 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::checkInput()
 
   assert(_forcingType.compare("iceStream")==0 || _forcingType.compare("no")==0 );
 
+  assert(_multirateCoupling.compare("yes")==0 || _multirateCoupling.compare("no")==0);
+  assert(_multirateTol >= 0);
+  assert(_multirateDtFactor > 0);
+  if (_multirateCoupling.compare("yes")==0) {
+    // only implicitly integrated fields can be sub-cycled
+    assert(_timeIntegrator.compare("RK32_WBE")==0 || _timeIntegrator.compare("RK43_WBE")==0);
+  }
+
   assert(_timeIntegrator.compare("FEuler")==0 ||
     _timeIntegrator.compare("RK32")==0 ||
     _timeIntegrator.compare("RK43")==0 ||
+    _timeIntegrator.compare("RK32_2N")==0 ||
+    _timeIntegrator.compare("RK43_2N")==0 ||
+    _timeIntegrator.compare("RK54")==0 ||
+    _timeIntegrator.compare("RK65")==0 ||
     _timeIntegrator.compare("RK32_WBE")==0 ||
-    _timeIntegrator.compare("RK43_WBE")==0 );
+    _timeIntegrator.compare("RK43_WBE")==0 ||
+    _timeIntegrator.compare("TSARKIMEX")==0 ||
+    _timeIntegrator.compare("TSROSW")==0 ||
+    _timeIntegrator.compare("TSBDF")==0 );
+
+  assert(_packedState.compare("yes")==0 || _packedState.compare("no")==0);
+  assert(_tsJacobian.compare("mf")==0 || _tsJacobian.compare("diagonal")==0);
+
+  // dense output requires an interpolant from the time integrator
+  assert(_outputInterval >= 0);
+  if (_outputTimes.size() > 0 || _outputInterval > 0) {
+    assert(_outputTimes.size() == 0 || _outputInterval == 0);
+    assert(_timeIntegrator.compare("RK32")==0 ||
+      _timeIntegrator.compare("RK43")==0 ||
+      _timeIntegrator.compare("RK54")==0 ||
+      _timeIntegrator.compare("RK65")==0 );
+    for (size_t i = 1; i < _outputTimes.size(); i++) { assert(_outputTimes[i] > _outputTimes[i-1]); }
+  }
 
   assert(_timeControlType.compare("P")==0 ||
     _timeControlType.compare("PID")==0 );
@@ -431,18 +485,23 @@ double startTime = MPI_Wtime();
   _deltaT = deltaT;
   _currTime = time;
 
-  if ( (_stride1D > 0 && _currTime == _maxTime) || (_stride1D > 0 && stepCount % _stride1D == 0)) {
-    ierr = writeStep1D(_stepCount, _currTime, _deltaT, _outputDir); CHKERRQ(ierr);
-    ierr = _material->writeStep1D(_stepCount, _outputDir); CHKERRQ(ierr);
-    ierr = _fault->writeStep(_stepCount, _outputDir); CHKERRQ(ierr);
-    if (_hydraulicCoupling.compare("no")!=0) { _p->writeStep(_stepCount,_currTime,_outputDir); }
-    if (_thermalCoupling.compare("no")!=0) { _he->writeStep1D(_stepCount,_currTime,_outputDir); }
+  if (_outputTimes.size() > 0 || _outputInterval > 0) {
+    ierr = writeDenseOutput(); CHKERRQ(ierr);
   }
+  else {
+    if ( (_stride1D > 0 && _currTime == _maxTime) || (_stride1D > 0 && stepCount % _stride1D == 0)) {
+      ierr = writeStep1D(_stepCount, _currTime, _deltaT, _outputDir); CHKERRQ(ierr);
+      ierr = _material->writeStep1D(_stepCount, _outputDir); CHKERRQ(ierr);
+      ierr = _fault->writeStep(_stepCount, _outputDir); CHKERRQ(ierr);
+      if (_hydraulicCoupling.compare("no")!=0) { _p->writeStep(_stepCount,_currTime,_outputDir); }
+      if (_thermalCoupling.compare("no")!=0) { _he->writeStep1D(_stepCount,_currTime,_outputDir); }
+    }
 
-  if ( (_stride2D > 0 && _currTime == _maxTime) || (_stride2D > 0 && stepCount % _stride2D == 0)) {
-    ierr = writeStep2D(_stepCount, _currTime, _deltaT, _outputDir); CHKERRQ(ierr);
-    ierr = _material->writeStep2D(_stepCount, _outputDir); CHKERRQ(ierr);
-    if (_thermalCoupling.compare("no")!=0) { _he->writeStep2D(_stepCount, _currTime,_outputDir); }
+    if ( (_stride2D > 0 && _currTime == _maxTime) || (_stride2D > 0 && stepCount % _stride2D == 0)) {
+      ierr = writeStep2D(_stepCount, _currTime, _deltaT, _outputDir); CHKERRQ(ierr);
+      ierr = _material->writeStep2D(_stepCount, _outputDir); CHKERRQ(ierr);
+      if (_thermalCoupling.compare("no")!=0) { _he->writeStep2D(_stepCount, _currTime,_outputDir); }
+    }
   }
 
   if (_D->_ckpt > 0 && (stepCount % _D->_interval == 0 || stepCount >= _maxStepCount || time >= _maxTime)) {
@@ -450,7 +509,7 @@ double startTime = MPI_Wtime();
     ierr = _material->writeCheckpoint(); CHKERRQ(ierr);
     ierr = _fault->writeCheckpoint(); CHKERRQ(ierr);
     //~ if (_hydraulicCoupling.compare("no")!=0) { _p->writeCheckpoint(); }
-    //~ if (_thermalCoupling.compare("no")!=0) { _he->writeCheckpoint(); }
+    if (_thermalCoupling.compare("no")!=0) { ierr = _he->writeCheckpoint(); CHKERRQ(ierr); }
     stopIntegration = 1;
   }
 
@@ -462,6 +521,81 @@ _writeTime += MPI_Wtime() - startTime;
 }
 
 
+// time of the next scheduled output
+PetscScalar StrikeSlip_LinearElastic_qd::nextOutputTime()
+{
+  if (_outputInterval > 0) { return _outputTime0 + _outputCount*_outputInterval; }
+  if (_outputCount < (PetscInt) _outputTimes.size()) { return _outputTimes[_outputCount]; }
+  return PETSC_MAX_REAL;
+}
+
+
+// write out fields at the output times passed during the last time step,
+// using the interpolant of the time integrator over the step
+// stride1D and stride2D then count output times instead of time steps
+PetscErrorCode StrikeSlip_LinearElastic_qd::writeDenseOutput()
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    std::string funcName = "StrikeSlip_LinearElastic_qd::writeDenseOutput";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  bool interpolated = 0;
+  PetscScalar outTime = nextOutputTime();
+  while (outTime <= _currTime) {
+    // output times before the initial time are skipped
+    if (outTime < _currTime && _stepCount == 0) {
+      _outputCount++;
+      outTime = nextOutputTime();
+      continue;
+    }
+
+    // update all fields to the output time
+    if (outTime < _currTime || interpolated) {
+      if (_varOut.size() == 0) {
+        for (map<string,Vec>::iterator it = _varEx.begin(); it != _varEx.end(); it++) {
+          Vec varOut,dvarOut;
+          ierr = VecDuplicate(it->second,&varOut); CHKERRQ(ierr);
+          ierr = VecDuplicate(it->second,&dvarOut); CHKERRQ(ierr);
+          _varOut[it->first] = varOut;
+          _dvarOut[it->first] = dvarOut;
+        }
+      }
+      ierr = _quadEx->interpolate(outTime,_varOut); CHKERRQ(ierr);
+      ierr = d_dt(outTime,_varOut,_dvarOut); CHKERRQ(ierr);
+      interpolated = 1;
+    }
+
+    if (_stride1D > 0 && _outputCount % _stride1D == 0) {
+      ierr = writeStep1D(_stepCount, outTime, _deltaT, _outputDir); CHKERRQ(ierr);
+      ierr = _material->writeStep1D(_stepCount, _outputDir); CHKERRQ(ierr);
+      ierr = _fault->writeStep(_stepCount, _outputDir); CHKERRQ(ierr);
+      if (_hydraulicCoupling.compare("no")!=0) { _p->writeStep(_stepCount,outTime,_outputDir); }
+      if (_thermalCoupling.compare("no")!=0) { _he->writeStep1D(_stepCount,outTime,_outputDir); }
+    }
+    if (_stride2D > 0 && _outputCount % _stride2D == 0) {
+      ierr = writeStep2D(_stepCount, outTime, _deltaT, _outputDir); CHKERRQ(ierr);
+      ierr = _material->writeStep2D(_stepCount, _outputDir); CHKERRQ(ierr);
+      if (_thermalCoupling.compare("no")!=0) { _he->writeStep2D(_stepCount,outTime,_outputDir); }
+    }
+
+    _outputCount++;
+    outTime = nextOutputTime();
+  }
+
+  // return fields to the current time
+  if (interpolated) {
+    ierr = d_dt(_currTime,_varEx,_dvarOut); CHKERRQ(ierr);
+  }
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
 // write out time and _deltaT at each time step
 PetscErrorCode StrikeSlip_LinearElastic_qd::writeStep1D(PetscInt stepCount, PetscScalar time, PetscScalar deltaT, const std::string outputDir)
 {
@@ -536,6 +670,8 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::writeCheckpoint()
   writeASCII(_outputDir, "ckptNumber", _D->_ckptNumber,"%i\n");
   writeASCII(_outputDir, "chkpt_currT", _currTime,"%.15e\n");
   writeASCII(_outputDir, "chkpt_stepCount", _stepCount,"%i\n");
+  writeASCII(_outputDir, "chkpt_outputCount", _outputCount,"%i\n");
+  writeASCII(_outputDir, "chkpt_outputTime0", _outputTime0,"%.15e\n");
 
   if (_timeIntegrator == "RK32_WBE" || _timeIntegrator == "RK43_WBE") {
     assert(0);
@@ -566,7 +702,7 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::view()
 
   _material->view(_integrateTime);
   _fault->view(_integrateTime);
-  if ((_timeIntegrator.compare("RK32")==0 || _timeIntegrator.compare("RK43")==0) && _quadEx!=NULL) {
+  if (_quadEx!=NULL) {
     ierr = _quadEx->view();
   }
   if ((_timeIntegrator.compare("RK32_WBE")==0 || _timeIntegrator.compare("RK43_WBE")==0) && _quadImex!=NULL) {
@@ -577,8 +713,13 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::view()
 
   ierr = PetscPrintf(PETSC_COMM_WORLD,"-------------------------------\n\n");CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"StrikeSlip_LinearElastic_qd Runtime Summary:\n");CHKERRQ(ierr);
+  if (_heSched != NULL) { ierr = _heSched->view();CHKERRQ(ierr); }
+  if (_pSched != NULL) { ierr = _pSched->view();CHKERRQ(ierr); }
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent in integration (s): %g\n",_integrateTime);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent writing output (s): %g\n",_writeTime);CHKERRQ(ierr);
+  if (_outputTimes.size() > 0 || _outputInterval > 0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of dense output times: %i\n",_outputCount);CHKERRQ(ierr);
+  }
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   total run time (s): %g\n",totRunTime);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   %% integration time spent writing output: %g\n",(_writeTime/_integrateTime)*100.);CHKERRQ(ierr);
 
@@ -605,6 +746,9 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::writeContext()
   PetscViewerFileSetName(viewer, str.c_str());
   ierr = PetscViewerASCIIPrintf(viewer,"thermalCoupling = %s\n",_thermalCoupling.c_str());CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"hydraulicCoupling = %s\n",_hydraulicCoupling.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"multirateCoupling = %s\n",_multirateCoupling.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"multirateTol = %.15e\n",_multirateTol);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"multirateDtFactor = %.15e\n",_multirateDtFactor);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"forcingType = %s\n",_forcingType.c_str());CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"vL = %g\n",_vL);CHKERRQ(ierr);
 
@@ -626,6 +770,12 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::writeContext()
     ierr = PetscViewerASCIIPrintf(viewer,"scale = %s\n",vector2str(_scale).c_str());CHKERRQ(ierr);
   }
   ierr = PetscViewerASCIIPrintf(viewer,"normType = %s\n",_normType.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"packedState = %s\n",_packedState.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"tsJacobian = %s\n",_tsJacobian.c_str());CHKERRQ(ierr);
+  if (_outputTimes.size() > 0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"outputTimes = %s\n",vector2str(_outputTimes).c_str());CHKERRQ(ierr);
+  }
+  ierr = PetscViewerASCIIPrintf(viewer,"outputInterval = %.15e # (s)\n",_outputInterval);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
 
   // boundary conditions for momentum balance equation
@@ -685,6 +835,21 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::integrate()
   else if (_timeIntegrator == "RK43") {
     _quadEx = new RK43(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
   }
+  else if (_timeIntegrator == "RK32_2N") {
+    _quadEx = new RK32_2N(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator == "RK43_2N") {
+    _quadEx = new RK43_2N(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator == "RK54") {
+    _quadEx = new RK54(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator == "RK65") {
+    _quadEx = new RK65(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator == "TSARKIMEX" || _timeIntegrator == "TSROSW" || _timeIntegrator == "TSBDF") {
+    _quadEx = new OdeSolver_TS(_maxStepCount,_maxTime,_initDeltaT,_timeControlType,_timeIntegrator,_tsJacobian);
+  }
   else if (_timeIntegrator == "RK32_WBE") {
     _quadImex = new RK32_WBE(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
   }
@@ -702,6 +867,7 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::integrate()
     ierr = _quadImex->setTimeStepBounds(_minDeltaT,_maxDeltaT);CHKERRQ(ierr);
     ierr = _quadImex->setTimeRange(_initTime,_maxTime);
     ierr = _quadImex->setToleranceType(_normType); CHKERRQ(ierr);
+    ierr = _quadImex->setPackedState(_packedState.compare("yes")==0);CHKERRQ(ierr);
     ierr = _quadImex->setInitialConds(_varEx,_varIm);CHKERRQ(ierr);
     ierr = _quadImex->setErrInds(_timeIntInds,_scale);
 
@@ -724,6 +890,8 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::integrate()
     ierr = _quadEx->setTimeStepBounds(_minDeltaT,_maxDeltaT);CHKERRQ(ierr);
     ierr = _quadEx->setTimeRange(_initTime,_maxTime);
     ierr = _quadEx->setToleranceType(_normType); CHKERRQ(ierr);
+    ierr = _quadEx->setPackedState(_packedState.compare("yes")==0);CHKERRQ(ierr);
+    ierr = _quadEx->setDenseOutput(_outputTimes.size() > 0 || _outputInterval > 0);CHKERRQ(ierr);
     ierr = _quadEx->setInitialConds(_varEx);CHKERRQ(ierr);
     ierr = _quadEx->setErrInds(_timeIntInds,_scale);
 
@@ -782,10 +950,7 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::d_dt(const PetscScalar time,const ma
   ierr = solveMomentumBalance(time,varEx,dvarEx); CHKERRQ(ierr);
 
   // update fields on fault from other classes
-  Vec sxy,sxz,sdev;
-  ierr = _material->getStresses(sxy,sxz,sdev);
-  ierr = VecScatterBegin(*_body2fault, sxy, _fault->_tauQSP, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
-  ierr = VecScatterEnd(*_body2fault, sxy, _fault->_tauQSP, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = _material->getFaultStress(_fault->_tauQSP); CHKERRQ(ierr);
 
   // rates for fault
   ierr = _fault->d_dt(time,varEx,dvarEx); // sets rates for slip and state
@@ -837,15 +1002,30 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::d_dt(const PetscScalar time,const ma
   ierr = solveMomentumBalance(time,varEx,dvarEx); CHKERRQ(ierr);
 
   // update shear stress on fault from momentum balance computation
-  Vec sxy,sxz,sdev;
-  ierr = _material->getStresses(sxy,sxz,sdev);
-  ierr = VecScatterBegin(*_body2fault, sxy, _fault->_tauQSP, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
-  ierr = VecScatterEnd(*_body2fault, sxy, _fault->_tauQSP, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = _material->getFaultStress(_fault->_tauQSP); CHKERRQ(ierr);
 
   // rates for fault
   ierr = _fault->d_dt(time,varEx,dvarEx); // sets rates for slip and state
 
-  if ( _hydraulicCoupling.compare("no")!=0 ) {
+  // pressure: with multirate coupling, implicit pressure is only advanced when
+  // its scheduler says so, using the time since it was last advanced
+  if ( _hydraulicCoupling.compare("no")!=0 && _pSched != NULL && varIm.find("pressure") != varIm.end()) {
+    vector<Vec> coupling;
+    if (varEx.find("permeability") != varEx.end()) { coupling.push_back(varEx.find("permeability")->second); }
+    bool isDue = 0;
+    ierr = _pSched->accumulate(dt,coupling); CHKERRQ(ierr);
+    ierr = _pSched->isDue(isDue); CHKERRQ(ierr);
+    if (isDue) {
+      ierr = _p->d_dt(time,varEx,dvarEx,varIm,varImo,_pSched->_elapsed); CHKERRQ(ierr);
+      ierr = _pSched->completeUpdate(coupling); CHKERRQ(ierr);
+      ierr = setMultirateMaxTimeSteps(); CHKERRQ(ierr);
+    }
+    else {
+      ierr = _p->d_dt(time,varEx,dvarEx); CHKERRQ(ierr); // permeability rate only
+      ierr = VecCopy(varImo.find("pressure")->second,varIm["pressure"]); CHKERRQ(ierr);
+    }
+  }
+  else if ( _hydraulicCoupling.compare("no")!=0 ) {
     _p->d_dt(time,varEx,dvarEx,varIm,varImo,dt);
   }
 
@@ -858,8 +1038,25 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::d_dt(const PetscScalar time,const ma
     Vec gVxy_t = NULL;
     Vec gVxz_t = NULL;
     Vec Told = varImo.find("Temp")->second;
-    // arguments: time, slipVel, txy, sigmadev, dgxy, dgxz, T, old T, dt
-    ierr = _he->be(time,V,tau,NULL,gVxy_t,gVxz_t,varIm["Temp"],Told,dt); CHKERRQ(ierr);
+    if (_heSched != NULL) {
+      // multirate: advance by the time since the last update, with time-averaged sources
+      vector<Vec> coupling = {V,tau}, avg;
+      bool isDue = 0;
+      ierr = _heSched->accumulate(dt,coupling); CHKERRQ(ierr);
+      ierr = _heSched->isDue(isDue); CHKERRQ(ierr);
+      if (isDue) {
+        ierr = _heSched->getAverage(avg); CHKERRQ(ierr);
+        ierr = _he->be(time,avg[0],avg[1],NULL,gVxy_t,gVxz_t,varIm["Temp"],Told,_heSched->_elapsed); CHKERRQ(ierr);
+        ierr = _heSched->completeUpdate(coupling); CHKERRQ(ierr);
+      }
+      else {
+        ierr = VecCopy(Told,varIm["Temp"]); CHKERRQ(ierr);
+      }
+    }
+    else {
+      // arguments: time, slipVel, txy, sigmadev, dgxy, dgxz, T, old T, dt
+      ierr = _he->be(time,V,tau,NULL,gVxy_t,gVxz_t,varIm["Temp"],Told,dt); CHKERRQ(ierr);
+    }
   }
 
   #if VERBOSE > 1
@@ -870,6 +1067,23 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::d_dt(const PetscScalar time,const ma
 }
 
 
+// max time steps for multirate coupling, from each physics' own time step limit
+PetscErrorCode StrikeSlip_LinearElastic_qd::setMultirateMaxTimeSteps()
+{
+  PetscErrorCode ierr = 0;
+  PetscScalar maxDeltaT = 0;
+  if (_heSched != NULL) {
+    ierr = _he->computeMaxTimeStep(maxDeltaT); CHKERRQ(ierr);
+    ierr = _heSched->setMaxTimeStep(_multirateDtFactor * maxDeltaT); CHKERRQ(ierr);
+  }
+  if (_pSched != NULL) {
+    ierr = _p->computeMaxTimeStep(maxDeltaT); CHKERRQ(ierr);
+    ierr = _pSched->setMaxTimeStep(_multirateDtFactor * maxDeltaT); CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
+
 // momentum balance equation and constitutive laws portion of d_dt
 PetscErrorCode StrikeSlip_LinearElastic_qd::solveMomentumBalance(const PetscScalar time,const map<string,Vec>& varEx,map<string,Vec>& dvarEx)
 {
@@ -884,8 +1098,9 @@ PetscErrorCode StrikeSlip_LinearElastic_qd::solveMomentumBalance(const PetscScal
   if (_forcingType.compare("iceStream")==0) { VecAXPY(_material->_rhs,1.0,_forcingTerm); }
 
   // compute displacement and stresses
+  // (in fault-only mode body stresses are computed later only if needed)
   _material->computeU();
-  _material->computeStresses();
+  if (_material->_faultStressOnly == 0) { _material->computeStresses(); }
 
   return ierr;
 }
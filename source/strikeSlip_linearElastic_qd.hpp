@@ -14,6 +14,7 @@
 
 #include "odeSolver.hpp"
 #include "odeSolverImex.hpp"
+#include "odeSolver_TS.hpp"
 #include "genFuncs.hpp"
 #include "domain.hpp"
 #include "sbpOps.hpp"
@@ -23,6 +24,7 @@
 #include "pressureEq.hpp"
 #include "heatEquation.hpp"
 #include "linearElastic.hpp"
+#include "multirateScheduler.hpp"
 
 using namespace std;
 
@@ -58,6 +60,13 @@ private:
   string       _forcingType; // what body forcing term to include (i.e. iceStream)
   PetscScalar  _faultTypeScale; // = 2 if symmetric fault, 1 if one side of fault is rigid
 
+  // multirate coupling: the implicitly integrated heat and pressure equations are
+  // only advanced when their own max time step is reached or their coupling terms change
+  string              _multirateCoupling; // "no" or "yes"
+  PetscScalar         _multirateTol; // relative change in coupling terms that forces an update
+  PetscScalar         _multirateDtFactor; // max time step = factor * diffusion time across one grid cell
+  MultirateScheduler *_heSched,*_pSched;
+
   // time stepping data
   map <string,Vec>  _varEx; // holds variables for explicit integration in time
   map <string,Vec>  _varIm; // holds variables for implicit integration in time
@@ -71,6 +80,16 @@ private:
   vector<string>    _timeIntInds;// keys of variables to be used in time integration
   vector<double>    _scale; // scale factor for entries in _timeIntInds
   string            _normType;
+  string            _packedState; // store integrated variables in one contiguous Vec
+  string            _tsJacobian; // preconditioner for the PETSc TS integrators: mf or diagonal
+
+  // dense output: write at scheduled times, interpolated by the time
+  // integrator, instead of every stride1D/stride2D time steps
+  vector<double>    _outputTimes; // list of output times (s)
+  PetscScalar       _outputInterval; // or spacing of uniformly spaced output times (s)
+  PetscInt          _outputCount; // number of output times passed
+  PetscScalar       _outputTime0; // time from which outputInterval is counted (s)
+  map<string,Vec>   _varOut,_dvarOut; // integrated variables and rates at an output time
 
   // runtime data
   double _integrateTime,_writeTime,_linSolveTime,_factorTime,_startTime,_totalRunTime, _miscTime;
@@ -100,6 +119,7 @@ private:
   PetscErrorCode parseBCs(); // parse boundary conditions
   PetscErrorCode computeMinTimeStep(); // compute min allowed time step as dx / cs
   PetscErrorCode constructIceStreamForcingTerm(); // ice stream forcing term
+  PetscErrorCode setMultirateMaxTimeSteps();
 
 public:
 
@@ -137,6 +157,8 @@ public:
   PetscErrorCode timeMonitor(PetscScalar time, PetscScalar deltaT, PetscInt stepCount, int& stopIntegration);
   PetscErrorCode writeStep1D(PetscInt stepCount, PetscScalar time, PetscScalar deltaT, const string outputDir);
   PetscErrorCode writeStep2D(PetscInt stepCount, PetscScalar time, PetscScalar deltaT, const string outputDir);
+  PetscErrorCode writeDenseOutput(); // write fields at output times passed in the last time step
+  PetscScalar nextOutputTime();
 
   // checkpointing functions
   PetscErrorCode loadCheckpoint();
@@ -13,6 +13,9 @@ strikeSlip_linearElastic_qd_fd::strikeSlip_linearElastic_qd_fd(Domain&D)
     _guessSteadyStateICs(0),_forcingType("no"),_faultTypeScale(2.0),
     _cycleCount(0),_maxNumCycles(1e3),
     _deltaT(-1), _CFL(-1),_y(&D._y),_z(&D._z),
+    _waveOp(NULL),_waveCu(NULL),_waveCuPrev(NULL),_faultD2uScale(NULL),_waveDeltaT(0),
+    _mtsLevels(1),_mtsStep(0),_mtsLevel(NULL),
+    _pml("no"),_pmlThickness(-1),_pmlR(1e-3),_pmlLayer(NULL),_waveCf(NULL),
     _inDynamic(false),_allowed(false),
     _trigger_qd2fd(1e-3), _trigger_fd2qd(1e-3),
     _limit_qd(10*_vL), _limit_fd(1e-1),_limit_stride_fd(-1),_u0(NULL),
@@ -22,7 +25,8 @@ strikeSlip_linearElastic_qd_fd::strikeSlip_linearElastic_qd_fd(Domain&D)
     _stride2D_fd(10),_stride1D_fd_end(10),_stride2D_fd_end(10),
     _maxStepCount(1e8),
     _initTime(0),_currTime(0),_minDeltaT(1e-3),_maxDeltaT(1e10),_maxTime(1e15),
-    _stepCount(0),_timeStepTol(1e-8),_initDeltaT(1e-3),_normType("L2_absolute"),
+    _stepCount(0),_timeStepTol(1e-8),_initDeltaT(1e-3),_normType("L2_absolute"),_packedState("no"),_tsJacobian("mf"),
+    _eventDetection("no"),_eventTol(1e-3),
     _timeV1D(NULL),_dtimeV1D(NULL),_timeV2D(NULL),_dtimeV2D(NULL),_regime1DV(NULL), _regime2DV(NULL),
     _integrateTime(0),_writeTime(0),_linSolveTime(0),_factorTime(0),
     _startTime(MPI_Wtime()),_miscTime(0),_dynTime(0), _qdTime(0),
@@ -70,6 +74,13 @@ strikeSlip_linearElastic_qd_fd::strikeSlip_linearElastic_qd_fd(Domain&D)
   if (_guessSteadyStateICs == 1) { _material = new LinearElastic(D,_mat_qd_bcRType,_mat_qd_bcTType,"Neumann",_mat_qd_bcBType); }
   else {_material = new LinearElastic(D,_mat_qd_bcRType,_mat_qd_bcTType,_mat_qd_bcLType,_mat_qd_bcBType); }
   computePenaltyVectors();
+  if (_pml.compare("yes")==0) {
+    _pmlLayer = new PerfectlyMatchedLayer(D,_pmlThickness,_pmlR);
+    _pmlLayer->setFields(_material->_sbp,_material->_mu,_material->_rho,_material->_cs);
+    // the layer's damping also acts on fault nodes inside it
+    VecScatterBegin(D._scatters["body2L"], _pmlLayer->_damping, _fault_fd->_pmlDamping, INSERT_VALUES, SCATTER_FORWARD);
+    VecScatterEnd(D._scatters["body2L"], _pmlLayer->_damping, _fault_fd->_pmlDamping, INSERT_VALUES, SCATTER_FORWARD);
+  }
 
   // body forcing term for ice stream
   _forcingTerm = NULL; _forcingTermPlain = NULL;
@@ -115,6 +126,15 @@ strikeSlip_linearElastic_qd_fd::~strikeSlip_linearElastic_qd_fd()
   PetscViewerDestroy(&_regime2DV);
   VecDestroy(&_u0);
   VecDestroy(&_ay);
+  MatDestroy(&_waveOp);
+  VecDestroy(&_waveCu);
+  VecDestroy(&_waveCuPrev);
+  VecDestroy(&_faultD2uScale);
+  VecDestroy(&_waveCf);
+  delete _pmlLayer; _pmlLayer = NULL;
+  VecDestroy(&_mtsLevel);
+  for (size_t k = 0; k < _mtsOps.size(); k++) { MatDestroy(&_mtsOps[k]); }
+  for (size_t k = 0; k < _mtsOpsOut.size(); k++) { VecDestroy(&_mtsOpsOut[k]); }
   VecDestroy(&_forcingTerm);
   VecDestroy(&_forcingTermPlain);
 
@@ -196,6 +216,10 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::loadSettings(const char *file)
     else if (var.compare("timeIntInds")==0) { loadVectorFromInputFile(rhsFull,_timeIntInds); }
     else if (var.compare("scale")==0) { loadVectorFromInputFile(rhsFull,_scale); }
     else if (var.compare("normType")==0) { _normType = rhs.c_str(); }
+    else if (var.compare("packedState")==0) { _packedState = rhs.c_str(); }
+    else if (var.compare("tsJacobian")==0) { _tsJacobian = rhs.c_str(); }
+    else if (var.compare("eventDetection")==0) { _eventDetection = rhs.c_str(); }
+    else if (var.compare("eventTol")==0) { _eventTol = atof( rhs.c_str() ); }
 
     else if (var.compare("vL")==0) { _vL = atof(rhs.c_str() ); }
 
@@ -219,6 +243,10 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::loadSettings(const char *file)
     else if (var.compare("limit_stride_fd")==0) { _limit_stride_fd = atof(rhs.c_str() ); }
     else if (var.compare("deltaT_fd")==0) { _deltaT = atof(rhs.c_str() ); }
     else if (var.compare("CFL")==0) { _CFL = atof(rhs.c_str() ); }
+    else if (var.compare("mtsLevels")==0) { _mtsLevels = (int)atof( rhs.c_str() ); }
+    else if (var.compare("pml")==0) { _pml = rhs.c_str(); }
+    else if (var.compare("pmlThickness")==0) { _pmlThickness = atof( rhs.c_str() ); }
+    else if (var.compare("pmlReflection")==0) { _pmlR = atof( rhs.c_str() ); }
     else if (var.compare("maxNumCycles")==0) { _maxNumCycles = atoi(rhs.c_str() ); }
 
   }
@@ -253,8 +281,35 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::checkInput()
   assert(_timeIntegrator.compare("FEuler")==0 ||
       _timeIntegrator.compare("RK32")==0 ||
       _timeIntegrator.compare("RK43")==0 ||
+      _timeIntegrator.compare("RK32_2N")==0 ||
+      _timeIntegrator.compare("RK43_2N")==0 ||
+      _timeIntegrator.compare("RK54")==0 ||
+      _timeIntegrator.compare("RK65")==0 ||
       _timeIntegrator.compare("RK32_WBE")==0 ||
-      _timeIntegrator.compare("RK43_WBE")==0 );
+      _timeIntegrator.compare("RK43_WBE")==0 ||
+      _timeIntegrator.compare("TSARKIMEX")==0 ||
+      _timeIntegrator.compare("TSROSW")==0 ||
+      _timeIntegrator.compare("TSBDF")==0 );
+
+  assert(_packedState.compare("yes")==0 || _packedState.compare("no")==0);
+  assert(_tsJacobian.compare("mf")==0 || _tsJacobian.compare("diagonal")==0);
+  assert(_eventDetection.compare("yes")==0 || _eventDetection.compare("no")==0);
+  assert(_eventTol > 0 && _eventTol < 1);
+  if (_eventDetection.compare("yes")==0) {
+    // event detection uses the dense output of the explicit Runge-Kutta methods
+    assert(_timeIntegrator.compare("RK32")==0 ||
+      _timeIntegrator.compare("RK43")==0 ||
+      _timeIntegrator.compare("RK54")==0 ||
+      _timeIntegrator.compare("RK65")==0 );
+  }
+
+  assert(_mtsLevels >= 1 && _mtsLevels <= 10);
+
+  assert(_pml.compare("yes")==0 || _pml.compare("no")==0);
+  if (_pml.compare("yes")==0) {
+    assert(_pmlThickness > 0);
+    assert(_pmlR > 0 && _pmlR < 1);
+  }
 
   assert(_timeControlType.compare("P")==0 ||
          _timeControlType.compare("PI")==0 ||
@@ -368,39 +423,16 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::computeTimeStep()
   if (_D->_order == 6) { gcfl = 0.7071/sqrt(2.1579); }
 
 
-  // compute grid spacing in y and z
-  Vec dy, dz;
-  VecDuplicate(*_y,&dy);
-  VecDuplicate(*_y,&dz);
-  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
-    Mat J,Jinv,qy,rz,yq,zr;
-    ierr = _material->_sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
-    MatGetDiagonal(yq, dy); VecScale(dy,1.0/(_D->_Ny-1));
-    MatGetDiagonal(zr, dz); VecScale(dz,1.0/(_D->_Nz-1));
-  }
-  else {
-    VecSet(dy,_D->_Ly/(_D->_Ny-1.0));
-    VecSet(dz,_D->_Lz/(_D->_Nz-1.0));
-  }
-
-  // compute time for shear wave to travel 1 dy or dz
-  Vec ts_dy,ts_dz;
-  VecDuplicate(*_y,&ts_dy);
-  VecDuplicate(*_z,&ts_dz);
-  VecPointwiseDivide(ts_dy,dy,_material->_cs);
-  VecPointwiseDivide(ts_dz,dz,_material->_cs);
-  PetscScalar min_ts_dy, min_ts_dz;
-  VecMin(ts_dy,NULL,&min_ts_dy);
-  VecMin(ts_dz,NULL,&min_ts_dz);
-
-  // clean up memory usage
-  VecDestroy(&dy);
-  VecDestroy(&dz);
-  VecDestroy(&ts_dy);
-  VecDestroy(&ts_dz);
+  // time for a shear wave to travel one grid spacing
+  Vec ts;
+  VecDuplicate(*_y,&ts);
+  ierr = computeWaveTravelTime(ts); CHKERRQ(ierr);
+  PetscScalar min_ts;
+  VecMin(ts,NULL,&min_ts);
+  VecDestroy(&ts);
 
   // largest possible time step permitted by CFL condition
-  PetscScalar max_deltaT = gcfl * min(abs(min_ts_dy),abs(min_ts_dz));
+  PetscScalar max_deltaT = gcfl * abs(min_ts);
 
 
   // compute time step requested by user
@@ -435,6 +467,265 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::computeTimeStep()
 
   _deltaT_fd = _deltaT;
 
+  // the levels of multiple time stepping are only within their CFL condition
+  // if the finest one is (see computeMtsLevels)
+  if (_mtsLevels > 1 && _deltaT_fd > max_deltaT) {
+    PetscPrintf(PETSC_COMM_WORLD,"ERROR: deltaT of %g is larger than the maximum deltaT of %g, which is required with mtsLevels > 1\n",_deltaT_fd,max_deltaT);
+    assert(0);
+  }
+
+  #if VERBOSE > 1
+     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// ts = min(dy,dz)/cs, the time for a shear wave to travel one grid spacing at each node
+PetscErrorCode strikeSlip_linearElastic_qd_fd::computeWaveTravelTime(Vec& ts)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    std::string funcName = "strikeSlip_linearElastic_qd_fd::computeWaveTravelTime";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  // compute grid spacing in y and z
+  Vec dy, dz;
+  VecDuplicate(*_y,&dy);
+  VecDuplicate(*_y,&dz);
+  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
+    Mat J,Jinv,qy,rz,yq,zr;
+    ierr = _material->_sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
+    MatGetDiagonal(yq, dy); VecScale(dy,1.0/(_D->_Ny-1));
+    MatGetDiagonal(zr, dz); VecScale(dz,1.0/(_D->_Nz-1));
+  }
+  else {
+    VecSet(dy,_D->_Ly/(_D->_Ny-1.0));
+    VecSet(dz,_D->_Lz/(_D->_Nz-1.0));
+  }
+
+  VecPointwiseMin(dy,dy,dz);
+  VecPointwiseDivide(ts,dy,_material->_cs);
+
+  // clean up memory usage
+  VecDestroy(&dy);
+  VecDestroy(&dz);
+
+  #if VERBOSE > 1
+     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// Group the nodes into multiple time stepping levels: a node is in level k if
+// its CFL time step is at least 2^k times the smallest one. deltaT_fd is at
+// most the CFL time step of the smallest one (see computeTimeStep), so every
+// level satisfies its own CFL condition when stepped with 2^k * deltaT_fd.
+// Nodes on the fault are always in level 0.
+// _mtsLevel must already exist; only its owned entries are set.
+PetscErrorCode strikeSlip_linearElastic_qd_fd::computeMtsLevels()
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    std::string funcName = "strikeSlip_linearElastic_qd_fd::computeMtsLevels";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  ierr = computeWaveTravelTime(_mtsLevel); CHKERRQ(ierr);
+  PetscScalar min_ts;
+  VecMin(_mtsLevel,NULL,&min_ts);
+
+  PetscInt       Ii,Istart,Iend;
+  PetscScalar   *level;
+  ierr = VecGetOwnershipRange(_mtsLevel,&Istart,&Iend);CHKERRQ(ierr);
+  ierr = VecGetArray(_mtsLevel, &level);
+  PetscInt Jj = 0;
+  for (Ii = Istart; Ii < Iend; Ii++) {
+    PetscInt k = (PetscInt) floor(log2(level[Jj]/min_ts) + 1e-12);
+    level[Jj] = (PetscScalar) max((PetscInt) 0, min(k, _mtsLevels-1));
+    Jj++;
+  }
+  ierr = VecRestoreArray(_mtsLevel, &level);
+
+  // the fault boundary condition needs the full D2u every time step
+  Vec faultLevel;
+  VecDuplicate(_fault_fd->_d2u, &faultLevel);
+  VecSet(faultLevel, 0.0);
+  ierr = VecScatterBegin(*_body2fault, faultLevel, _mtsLevel, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+  ierr = VecScatterEnd(*_body2fault, faultLevel, _mtsLevel, INSERT_VALUES, SCATTER_REVERSE); CHKERRQ(ierr);
+  VecDestroy(&faultLevel);
+
+  #if VERBOSE > 1
+     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// Split the scaled wave operator by level for multiple time stepping (force
+// splitting), in the impulse (Verlet-I) form for the leapfrog scheme: level k
+// is applied every 2^k steps with 2^k times its strength. This is not local
+// time stepping: every node is still advanced with deltaT_fd, and the sweep,
+// the fault and the PML are done every step on the whole domain, so only the
+// work of applying _waveOp is reduced.
+//
+// Each interaction a_ij (i != j) belongs to level k = min(level_i,level_j),
+// so it is updated at the rate of the finer node, and the matching -a_ij is
+// put on the diagonal of row i in the same level. Every level operator then
+// has zero row sums: it does not act on a constant field, so applying the
+// levels at different rates cannot make a constant drift. What is left of
+// the diagonal, the row sum of _waveOp, is nonzero only on the boundary rows
+// with a Dirichlet-type SAT, and is applied every step. Since _waveOp = D*A,
+// with D diagonal and A symmetric, and the level of an interaction does not
+// depend on its direction, each level is D*A_k with A_k symmetric.
+//
+// On the nodes of level k only, level k is the leapfrog scheme with step
+// 2^k * deltaT_fd, which is within its CFL condition by computeMtsLevels.
+// That is necessary, but not sufficient, for the split to be stable: force
+// splitting can resonate at the level interfaces, and with the wider stencils
+// of order 4 and 6 a level operator need not be negative semidefinite on its
+// own. examples/benchmark_mts.sh compares runs with mtsLevels > 1 against the
+// single rate scheme.
+//
+// _mtsOps[k] only holds the rows that have an interaction in level k (the
+// level k nodes and the interface band next to them), so the far-field
+// levels cost 1/2^k of their share of a single rate step.
+PetscErrorCode strikeSlip_linearElastic_qd_fd::constructMtsOperators()
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    std::string funcName = "strikeSlip_linearElastic_qd_fd::constructMtsOperators";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  for (size_t k = 0; k < _mtsOps.size(); k++) { MatDestroy(&_mtsOps[k]); }
+  for (size_t k = 0; k < _mtsOpsOut.size(); k++) { VecDestroy(&_mtsOpsOut[k]); }
+  _mtsOps.assign(_mtsLevels, NULL);
+  _mtsOpsOut.assign(_mtsLevels, NULL);
+  _mtsRows.assign(_mtsLevels, vector<PetscInt>());
+  _mtsSumRows.clear();
+  _mtsSums.clear();
+  _mtsStep = 0;
+
+  PetscInt Istart,Iend,Jstart,Jend,m,n;
+  ierr = MatGetOwnershipRange(_waveOp,&Istart,&Iend); CHKERRQ(ierr);
+  ierr = MatGetOwnershipRangeColumn(_waveOp,&Jstart,&Jend); CHKERRQ(ierr);
+  ierr = MatGetLocalSize(_waveOp,&m,&n); CHKERRQ(ierr);
+
+  // the levels of the off-processor columns are needed, so ghost them
+  PetscInt ncols;
+  const PetscInt *cols;
+  const PetscScalar *vals;
+  set<PetscInt> ghostSet;
+  for (PetscInt Ii = Istart; Ii < Iend; Ii++) {
+    ierr = MatGetRow(_waveOp,Ii,&ncols,&cols,NULL); CHKERRQ(ierr);
+    for (PetscInt c = 0; c < ncols; c++) {
+      if (cols[c] < Jstart || cols[c] >= Jend) { ghostSet.insert(cols[c]); }
+    }
+    ierr = MatRestoreRow(_waveOp,Ii,&ncols,&cols,NULL); CHKERRQ(ierr);
+  }
+  vector<PetscInt> ghosts(ghostSet.begin(),ghostSet.end());
+  VecDestroy(&_mtsLevel);
+  ierr = VecCreateGhost(PETSC_COMM_WORLD,n,PETSC_DETERMINE,(PetscInt) ghosts.size(),ghosts.data(),&_mtsLevel); CHKERRQ(ierr);
+  ierr = computeMtsLevels(); CHKERRQ(ierr);
+  ierr = VecGhostUpdateBegin(_mtsLevel,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecGhostUpdateEnd(_mtsLevel,INSERT_VALUES,SCATTER_FORWARD); CHKERRQ(ierr);
+  Vec levelLocal;
+  const PetscScalar *lvl;
+  ierr = VecGhostGetLocalForm(_mtsLevel,&levelLocal); CHKERRQ(ierr);
+  ierr = VecGetArrayRead(levelLocal,&lvl); CHKERRQ(ierr);
+
+  // split each row by level, in compressed row form per level
+  vector< vector<PetscInt> > levelCols(_mtsLevels), levelPtr(_mtsLevels, vector<PetscInt>(1,0));
+  vector< vector<PetscScalar> > levelVals(_mtsLevels);
+  vector<PetscScalar> levelSum(_mtsLevels);
+  vector<PetscInt> numNodes(_mtsLevels,0);
+  for (PetscInt Ii = Istart; Ii < Iend; Ii++) {
+    PetscInt rowLevel = (PetscInt) lvl[Ii-Istart];
+    numNodes[rowLevel]++;
+    PetscScalar rowSum = 0, rowMax = 0;
+    for (PetscInt k = 0; k < _mtsLevels; k++) { levelSum[k] = 0; }
+
+    ierr = MatGetRow(_waveOp,Ii,&ncols,&cols,&vals); CHKERRQ(ierr);
+    for (PetscInt c = 0; c < ncols; c++) {
+      rowSum += vals[c];
+      rowMax = max(rowMax,PetscAbsScalar(vals[c]));
+      if (cols[c] == Ii) { continue; }
+
+      PetscInt colLevel;
+      if (cols[c] >= Jstart && cols[c] < Jend) { colLevel = (PetscInt) lvl[cols[c]-Jstart]; }
+      else { colLevel = (PetscInt) lvl[n + (lower_bound(ghosts.begin(),ghosts.end(),cols[c]) - ghosts.begin())]; }
+
+      PetscInt k = min(rowLevel,colLevel);
+      levelCols[k].push_back(cols[c]);
+      levelVals[k].push_back(vals[c] * (PetscScalar) (1 << k));
+      levelSum[k] += vals[c];
+    }
+    ierr = MatRestoreRow(_waveOp,Ii,&ncols,&cols,&vals); CHKERRQ(ierr);
+
+    for (PetscInt k = 0; k < _mtsLevels; k++) {
+      if ((PetscInt) levelCols[k].size() == levelPtr[k].back()) { continue; }
+      levelCols[k].push_back(Ii);
+      levelVals[k].push_back(-levelSum[k] * (PetscScalar) (1 << k));
+      levelPtr[k].push_back((PetscInt) levelCols[k].size());
+      _mtsRows[k].push_back(Ii-Istart);
+    }
+
+    // in the interior the row sum is zero up to round off
+    if (PetscAbsScalar(rowSum) > 1e-10 * rowMax) {
+      _mtsSumRows.push_back(Ii-Istart);
+      _mtsSums.push_back(rowSum);
+    }
+  }
+  ierr = VecRestoreArrayRead(levelLocal,&lvl); CHKERRQ(ierr);
+  ierr = VecGhostRestoreLocalForm(_mtsLevel,&levelLocal); CHKERRQ(ierr);
+
+  // assemble the level operators, with the rows of each numbered consecutively
+  for (PetscInt k = 0; k < _mtsLevels; k++) {
+    PetscInt mk = (PetscInt) _mtsRows[k].size();
+    vector<PetscInt> d_nnz(mk,0), o_nnz(mk,0);
+    for (PetscInt r = 0; r < mk; r++) {
+      for (PetscInt e = levelPtr[k][r]; e < levelPtr[k][r+1]; e++) {
+        if (levelCols[k][e] >= Jstart && levelCols[k][e] < Jend) { d_nnz[r]++; }
+        else { o_nnz[r]++; }
+      }
+    }
+
+    ierr = MatCreate(PETSC_COMM_WORLD,&_mtsOps[k]); CHKERRQ(ierr);
+    ierr = MatSetSizes(_mtsOps[k],mk,n,PETSC_DETERMINE,PETSC_DETERMINE); CHKERRQ(ierr);
+    ierr = MatSetType(_mtsOps[k],MATAIJ); CHKERRQ(ierr);
+    ierr = MatMPIAIJSetPreallocation(_mtsOps[k],0,d_nnz.data(),0,o_nnz.data()); CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation(_mtsOps[k],0,d_nnz.data()); CHKERRQ(ierr);
+
+    PetscInt rStart,rEnd;
+    ierr = MatGetOwnershipRange(_mtsOps[k],&rStart,&rEnd); CHKERRQ(ierr);
+    for (PetscInt r = 0; r < mk; r++) {
+      PetscInt row = rStart + r;
+      PetscInt nc = levelPtr[k][r+1] - levelPtr[k][r];
+      ierr = MatSetValues(_mtsOps[k],1,&row,nc,&levelCols[k][levelPtr[k][r]],&levelVals[k][levelPtr[k][r]],INSERT_VALUES); CHKERRQ(ierr);
+    }
+    ierr = MatAssemblyBegin(_mtsOps[k],MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(_mtsOps[k],MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+    ierr = MatCreateVecs(_mtsOps[k],NULL,&_mtsOpsOut[k]); CHKERRQ(ierr);
+  }
+
+  // how the nodes are distributed over the levels, for view
+  _mtsNumNodes.assign(_mtsLevels,0);
+  _mtsNumRows.assign(_mtsLevels,0);
+  MPI_Allreduce(numNodes.data(),_mtsNumNodes.data(),_mtsLevels,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+  for (PetscInt k = 0; k < _mtsLevels; k++) {
+    ierr = MatGetSize(_mtsOps[k],&_mtsNumRows[k],NULL); CHKERRQ(ierr);
+  }
+
+  #if VERBOSE > 0
+    for (PetscInt k = 0; k < _mtsLevels; k++) {
+      PetscPrintf(PETSC_COMM_WORLD,"multiple time stepping level %i: %i nodes, %i rows in its operator, deltaT = %g\n",
+        k,_mtsNumNodes[k],_mtsNumRows[k],_waveDeltaT*(1 << k));
+    }
+  #endif
+
   #if VERBOSE > 1
      PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
   #endif
@@ -442,6 +733,37 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::computeTimeStep()
 }
 
 
+// out = sum of 2^k * _mtsOps[k]*u over the levels that are updated at this step,
+// plus the boundary row sums times u
+PetscErrorCode strikeSlip_linearElastic_qd_fd::applyMtsOperators(const Vec& u,Vec& out,const PetscInt step)
+{
+  PetscErrorCode ierr = 0;
+
+  PetscScalar *outA;
+  const PetscScalar *uA,*levelOut;
+  ierr = VecSet(out,0.0); CHKERRQ(ierr);
+  ierr = VecGetArray(out,&outA); CHKERRQ(ierr);
+  ierr = VecGetArrayRead(u,&uA); CHKERRQ(ierr);
+  for (size_t r = 0; r < _mtsSumRows.size(); r++) {
+    outA[_mtsSumRows[r]] += _mtsSums[r] * uA[_mtsSumRows[r]];
+  }
+  ierr = VecRestoreArrayRead(u,&uA); CHKERRQ(ierr);
+
+  for (PetscInt k = 0; k < _mtsLevels; k++) {
+    if (step % (1 << k) != 0) { break; }
+    ierr = MatMult(_mtsOps[k],u,_mtsOpsOut[k]); CHKERRQ(ierr);
+    ierr = VecGetArrayRead(_mtsOpsOut[k],&levelOut); CHKERRQ(ierr);
+    for (size_t r = 0; r < _mtsRows[k].size(); r++) {
+      outA[_mtsRows[k][r]] += levelOut[r];
+    }
+    ierr = VecRestoreArrayRead(_mtsOpsOut[k],&levelOut); CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(out,&outA); CHKERRQ(ierr);
+
+  return ierr;
+}
+
+
 // compute alphay and alphaz for use in time stepping routines
 PetscErrorCode strikeSlip_linearElastic_qd_fd::computePenaltyVectors()
 {
@@ -597,12 +919,10 @@ bool strikeSlip_linearElastic_qd_fd::checkSwitchRegime(const Fault* _fault)
   //~ VecDestroy(&absSlipVel);
 
   // if using R = eta*V / tauQS
-  Vec R; VecDuplicate(_fault->_slipVel,&R);
-  VecPointwiseMult(R,_fault_qd->_eta_rad,_fault->_slipVel);
-  VecPointwiseDivide(R,R,_fault->_tauQSP);
+  PetscErrorCode ierr = 0;
   PetscScalar maxV;
-  VecMax(R,NULL,&maxV);
-  VecDestroy(&R);
+  ierr = computeMaxR(_fault->_slipVel,_fault->_tauQSP,maxV);
+  CHKERRABORT(PETSC_COMM_WORLD,ierr);
 
 
   //~ // if integrating past allowed time or step count, force switching now
@@ -662,6 +982,47 @@ bool strikeSlip_linearElastic_qd_fd::checkSwitchRegime(const Fault* _fault)
 }
 
 
+// max over the fault of R = eta*V / tauQS, with a single reduction
+PetscErrorCode strikeSlip_linearElastic_qd_fd::computeMaxR(const Vec& slipVel,const Vec& tauQS,PetscScalar& maxR)
+{
+  PetscErrorCode ierr = 0;
+
+  PetscScalar const *eta,*V,*tau;
+  PetscInt Istart,Iend;
+  ierr = VecGetOwnershipRange(slipVel,&Istart,&Iend);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(_fault_qd->_eta_rad,&eta);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(slipVel,&V);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(tauQS,&tau);CHKERRQ(ierr);
+  PetscScalar maxLocal = -PETSC_MAX_REAL;
+  for (PetscInt Jj = 0; Jj < Iend-Istart; Jj++) {
+    maxLocal = max(maxLocal, eta[Jj]*V[Jj]/tau[Jj]);
+  }
+  ierr = VecRestoreArrayRead(_fault_qd->_eta_rad,&eta);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(slipVel,&V);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(tauQS,&tau);CHKERRQ(ierr);
+
+  ierr = MPI_Allreduce(&maxLocal,&maxR,1,MPIU_SCALAR,MPI_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  return ierr;
+}
+
+
+// event function for locating the switch from quasidynamic to fully dynamic:
+// g = max(R) - trigger_qd2fd, with V from the interpolated slip rate and
+// tauQS from the last evaluation of d_dt (at the end of the step)
+// g < 0 while switching is not yet allowed
+PetscErrorCode strikeSlip_linearElastic_qd_fd::eventFunction(const PetscReal time,const map<string,Vec>& var,const map<string,Vec>& dvar,PetscScalar& g)
+{
+  PetscErrorCode ierr = 0;
+  g = -1.0;
+  if (_inDynamic || !_allowed) { return ierr; }
+
+  PetscScalar maxR = 0;
+  ierr = computeMaxR(dvar.find("slip")->second,_fault_qd->_tauQSP,maxR);CHKERRQ(ierr);
+  g = maxR - _trigger_qd2fd;
+  return ierr;
+}
+
+
 // initiate varQSEx, varIm, and varFD
 // includes computation of steady-state initial conditions if necessary
 // should only be called once before the 1st earthquake cycle
@@ -878,6 +1239,8 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::prepare_qd2fd()
 
   // update momentum balance equation boundary conditions
   _material->changeBCTypes(_mat_fd_bcRType,_mat_fd_bcTType,_mat_fd_bcLType,_mat_fd_bcBType);
+  MatDestroy(&_waveOp); // A changed, reconstructed on the next call to propagateWaves
+  if (_pmlLayer != NULL) { _pmlLayer->reset(); } // the layer starts at rest
 
 
   #if VERBOSE > 1
@@ -909,6 +1272,21 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::integrate_singleQDTimeStep()
   else if (_timeIntegrator.compare("RK43")==0) {
     quadEx = new RK43(1,_maxTime,_deltaT_fd,_timeControlType);
   }
+  else if (_timeIntegrator.compare("RK32_2N")==0) {
+    quadEx = new RK32_2N(1,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK43_2N")==0) {
+    quadEx = new RK43_2N(1,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK54")==0) {
+    quadEx = new RK54(1,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK65")==0) {
+    quadEx = new RK65(1,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("TSARKIMEX")==0 || _timeIntegrator.compare("TSROSW")==0 || _timeIntegrator.compare("TSBDF")==0) {
+    quadEx = new OdeSolver_TS(1,_maxTime,_deltaT_fd,_timeControlType,_timeIntegrator,_tsJacobian);
+  }
   else if (_timeIntegrator.compare("RK32_WBE")==0) {
     quadImex = new RK32_WBE(1,_maxTime,_deltaT_fd,_timeControlType);
   }
@@ -926,6 +1304,7 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::integrate_singleQDTimeStep()
     quadImex->setTimeStepBounds(_deltaT_fd,_deltaT_fd);
     quadImex->setTimeRange(_currTime,_currTime+_deltaT_fd);
     quadImex->setInitialStepCount(_stepCount);
+    quadImex->setPackedState(_packedState.compare("yes")==0);
     quadImex->setInitialConds(_varQSEx,_varIm);
     quadImex->setToleranceType(_normType);
     quadImex->setErrInds(_timeIntInds,_scale);
@@ -938,6 +1317,7 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::integrate_singleQDTimeStep()
     quadEx->setTimeRange(_currTime,_currTime+_deltaT_fd);
     quadEx->setInitialStepCount(_stepCount);
     quadEx->setToleranceType(_normType);
+    quadEx->setPackedState(_packedState.compare("yes")==0);
     quadEx->setInitialConds(_varQSEx);
     quadEx->setErrInds(_timeIntInds,_scale);
 
@@ -1052,6 +1432,9 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::view()
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent in dynamic (s): %g\n",_dynTime);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   total run time (s): %g\n",totRunTime);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   %% integration time spent writing output: %g\n",(_writeTime/_integrateTime)*100.);CHKERRQ(ierr);
+  for (size_t k = 0; k < _mtsNumNodes.size(); k++) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   multiple time stepping level %i: %i nodes, %i rows in its operator\n",(int) k,_mtsNumNodes[k],_mtsNumRows[k]);CHKERRQ(ierr);
+  }
   return ierr;
 }
 
@@ -1101,6 +1484,10 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::writeContext()
     ierr = PetscViewerASCIIPrintf(viewer,"scale = %s\n",vector2str(_scale).c_str());CHKERRQ(ierr);
   }
   ierr = PetscViewerASCIIPrintf(viewer,"normType = %s\n",_normType.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"packedState = %s\n",_packedState.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"tsJacobian = %s\n",_tsJacobian.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"eventDetection = %s\n",_eventDetection.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"eventTol = %.15e\n",_eventTol);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
 
   ierr = PetscViewerASCIIPrintf(viewer,"trigger_qd2fd = %.15e\n",_trigger_qd2fd);CHKERRQ(ierr);
@@ -1110,6 +1497,12 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::writeContext()
   ierr = PetscViewerASCIIPrintf(viewer,"limit_stride_fd = %.15e\n",_limit_stride_fd);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"CFL = %.15e\n",_CFL);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"deltaT_fd = %.15e\n",_deltaT_fd);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"mtsLevels = %i\n",_mtsLevels);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"pml = %s\n",_pml.c_str());CHKERRQ(ierr);
+  if (_pml.compare("yes")==0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"pmlThickness = %.15e # (km)\n",_pmlThickness);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"pmlReflection = %.15e\n",_pmlR);CHKERRQ(ierr);
+  }
 
 
   // boundary conditions for momentum balance equation
@@ -1159,8 +1552,10 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::solveMomentumBalance(const PetscS
   // add source term for driving the ice stream to rhs Vec
   if (_forcingType.compare("iceStream")==0) { VecAXPY(_material->_rhs,1.0,_forcingTerm); }
 
+  // compute displacement and stresses
+  // (in fault-only mode body stresses are computed later only if needed)
   _material->computeU();
-  _material->computeStresses();
+  if (_material->_faultStressOnly == 0) { _material->computeStresses(); }
 
   return ierr;
 }
@@ -1177,25 +1572,33 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::propagateWaves(const PetscScalar
 
 double startPropagation = MPI_Wtime();
 
-  // compute D2u = (Dyy+Dzz)*u
-  Vec D2u, temp;
-  VecDuplicate(*_y, &D2u);
-  VecDuplicate(*_y, &temp);
-  Mat A; _material->_sbp->getA(A);
-  ierr = MatMult(A, var.find("u")->second, temp);
-  ierr = _material->_sbp->Hinv(temp, D2u);
-  VecDestroy(&temp);
-  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
-      Mat J,Jinv,qy,rz,yq,zr;
-      ierr = _material->_sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
-      Vec temp;
-      VecDuplicate(D2u, &temp);
-      MatMult(Jinv, D2u, temp);
-      VecCopy(temp, D2u);
-      VecDestroy(&temp);
+  if (_waveOp == NULL || deltaT != _waveDeltaT) {
+    ierr = constructWaveOperator(deltaT); CHKERRQ(ierr);
   }
-  ierr = VecScatterBegin(*_body2fault, D2u, _fault_fd->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
-  ierr = VecScatterEnd(*_body2fault, D2u, _fault_fd->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+
+  // uNext = dt^2/(rho*(1+dt*ay)) * D2u, with D2u = Jinv*Hinv*A*u = (Dyy+Dzz)*u
+  if (_mtsLevels > 1) {
+    // multiple time stepping: level k is only applied every 2^k steps, but
+    // every node is still advanced by the sweep below
+    ierr = applyMtsOperators(var.find("u")->second, varNext["u"], _mtsStep); CHKERRQ(ierr);
+    _mtsStep++;
+  }
+  else {
+    ierr = MatMult(_waveOp, var.find("u")->second, varNext["u"]); CHKERRQ(ierr);
+  }
+
+  // perfectly matched layer: add dt^2/(rho*(1+dt*ay)) * (Dy*psiY + Dz*psiZ - rho*zetaY*zetaZ*u)
+  if (_pmlLayer != NULL) {
+    ierr = _pmlLayer->updateAuxFields(var.find("u")->second, varPrev.find("u")->second, deltaT); CHKERRQ(ierr);
+    ierr = _pmlLayer->computeForce(var.find("u")->second); CHKERRQ(ierr);
+    ierr = VecPointwiseMult(_pmlLayer->_force, _pmlLayer->_force, _waveCf); CHKERRQ(ierr);
+    ierr = VecAXPY(varNext["u"], 1.0, _pmlLayer->_force); CHKERRQ(ierr);
+  }
+
+  // the fault needs D2u itself, so undo the scaling on the fault only
+  ierr = VecScatterBegin(*_body2fault, varNext["u"], _fault_fd->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(*_body2fault, varNext["u"], _fault_fd->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecPointwiseMult(_fault_fd->_d2u, _fault_fd->_d2u, _faultD2uScale); CHKERRQ(ierr);
 
 
   // Propagate waves and compute displacement at the next time step
@@ -1203,34 +1606,122 @@ double startPropagation = MPI_Wtime();
 
   PetscInt       Ii,Istart,Iend;
   PetscScalar   *uNextA; // changed in this loop
-  const PetscScalar   *u, *uPrev, *d2u, *ay, *rho; // unchchanged in this loop
+  const PetscScalar   *u, *uPrev, *cu, *cuPrev; // unchchanged in this loop
   ierr = VecGetArray(varNext["u"], &uNextA);
   ierr = VecGetArrayRead(var.find("u")->second, &u);
   ierr = VecGetArrayRead(varPrev.find("u")->second, &uPrev);
-  ierr = VecGetArrayRead(_ay, &ay);
-  ierr = VecGetArrayRead(D2u, &d2u);
-  ierr = VecGetArrayRead(_material->_rho, &rho);
+  ierr = VecGetArrayRead(_waveCu, &cu);
+  ierr = VecGetArrayRead(_waveCuPrev, &cuPrev);
 
   ierr = VecGetOwnershipRange(varNext["u"],&Istart,&Iend);CHKERRQ(ierr);
   PetscInt       Jj = 0;
   for (Ii = Istart; Ii < Iend; Ii++){
-    PetscScalar c1 = deltaT*deltaT / rho[Jj];
-    PetscScalar c2 = deltaT*ay[Jj] - 1.0;
-    PetscScalar c3 = deltaT*ay[Jj] + 1.0;
-
-    uNextA[Jj] = (c1*d2u[Jj] + 2.*u[Jj] + c2*uPrev[Jj]) / c3;
+    uNextA[Jj] += cu[Jj]*u[Jj] + cuPrev[Jj]*uPrev[Jj];
     Jj++;
   }
   ierr = VecRestoreArray(varNext["u"], &uNextA);
   ierr = VecRestoreArrayRead(var.find("u")->second, &u);
   ierr = VecRestoreArrayRead(varPrev.find("u")->second, &uPrev);
+  ierr = VecRestoreArrayRead(_waveCu, &cu);
+  ierr = VecRestoreArrayRead(_waveCuPrev, &cuPrev);
+
+_propagateTime += MPI_Wtime() - startPropagation;
+
+  #if VERBOSE > 1
+     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// Construct the scaled operator and coefficients for the leapfrog update
+//   uNext = _waveOp*u + _waveCu.*u + _waveCuPrev.*uPrev
+// which, with c2 = dt*ay - 1 and c3 = dt*ay + 1, is
+//   uNext = (dt^2/rho * Jinv*Hinv*A*u + 2*u + c2*uPrev) / c3
+// Jinv and Hinv are diagonal, so they are folded into the rows of a copy of A.
+// Must be reconstructed if deltaT or the boundary conditions of A change.
+PetscErrorCode strikeSlip_linearElastic_qd_fd::constructWaveOperator(const PetscScalar deltaT)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    std::string funcName = "strikeSlip_linearElastic_qd_fd::constructWaveOperator";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  // diagonal of Jinv*Hinv
+  Vec rowScale, temp;
+  VecDuplicate(*_y, &rowScale);
+  VecDuplicate(*_y, &temp);
+  VecSet(temp, 1.0);
+  ierr = _material->_sbp->Hinv(temp, rowScale); CHKERRQ(ierr);
+  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
+    Mat J,Jinv,qy,rz,yq,zr;
+    ierr = _material->_sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
+    ierr = MatMult(Jinv, rowScale, temp); CHKERRQ(ierr);
+    ierr = VecCopy(temp, rowScale); CHKERRQ(ierr);
+  }
+
+  if (_waveCu == NULL) {
+    VecDuplicate(*_y, &_waveCu);
+    VecDuplicate(*_y, &_waveCuPrev);
+    VecDuplicate(_fault_fd->_d2u, &_faultD2uScale);
+  }
+  if (_pmlLayer != NULL && _waveCf == NULL) { VecDuplicate(*_y, &_waveCf); }
+
+  // temp is reused for rho*c3/dt^2, the inverse of the scaling applied to D2u
+  PetscInt       Ii,Istart,Iend;
+  PetscScalar   *scale, *invScale, *cu, *cuPrev, *cf = NULL;
+  const PetscScalar *ay, *rho, *pmlDamping = NULL;
+  ierr = VecGetArray(rowScale, &scale);
+  ierr = VecGetArray(temp, &invScale);
+  ierr = VecGetArray(_waveCu, &cu);
+  ierr = VecGetArray(_waveCuPrev, &cuPrev);
+  ierr = VecGetArrayRead(_ay, &ay);
+  ierr = VecGetArrayRead(_material->_rho, &rho);
+  if (_pmlLayer != NULL) {
+    ierr = VecGetArray(_waveCf, &cf);
+    ierr = VecGetArrayRead(_pmlLayer->_damping, &pmlDamping);
+  }
+  ierr = VecGetOwnershipRange(rowScale,&Istart,&Iend);CHKERRQ(ierr);
+  PetscInt       Jj = 0;
+  for (Ii = Istart; Ii < Iend; Ii++){
+    PetscScalar a = ay[Jj];
+    if (pmlDamping != NULL) { a += pmlDamping[Jj]; }
+    PetscScalar c1 = deltaT*deltaT / rho[Jj];
+    PetscScalar c2 = deltaT*a - 1.0;
+    PetscScalar c3 = deltaT*a + 1.0;
+
+    scale[Jj] *= c1 / c3;
+    invScale[Jj] = c3 / c1;
+    cu[Jj] = 2.0 / c3;
+    cuPrev[Jj] = c2 / c3;
+    if (cf != NULL) { cf[Jj] = c1 / c3; }
+    Jj++;
+  }
+  if (_pmlLayer != NULL) {
+    ierr = VecRestoreArray(_waveCf, &cf);
+    ierr = VecRestoreArrayRead(_pmlLayer->_damping, &pmlDamping);
+  }
+  ierr = VecRestoreArray(rowScale, &scale);
+  ierr = VecRestoreArray(temp, &invScale);
+  ierr = VecRestoreArray(_waveCu, &cu);
+  ierr = VecRestoreArray(_waveCuPrev, &cuPrev);
   ierr = VecRestoreArrayRead(_ay, &ay);
-  ierr = VecRestoreArrayRead(D2u, &d2u);
   ierr = VecRestoreArrayRead(_material->_rho, &rho);
 
-  VecDestroy(&D2u);
+  ierr = VecScatterBegin(*_body2fault, temp, _faultD2uScale, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(*_body2fault, temp, _faultD2uScale, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
 
-_propagateTime += MPI_Wtime() - startPropagation;
+  // _waveOp = diag(rowScale) * A
+  Mat A; _material->_sbp->getA(A);
+  MatDestroy(&_waveOp);
+  ierr = MatDuplicate(A, MAT_COPY_VALUES, &_waveOp); CHKERRQ(ierr);
+  ierr = MatDiagonalScale(_waveOp, rowScale, NULL); CHKERRQ(ierr);
+  _waveDeltaT = deltaT;
+  if (_mtsLevels > 1) { ierr = constructMtsOperators(); CHKERRQ(ierr); }
+
+  VecDestroy(&rowScale);
+  VecDestroy(&temp);
 
   #if VERBOSE > 1
      PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
@@ -1454,6 +1945,21 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::integrate_qd()
   else if (_timeIntegrator.compare("RK43")==0) {
     quadEx = new RK43(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
   }
+  else if (_timeIntegrator.compare("RK32_2N")==0) {
+    quadEx = new RK32_2N(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK43_2N")==0) {
+    quadEx = new RK43_2N(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK54")==0) {
+    quadEx = new RK54(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK65")==0) {
+    quadEx = new RK65(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("TSARKIMEX")==0 || _timeIntegrator.compare("TSROSW")==0 || _timeIntegrator.compare("TSBDF")==0) {
+    quadEx = new OdeSolver_TS(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType,_timeIntegrator,_tsJacobian);
+  }
   else if (_timeIntegrator.compare("RK32_WBE")==0) {
     quadImex = new RK32_WBE(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
   }
@@ -1471,6 +1977,7 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::integrate_qd()
     quadImex->setTimeStepBounds(_minDeltaT,_maxDeltaT);
     quadImex->setTimeRange(_currTime,_maxTime);
     quadImex->setInitialStepCount(_stepCount);
+    quadImex->setPackedState(_packedState.compare("yes")==0);
     quadImex->setInitialConds(_varQSEx,_varIm);
     quadImex->setToleranceType(_normType);
     quadImex->setErrInds(_timeIntInds,_scale);
@@ -1488,6 +1995,8 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::integrate_qd()
     quadEx->setTimeRange(_currTime,_maxTime);
     quadEx->setInitialStepCount(_stepCount);
     quadEx->setToleranceType(_normType);
+    quadEx->setPackedState(_packedState.compare("yes")==0);
+    quadEx->setEventDetection(_eventDetection.compare("yes")==0,_eventTol);
     quadEx->setInitialConds(_varQSEx);
     quadEx->setErrInds(_timeIntInds,_scale);
 
@@ -1577,10 +2086,7 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::d_dt(const PetscScalar time,const
   ierr = solveMomentumBalance(time,varEx,dvarEx); CHKERRQ(ierr);
 
   // update fields on fault from other classes
-  Vec sxy,sxz,sdev;
-  ierr = _material->getStresses(sxy,sxz,sdev);
-  ierr = VecScatterBegin(*_body2fault, sxy, _fault_qd->_tauQSP, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
-  ierr = VecScatterEnd(*_body2fault, sxy, _fault_qd->_tauQSP, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = _material->getFaultStress(_fault_qd->_tauQSP); CHKERRQ(ierr);
 
   // rates for fault
   ierr = _fault_qd->d_dt(time,varEx,dvarEx); // sets rates for slip and state
@@ -1638,10 +2144,7 @@ PetscErrorCode strikeSlip_linearElastic_qd_fd::d_dt(const PetscScalar time,const
   ierr = solveMomentumBalance(time,varEx,dvarEx); CHKERRQ(ierr);
 
   // update shear stress on fault from momentum balance computation
-  Vec sxy,sxz,sdev;
-  ierr = _material->getStresses(sxy,sxz,sdev);
-  ierr = VecScatterBegin(*_body2fault, sxy, _fault_qd->_tauQSP, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
-  ierr = VecScatterEnd(*_body2fault, sxy, _fault_qd->_tauQSP, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = _material->getFaultStress(_fault_qd->_tauQSP); CHKERRQ(ierr);
 
   // rates for fault
   ierr = _fault_qd->d_dt(time,varEx,dvarEx); // sets rates for slip and state
@@ -8,6 +8,8 @@
 #include <assert.h>
 #include <vector>
 #include <map>
+#include <set>
+#include <algorithm>
 
 #include "integratorContextEx.hpp"
 #include "integratorContextImex.hpp"
@@ -16,6 +18,7 @@
 
 #include "odeSolver.hpp"
 #include "odeSolverImex.hpp"
+#include "odeSolver_TS.hpp"
 #include "odeSolver_WaveEq.hpp"
 #include "odeSolver_WaveImex.hpp"
 #include "genFuncs.hpp"
@@ -25,6 +28,7 @@
 #include "sbpOps_m_varGrid.hpp"
 #include "fault.hpp"
 #include "pressureEq.hpp"
+#include "pml.hpp"
 #include "heatEquation.hpp"
 #include "linearElastic.hpp"
 
@@ -65,6 +69,21 @@ private:
   Vec         *_y,*_z;
   Vec          _ay;
   Vec          _alphay;
+  Mat          _waveOp; // scaled spatial operator for the wave equation, see constructWaveOperator
+  Vec          _waveCu,_waveCuPrev,_faultD2uScale;
+  PetscScalar  _waveDeltaT; // deltaT for which _waveOp was constructed
+  PetscInt     _mtsLevels,_mtsStep; // number of multiple time stepping levels (1 = off), and steps taken with them
+  Vec          _mtsLevel; // level k of each node, whose forces are updated every 2^k steps, ghosted with the off-processor columns of _waveOp
+  vector<Mat>  _mtsOps; // interactions in _waveOp by level, on only the rows they touch
+  vector<Vec>  _mtsOpsOut; // _mtsOps[k]*u
+  vector< vector<PetscInt> > _mtsRows; // local row of _waveOp for each local row of _mtsOps[k]
+  vector<PetscInt>    _mtsSumRows; // local rows of _waveOp with a nonzero row sum (boundary rows)
+  vector<PetscScalar> _mtsSums; // and their row sums
+  vector<PetscInt>    _mtsNumNodes,_mtsNumRows; // nodes in each level, and rows in each _mtsOps[k]
+  string       _pml; // yes: perfectly matched layer on the right and bottom boundaries when fully dynamic
+  PetscScalar  _pmlThickness,_pmlR; // (km) thickness of the layer, and its reflection coefficient
+  PerfectlyMatchedLayer *_pmlLayer;
+  Vec          _waveCf; // dt^2/(rho*(1+dt*ay)), scales the force from the layer
   bool         _inDynamic,_allowed;
   PetscScalar  _trigger_qd2fd, _trigger_fd2qd, _limit_qd, _limit_fd, _limit_stride_fd;
 
@@ -85,6 +104,10 @@ private:
   vector<string>    _timeIntInds;// keys of variables to be used in time integration
   vector<double>    _scale; // scale factor for entries in _timeIntInds
   string            _normType;
+  string            _packedState; // store integrated variables in one contiguous Vec
+  string            _tsJacobian; // preconditioner for the PETSc TS integrators: mf or diagonal
+  string            _eventDetection; // locate the switch to fully dynamic within the step: yes or no
+  PetscScalar       _eventTol; // tolerance on the switching time, relative to the step size
 
 
   // viewers
@@ -113,6 +136,10 @@ private:
   PetscErrorCode checkInput();
   PetscErrorCode parseBCs(); // parse boundary conditions
   PetscErrorCode computeTimeStep();
+  PetscErrorCode computeWaveTravelTime(Vec& ts);
+  PetscErrorCode computeMtsLevels();
+  PetscErrorCode constructMtsOperators();
+  PetscErrorCode applyMtsOperators(const Vec& u,Vec& out,const PetscInt step);
   PetscErrorCode computePenaltyVectors(); // computes alphay and alphaz
   PetscErrorCode constructIceStreamForcingTerm(); // ice stream forcing term
 
@@ -146,9 +173,12 @@ public:
   PetscErrorCode solveMomentumBalance(const PetscScalar time,const map<string,Vec>& varEx,map<string,Vec>& dvarEx);
   PetscErrorCode propagateWaves(const PetscScalar time, const PetscScalar deltaT,
         map<string,Vec>& varNext, const map<string,Vec>& var, const map<string,Vec>& varPrev);
+  PetscErrorCode constructWaveOperator(const PetscScalar deltaT);
 
   // help with switching between fully dynamic and quasidynamic
   bool checkSwitchRegime(const Fault* _fault);
+  PetscErrorCode computeMaxR(const Vec& slipVel,const Vec& tauQS,PetscScalar& maxR); // max of R = eta*V/tauQS
+  PetscErrorCode eventFunction(const PetscReal time,const map<string,Vec>& var,const map<string,Vec>& dvar,PetscScalar& g);
   PetscErrorCode prepare_qd2fd(); // switch from quasidynamic to fully dynamic
   PetscErrorCode prepare_fd2qd(); // switch from fully dynamic to quasidynamic
 
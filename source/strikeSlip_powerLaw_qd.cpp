@@ -12,11 +12,14 @@ StrikeSlip_PowerLaw_qd::StrikeSlip_PowerLaw_qd(Domain&D)
     _hydraulicCoupling("no"),_hydraulicTimeIntType("explicit"),
     _stateLaw("agingLaw"),_forcingType("no"),_wLinearMaxwell("no"),
     _vL(1e-9),_faultTypeScale(2.0),
+    _multirateCoupling("no"),_multirateTol(1e-2),_multirateDtFactor(1.0),
+    _heSched(NULL),_pSched(NULL),
     _timeIntegrator("RK43"),_timeControlType("PID"),
     _stride1D(1),_stride2D(1),_maxStepCount(1e8),
     _initTime(0),_currTime(0),_maxTime(1e15),
     _minDeltaT(1e-3),_maxDeltaT(1e10),
-    _stepCount(0),_timeStepTol(1e-8),_initDeltaT(1e-3),_normType("L2_absolute"),
+    _stepCount(0),_timeStepTol(1e-8),_initDeltaT(1e-3),_normType("L2_absolute"),_packedState("no"),_tsJacobian("mf"),
+    _outputInterval(0),_outputCount(0),
     _integrateTime(0),_writeTime(0),_linSolveTime(0),_factorTime(0),
     _startTime(MPI_Wtime()),_miscTime(0),
     _timeV1D(NULL),_dtimeV1D(NULL),_timeV2D(NULL),_dtimeV2D(NULL),_forcingVal(0),
@@ -26,7 +29,7 @@ StrikeSlip_PowerLaw_qd::StrikeSlip_PowerLaw_qd(Domain&D)
     _fault(NULL),_material(NULL),_he(NULL),_p(NULL),_grainDist(NULL),
     _fss_T(0.15),_fss_EffVisc(0.2),_fss_grainSize(0.2),_gss_t(1e-10),
     _maxSSIts_effVisc(50),_maxSSIts_tot(100),_maxSSIts_timesteps(2e5),
-    _atolSS_effVisc(1e-3)
+    _atolSS_effVisc(1e-3),_andersonDepthSS_effVisc(0),_andersonDepthSS_tot(0)
 {
   #if VERBOSE > 1
     std::string funcName = "StrikeSlip_PowerLaw_qd::StrikeSlip_PowerLaw_qd()";
@@ -39,6 +42,19 @@ StrikeSlip_PowerLaw_qd::StrikeSlip_PowerLaw_qd(Domain&D)
 
   // initiate momentum balance equation
   _material = new PowerLaw(D,_mat_bcRType,_mat_bcTType,_mat_bcLType,_mat_bcBType);
+  if (_material->_viscStrainTimeIntType.compare("implicit")==0 &&
+    _timeIntegrator.compare("RK32_WBE")!=0 && _timeIntegrator.compare("RK43_WBE")!=0) {
+    PetscPrintf(PETSC_COMM_WORLD,"ERROR: viscStrainTimeIntType = implicit requires timeIntegrator = RK32_WBE or RK43_WBE.\n");
+    assert(0);
+  }
+  // the viscosity is refreshed by the step hooks of the explicit Runge-Kutta methods
+  if (_material->_lagViscosity.compare("yes")==0 &&
+    _timeIntegrator.compare("RK32")!=0 && _timeIntegrator.compare("RK43")!=0 &&
+    _timeIntegrator.compare("RK32_2N")!=0 && _timeIntegrator.compare("RK43_2N")!=0 &&
+    _timeIntegrator.compare("RK54")!=0 && _timeIntegrator.compare("RK65")!=0) {
+    PetscPrintf(PETSC_COMM_WORLD,"ERROR: lagViscosity = yes requires timeIntegrator = RK32, RK43, RK32_2N, RK43_2N, RK54 or RK65.\n");
+    assert(0);
+  }
 
   _he = new HeatEquation(D); // heat equation
   if (_thermalCoupling.compare("coupled")==0) { VecCopy(_he->_T,_material->_T); }
@@ -55,6 +71,13 @@ StrikeSlip_PowerLaw_qd::StrikeSlip_PowerLaw_qd(Domain&D)
   if (_hydraulicCoupling.compare("no")!=0) { _p = new PressureEq(D); }
   if (_hydraulicCoupling.compare("coupled")==0) { _fault->setSNEff(_p->_p); }
 
+  // multirate coupling
+  if (_multirateCoupling.compare("yes")==0) {
+    if (_thermalCoupling.compare("no")!=0) { _heSched = new MultirateScheduler("heat equation",_multirateTol); }
+    if (_hydraulicCoupling.compare("no")!=0) { _pSched = new MultirateScheduler("pressure equation",_multirateTol); }
+    setMultirateMaxTimeSteps();
+  }
+
   // grain size distribution
   if (_grainSizeEvCoupling.compare("no")!=0) { _grainDist = new GrainSizeEvolution(D); }
   if (_grainSizeEvCoupling.compare("coupled")==0) { VecCopy(_grainDist->_d, _material->_grainSize); }
@@ -91,6 +114,9 @@ StrikeSlip_PowerLaw_qd::~StrikeSlip_PowerLaw_qd()
     }
   }
 
+  destroyVector(_varOut);
+  destroyVector(_dvarOut);
+
   PetscViewerDestroy(&_timeV1D);
   PetscViewerDestroy(&_dtimeV1D);
   PetscViewerDestroy(&_timeV2D);
@@ -102,6 +128,8 @@ StrikeSlip_PowerLaw_qd::~StrikeSlip_PowerLaw_qd()
   delete _fault;       _fault = NULL;
   delete _he;          _he = NULL;
   delete _p;           _p = NULL;
+  delete _heSched;     _heSched = NULL;
+  delete _pSched;      _pSched = NULL;
   delete _grainDist;   _grainDist = NULL;
 
   if (_varSS.find("v") != _varSS.end()) { VecDestroy(&_varSS["v"]); }
@@ -152,6 +180,9 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::loadSettings(const char *file)
     else if (var.compare("guessSteadyStateICs")==0) { _guessSteadyStateICs = atoi( rhs.c_str() ); }
     else if (var.compare("forcingType")==0) { _forcingType = rhs.c_str(); }
     else if (var.compare("wLinearMaxwell")==0) { _wLinearMaxwell = rhs.c_str(); }
+    else if (var.compare("multirateCoupling")==0) { _multirateCoupling = rhs.c_str(); }
+    else if (var.compare("multirateTol")==0) { _multirateTol = atof( rhs.c_str() ); }
+    else if (var.compare("multirateDtFactor")==0) { _multirateDtFactor = atof( rhs.c_str() ); }
 
     // for steady state iteration
     else if (var.compare("fss_T")==0) { _fss_T = atof( rhs.c_str() ); }
@@ -161,6 +192,8 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::loadSettings(const char *file)
     else if (var.compare("maxSSIts_tot")==0) { _maxSSIts_tot = atoi( rhs.c_str() ); }
     else if (var.compare("maxSSIts_timesteps")==0) { _maxSSIts_timesteps = (int) atoi( rhs.c_str() ); }
     else if (var.compare("atolSS_effVisc")==0) { _atolSS_effVisc = atof( rhs.c_str() ); }
+    else if (var.compare("andersonDepthSS_effVisc")==0) { _andersonDepthSS_effVisc = atoi( rhs.c_str() ); }
+    else if (var.compare("andersonDepthSS_tot")==0) { _andersonDepthSS_tot = atoi( rhs.c_str() ); }
 
     // time integration properties
     else if (var.compare("timeIntegrator")==0) { _timeIntegrator = rhs; }
@@ -177,6 +210,10 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::loadSettings(const char *file)
     else if (var.compare("timeIntInds")==0) { loadVectorFromInputFile(rhsFull,_timeIntInds); }
     else if (var.compare("scale")==0) { loadVectorFromInputFile(rhsFull,_scale); }
     else if (var.compare("normType")==0) { _normType = rhs.c_str(); }
+    else if (var.compare("packedState")==0) { _packedState = rhs.c_str(); }
+    else if (var.compare("tsJacobian")==0) { _tsJacobian = rhs.c_str(); }
+    else if (var.compare("outputTimes")==0) { loadVectorFromInputFile(rhsFull,_outputTimes); }
+    else if (var.compare("outputInterval")==0) { _outputInterval = atof( rhs.c_str() ); }
 
     else if (var.compare("vL")==0) { _vL = atof( rhs.c_str() ); }
 
@@ -221,13 +258,45 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::checkInput()
   assert(_timeIntegrator.compare("FEuler")==0 ||
       _timeIntegrator.compare("RK32")==0 ||
       _timeIntegrator.compare("RK43")==0 ||
+      _timeIntegrator.compare("RK32_2N")==0 ||
+      _timeIntegrator.compare("RK43_2N")==0 ||
+      _timeIntegrator.compare("RK54")==0 ||
+      _timeIntegrator.compare("RK65")==0 ||
       _timeIntegrator.compare("RK32_WBE")==0 ||
-      _timeIntegrator.compare("RK43_WBE")==0 );
+      _timeIntegrator.compare("RK43_WBE")==0 ||
+      _timeIntegrator.compare("TSARKIMEX")==0 ||
+      _timeIntegrator.compare("TSROSW")==0 ||
+      _timeIntegrator.compare("TSBDF")==0 );
+
+  assert(_packedState.compare("yes")==0 || _packedState.compare("no")==0);
+  assert(_tsJacobian.compare("mf")==0 || _tsJacobian.compare("diagonal")==0);
+
+  // dense output requires an interpolant from the time integrator
+  assert(_outputInterval >= 0);
+  if (_outputTimes.size() > 0 || _outputInterval > 0) {
+    assert(_outputTimes.size() == 0 || _outputInterval == 0);
+    assert(_timeIntegrator.compare("RK32")==0 ||
+      _timeIntegrator.compare("RK43")==0 ||
+      _timeIntegrator.compare("RK54")==0 ||
+      _timeIntegrator.compare("RK65")==0 );
+    for (size_t i = 1; i < _outputTimes.size(); i++) { assert(_outputTimes[i] > _outputTimes[i-1]); }
+  }
 
   assert(_timeControlType.compare("P")==0 ||
          _timeControlType.compare("PI")==0 ||
          _timeControlType.compare("PID")==0 );
 
+  assert(_andersonDepthSS_effVisc >= 0);
+  assert(_andersonDepthSS_tot >= 0);
+
+  assert(_multirateCoupling.compare("yes")==0 || _multirateCoupling.compare("no")==0);
+  assert(_multirateTol >= 0);
+  assert(_multirateDtFactor > 0);
+  if (_multirateCoupling.compare("yes")==0) {
+    // only implicitly integrated fields can be sub-cycled
+    assert(_timeIntegrator.compare("RK32_WBE")==0 || _timeIntegrator.compare("RK43_WBE")==0);
+  }
+
   if (_initDeltaT<_minDeltaT || _initDeltaT < 1e-14) {_initDeltaT = _minDeltaT; }
   assert(_maxStepCount >= 0);
   assert(_initTime >= 0);
@@ -320,11 +389,13 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::initiateIntegrand()
   if (_guessSteadyStateICs) {
     std::string saveWDiffCreep = _material->_wDiffCreep;
     _material->_wDiffCreep = "no"; // don't include diffusion creep when computing steady-state
+    _material->setViscosityKernel();
     solveSS(0,_outputDir);
     _material->_wDiffCreep = saveWDiffCreep;
+    _material->setViscosityKernel();
   }
 
-  _material->initiateIntegrand(_initTime,_varEx);
+  _material->initiateIntegrand(_initTime,_varEx,_varIm);
   _fault->initiateIntegrand(_initTime,_varEx);
 
   if (_thermalCoupling.compare("no")!=0) {
@@ -364,22 +435,27 @@ double startTime = MPI_Wtime();
   _deltaT = deltaT;
   _currTime = time;
 
-  if (_stepCount < 50 ) { _stride1D = 1; _stride2D = 1; }
-  else { _stride1D = 100; _stride2D = 100; }
-
-  if ( (_stride1D>0 &&_currTime == _maxTime) || (_stride1D>0 && stepCount % _stride1D == 0)) {
-    ierr = writeStep1D(stepCount,time,_outputDir); CHKERRQ(ierr);
-    ierr = _material->writeStep1D(_outputDir); CHKERRQ(ierr);
-    ierr = _fault->writeStep(_stepCount, _outputDir); CHKERRQ(ierr);
-    if (_hydraulicCoupling.compare("no")!=0) { ierr = _p->writeStep(_stepCount,time,_outputDir); CHKERRQ(ierr); }
-    if (_thermalCoupling.compare("no")!=0) { ierr =  _he->writeStep1D(_stepCount,time,_outputDir); CHKERRQ(ierr); }
+  if (_outputTimes.size() > 0 || _outputInterval > 0) {
+    ierr = writeDenseOutput(); CHKERRQ(ierr);
   }
+  else {
+    if (_stepCount < 50 ) { _stride1D = 1; _stride2D = 1; }
+    else { _stride1D = 100; _stride2D = 100; }
+
+    if ( (_stride1D>0 &&_currTime == _maxTime) || (_stride1D>0 && stepCount % _stride1D == 0)) {
+      ierr = writeStep1D(stepCount,time,_outputDir); CHKERRQ(ierr);
+      ierr = _material->writeStep1D(_outputDir); CHKERRQ(ierr);
+      ierr = _fault->writeStep(_stepCount, _outputDir); CHKERRQ(ierr);
+      if (_hydraulicCoupling.compare("no")!=0) { ierr = _p->writeStep(_stepCount,time,_outputDir); CHKERRQ(ierr); }
+      if (_thermalCoupling.compare("no")!=0) { ierr =  _he->writeStep1D(_stepCount,time,_outputDir); CHKERRQ(ierr); }
+    }
 
-  if ( (_stride2D>0 &&_currTime == _maxTime) || (_stride2D>0 && stepCount % _stride2D == 0)) {
-    ierr = writeStep2D(stepCount,time,_outputDir); CHKERRQ(ierr);
-    ierr = _material->writeStep2D(_outputDir);CHKERRQ(ierr);
-    if (_thermalCoupling.compare("no")!=0) { ierr =  _he->writeStep2D(_stepCount,time,_outputDir);CHKERRQ(ierr); }
-    if (_grainSizeEvCoupling.compare("no")!=0) { ierr =  _grainDist->writeStep(_stepCount,time,_outputDir);CHKERRQ(ierr); }
+    if ( (_stride2D>0 &&_currTime == _maxTime) || (_stride2D>0 && stepCount % _stride2D == 0)) {
+      ierr = writeStep2D(stepCount,time,_outputDir); CHKERRQ(ierr);
+      ierr = _material->writeStep2D(_outputDir);CHKERRQ(ierr);
+      if (_thermalCoupling.compare("no")!=0) { ierr =  _he->writeStep2D(_stepCount,time,_outputDir);CHKERRQ(ierr); }
+      if (_grainSizeEvCoupling.compare("no")!=0) { ierr =  _grainDist->writeStep(_stepCount,time,_outputDir);CHKERRQ(ierr); }
+    }
   }
 
   PetscScalar maxTimeStep_tot, maxDeltaT_momBal = 0.0;
@@ -407,6 +483,84 @@ _writeTime += MPI_Wtime() - startTime;
   return ierr;
 }
 
+// time of the next scheduled output
+PetscScalar StrikeSlip_PowerLaw_qd::nextOutputTime()
+{
+  if (_outputInterval > 0) { return _initTime + _outputCount*_outputInterval; }
+  if (_outputCount < (PetscInt) _outputTimes.size()) { return _outputTimes[_outputCount]; }
+  return PETSC_MAX_REAL;
+}
+
+
+// write out fields at the output times passed during the last time step,
+// using the interpolant of the time integrator over the step
+// stride1D and stride2D then count output times instead of time steps
+PetscErrorCode StrikeSlip_PowerLaw_qd::writeDenseOutput()
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    std::string funcName = "StrikeSlip_PowerLaw_qd::writeDenseOutput";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  bool interpolated = 0;
+  PetscScalar outTime = nextOutputTime();
+  while (outTime <= _currTime) {
+    // output times before the initial time are skipped
+    if (outTime < _currTime && _stepCount == 0) {
+      _outputCount++;
+      outTime = nextOutputTime();
+      continue;
+    }
+
+    // update all fields to the output time, including the effective viscosity
+    if (outTime < _currTime || interpolated) {
+      if (_varOut.size() == 0) {
+        for (map<string,Vec>::iterator it = _varEx.begin(); it != _varEx.end(); it++) {
+          Vec varOut,dvarOut;
+          ierr = VecDuplicate(it->second,&varOut); CHKERRQ(ierr);
+          ierr = VecDuplicate(it->second,&dvarOut); CHKERRQ(ierr);
+          _varOut[it->first] = varOut;
+          _dvarOut[it->first] = dvarOut;
+        }
+      }
+      ierr = _quadEx->interpolate(outTime,_varOut); CHKERRQ(ierr);
+      ierr = _material->markViscosityStale(); CHKERRQ(ierr);
+      ierr = d_dt(outTime,_varOut,_dvarOut); CHKERRQ(ierr);
+      interpolated = 1;
+    }
+
+    if (_stride1D > 0 && _outputCount % _stride1D == 0) {
+      ierr = writeStep1D(_stepCount,outTime,_outputDir); CHKERRQ(ierr);
+      ierr = _material->writeStep1D(_outputDir); CHKERRQ(ierr);
+      ierr = _fault->writeStep(_stepCount, _outputDir); CHKERRQ(ierr);
+      if (_hydraulicCoupling.compare("no")!=0) { ierr = _p->writeStep(_stepCount,outTime,_outputDir); CHKERRQ(ierr); }
+      if (_thermalCoupling.compare("no")!=0) { ierr =  _he->writeStep1D(_stepCount,outTime,_outputDir); CHKERRQ(ierr); }
+    }
+    if (_stride2D > 0 && _outputCount % _stride2D == 0) {
+      ierr = writeStep2D(_stepCount,outTime,_outputDir); CHKERRQ(ierr);
+      ierr = _material->writeStep2D(_outputDir);CHKERRQ(ierr);
+      if (_thermalCoupling.compare("no")!=0) { ierr =  _he->writeStep2D(_stepCount,outTime,_outputDir);CHKERRQ(ierr); }
+      if (_grainSizeEvCoupling.compare("no")!=0) { ierr =  _grainDist->writeStep(_stepCount,outTime,_outputDir);CHKERRQ(ierr); }
+    }
+
+    _outputCount++;
+    outTime = nextOutputTime();
+  }
+
+  // return fields, including the viscosity, to the current time
+  if (interpolated) {
+    ierr = _material->markViscosityStale(); CHKERRQ(ierr);
+    ierr = d_dt(_currTime,_varEx,_dvarOut); CHKERRQ(ierr);
+  }
+
+  #if VERBOSE > 1
+    PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
 PetscErrorCode StrikeSlip_PowerLaw_qd::writeStep1D(PetscInt stepCount, PetscScalar time, const std::string outputDir)
 {
   PetscErrorCode ierr = 0;
@@ -472,7 +626,7 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::view()
   double totRunTime = MPI_Wtime() - _startTime;
 
   if (_timeIntegrator.compare("IMEX")==0&& _quadImex!=NULL) { ierr = _quadImex->view(); }
-  if (_timeIntegrator.compare("RK32")==0 && _quadEx!=NULL) { ierr = _quadEx->view(); }
+  if (_quadEx!=NULL) { ierr = _quadEx->view(); }
 
   _material->view(_integrateTime);
   _fault->view(_integrateTime);
@@ -481,8 +635,13 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::view()
 
   ierr = PetscPrintf(PETSC_COMM_WORLD,"-------------------------------\n\n");CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"StrikeSlip_PowerLaw_qd Runtime Summary:\n");CHKERRQ(ierr);
+  if (_heSched != NULL) { ierr = _heSched->view();CHKERRQ(ierr); }
+  if (_pSched != NULL) { ierr = _pSched->view();CHKERRQ(ierr); }
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent in integration (s): %g\n",_integrateTime);CHKERRQ(ierr);
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   time spent writing output (s): %g\n",_writeTime);CHKERRQ(ierr);
+  if (_outputTimes.size() > 0 || _outputInterval > 0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"   number of dense output times: %i\n",_outputCount);CHKERRQ(ierr);
+  }
   ierr = PetscPrintf(PETSC_COMM_WORLD,"   %% integration time spent writing output: %g\n",_writeTime/totRunTime*100.);CHKERRQ(ierr);
   return ierr;
 }
@@ -505,6 +664,9 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::writeContext()
   ierr = PetscViewerASCIIPrintf(viewer,"thermalCoupling = %s\n",_thermalCoupling.c_str());CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"grainSizeEvolution = %s\n",_grainSizeEvCoupling.c_str());CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"hydraulicCoupling = %s\n",_hydraulicCoupling.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"multirateCoupling = %s\n",_multirateCoupling.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"multirateTol = %.15e\n",_multirateTol);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"multirateDtFactor = %.15e\n",_multirateDtFactor);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"forcingType = %s\n",_forcingType.c_str());CHKERRQ(ierr);
 
   ierr = PetscViewerASCIIPrintf(viewer,"vL = %g\n",_vL);CHKERRQ(ierr);
@@ -527,6 +689,12 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::writeContext()
     ierr = PetscViewerASCIIPrintf(viewer,"scale = %s\n",vector2str(_scale).c_str());CHKERRQ(ierr);
   }
   ierr = PetscViewerASCIIPrintf(viewer,"normType = %s\n",_normType.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"packedState = %s\n",_packedState.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"tsJacobian = %s\n",_tsJacobian.c_str());CHKERRQ(ierr);
+  if (_outputTimes.size() > 0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"outputTimes = %s\n",vector2str(_outputTimes).c_str());CHKERRQ(ierr);
+  }
+  ierr = PetscViewerASCIIPrintf(viewer,"outputInterval = %.15e # (s)\n",_outputInterval);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
 
   // boundary conditions for momentum balance equation
@@ -581,6 +749,21 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::integrate()
   else if (_timeIntegrator.compare("RK43")==0) {
     _quadEx = new RK43(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
   }
+  else if (_timeIntegrator.compare("RK32_2N")==0) {
+    _quadEx = new RK32_2N(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK43_2N")==0) {
+    _quadEx = new RK43_2N(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK54")==0) {
+    _quadEx = new RK54(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK65")==0) {
+    _quadEx = new RK65(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("TSARKIMEX")==0 || _timeIntegrator.compare("TSROSW")==0 || _timeIntegrator.compare("TSBDF")==0) {
+    _quadEx = new OdeSolver_TS(_maxStepCount,_maxTime,_initDeltaT,_timeControlType,_timeIntegrator,_tsJacobian);
+  }
   else if (_timeIntegrator.compare("RK32_WBE")==0) {
     _quadImex = new RK32_WBE(_maxStepCount,_maxTime,_initDeltaT,_timeControlType);
   }
@@ -596,6 +779,7 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::integrate()
     _quadImex->setTolerance(_timeStepTol);CHKERRQ(ierr);
     _quadImex->setTimeStepBounds(_minDeltaT,_maxDeltaT);CHKERRQ(ierr);
     ierr = _quadImex->setTimeRange(_initTime,_maxTime);
+    ierr = _quadImex->setPackedState(_packedState.compare("yes")==0);CHKERRQ(ierr);
     ierr = _quadImex->setInitialConds(_varEx,_varIm);CHKERRQ(ierr);
     ierr = _quadImex->setToleranceType(_normType); CHKERRQ(ierr);
     ierr = _quadImex->setErrInds(_timeIntInds,_scale); // control which fields are used to select step size
@@ -611,6 +795,8 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::integrate()
     _quadEx->setTimeStepBounds(_minDeltaT,_maxDeltaT);CHKERRQ(ierr);
     ierr = _quadEx->setTimeRange(_initTime,_maxTime);
     ierr = _quadEx->setToleranceType(_normType); CHKERRQ(ierr);
+    ierr = _quadEx->setPackedState(_packedState.compare("yes")==0);CHKERRQ(ierr);
+    ierr = _quadEx->setDenseOutput(_outputTimes.size() > 0 || _outputInterval > 0);CHKERRQ(ierr);
     ierr = _quadEx->setInitialConds(_varEx);CHKERRQ(ierr);
     ierr = _quadEx->setErrInds(_timeIntInds,_scale); // control which fields are used to select step size
 
@@ -687,6 +873,34 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::d_dt(const PetscScalar time,const map<str
 }
 
 
+// If the effective viscosity is lagged, the last stage of each step uses a
+// fresh value, and the difference from the lagged one is added to the error
+// estimate, so a step over which lagging was unsafe is rejected.
+PetscErrorCode StrikeSlip_PowerLaw_qd::beginLastStage()
+{
+  return _material->measureViscosityLag();
+}
+
+PetscErrorCode StrikeSlip_PowerLaw_qd::stepError(PetscScalar& err)
+{
+  return _material->getViscosityLagError(err);
+}
+
+// the viscosity computed from a discarded trial state must not be reused
+PetscErrorCode StrikeSlip_PowerLaw_qd::stepRejected()
+{
+  return _material->markViscosityStale();
+}
+
+// the viscosity used by f(t,var) at the accepted solution, and so by the next
+// step, must be computed at that solution
+PetscErrorCode StrikeSlip_PowerLaw_qd::stepAccepted(const bool lastStageIsSolution)
+{
+  if (lastStageIsSolution) { return 0; } // the last stage was fresh
+  return _material->markViscosityStale();
+}
+
+
 
 // implicit/explicit time stepping
 PetscErrorCode StrikeSlip_PowerLaw_qd::d_dt(const PetscScalar time,const map<string,Vec>& varEx,map<string,Vec>& dvarEx, map<string,Vec>& varIm,const map<string,Vec>& varImo,const PetscScalar dt)
@@ -709,7 +923,7 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::d_dt(const PetscScalar time,const map<str
     ierr = VecAXPY(_material->_bcR,1.0,_material->_bcRShift);CHKERRQ(ierr);
   }
 
-  _material->updateFields(time,varEx);
+  _material->updateFields(time,varEx,varImo);
   _fault->updateFields(time,varEx);
 
   if ( varImo.find("pressure") != varImo.end() || varEx.find("pressure") != varEx.end()) {
@@ -737,7 +951,25 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::d_dt(const PetscScalar time,const map<str
   // 2. compute rates
   ierr = solveMomentumBalance(time,varEx,dvarEx); CHKERRQ(ierr);
 
-  if ( varImo.find("pressure") != varImo.end() || varEx.find("pressure") != varEx.end()) {
+  // pressure: with multirate coupling, implicit pressure is only advanced when
+  // its scheduler says so, using the time since it was last advanced
+  if (_pSched != NULL && varIm.find("pressure") != varIm.end()) {
+    vector<Vec> coupling;
+    if (varEx.find("permeability") != varEx.end()) { coupling.push_back(varEx.find("permeability")->second); }
+    bool isDue = 0;
+    ierr = _pSched->accumulate(dt,coupling); CHKERRQ(ierr);
+    ierr = _pSched->isDue(isDue); CHKERRQ(ierr);
+    if (isDue) {
+      ierr = _p->d_dt(time,varEx,dvarEx,varIm,varImo,_pSched->_elapsed); CHKERRQ(ierr);
+      ierr = _pSched->completeUpdate(coupling); CHKERRQ(ierr);
+      ierr = setMultirateMaxTimeSteps(); CHKERRQ(ierr);
+    }
+    else {
+      ierr = _p->d_dt(time,varEx,dvarEx); CHKERRQ(ierr); // permeability rate only
+      ierr = VecCopy(varImo.find("pressure")->second,varIm["pressure"]); CHKERRQ(ierr);
+    }
+  }
+  else if ( varImo.find("pressure") != varImo.end() || varEx.find("pressure") != varEx.end()) {
     _p->d_dt(time,varEx,dvarEx,varIm,varImo,dt);
   }
 
@@ -760,6 +992,12 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::d_dt(const PetscScalar time,const map<str
   }
 
   // 3. implicitly integrated variables
+
+  // viscous strains, which also updates stresses and viscous strain rates
+  if ( varIm.find("gVxy") != varIm.end() ) {
+    ierr = _material->be(time,varIm["gVxy"],varIm["gVxz"],varImo.find("gVxy")->second,varImo.find("gVxz")->second,dt); CHKERRQ(ierr);
+  }
+
   if ( varIm.find("grainSize") != varIm.end() ) {
     _grainDist->be(varIm["grainSize"],varImo.find("grainSize")->second,time,_material->_sdev,_material->_dgVdev_disl,_material->_T,dt);
   }
@@ -770,11 +1008,32 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::d_dt(const PetscScalar time,const map<str
     _material->getStresses(sxy,sxz,sdev);
     Vec V = dvarEx.find("slip")->second;
     Vec tau = _fault->_tauP;
-    Vec gVxy_t = dvarEx.find("gVxy")->second;
-    Vec gVxz_t = dvarEx.find("gVxz")->second;
+    Vec gVxy_t = _material->_dgVxy;
+    Vec gVxz_t = _material->_dgVxz;
+    if (dvarEx.find("gVxy") != dvarEx.end()) {
+      gVxy_t = dvarEx.find("gVxy")->second;
+      gVxz_t = dvarEx.find("gVxz")->second;
+    }
     Vec Told = varImo.find("Temp")->second;
-    ierr = _he->be(time,V,tau,sdev,gVxy_t,gVxz_t,varIm["Temp"],Told,dt); CHKERRQ(ierr);
-    // arguments: time, slipVel, txy, sigmadev, dgxy, dgxz, T, old T, dt
+    if (_heSched != NULL) {
+      // multirate: advance by the time since the last update, with time-averaged sources
+      vector<Vec> coupling = {V,tau,sdev,gVxy_t,gVxz_t}, avg;
+      bool isDue = 0;
+      ierr = _heSched->accumulate(dt,coupling); CHKERRQ(ierr);
+      ierr = _heSched->isDue(isDue); CHKERRQ(ierr);
+      if (isDue) {
+        ierr = _heSched->getAverage(avg); CHKERRQ(ierr);
+        ierr = _he->be(time,avg[0],avg[1],avg[2],avg[3],avg[4],varIm["Temp"],Told,_heSched->_elapsed); CHKERRQ(ierr);
+        ierr = _heSched->completeUpdate(coupling); CHKERRQ(ierr);
+      }
+      else {
+        ierr = VecCopy(Told,varIm["Temp"]); CHKERRQ(ierr);
+      }
+    }
+    else {
+      ierr = _he->be(time,V,tau,sdev,gVxy_t,gVxz_t,varIm["Temp"],Told,dt); CHKERRQ(ierr);
+      // arguments: time, slipVel, txy, sigmadev, dgxy, dgxz, T, old T, dt
+    }
   }
 
   #if VERBOSE > 1
@@ -783,6 +1042,22 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::d_dt(const PetscScalar time,const map<str
   return ierr;
 }
 
+// max time steps for multirate coupling, from each physics' own time step limit
+PetscErrorCode StrikeSlip_PowerLaw_qd::setMultirateMaxTimeSteps()
+{
+  PetscErrorCode ierr = 0;
+  PetscScalar maxDeltaT = 0;
+  if (_heSched != NULL) {
+    ierr = _he->computeMaxTimeStep(maxDeltaT); CHKERRQ(ierr);
+    ierr = _heSched->setMaxTimeStep(_multirateDtFactor * maxDeltaT); CHKERRQ(ierr);
+  }
+  if (_pSched != NULL) {
+    ierr = _p->computeMaxTimeStep(maxDeltaT); CHKERRQ(ierr);
+    ierr = _pSched->setMaxTimeStep(_multirateDtFactor * maxDeltaT); CHKERRQ(ierr);
+  }
+  return ierr;
+}
+
 // momentum balance equation and constitutive laws portion of d_dt
 PetscErrorCode StrikeSlip_PowerLaw_qd::solveMomentumBalance(const PetscScalar time,const map<string,Vec>& varEx,map<string,Vec>& dvarEx)
 {
@@ -811,12 +1086,18 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::solveMomentumBalance(const PetscScalar ti
   // update stresses, viscosity, and set shear traction on fault
   ierr = _material->computeTotalStrains(); CHKERRQ(ierr);
   ierr = _material->computeStresses(); CHKERRQ(ierr);
-  ierr = _material->computeViscosity(_material->_effViscCap); CHKERRQ(ierr);
+  ierr = _material->updateViscosity(); CHKERRQ(ierr);
 
   // compute viscous strain rates
-  Vec gVxy = varEx.find("gVxy")->second;
-  Vec gVxz = varEx.find("gVxz")->second;
-  ierr = _material->computeViscStrainRates(time,gVxy,gVxz,dvarEx["gVxy"],dvarEx["gVxz"]); CHKERRQ(ierr);
+  // (if integrated implicitly, only the material's copy of the rates is set)
+  if (varEx.find("gVxy") != varEx.end()) {
+    Vec gVxy = varEx.find("gVxy")->second;
+    Vec gVxz = varEx.find("gVxz")->second;
+    ierr = _material->computeViscStrainRates(time,gVxy,gVxz,dvarEx["gVxy"],dvarEx["gVxz"]); CHKERRQ(ierr);
+  }
+  else {
+    ierr = _material->computeViscStrainRates(time,_material->_gVxy,_material->_gVxz,_material->_dgVxy,_material->_dgVxz); CHKERRQ(ierr);
+  }
   //~ if (_isMMS) { _material->addViscStrainRates_MMSSource(time,dvarEx["gVxy"],dvarEx["gVxz"]); }
 
   return ierr;
@@ -850,6 +1131,20 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::integrateSS()
   writeSS(Jj,baseOutDir);
   Jj = 1;
 
+  // Anderson acceleration of the outer iteration, applied to the fault shear
+  // stress (and temperature) each time a new shear stress has been computed
+  AndersonAcceleration aaTot(_andersonDepthSS_tot,1.0);
+  vector<Vec> xTot,gTot;
+  if (_andersonDepthSS_tot > 0) {
+    gTot.push_back(_varSS["tau"]);
+    if (_thermalCoupling.compare("no")!=0) { gTot.push_back(_varSS["Temp"]); }
+    xTot.resize(gTot.size());
+    for (size_t c = 0; c < gTot.size(); c++) {
+      VecDuplicate(gTot[c],&xTot[c]);
+      VecCopy(gTot[c],xTot[c]);
+    }
+  }
+
   // iterate to converge to steady-state solution
   while (Jj < _maxSSIts_tot) {
     PetscPrintf(PETSC_COMM_WORLD,"Jj = %i\n",Jj);
@@ -857,6 +1152,16 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::integrateSS()
     // brute force time integrate for steady-state shear stress the fault
     solveSStau(Jj,baseOutDir);
 
+    if (_andersonDepthSS_tot > 0) {
+      ierr = aaTot.update(xTot,gTot); CHKERRQ(ierr);
+      for (size_t c = 0; c < gTot.size(); c++) { VecCopy(gTot[c],xTot[c]); }
+      if (_thermalCoupling.compare("no")!=0) { VecWAXPY(_he->_dT,-1.0,_he->_Tamb,_varSS["Temp"]); }
+      if (_thermalCoupling.compare("coupled")==0) {
+        _material->updateTemperature(_varSS["Temp"]);
+        _fault->updateTemperature(_varSS["Temp"]);
+      }
+    }
+
     //~ // iterate to find effective viscosity etc
     solveSSViscoelasticProblem(Jj,baseOutDir);
 
@@ -874,6 +1179,7 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::integrateSS()
     writeSS(Jj,baseOutDir);
     Jj++;
   }
+  for (size_t c = 0; c < xTot.size(); c++) { VecDestroy(&xTot[c]); }
 
 
   _integrateTime += MPI_Wtime() - startTime;
@@ -974,6 +1280,7 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::solveSStau(const PetscInt Jj, const std::
   // set up to begin time integration
   _stepCount = 0;
   _currTime = _initTime;
+  _outputCount = 0;
   _material->initiateIntegrand(_initTime,_varEx);
   _fault->initiateIntegrand(_initTime,_varEx);
 
@@ -984,6 +1291,21 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::solveSStau(const PetscInt Jj, const std::
   else if (_timeIntegrator.compare("RK43")==0) {
     _quadEx = new RK43(_maxSSIts_timesteps,_maxTime,_initDeltaT,_timeControlType);
   }
+  else if (_timeIntegrator.compare("RK32_2N")==0) {
+    _quadEx = new RK32_2N(_maxSSIts_timesteps,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK43_2N")==0) {
+    _quadEx = new RK43_2N(_maxSSIts_timesteps,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK54")==0) {
+    _quadEx = new RK54(_maxSSIts_timesteps,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK65")==0) {
+    _quadEx = new RK65(_maxSSIts_timesteps,_maxTime,_initDeltaT,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("TSARKIMEX")==0 || _timeIntegrator.compare("TSROSW")==0 || _timeIntegrator.compare("TSBDF")==0) {
+    _quadEx = new OdeSolver_TS(_maxSSIts_timesteps,_maxTime,_initDeltaT,_timeControlType,_timeIntegrator,_tsJacobian);
+  }
   else {
     PetscPrintf(PETSC_COMM_WORLD,"ERROR: time integrator type not acceptable for fixed point iteration method.\n");
     assert(0);
@@ -992,6 +1314,8 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::solveSStau(const PetscInt Jj, const std::
   ierr = _quadEx->setTimeStepBounds(_minDeltaT,_maxDeltaT);CHKERRQ(ierr);
   ierr = _quadEx->setTimeRange(_initTime,_maxTime); CHKERRQ(ierr);
   ierr = _quadEx->setToleranceType(_normType); CHKERRQ(ierr);
+  ierr = _quadEx->setPackedState(_packedState.compare("yes")==0);CHKERRQ(ierr);
+  ierr = _quadEx->setDenseOutput(_outputTimes.size() > 0 || _outputInterval > 0);CHKERRQ(ierr);
   ierr = _quadEx->setInitialConds(_varEx);CHKERRQ(ierr);
   ierr = _quadEx->setErrInds(_timeIntInds);
   ierr = _quadEx->integrate(this);CHKERRQ(ierr);
@@ -1047,6 +1371,11 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::solveSSViscoelasticProblem(const PetscInt
   // loop over effective viscosity
   Vec effVisc_old; VecDuplicate(_varSS["effVisc"],&effVisc_old);
   Vec temp; VecDuplicate(_varSS["effVisc"],&temp); VecSet(temp,0.);
+
+  // for Anderson acceleration, which is applied to log(effective viscosity)
+  AndersonAcceleration aa(_andersonDepthSS_effVisc,_fss_EffVisc);
+  vector<Vec> xLog(1,temp),gLog(1,NULL);
+  VecDuplicate(temp,&gLog[0]);
   double err = 1e10;
   int Ii = 0;
   while (Ii < _maxSSIts_effVisc && err >= _atolSS_effVisc) {
@@ -1059,8 +1388,18 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::solveSSViscoelasticProblem(const PetscInt
     //~ VecAXPY(_varSS["effVisc"],1.-_fss_EffVisc,effVisc_old);
 
     // update effective viscosity: log10(accepted viscosity) = (1-f)*log10(old viscosity) + f*log10(new viscosity):
-    MyVecLog10AXPBY(temp,1.-_fss_EffVisc,effVisc_old,_fss_EffVisc,_varSS["effVisc"]);
-    VecCopy(temp,_varSS["effVisc"]);
+    if (_andersonDepthSS_effVisc == 0) {
+      MyVecLog10AXPBY(temp,1.-_fss_EffVisc,effVisc_old,_fss_EffVisc,_varSS["effVisc"]);
+      VecCopy(temp,_varSS["effVisc"]);
+    }
+    // or accelerated version of the same iteration
+    else {
+      VecCopy(effVisc_old,xLog[0]); VecLog(xLog[0]);
+      VecCopy(_varSS["effVisc"],gLog[0]); VecLog(gLog[0]);
+      ierr = aa.update(xLog,gLog); CHKERRQ(ierr);
+      VecExp(gLog[0]);
+      VecCopy(gLog[0],_varSS["effVisc"]);
+    }
 
     // write out results for current iteration
     ierr = VecView(_varSS["effVisc"],vw["effViscTot"].first); CHKERRQ(ierr);
@@ -1082,6 +1421,10 @@ PetscErrorCode StrikeSlip_PowerLaw_qd::solveSSViscoelasticProblem(const PetscInt
   }
   VecDestroy(&effVisc_old);
   VecDestroy(&temp);
+  VecDestroy(&gLog[0]);
+  if (aa._numRestarts > 0) {
+    PetscPrintf(PETSC_COMM_WORLD,"    effective viscosity loop: Anderson history discarded %i times\n",aa._numRestarts);
+  }
 
   // destroy viewers for steady state iteration
   map<string,std::pair<PetscViewer,string> >::iterator it;
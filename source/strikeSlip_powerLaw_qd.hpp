@@ -14,6 +14,7 @@
 
 #include "odeSolver.hpp"
 #include "odeSolverImex.hpp"
+#include "odeSolver_TS.hpp"
 #include "genFuncs.hpp"
 #include "domain.hpp"
 #include "sbpOps.hpp"
@@ -24,6 +25,8 @@
 #include "heatEquation.hpp"
 #include "powerLaw.hpp"
 #include "grainSizeEvolution.hpp"
+#include "andersonAcceleration.hpp"
+#include "multirateScheduler.hpp"
 
 using namespace std;
 
@@ -63,6 +66,13 @@ public:
   PetscScalar     _vL;
   PetscScalar     _faultTypeScale; // = 2 if symmetric fault, 1 if one side of fault is rigid
 
+  // multirate coupling: the implicitly integrated heat and pressure equations are
+  // only advanced when their own max time step is reached or their coupling terms change
+  string              _multirateCoupling; // "no" or "yes"
+  PetscScalar         _multirateTol; // relative change in coupling terms that forces an update
+  PetscScalar         _multirateDtFactor; // max time step = factor * diffusion time across one grid cell
+  MultirateScheduler *_heSched,*_pSched;
+
   // time stepping data
   map <string,Vec>  _varEx; // holds variables for explicit integration in time
   map <string,Vec>  _varIm; // holds variables for implicit integration in time
@@ -76,6 +86,15 @@ public:
   vector<string>    _timeIntInds; // indices of variables to be used in time integration
   vector<double>    _scale; // scale factor for entries in _timeIntInds
   string            _normType;
+  string            _packedState; // store integrated variables in one contiguous Vec
+  string            _tsJacobian; // preconditioner for the PETSc TS integrators: mf or diagonal
+
+  // dense output: write at scheduled times, interpolated by the time
+  // integrator, instead of every stride1D/stride2D time steps
+  vector<double>    _outputTimes; // list of output times (s)
+  PetscScalar       _outputInterval; // or spacing of uniformly spaced output times (s)
+  PetscInt          _outputCount; // number of output times passed
+  map<string,Vec>   _varOut,_dvarOut; // integrated variables and rates at an output time
 
 
   // runtime data
@@ -114,6 +133,7 @@ public:
   PetscErrorCode checkInput();
   PetscErrorCode parseBCs(); // parse boundary conditions
   PetscErrorCode constructIceStreamForcingTerm(); // ice stream forcing term
+  PetscErrorCode setMultirateMaxTimeSteps();
 
   // estimating steady state conditions
   // viewers:
@@ -127,6 +147,7 @@ public:
   PetscScalar                                       _gss_t; // guess steady state strain rate
   PetscInt                 _maxSSIts_effVisc,_maxSSIts_tot,_maxSSIts_timesteps; // max iterations allowed
   PetscScalar              _atolSS_effVisc;
+  PetscInt                 _andersonDepthSS_effVisc,_andersonDepthSS_tot; // Anderson acceleration depth, 0 = plain fixed-point iteration
 
   PetscErrorCode writeSS(const int Ii, const string outputDir);
   PetscErrorCode computeSSEffVisc();
@@ -149,6 +170,12 @@ public:
   // explicit time-stepping methods
   PetscErrorCode d_dt(const PetscScalar time,const map<string,Vec>& varEx,map<string,Vec>& dvarEx);
 
+  // step hooks of the explicit Runge-Kutta methods, for lagging the effective viscosity
+  PetscErrorCode beginLastStage();
+  PetscErrorCode stepError(PetscScalar& err);
+  PetscErrorCode stepRejected();
+  PetscErrorCode stepAccepted(const bool lastStageIsSolution);
+
   // methods for implicit/explicit time stepping
   PetscErrorCode d_dt(const PetscScalar time,const map<string,Vec>& varEx,map<string,Vec>& dvarEx, map<string,Vec>& varIm,const map<string,Vec>& varImo,const PetscScalar dt);
 
@@ -159,6 +186,8 @@ public:
   PetscErrorCode timeMonitor(PetscScalar time, PetscScalar deltaT, PetscInt stepCount, int& stopIntegration);
   PetscErrorCode writeStep1D(PetscInt stepCount, PetscScalar time, const string outputDir);
   PetscErrorCode writeStep2D(PetscInt stepCount, PetscScalar time, const string outputDir);
+  PetscErrorCode writeDenseOutput(); // write fields at output times passed in the last time step
+  PetscScalar nextOutputTime();
 
   // debugging and MMS tests
   PetscErrorCode measureMMSError();
@@ -13,13 +13,16 @@ StrikeSlip_PowerLaw_qd_fd::StrikeSlip_PowerLaw_qd_fd(Domain&D)
   _guessSteadyStateICs(0),_forcingType("no"),_faultTypeScale(2.0),
   _cycleCount(0),_maxNumCycles(1e3),_deltaT(1e-3),_deltaT_fd(-1),_CFL(0.5),
   _ay(NULL),_Fhat(NULL),_alphay(NULL),
+  _waveOp(NULL),_waveCu(NULL),_waveCuPrev(NULL),_faultD2uScale(NULL),_waveDeltaT(0),
+  _pml("no"),_pmlThickness(-1),_pmlR(1e-3),_pmlLayer(NULL),_waveCf(NULL),
   _inDynamic(false),_allowed(false), _trigger_qd2fd(1e-3), _trigger_fd2qd(1e-3),
   _limit_qd(10*_vL), _limit_fd(1e-1),_limit_stride_fd(1e-2),_u0(NULL),
   _timeIntegrator("RK32"),_timeControlType("PID"),
   _stride1D(1),_stride2D(1),_maxStepCount(1e8),
   _initTime(0),_currTime(0),_maxTime(1e15),
   _minDeltaT(1e-3),_maxDeltaT(1e10),
-  _stepCount(0),_timeStepTol(1e-8),_initDeltaT(1e-3),_normType("L2_absolute"),
+  _stepCount(0),_timeStepTol(1e-8),_initDeltaT(1e-3),_normType("L2_absolute"),_packedState("no"),_tsJacobian("mf"),
+  _eventDetection("no"),_eventTol(1e-3),
   _integrateTime(0),_writeTime(0),_linSolveTime(0),_factorTime(0),
   _startTime(MPI_Wtime()),_miscTime(0),
   _timeV1D(NULL),_dtimeV1D(NULL),_timeV2D(NULL),_dtimeV2D(NULL),_regime1DV(NULL),_regime2DV(NULL),_forcingVal(0),
@@ -42,6 +45,15 @@ StrikeSlip_PowerLaw_qd_fd::StrikeSlip_PowerLaw_qd_fd(Domain&D)
 
   // initiate momentum balance equation
   _material = new PowerLaw(D,_mat_qd_bcRType,_mat_qd_bcTType,_mat_qd_bcLType,_mat_qd_bcBType);
+  if (_material->_viscStrainTimeIntType.compare("explicit")!=0) {
+    PetscPrintf(PETSC_COMM_WORLD,"ERROR: viscStrainTimeIntType = implicit is not supported for switching between quasi-dynamic and fully dynamic.\n");
+    assert(0);
+  }
+  // the viscosity is only refreshed by the step hooks of StrikeSlip_PowerLaw_qd
+  if (_material->_lagViscosity.compare("yes")==0) {
+    PetscPrintf(PETSC_COMM_WORLD,"ERROR: lagViscosity = yes is not supported for switching between quasi-dynamic and fully dynamic.\n");
+    assert(0);
+  }
 
   if ( _thermalCoupling.compare("no")!=0 ) {
     _he = new HeatEquation(D); // heat equation
@@ -68,6 +80,13 @@ StrikeSlip_PowerLaw_qd_fd::StrikeSlip_PowerLaw_qd_fd(Domain&D)
   }
 
   computePenaltyVectors();
+  if (_pml.compare("yes")==0) {
+    _pmlLayer = new PerfectlyMatchedLayer(D,_pmlThickness,_pmlR);
+    _pmlLayer->setFields(_material->_sbp,_material->_mu,_material->_rho,_material->_cs);
+    // the layer's damping also acts on fault nodes inside it
+    VecScatterBegin(*_body2fault, _pmlLayer->_damping, _fault_fd->_pmlDamping, INSERT_VALUES, SCATTER_FORWARD);
+    VecScatterEnd(*_body2fault, _pmlLayer->_damping, _fault_fd->_pmlDamping, INSERT_VALUES, SCATTER_FORWARD);
+  }
   computeTimeStep(); // compute fully dynamic time step
 
   // body forcing term for ice stream
@@ -119,6 +138,12 @@ StrikeSlip_PowerLaw_qd_fd::~StrikeSlip_PowerLaw_qd_fd()
   VecDestroy(&_u0);
   VecDestroy(&_Fhat);
   VecDestroy(&_ay);
+  MatDestroy(&_waveOp);
+  VecDestroy(&_waveCu);
+  VecDestroy(&_waveCuPrev);
+  VecDestroy(&_faultD2uScale);
+  VecDestroy(&_waveCf);
+  delete _pmlLayer; _pmlLayer = NULL;
 
 
   delete _quadImex;    _quadImex = NULL;
@@ -213,6 +238,10 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::loadSettings(const char *file)
     else if (var.compare("timeIntInds")==0) { loadVectorFromInputFile(rhsFull,_timeIntInds); }
     else if (var.compare("scale")==0) { loadVectorFromInputFile(rhsFull,_scale); }
     else if (var.compare("normType")==0) { _normType = rhs.c_str(); }
+    else if (var.compare("packedState")==0) { _packedState = rhs.c_str(); }
+    else if (var.compare("tsJacobian")==0) { _tsJacobian = rhs.c_str(); }
+    else if (var.compare("eventDetection")==0) { _eventDetection = rhs.c_str(); }
+    else if (var.compare("eventTol")==0) { _eventTol = atof( rhs.c_str() ); }
     else if (var.compare("vL")==0) { _vL = atof( rhs.c_str() ); }
 
     else if (var.compare("bodyForce")==0) { _forcingVal = atof( rhs.c_str() ); }
@@ -236,6 +265,9 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::loadSettings(const char *file)
 
     else if (var.compare("deltaT_fd")==0) { _deltaT_fd = atof( rhs.c_str() ); }
     else if (var.compare("CFL")==0) { _CFL = atof( rhs.c_str() ); }
+    else if (var.compare("pml")==0) { _pml = rhs.c_str(); }
+    else if (var.compare("pmlThickness")==0) { _pmlThickness = atof( rhs.c_str() ); }
+    else if (var.compare("pmlReflection")==0) { _pmlR = atof( rhs.c_str() ); }
     else if (var.compare("maxNumCycles")==0) { _maxNumCycles = atoi( rhs.c_str() ); }
   }
 
@@ -271,8 +303,33 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::checkInput()
   assert(_timeIntegrator.compare("FEuler")==0 ||
       _timeIntegrator.compare("RK32")==0 ||
       _timeIntegrator.compare("RK43")==0 ||
+      _timeIntegrator.compare("RK32_2N")==0 ||
+      _timeIntegrator.compare("RK43_2N")==0 ||
+      _timeIntegrator.compare("RK54")==0 ||
+      _timeIntegrator.compare("RK65")==0 ||
       _timeIntegrator.compare("RK32_WBE")==0 ||
-      _timeIntegrator.compare("RK43_WBE")==0 );
+      _timeIntegrator.compare("RK43_WBE")==0 ||
+      _timeIntegrator.compare("TSARKIMEX")==0 ||
+      _timeIntegrator.compare("TSROSW")==0 ||
+      _timeIntegrator.compare("TSBDF")==0 );
+
+  assert(_packedState.compare("yes")==0 || _packedState.compare("no")==0);
+  assert(_tsJacobian.compare("mf")==0 || _tsJacobian.compare("diagonal")==0);
+  assert(_eventDetection.compare("yes")==0 || _eventDetection.compare("no")==0);
+  assert(_eventTol > 0 && _eventTol < 1);
+  if (_eventDetection.compare("yes")==0) {
+    // event detection uses the dense output of the explicit Runge-Kutta methods
+    assert(_timeIntegrator.compare("RK32")==0 ||
+      _timeIntegrator.compare("RK43")==0 ||
+      _timeIntegrator.compare("RK54")==0 ||
+      _timeIntegrator.compare("RK65")==0 );
+  }
+
+  assert(_pml.compare("yes")==0 || _pml.compare("no")==0);
+  if (_pml.compare("yes")==0) {
+    assert(_pmlThickness > 0);
+    assert(_pmlR > 0 && _pmlR < 1);
+  }
 
   assert(_timeControlType.compare("P")==0 ||
          _timeControlType.compare("PI")==0 ||
@@ -372,12 +429,10 @@ bool StrikeSlip_PowerLaw_qd_fd::checkSwitchRegime(const Fault* _fault)
   //~ VecDestroy(&absSlipVel);
 
   // if using R = eta*V / tauQS
-  Vec R; VecDuplicate(_fault->_slipVel,&R);
-  VecPointwiseMult(R,_fault_qd->_eta_rad,_fault->_slipVel);
-  VecPointwiseDivide(R,R,_fault->_tauQSP);
+  PetscErrorCode ierr = 0;
   PetscScalar maxV;
-  VecMax(R,NULL,&maxV);
-  VecDestroy(&R);
+  ierr = computeMaxR(_fault->_slipVel,_fault->_tauQSP,maxV);
+  CHKERRABORT(PETSC_COMM_WORLD,ierr);
 
 
   // if integrating past allowed time or step count, force switching now
@@ -413,6 +468,47 @@ bool StrikeSlip_PowerLaw_qd_fd::checkSwitchRegime(const Fault* _fault)
 }
 
 
+// max over the fault of R = eta*V / tauQS, with a single reduction
+PetscErrorCode StrikeSlip_PowerLaw_qd_fd::computeMaxR(const Vec& slipVel,const Vec& tauQS,PetscScalar& maxR)
+{
+  PetscErrorCode ierr = 0;
+
+  PetscScalar const *eta,*V,*tau;
+  PetscInt Istart,Iend;
+  ierr = VecGetOwnershipRange(slipVel,&Istart,&Iend);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(_fault_qd->_eta_rad,&eta);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(slipVel,&V);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(tauQS,&tau);CHKERRQ(ierr);
+  PetscScalar maxLocal = -PETSC_MAX_REAL;
+  for (PetscInt Jj = 0; Jj < Iend-Istart; Jj++) {
+    maxLocal = max(maxLocal, eta[Jj]*V[Jj]/tau[Jj]);
+  }
+  ierr = VecRestoreArrayRead(_fault_qd->_eta_rad,&eta);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(slipVel,&V);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(tauQS,&tau);CHKERRQ(ierr);
+
+  ierr = MPI_Allreduce(&maxLocal,&maxR,1,MPIU_SCALAR,MPI_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  return ierr;
+}
+
+
+// event function for locating the switch from quasidynamic to fully dynamic:
+// g = max(R) - trigger_qd2fd, with V from the interpolated slip rate and
+// tauQS from the last evaluation of d_dt (at the end of the step)
+// g < 0 while switching is not yet allowed
+PetscErrorCode StrikeSlip_PowerLaw_qd_fd::eventFunction(const PetscReal time,const map<string,Vec>& var,const map<string,Vec>& dvar,PetscScalar& g)
+{
+  PetscErrorCode ierr = 0;
+  g = -1.0;
+  if (_inDynamic || !_allowed) { return ierr; }
+
+  PetscScalar maxR = 0;
+  ierr = computeMaxR(dvar.find("slip")->second,_fault_qd->_tauQSP,maxR);CHKERRQ(ierr);
+  g = maxR - _trigger_qd2fd;
+  return ierr;
+}
+
+
 // compute allowed time step based on CFL condition and user input
 PetscErrorCode StrikeSlip_PowerLaw_qd_fd::computeTimeStep()
 {
@@ -736,7 +832,7 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::view()
   double totRunTime = MPI_Wtime() - _startTime;
 
   if (_timeIntegrator.compare("IMEX")==0&& _quadImex!=NULL) { ierr = _quadImex->view(); }
-  if (_timeIntegrator.compare("RK32")==0 && _quadEx!=NULL) { ierr = _quadEx->view(); }
+  if (_quadEx!=NULL) { ierr = _quadEx->view(); }
 
   _material->view(_integrateTime);
   _fault_qd->view(_integrateTime);
@@ -790,6 +886,10 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::writeContext()
     ierr = PetscViewerASCIIPrintf(viewer,"scale = %s\n",vector2str(_scale).c_str());CHKERRQ(ierr);
   }
   ierr = PetscViewerASCIIPrintf(viewer,"normType = %s\n",_normType.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"packedState = %s\n",_packedState.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"tsJacobian = %s\n",_tsJacobian.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"eventDetection = %s\n",_eventDetection.c_str());CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"eventTol = %.15e\n",_eventTol);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
 
   ierr = PetscViewerASCIIPrintf(viewer,"stride1D_qd = %i\n",_stride1D_qd);CHKERRQ(ierr);
@@ -807,6 +907,11 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::writeContext()
   ierr = PetscViewerASCIIPrintf(viewer,"limit_stride_fd = %.15e\n",_limit_stride_fd);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"CFL = %.15e\n",_CFL);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"deltaT_fd = %.15e\n",_deltaT_fd);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"pml = %s\n",_pml.c_str());CHKERRQ(ierr);
+  if (_pml.compare("yes")==0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"pmlThickness = %.15e # (km)\n",_pmlThickness);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"pmlReflection = %.15e\n",_pmlR);CHKERRQ(ierr);
+  }
   ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
 
   // boundary conditions for momentum balance equation
@@ -928,6 +1033,21 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::integrate_qd()
   else if (_timeIntegrator.compare("RK43")==0) {
     _quadEx = new RK43(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
   }
+  else if (_timeIntegrator.compare("RK32_2N")==0) {
+    _quadEx = new RK32_2N(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK43_2N")==0) {
+    _quadEx = new RK43_2N(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK54")==0) {
+    _quadEx = new RK54(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK65")==0) {
+    _quadEx = new RK65(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("TSARKIMEX")==0 || _timeIntegrator.compare("TSROSW")==0 || _timeIntegrator.compare("TSBDF")==0) {
+    _quadEx = new OdeSolver_TS(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType,_timeIntegrator,_tsJacobian);
+  }
   else if (_timeIntegrator.compare("RK32_WBE")==0) {
     _quadImex = new RK32_WBE(_maxStepCount,_maxTime,_deltaT_fd,_timeControlType);
   }
@@ -945,6 +1065,7 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::integrate_qd()
     _quadImex->setTimeStepBounds(_minDeltaT,_maxDeltaT);
     _quadImex->setTimeRange(_currTime,_maxTime);
     _quadImex->setInitialStepCount(_stepCount);
+    _quadImex->setPackedState(_packedState.compare("yes")==0);
     _quadImex->setInitialConds(_varQSEx,_varIm);
     _quadImex->setToleranceType(_normType);
     _quadImex->setErrInds(_timeIntInds,_scale);
@@ -962,6 +1083,8 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::integrate_qd()
     _quadEx->setTimeRange(_currTime,_maxTime);
     _quadEx->setInitialStepCount(_stepCount);
     _quadEx->setToleranceType(_normType);
+    _quadEx->setPackedState(_packedState.compare("yes")==0);
+    _quadEx->setEventDetection(_eventDetection.compare("yes")==0,_eventTol);
     _quadEx->setInitialConds(_varQSEx);
     _quadEx->setErrInds(_timeIntInds,_scale);
 
@@ -1118,6 +1241,8 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::prepare_qd2fd()
 
   // update momentum balance equation boundary conditions
   _material->changeBCTypes(_mat_fd_bcRType,_mat_fd_bcTType,_mat_fd_bcLType,_mat_fd_bcBType);
+  MatDestroy(&_waveOp); // A changed, reconstructed on the next call to propagateWaves
+  if (_pmlLayer != NULL) { _pmlLayer->reset(); } // the layer starts at rest
 
 
   #if VERBOSE > 1
@@ -1148,6 +1273,21 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::integrate_singleQDTimeStep()
   else if (_timeIntegrator.compare("RK43")==0) {
     quadEx = new RK43(1,_maxTime,_deltaT_fd,_timeControlType);
   }
+  else if (_timeIntegrator.compare("RK32_2N")==0) {
+    quadEx = new RK32_2N(1,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK43_2N")==0) {
+    quadEx = new RK43_2N(1,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK54")==0) {
+    quadEx = new RK54(1,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("RK65")==0) {
+    quadEx = new RK65(1,_maxTime,_deltaT_fd,_timeControlType);
+  }
+  else if (_timeIntegrator.compare("TSARKIMEX")==0 || _timeIntegrator.compare("TSROSW")==0 || _timeIntegrator.compare("TSBDF")==0) {
+    quadEx = new OdeSolver_TS(1,_maxTime,_deltaT_fd,_timeControlType,_timeIntegrator,_tsJacobian);
+  }
   else if (_timeIntegrator.compare("RK32_WBE")==0) {
     quadImex = new RK32_WBE(1,_maxTime,_deltaT_fd,_timeControlType);
   }
@@ -1165,6 +1305,7 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::integrate_singleQDTimeStep()
     quadImex->setTimeStepBounds(_deltaT_fd,_deltaT_fd);
     quadImex->setTimeRange(_currTime,_currTime+_deltaT_fd);
     quadImex->setInitialStepCount(_stepCount);
+    quadImex->setPackedState(_packedState.compare("yes")==0);
     quadImex->setInitialConds(_varQSEx,_varIm);
     quadImex->setToleranceType(_normType);
     quadImex->setErrInds(_timeIntInds,_scale);
@@ -1177,6 +1318,7 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::integrate_singleQDTimeStep()
     quadEx->setTimeRange(_currTime,_currTime+_deltaT_fd);
     quadEx->setInitialStepCount(_stepCount);
     quadEx->setToleranceType(_normType);
+    quadEx->setPackedState(_packedState.compare("yes")==0);
     quadEx->setInitialConds(_varQSEx);
     quadEx->setErrInds(_timeIntInds,_scale);
 
@@ -1498,26 +1640,25 @@ PetscErrorCode StrikeSlip_PowerLaw_qd_fd::propagateWaves(const PetscScalar time,
 
 double startPropagation = MPI_Wtime();
 
-  // compute D2u = (Dyy+Dzz)*u
-  Vec D2u, temp;
-  VecDuplicate(*_y, &D2u);
-  VecDuplicate(*_y, &temp);
-  Mat A; _material->_sbp->getA(A);
-  ierr = MatMult(A, var.find("u")->second, temp);
-  //~ ierr = VecAXPY(temp, 1.0, _Fhat); // !!! Fhat term
-  ierr = _material->_sbp->Hinv(temp, D2u);
-  VecDestroy(&temp);
-  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
-      Mat J,Jinv,qy,rz,yq,zr;
-      ierr = _material->_sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
-      Vec temp;
-      VecDuplicate(D2u, &temp);
-      MatMult(Jinv, D2u, temp);
-      VecCopy(temp, D2u);
-      VecDestroy(&temp);
+  if (_waveOp == NULL || deltaT != _waveDeltaT) {
+    ierr = constructWaveOperator(deltaT); CHKERRQ(ierr);
   }
-  ierr = VecScatterBegin(*_body2fault, D2u, _fault_fd->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
-  ierr = VecScatterEnd(*_body2fault, D2u, _fault_fd->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+
+  // uNext = dt^2/(rho*(1+dt*ay)) * D2u, with D2u = Jinv*Hinv*A*u = (Dyy+Dzz)*u
+  ierr = MatMult(_waveOp, var.find("u")->second, varNext["u"]); CHKERRQ(ierr);
+
+  // perfectly matched layer: add dt^2/(rho*(1+dt*ay)) * (Dy*psiY + Dz*psiZ - rho*zetaY*zetaZ*u)
+  if (_pmlLayer != NULL) {
+    ierr = _pmlLayer->updateAuxFields(var.find("u")->second, varPrev.find("u")->second, deltaT); CHKERRQ(ierr);
+    ierr = _pmlLayer->computeForce(var.find("u")->second); CHKERRQ(ierr);
+    ierr = VecPointwiseMult(_pmlLayer->_force, _pmlLayer->_force, _waveCf); CHKERRQ(ierr);
+    ierr = VecAXPY(varNext["u"], 1.0, _pmlLayer->_force); CHKERRQ(ierr);
+  }
+
+  // the fault needs D2u itself, so undo the scaling on the fault only
+  ierr = VecScatterBegin(*_body2fault, varNext["u"], _fault_fd->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(*_body2fault, varNext["u"], _fault_fd->_d2u, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecPointwiseMult(_fault_fd->_d2u, _fault_fd->_d2u, _faultD2uScale); CHKERRQ(ierr);
 
 
   // Propagate waves and compute displacement at the next time step
@@ -1525,34 +1666,121 @@ double startPropagation = MPI_Wtime();
 
   PetscInt       Ii,Istart,Iend;
   PetscScalar   *uNextA; // changed in this loop
-  const PetscScalar   *u, *uPrev, *d2u, *ay, *rho; // unchchanged in this loop
+  const PetscScalar   *u, *uPrev, *cu, *cuPrev; // unchchanged in this loop
   ierr = VecGetArray(varNext["u"], &uNextA);
   ierr = VecGetArrayRead(var.find("u")->second, &u);
   ierr = VecGetArrayRead(varPrev.find("u")->second, &uPrev);
-  ierr = VecGetArrayRead(_ay, &ay);
-  ierr = VecGetArrayRead(D2u, &d2u);
-  ierr = VecGetArrayRead(_material->_rho, &rho);
+  ierr = VecGetArrayRead(_waveCu, &cu);
+  ierr = VecGetArrayRead(_waveCuPrev, &cuPrev);
 
   ierr = VecGetOwnershipRange(varNext["u"],&Istart,&Iend);CHKERRQ(ierr);
   PetscInt       Jj = 0;
   for (Ii = Istart; Ii < Iend; Ii++){
-    PetscScalar c1 = deltaT*deltaT / rho[Jj];
-    PetscScalar c2 = deltaT*ay[Jj] - 1.0;
-    PetscScalar c3 = deltaT*ay[Jj] + 1.0;
-
-    uNextA[Jj] = (c1*d2u[Jj] + 2.*u[Jj] + c2*uPrev[Jj]) / c3;
+    uNextA[Jj] += cu[Jj]*u[Jj] + cuPrev[Jj]*uPrev[Jj];
     Jj++;
   }
   ierr = VecRestoreArray(varNext["u"], &uNextA);
   ierr = VecRestoreArrayRead(var.find("u")->second, &u);
   ierr = VecRestoreArrayRead(varPrev.find("u")->second, &uPrev);
+  ierr = VecRestoreArrayRead(_waveCu, &cu);
+  ierr = VecRestoreArrayRead(_waveCuPrev, &cuPrev);
+
+_propagateTime += MPI_Wtime() - startPropagation;
+
+  #if VERBOSE > 1
+     PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+  return ierr;
+}
+
+
+// Construct the scaled operator and coefficients for the leapfrog update
+//   uNext = _waveOp*u + _waveCu.*u + _waveCuPrev.*uPrev
+// which, with c2 = dt*ay - 1 and c3 = dt*ay + 1, is
+//   uNext = (dt^2/rho * Jinv*Hinv*A*u + 2*u + c2*uPrev) / c3
+// Jinv and Hinv are diagonal, so they are folded into the rows of a copy of A.
+// Must be reconstructed if deltaT or the boundary conditions of A change.
+PetscErrorCode StrikeSlip_PowerLaw_qd_fd::constructWaveOperator(const PetscScalar deltaT)
+{
+  PetscErrorCode ierr = 0;
+  #if VERBOSE > 1
+    std::string funcName = "StrikeSlip_PowerLaw_qd_fd::constructWaveOperator";
+    PetscPrintf(PETSC_COMM_WORLD,"Starting %s in %s\n",funcName.c_str(),FILENAME);
+  #endif
+
+  // diagonal of Jinv*Hinv
+  Vec rowScale, temp;
+  VecDuplicate(*_y, &rowScale);
+  VecDuplicate(*_y, &temp);
+  VecSet(temp, 1.0);
+  ierr = _material->_sbp->Hinv(temp, rowScale); CHKERRQ(ierr);
+  if (_D->_gridSpacingType.compare("variableGridSpacing")==0) {
+    Mat J,Jinv,qy,rz,yq,zr;
+    ierr = _material->_sbp->getCoordTrans(J,Jinv,qy,rz,yq,zr); CHKERRQ(ierr);
+    ierr = MatMult(Jinv, rowScale, temp); CHKERRQ(ierr);
+    ierr = VecCopy(temp, rowScale); CHKERRQ(ierr);
+  }
+
+  if (_waveCu == NULL) {
+    VecDuplicate(*_y, &_waveCu);
+    VecDuplicate(*_y, &_waveCuPrev);
+    VecDuplicate(_fault_fd->_d2u, &_faultD2uScale);
+  }
+  if (_pmlLayer != NULL && _waveCf == NULL) { VecDuplicate(*_y, &_waveCf); }
+
+  // temp is reused for rho*c3/dt^2, the inverse of the scaling applied to D2u
+  PetscInt       Ii,Istart,Iend;
+  PetscScalar   *scale, *invScale, *cu, *cuPrev, *cf = NULL;
+  const PetscScalar *ay, *rho, *pmlDamping = NULL;
+  ierr = VecGetArray(rowScale, &scale);
+  ierr = VecGetArray(temp, &invScale);
+  ierr = VecGetArray(_waveCu, &cu);
+  ierr = VecGetArray(_waveCuPrev, &cuPrev);
+  ierr = VecGetArrayRead(_ay, &ay);
+  ierr = VecGetArrayRead(_material->_rho, &rho);
+  if (_pmlLayer != NULL) {
+    ierr = VecGetArray(_waveCf, &cf);
+    ierr = VecGetArrayRead(_pmlLayer->_damping, &pmlDamping);
+  }
+  ierr = VecGetOwnershipRange(rowScale,&Istart,&Iend);CHKERRQ(ierr);
+  PetscInt       Jj = 0;
+  for (Ii = Istart; Ii < Iend; Ii++){
+    PetscScalar a = ay[Jj];
+    if (pmlDamping != NULL) { a += pmlDamping[Jj]; }
+    PetscScalar c1 = deltaT*deltaT / rho[Jj];
+    PetscScalar c2 = deltaT*a - 1.0;
+    PetscScalar c3 = deltaT*a + 1.0;
+
+    scale[Jj] *= c1 / c3;
+    invScale[Jj] = c3 / c1;
+    cu[Jj] = 2.0 / c3;
+    cuPrev[Jj] = c2 / c3;
+    if (cf != NULL) { cf[Jj] = c1 / c3; }
+    Jj++;
+  }
+  if (_pmlLayer != NULL) {
+    ierr = VecRestoreArray(_waveCf, &cf);
+    ierr = VecRestoreArrayRead(_pmlLayer->_damping, &pmlDamping);
+  }
+  ierr = VecRestoreArray(rowScale, &scale);
+  ierr = VecRestoreArray(temp, &invScale);
+  ierr = VecRestoreArray(_waveCu, &cu);
+  ierr = VecRestoreArray(_waveCuPrev, &cuPrev);
   ierr = VecRestoreArrayRead(_ay, &ay);
-  ierr = VecRestoreArrayRead(D2u, &d2u);
   ierr = VecRestoreArrayRead(_material->_rho, &rho);
 
-  VecDestroy(&D2u);
+  ierr = VecScatterBegin(*_body2fault, temp, _faultD2uScale, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+  ierr = VecScatterEnd(*_body2fault, temp, _faultD2uScale, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
 
-_propagateTime += MPI_Wtime() - startPropagation;
+  // _waveOp = diag(rowScale) * A
+  Mat A; _material->_sbp->getA(A);
+  MatDestroy(&_waveOp);
+  ierr = MatDuplicate(A, MAT_COPY_VALUES, &_waveOp); CHKERRQ(ierr);
+  ierr = MatDiagonalScale(_waveOp, rowScale, NULL); CHKERRQ(ierr);
+  _waveDeltaT = deltaT;
+
+  VecDestroy(&rowScale);
+  VecDestroy(&temp);
 
   #if VERBOSE > 1
      PetscPrintf(PETSC_COMM_WORLD,"Ending %s in %s\n",funcName.c_str(),FILENAME);
@@ -16,6 +16,7 @@
 
 #include "odeSolver.hpp"
 #include "odeSolverImex.hpp"
+#include "odeSolver_TS.hpp"
 #include "odeSolver_WaveEq.hpp"
 #include "odeSolver_WaveImex.hpp"
 #include "genFuncs.hpp"
@@ -25,6 +26,7 @@
 #include "sbpOps_m_varGrid.hpp"
 #include "fault.hpp"
 #include "pressureEq.hpp"
+#include "pml.hpp"
 #include "heatEquation.hpp"
 #include "powerLaw.hpp"
 
@@ -68,6 +70,13 @@ public:
   Vec             _ay;
   Vec             _Fhat;
   Vec             _alphay;
+  Mat             _waveOp; // scaled spatial operator for the wave equation, see constructWaveOperator
+  Vec             _waveCu,_waveCuPrev,_faultD2uScale;
+  PetscScalar     _waveDeltaT; // deltaT for which _waveOp was constructed
+  string          _pml; // yes: perfectly matched layer on the right and bottom boundaries when fully dynamic
+  PetscScalar     _pmlThickness,_pmlR; // (km) thickness of the layer, and its reflection coefficient
+  PerfectlyMatchedLayer *_pmlLayer;
+  Vec             _waveCf; // dt^2/(rho*(1+dt*ay)), scales the force from the layer
   bool            _inDynamic,_allowed;
   PetscScalar     _trigger_qd2fd, _trigger_fd2qd, _limit_qd, _limit_fd, _limit_stride_fd;
 
@@ -87,6 +96,10 @@ public:
   vector<string>    _timeIntInds; // indices of variables to be used in time integration
   vector<double>    _scale; // scale factor for entries in _timeIntInds
   string            _normType;
+  string            _packedState; // store integrated variables in one contiguous Vec
+  string            _tsJacobian; // preconditioner for the PETSc TS integrators: mf or diagonal
+  string            _eventDetection; // locate the switch to fully dynamic within the step: yes or no
+  PetscScalar       _eventTol; // tolerance on the switching time, relative to the step size
 
   // runtime data
   double       _integrateTime,_writeTime,_linSolveTime,_factorTime,_startTime,_miscTime,_startIntegrateTime, _propagateTime, _dynTime, _qdTime;
@@ -154,9 +167,12 @@ public:
   PetscErrorCode solveMomentumBalance(const PetscScalar time,const map<string,Vec>& varEx,map<string,Vec>& dvarEx);
   PetscErrorCode propagateWaves(const PetscScalar time, const PetscScalar deltaT,
         map<string,Vec>& varNext, const map<string,Vec>& var, const map<string,Vec>& varPrev);
+  PetscErrorCode constructWaveOperator(const PetscScalar deltaT);
 
   // help with switching between fully dynamic and quasidynamic
   bool checkSwitchRegime(const Fault* _fault);
+  PetscErrorCode computeMaxR(const Vec& slipVel,const Vec& tauQS,PetscScalar& maxR); // max of R = eta*V/tauQS
+  PetscErrorCode eventFunction(const PetscReal time,const map<string,Vec>& var,const map<string,Vec>& dvar,PetscScalar& g);
   PetscErrorCode prepare_qd2fd(); // switch from quasidynamic to fully dynamic
   PetscErrorCode prepare_fd2qd(); // switch from fully dynamic to quasidynamic
 